@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * @brief 基准测试的小工具（bench_*共用，只有头文件）
+ *
+ * measureMs()把函数运行repeats次，返回最快一次的毫秒数：
+ * 取最小值而不是平均值，排除线程调度、页错误这些和被测代码无关的噪声。
+ * 第一次运行之前先热身一次（缓存、分支预测、懒分配）。
+ *
+ * 用doNotOptimize()吃掉计算结果，防止编译器把整个循环删掉。
+ */
+namespace bench {
+
+template<typename Func>
+double measureMs(int repeats, Func&& func) {
+    func();
+    double best = 1e30;
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const T* volatile sink;
+    sink = &value;
+#endif
+}
+
+// 第一个命令行参数覆盖默认规模（比如 bench_bvh 100000）
+inline uint32_t argOr(int argc, char** argv, uint32_t fallback) {
+    return argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : fallback;
+}
+
+} // namespace bench
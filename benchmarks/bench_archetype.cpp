@@ -0,0 +1,121 @@
+#include "Benchmark.h"
+#include "ECS/ECS.h"
+#include <cstdio>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// 迭代一个两组件查询：改用archetype存储之前（每个实体一个unordered_map，组件单独new）
+// 和之后（archetype chunk里的连续数组，view().each()）的对比
+
+namespace {
+
+struct Position { float x, y, z; };
+struct Velocity { float x, y, z; };
+struct Health { float value; };
+
+// archetype之前的存储方式：Entity -> (类型 -> 堆上的组件)，查询逐个实体查两次哈希表
+class LegacyECS {
+public:
+    ~LegacyECS() {
+        for (auto& entity : m_components) {
+            for (auto& component : entity.second) ::operator delete(component.second);
+        }
+    }
+
+    uint32_t createEntity() {
+        m_entities.push_back(m_nextID);
+        return m_nextID++;
+    }
+
+    template<typename T>
+    void addComponent(uint32_t entity, const T& component) {
+        void* memory = ::operator new(sizeof(T));
+        new (memory) T(component);
+        m_components[entity][std::type_index(typeid(T))] = memory;
+    }
+
+    template<typename T>
+    T* getComponent(uint32_t entity) {
+        auto entityIt = m_components.find(entity);
+        if (entityIt == m_components.end()) return nullptr;
+        auto componentIt = entityIt->second.find(std::type_index(typeid(T)));
+        return componentIt == entityIt->second.end() ? nullptr : static_cast<T*>(componentIt->second);
+    }
+
+    template<typename T1, typename T2>
+    std::vector<uint32_t> entitiesWith() {
+        std::vector<uint32_t> result;
+        for (uint32_t entity : m_entities) {
+            if (getComponent<T1>(entity) && getComponent<T2>(entity)) result.push_back(entity);
+        }
+        return result;
+    }
+
+private:
+    uint32_t m_nextID = 1;
+    std::vector<uint32_t> m_entities;
+    std::unordered_map<uint32_t, std::unordered_map<std::type_index, void*>> m_components;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t count = bench::argOr(argc, argv, 100000);
+    const float dt = 1.0f / 60.0f;
+
+    // 一半实体多一个Health：查询要跨两个archetype
+    LegacyECS legacy;
+    ECS ecs;
+    for (uint32_t i = 0; i < count; ++i) {
+        Position position{ float(i), 0.0f, 0.0f };
+        Velocity velocity{ 1.0f, 2.0f, 3.0f };
+
+        uint32_t legacyEntity = legacy.createEntity();
+        legacy.addComponent(legacyEntity, position);
+        legacy.addComponent(legacyEntity, velocity);
+
+        Entity entity = ecs.createEntity();
+        ecs.addComponent(entity, position);
+        ecs.addComponent(entity, velocity);
+        if (i % 2 == 0) {
+            legacy.addComponent(legacyEntity, Health{ 100.0f });
+            ecs.addComponent(entity, Health{ 100.0f });
+        }
+    }
+
+    double legacyMs = bench::measureMs(10, [&]() {
+        for (uint32_t entity : legacy.entitiesWith<Position, Velocity>()) {
+            Position* p = legacy.getComponent<Position>(entity);
+            const Velocity* v = legacy.getComponent<Velocity>(entity);
+            p->x += v->x * dt; p->y += v->y * dt; p->z += v->z * dt;
+        }
+    });
+
+    // 新存储上仍然按实体查找（entitiesWith + getComponent）
+    double lookupMs = bench::measureMs(10, [&]() {
+        for (Entity entity : ecs.entitiesWith<Position, Velocity>()) {
+            Position* p = ecs.getComponent<Position>(entity);
+            const Velocity* v = ecs.getComponent<Velocity>(entity);
+            p->x += v->x * dt; p->y += v->y * dt; p->z += v->z * dt;
+        }
+    });
+
+    double viewMs = bench::measureMs(10, [&]() {
+        ecs.view<Position, Velocity>().each([&](Entity, Position& p, const Velocity& v) {
+            p.x += v.x * dt; p.y += v.y * dt; p.z += v.z * dt;
+        });
+    });
+
+    float checksum = 0.0f;
+    ecs.view<Position>().each([&](Entity, Position& p) { checksum += p.x; });
+    bench::doNotOptimize(checksum);
+
+    auto nsPerEntity = [&](double ms) { return ms * 1e6 / count; };
+    std::printf("bench_archetype: %u entities, query <Position, Velocity>\n", count);
+    std::printf("  before (hash map per entity)    %9.3f ms  %7.2f ns/entity\n", legacyMs, nsPerEntity(legacyMs));
+    std::printf("  archetype, entitiesWith+get     %9.3f ms  %7.2f ns/entity\n", lookupMs, nsPerEntity(lookupMs));
+    std::printf("  archetype, view().each()        %9.3f ms  %7.2f ns/entity  (%.1fx faster than before)\n",
+                viewMs, nsPerEntity(viewMs), legacyMs / viewMs);
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+#include "ECS/BVH.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// BVH在1M实体上的构建和查询：
+// - build()（SAH）和逐个insert()构建的耗时，以及两者的树质量（面积比）
+// - queryAABB / raycast 每次查询的耗时，和暴力遍历全部AABB对比
+// - update()：小幅移动（在胖包围盒内）和大幅移动（需要重新插入）
+
+int main(int argc, char** argv) {
+    const uint32_t count = bench::argOr(argc, argv, 1000000);
+    const float worldSize = 2000.0f;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(0.0f, worldSize);
+    std::uniform_real_distribution<float> size(0.5f, 3.0f);
+
+    std::vector<Entity> entities(count);
+    std::vector<AABBComponent> bounds(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        entities[i] = makeEntity(i, 1);
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        glm::vec3 half(size(rng) * 0.5f);
+        bounds[i].min = center - half;
+        bounds[i].max = center + half;
+    }
+
+    std::printf("bench_bvh: %u entities in a %.0f^3 world\n", count, worldSize);
+
+    // ---- 构建 ----
+    BVH bvh;
+    double buildMs = bench::measureMs(3, [&]() { bvh.build(entities, bounds); });
+    std::printf("  build (SAH)           %9.1f ms  height %d, area ratio %.1f\n",
+                buildMs, bvh.getHeight(), bvh.getAreaRatio());
+
+    {
+        BVH incremental;
+        double insertMs = bench::measureMs(1, [&]() {
+            incremental.clear();
+            for (uint32_t i = 0; i < count; ++i) incremental.insert(entities[i], bounds[i]);
+        });
+        std::printf("  insert one by one     %9.1f ms  height %d, area ratio %.1f\n",
+                    insertMs, incremental.getHeight(), incremental.getAreaRatio());
+    }
+
+    // ---- 查询 ----
+    const uint32_t queryCount = 1000;
+    std::vector<AABBComponent> queries(queryCount);
+    for (auto& query : queries) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        query.min = center - glm::vec3(25.0f);
+        query.max = center + glm::vec3(25.0f);
+    }
+
+    size_t hits = 0;
+    double queryMs = bench::measureMs(5, [&]() {
+        hits = 0;
+        for (const auto& query : queries) bvh.queryAABB(query, [&](Entity) { hits++; });
+    });
+
+    // 暴力遍历太慢，只跑前10个查询
+    const uint32_t bruteCount = 10;
+    size_t bruteHits = 0;
+    double bruteMs = bench::measureMs(1, [&]() {
+        bruteHits = 0;
+        for (uint32_t q = 0; q < bruteCount; ++q) {
+            const AABBComponent& query = queries[q];
+            for (const auto& box : bounds) {
+                if (box.max.x >= query.min.x && box.min.x <= query.max.x &&
+                    box.max.y >= query.min.y && box.min.y <= query.max.y &&
+                    box.max.z >= query.min.z && box.min.z <= query.max.z) {
+                    bruteHits++;
+                }
+            }
+        }
+    });
+    std::printf("  queryAABB (50^3 box)  %9.3f us/query  %.1f hits/query   brute force %9.1f us/query\n",
+                queryMs * 1e3 / queryCount, double(hits) / queryCount, bruteMs * 1e3 / bruteCount);
+    bench::doNotOptimize(bruteHits);
+
+    std::vector<glm::vec3> rayOrigins(queryCount), rayDirections(queryCount);
+    for (uint32_t i = 0; i < queryCount; ++i) {
+        rayOrigins[i] = glm::vec3(position(rng), position(rng), position(rng));
+        rayDirections[i] = glm::normalize(glm::vec3(position(rng), position(rng), position(rng)) - rayOrigins[i]);
+    }
+
+    // 最近命中：每个命中把射线截短到进入距离
+    size_t rayHits = 0;
+    double rayMs = bench::measureMs(5, [&]() {
+        rayHits = 0;
+        for (uint32_t i = 0; i < queryCount; ++i) {
+            bool hit = false;
+            bvh.raycast(rayOrigins[i], rayDirections[i], worldSize, [&](Entity, float entry) {
+                hit = true;
+                return entry;
+            });
+            rayHits += hit ? 1 : 0;
+        }
+    });
+    std::printf("  raycast closest hit   %9.3f us/ray    %.0f%% hit\n",
+                rayMs * 1e3 / queryCount, 100.0 * double(rayHits) / queryCount);
+
+    // ---- 更新 ----
+    const uint32_t moveCount = count / 10;
+    std::vector<AABBComponent> moved(bounds.begin(), bounds.begin() + moveCount);
+
+    auto moveAll = [&](float offset) {
+        uint32_t reinserted = 0;
+        for (uint32_t i = 0; i < moveCount; ++i) {
+            moved[i].min.x += offset;
+            moved[i].max.x += offset;
+            reinserted += bvh.update(entities[i], moved[i]) ? 1 : 0;
+        }
+        return reinserted;
+    };
+
+    // 来回移动，避免盒子一路漂出原来的位置
+    uint32_t reinserted = 0;
+    float direction = 1.0f;
+    double smallMs = bench::measureMs(4, [&]() {
+        reinserted = moveAll(0.01f * direction);
+        direction = -direction;
+    });
+    std::printf("  update, small move    %9.1f ns/entity (%u of %u re-inserted)\n",
+                smallMs * 1e6 / moveCount, reinserted, moveCount);
+
+    double largeMs = bench::measureMs(4, [&]() {
+        reinserted = moveAll(5.0f * direction);
+        direction = -direction;
+    });
+    std::printf("  update, large move    %9.1f ns/entity (%u of %u re-inserted)\n",
+                largeMs * 1e6 / moveCount, reinserted, moveCount);
+    return 0;
+}
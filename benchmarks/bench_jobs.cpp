@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+#include "Framework/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// JobSystem的两项开销：
+// 1. 调度开销 - 空作业 run() + wait() 平均每个多少纳秒
+// 2. 扩展性 - 同一个parallelFor在1..N个线程上相对串行循环的加速比
+
+namespace {
+
+// 每个元素几十纳秒的纯计算，代表一个轻量的每实体更新
+float work(float x) {
+    for (int i = 0; i < 8; ++i) x = std::sqrt(x * x + 1.0f) * 0.5f;
+    return x;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t count = bench::argOr(argc, argv, 1000000);
+    uint32_t hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::printf("bench_jobs: %u hardware threads\n", hardwareThreads);
+
+    // ---- 调度开销 ----
+    {
+        JobSystem jobs;
+        const uint32_t jobCount = 100000;
+
+        double batchMs = bench::measureMs(5, [&]() {
+            JobCounter counter;
+            for (uint32_t i = 0; i < jobCount; ++i) jobs.run([]() {}, &counter);
+            jobs.wait(counter);
+        });
+
+        // 单个作业的往返延迟：提交后立刻等待
+        const uint32_t roundTrips = 10000;
+        double roundTripMs = bench::measureMs(5, [&]() {
+            for (uint32_t i = 0; i < roundTrips; ++i) {
+                JobCounter counter;
+                jobs.run([]() {}, &counter);
+                jobs.wait(counter);
+            }
+        });
+
+        std::printf("  dispatch, %u empty jobs then wait   %8.1f ns/job\n", jobCount, batchMs * 1e6 / jobCount);
+        std::printf("  dispatch, run + wait round trip         %8.1f ns/job\n", roundTripMs * 1e6 / roundTrips);
+    }
+
+    // ---- parallelFor扩展性 ----
+    std::vector<float> data(count);
+    for (uint32_t i = 0; i < count; ++i) data[i] = float(i % 1000);
+
+    double serialMs = bench::measureMs(5, [&]() {
+        for (uint32_t i = 0; i < count; ++i) data[i] = work(data[i]);
+    });
+    std::printf("  parallelFor over %u elements\n", count);
+    std::printf("    serial loop     %9.3f ms\n", serialMs);
+
+    // 线程数包括主线程，所以工作线程数 = threads - 1
+    for (uint32_t threads = 2; threads <= hardwareThreads; ++threads) {
+        JobSystem jobs(threads - 1);
+        double parallelMs = bench::measureMs(5, [&]() {
+            jobs.parallelFor(0, count, 0, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) data[i] = work(data[i]);
+            });
+        });
+        std::printf("    %2u threads      %9.3f ms  %5.2fx\n", threads, parallelMs, serialMs / parallelMs);
+    }
+
+    bench::doNotOptimize(data[count / 2]);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/MeshBVH.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// 拾取的精测阶段（射线 vs 网格三角形）在百万三角形的球上：
+// - MeshBVH构建耗时（每个网格第一次被拾取时付一次）
+// - 每条射线的平均和最坏耗时，目标是1 ms以内
+// - 和逐个三角形暴力求交对比
+// 参数是球的分段数，三角形数约为 2 * segments^2
+
+namespace {
+
+void makeSphere(uint32_t segments, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    const float pi = 3.14159265358979f;
+    for (uint32_t ring = 0; ring <= segments; ++ring) {
+        float phi = pi * ring / segments;
+        for (uint32_t segment = 0; segment <= segments; ++segment) {
+            float theta = 2.0f * pi * segment / segments;
+            Vertex vertex{};
+            vertex.position = glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            vertex.normal = vertex.position;
+            vertices.push_back(vertex);
+        }
+    }
+    for (uint32_t ring = 0; ring < segments; ++ring) {
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            uint32_t current = ring * (segments + 1) + segment;
+            uint32_t next = current + segments + 1;
+            indices.insert(indices.end(), { current, next, current + 1, current + 1, next, next + 1 });
+        }
+    }
+}
+
+// 逐个三角形的Möller–Trumbore，返回最近距离
+float bruteForce(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                 const glm::vec3& origin, const glm::vec3& direction) {
+    float best = 1e30f;
+    for (size_t t = 0; t < indices.size(); t += 3) {
+        const glm::vec3& a = vertices[indices[t]].position;
+        glm::vec3 edge1 = vertices[indices[t + 1]].position - a;
+        glm::vec3 edge2 = vertices[indices[t + 2]].position - a;
+        glm::vec3 p = glm::cross(direction, edge2);
+        float determinant = glm::dot(edge1, p);
+        if (std::abs(determinant) < 1e-12f) continue;
+        float inverseDeterminant = 1.0f / determinant;
+        glm::vec3 toOrigin = origin - a;
+        float u = glm::dot(toOrigin, p) * inverseDeterminant;
+        if (u < 0.0f || u > 1.0f) continue;
+        glm::vec3 q = glm::cross(toOrigin, edge1);
+        float v = glm::dot(direction, q) * inverseDeterminant;
+        if (v < 0.0f || u + v > 1.0f) continue;
+        float distance = glm::dot(edge2, q) * inverseDeterminant;
+        if (distance >= 0.0f && distance < best) best = distance;
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t segments = bench::argOr(argc, argv, 1000);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    makeSphere(segments, vertices, indices);
+    std::printf("bench_picking: sphere with %u segments, %zu triangles\n", segments, indices.size() / 3);
+
+    // ---- 构建（每个网格第一次被拾取时） ----
+    std::unique_ptr<MeshBVH> bvh;
+    double buildMs = bench::measureMs(1, [&]() { bvh = std::make_unique<MeshBVH>(vertices, indices); });
+    std::printf("  build                %9.1f ms  %zu nodes, depth %u\n", buildMs, bvh->getNodeCount(), bvh->getDepth());
+
+    // ---- 拾取：相机在球外随机位置，射线打向球附近（约一半命中） ----
+    const uint32_t rayCount = 10000;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::vec3> origins(rayCount), directions(rayCount);
+    for (uint32_t i = 0; i < rayCount; ++i) {
+        glm::vec3 eye(unit(rng), unit(rng), unit(rng));
+        origins[i] = glm::normalize(eye + glm::vec3(0.0f, 0.0f, 1e-3f)) * 4.0f;
+        glm::vec3 target = glm::vec3(unit(rng), unit(rng), unit(rng)) * 1.4f;
+        directions[i] = glm::normalize(target - origins[i]);
+    }
+
+    size_t hits = 0;
+    double worstUs = 0.0;
+    double pickMs = bench::measureMs(3, [&]() {
+        hits = 0;
+        for (uint32_t i = 0; i < rayCount; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            MeshBVH::Hit hit;
+            hits += bvh->intersect(origins[i], directions[i], 1e30f, hit);
+            bench::doNotOptimize(hit);
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            worstUs = std::max(worstUs, us);
+        }
+    });
+
+    // 暴力求交太慢，只跑前10条射线
+    const uint32_t bruteCount = 10;
+    float bruteSum = 0.0f;
+    double bruteMs = bench::measureMs(1, [&]() {
+        bruteSum = 0.0f;
+        for (uint32_t i = 0; i < bruteCount; ++i) {
+            bruteSum += bruteForce(vertices, indices, origins[i], directions[i]);
+        }
+    });
+    bench::doNotOptimize(bruteSum);
+
+    double averageUs = pickMs * 1e3 / rayCount;
+    std::printf("  pick                 %9.3f us/ray average, %.1f us worst  (%.0f%% hit)   brute force %9.1f us/ray\n",
+                averageUs, worstUs, 100.0 * hits / rayCount, bruteMs * 1e3 / bruteCount);
+    std::printf("  target < 1 ms per pick: %s\n", worstUs < 1000.0 ? "met" : "MISSED");
+    return 0;
+}
@@ -0,0 +1,404 @@
+#include "Benchmark.h"
+#include "Framework/JobSystem.h"
+#include "Rendering/ForwardPass.h"
+#include "Rendering/ThreadCommandPools.h"
+#include <glm/glm.hpp>
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 多线程录制secondary command buffer：100k个绘制在1..N个线程上的录制时间
+//
+// 用ForwardPass::recordParallel()的切块方式（getChunkCount/getChunkRange：每线程2块，每块至少1024个绘制），
+// 每个绘制 = push constants(MVP) + vkCmdDrawIndexed。只录制不提交，
+// 不需要窗口和交换链；但需要Vulkan驱动和编译好的着色器（在仓库根目录运行）。
+
+namespace {
+
+
+void check(VkResult result, const char* what) {
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error(std::string("bench_record: ") + what + " failed");
+    }
+}
+
+std::vector<char> readFile(const char* path) {
+    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::string("bench_record: cannot open ") + path + " (run from the repository root after compiling shaders)");
+    }
+    std::vector<char> buffer(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), buffer.size());
+    return buffer;
+}
+
+// 录制需要的最少Vulkan对象：设备、render pass、pipeline、一对顶点/索引缓冲
+struct Context {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkBuffer vertexBuffer = VK_NULL_HANDLE;
+    VkBuffer indexBuffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+
+    void initialize();
+    void cleanup();
+
+private:
+    void createDevice();
+    void createRenderPass();
+    void createPipeline();
+    void createBuffers();
+    VkShaderModule createShaderModule(const char* path);
+};
+
+void Context::initialize() {
+    createDevice();
+    createRenderPass();
+    createPipeline();
+    createBuffers();
+}
+
+void Context::createDevice() {
+    VkApplicationInfo appInfo{};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "bench_record";
+    appInfo.apiVersion = VK_API_VERSION_1_2;
+
+    VkInstanceCreateInfo instanceInfo{};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instanceInfo.pApplicationInfo = &appInfo;
+    check(vkCreateInstance(&instanceInfo, nullptr, &instance), "vkCreateInstance");
+
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+    for (VkPhysicalDevice candidate : devices) {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, families.data());
+        for (uint32_t i = 0; i < familyCount; ++i) {
+            if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                physicalDevice = candidate;
+                queueFamily = i;
+                break;
+            }
+        }
+        if (physicalDevice != VK_NULL_HANDLE) break;
+    }
+    if (physicalDevice == VK_NULL_HANDLE) {
+        throw std::runtime_error("bench_record: no GPU with a graphics queue");
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    std::printf("bench_record: %s\n", properties.deviceName);
+
+    float priority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo{};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = queueFamily;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo deviceInfo{};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    check(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device), "vkCreateDevice");
+}
+
+void Context::createRenderPass() {
+    VkAttachmentDescription colorAttachment{};
+    colorAttachment.format = VK_FORMAT_R8G8B8A8_UNORM;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorReference{};
+    colorReference.attachment = 0;
+    colorReference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorReference;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    check(vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass), "vkCreateRenderPass");
+}
+
+VkShaderModule Context::createShaderModule(const char* path) {
+    std::vector<char> code = readFile(path);
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule module;
+    check(vkCreateShaderModule(device, &moduleInfo, nullptr, &module), "vkCreateShaderModule");
+    return module;
+}
+
+void Context::createPipeline() {
+    // 和SimpleMaterial一样：顶点着色器里一个mat4的push constant
+    VkPushConstantRange pushConstant{};
+    pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstant.size = sizeof(glm::mat4);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstant;
+    check(vkCreatePipelineLayout(device, &layoutInfo, nullptr, &pipelineLayout), "vkCreatePipelineLayout");
+
+    VkShaderModule vertexModule = createShaderModule("shaders/compiled/simple.vert.spv");
+    VkShaderModule fragmentModule = createShaderModule("shaders/compiled/simple.frag.spv");
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertexModule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragmentModule;
+    stages[1].pName = "main";
+
+    // Vertex的布局：position, color, normal (vec3) + texCoord (vec2)
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = 11 * sizeof(float);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkVertexInputAttributeDescription attributes[4]{};
+    for (uint32_t i = 0; i < 4; ++i) {
+        attributes[i].location = i;
+        attributes[i].format = i < 3 ? VK_FORMAT_R32G32B32_SFLOAT : VK_FORMAT_R32G32_SFLOAT;
+        attributes[i].offset = i * 3 * sizeof(float);
+    }
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = 1;
+    vertexInput.pVertexBindingDescriptions = &binding;
+    vertexInput.vertexAttributeDescriptionCount = 4;
+    vertexInput.pVertexAttributeDescriptions = attributes;
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState blendAttachment{};
+    blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                     VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &blendAttachment;
+
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = stages;
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = pipelineLayout;
+    pipelineInfo.renderPass = renderPass;
+    pipelineInfo.subpass = 0;
+    VkResult result = vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+
+    vkDestroyShaderModule(device, vertexModule, nullptr);
+    vkDestroyShaderModule(device, fragmentModule, nullptr);
+    check(result, "vkCreateGraphicsPipelines");
+}
+
+void Context::createBuffers() {
+    // 内容无所谓（从不提交），只需要有效的、绑定了内存的缓冲
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = 256;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    bufferInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    check(vkCreateBuffer(device, &bufferInfo, nullptr, &vertexBuffer), "vkCreateBuffer");
+    bufferInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+    check(vkCreateBuffer(device, &bufferInfo, nullptr, &indexBuffer), "vkCreateBuffer");
+
+    VkMemoryRequirements vertexRequirements, indexRequirements;
+    vkGetBufferMemoryRequirements(device, vertexBuffer, &vertexRequirements);
+    vkGetBufferMemoryRequirements(device, indexBuffer, &indexRequirements);
+
+    VkDeviceSize alignment = std::max(indexRequirements.alignment, VkDeviceSize(1));
+    VkDeviceSize indexOffset = (vertexRequirements.size + alignment - 1) / alignment * alignment;
+    uint32_t typeBits = vertexRequirements.memoryTypeBits & indexRequirements.memoryTypeBits;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = indexOffset + indexRequirements.size;
+    while (allocInfo.memoryTypeIndex < 32 && !(typeBits & (1u << allocInfo.memoryTypeIndex))) {
+        allocInfo.memoryTypeIndex++;
+    }
+    check(vkAllocateMemory(device, &allocInfo, nullptr, &memory), "vkAllocateMemory");
+    vkBindBufferMemory(device, vertexBuffer, memory, 0);
+    vkBindBufferMemory(device, indexBuffer, memory, indexOffset);
+}
+
+void Context::cleanup() {
+    if (device != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, vertexBuffer, nullptr);
+        vkDestroyBuffer(device, indexBuffer, nullptr);
+        vkFreeMemory(device, memory, nullptr);
+        vkDestroyPipeline(device, pipeline, nullptr);
+        vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        vkDestroyRenderPass(device, renderPass, nullptr);
+        vkDestroyDevice(device, nullptr);
+        device = VK_NULL_HANDLE;
+    }
+    if (instance != VK_NULL_HANDLE) {
+        vkDestroyInstance(instance, nullptr);
+        instance = VK_NULL_HANDLE;
+    }
+}
+
+// 录制排序后第[begin, end)个绘制（相当于ForwardPass::recordDraws的逐个绘制路径）
+void recordDraws(VkCommandBuffer cmd, const Context& context, const std::vector<glm::mat4>& mvps,
+                 uint32_t begin, uint32_t end) {
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, context.pipeline);
+
+    VkViewport viewport{ 0.0f, 0.0f, 1920.0f, 1080.0f, 0.0f, 1.0f };
+    VkRect2D scissor{ { 0, 0 }, { 1920, 1080 } };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &context.vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(cmd, context.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+
+    for (uint32_t i = begin; i < end; ++i) {
+        vkCmdPushConstants(cmd, context.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &mvps[i]);
+        vkCmdDrawIndexed(cmd, 3, 1, 0, 0, 0);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t drawCount = bench::argOr(argc, argv, 100000);
+    const uint32_t hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    Context context;
+    try {
+        context.initialize();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        context.cleanup();
+        return 1;
+    }
+
+    std::vector<glm::mat4> mvps(drawCount);
+    for (uint32_t i = 0; i < drawCount; ++i) mvps[i][3][0] = float(i);
+
+    std::printf("  %u draws, recorded into secondaries (not submitted)\n", drawCount);
+
+    // 单线程：主线程一个secondary录制全部
+    double serialMs;
+    {
+        ThreadCommandPools pools;
+        pools.initialize(context.device, context.queueFamily, 1);
+        uint32_t frame = 0;
+        serialMs = bench::measureMs(10, [&]() {
+            pools.beginFrame(frame++ % IRenderPass::MAX_FRAMES_IN_FLIGHT);
+            VkCommandBuffer secondary = pools.beginSecondary(0, context.renderPass, 0);
+            recordDraws(secondary, context, mvps, 0, drawCount);
+            vkEndCommandBuffer(secondary);
+        });
+        pools.cleanup();
+    }
+    std::printf("     1 thread   %8.3f ms  %6.1f ns/draw\n", serialMs, serialMs * 1e6 / drawCount);
+
+    // 线程数包括主线程，所以工作线程数 = threads - 1
+    for (uint32_t threads = 2; threads <= hardwareThreads; ++threads) {
+        JobSystem jobs(threads - 1);
+        ThreadCommandPools pools;
+        pools.initialize(context.device, context.queueFamily, jobs.getThreadCount());
+
+        uint32_t chunkCount = ForwardPass::getChunkCount(drawCount, threads);
+        std::vector<VkCommandBuffer> secondaries(chunkCount);
+
+        uint32_t frame = 0;
+        double parallelMs = bench::measureMs(10, [&]() {
+            pools.beginFrame(frame++ % IRenderPass::MAX_FRAMES_IN_FLIGHT);
+            jobs.parallelFor(0, chunkCount, 1, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+                uint32_t threadIndex = jobs.getCurrentThreadIndex();
+                for (uint32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+                    size_t begin = 0;
+                    size_t end = 0;
+                    ForwardPass::getChunkRange(drawCount, chunkCount, chunk, begin, end);
+                    VkCommandBuffer secondary = pools.beginSecondary(threadIndex, context.renderPass, 0);
+                    recordDraws(secondary, context, mvps, uint32_t(begin), uint32_t(end));
+                    vkEndCommandBuffer(secondary);
+                    secondaries[chunk] = secondary;
+                }
+            });
+        });
+        pools.cleanup();
+
+        std::printf("    %2u threads  %8.3f ms  %6.1f ns/draw  %5.2fx  (%u secondaries)\n",
+                    threads, parallelMs, parallelMs * 1e6 / drawCount, serialMs / parallelMs, chunkCount);
+    }
+
+    context.cleanup();
+    return 0;
+}
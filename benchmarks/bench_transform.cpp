@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+#include "Framework/TransformBatch.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstdio>
+#include <vector>
+
+// TransformBatch相对逐个调用glm的吞吐量（百万矩阵/秒），规模10k / 100k / 1M：
+// 10k在L1/L2里，1M要走内存，能看出什么时候从算力瓶颈变成带宽瓶颈
+
+namespace {
+
+struct Inputs {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> out;
+
+    explicit Inputs(size_t count)
+        : positions(count), rotations(count), scales(count), locals(count), out(count) {
+        for (size_t i = 0; i < count; ++i) {
+            float f = float(i);
+            positions[i] = glm::vec3(f, f * 0.5f, -f);
+            rotations[i] = glm::normalize(glm::quat(1.0f, f * 0.001f, 0.3f, -0.2f));
+            scales[i] = glm::vec3(1.0f + f * 0.0001f);
+        }
+    }
+};
+
+double matricesPerSecond(size_t count, double ms) {
+    return double(count) / (ms * 1e-3) / 1e6;
+}
+
+} // namespace
+
+int main() {
+    const size_t sizes[] = { 10000, 100000, 1000000 };
+    const glm::mat4 viewProjection =
+        glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+        glm::lookAt(glm::vec3(0.0f, 10.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    std::printf("bench_transform: TransformBatch = %s, numbers in million matrices/s\n",
+                TransformBatch::getInstructionSet());
+    std::printf("  %9s  %12s %12s  %12s %12s\n", "count", "local glm", "local batch", "mul glm", "mul batch");
+
+    for (size_t count : sizes) {
+        Inputs in(count);
+        int repeats = count >= 1000000 ? 5 : 20;
+
+        double localGlmMs = bench::measureMs(repeats, [&]() {
+            for (size_t i = 0; i < count; ++i) {
+                in.locals[i] = glm::translate(glm::mat4(1.0f), in.positions[i]) *
+                               glm::mat4_cast(in.rotations[i]) *
+                               glm::scale(glm::mat4(1.0f), in.scales[i]);
+            }
+            bench::doNotOptimize(in.locals[count - 1]);
+        });
+
+        double localBatchMs = bench::measureMs(repeats, [&]() {
+            TransformBatch::computeLocalMatrices(in.positions.data(), in.rotations.data(), in.scales.data(),
+                                                 in.locals.data(), count);
+            bench::doNotOptimize(in.locals[count - 1]);
+        });
+
+        double mulGlmMs = bench::measureMs(repeats, [&]() {
+            for (size_t i = 0; i < count; ++i) in.out[i] = viewProjection * in.locals[i];
+            bench::doNotOptimize(in.out[count - 1]);
+        });
+
+        double mulBatchMs = bench::measureMs(repeats, [&]() {
+            TransformBatch::multiply(viewProjection, in.locals.data(), in.out.data(), count);
+            bench::doNotOptimize(in.out[count - 1]);
+        });
+
+        std::printf("  %9zu  %12.1f %12.1f  %12.1f %12.1f\n", count,
+                    matricesPerSecond(count, localGlmMs), matricesPerSecond(count, localBatchMs),
+                    matricesPerSecond(count, mulGlmMs), matricesPerSecond(count, mulBatchMs));
+    }
+    return 0;
+}
@@ -6,7 +6,7 @@ REM
 REM Features:
 REM - Compiles GLSL shaders to SPIR-V
 REM - Auto-creates output directory
-REM - Compiles all .vert and .frag files
+REM - Compiles all .vert, .frag and .comp files
 REM
 REM Usage:
 REM   Double-click or run: tools\compile_shaders.bat
@@ -46,6 +46,18 @@ for %%f in (shaders\*.frag) do (
     )
 )
 
+REM Compile compute shaders
+echo Compiling compute shaders...
+for %%f in (shaders\*.comp) do (
+    echo   %%f -^> shaders\compiled\%%~nf.comp.spv
+    glslc %%f -o shaders\compiled\%%~nf.comp.spv
+    if errorlevel 1 (
+        echo ERROR: Failed to compile %%f
+        pause
+        exit /b 1
+    )
+)
+
 echo.
 echo ========================================
 echo All shaders compiled successfully!
@@ -0,0 +1,50 @@
+#version 450
+
+// ============================================================================
+// GPU DRIVEN VERTEX SHADER
+// ============================================================================
+//
+// 功能：
+// - 和simple.vert相同，但model矩阵来自物体存储缓冲
+// - 间接命令的firstInstance是物体下标，gl_InstanceIndex包含firstInstance
+// - push constant里是ViewProjection
+// - 片段着色器用simple.frag
+
+// 输入（来自Vertex结构体）
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inTexCoord;
+
+struct GPUObject {
+    mat4 model;
+    vec4 boundsCenter;
+    vec4 boundsExtents;
+    uint meshIndex;
+    uint pad0;
+    uint pad1;
+    uint pad2;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+    GPUObject objects[];
+};
+
+// Push Constants（ViewProjection矩阵）
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+} push;
+
+// 输出到片段着色器
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+
+void main() {
+    mat4 model = objects[gl_InstanceIndex].model;
+    gl_Position = push.viewProjection * model * vec4(inPosition, 1.0);
+
+    fragColor = inColor;
+    fragNormal = mat3(model) * inNormal;
+    fragTexCoord = inTexCoord;
+}
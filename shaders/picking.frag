@@ -0,0 +1,19 @@
+#version 450
+
+// ============================================================================
+// PICKING FRAGMENT SHADER
+// ============================================================================
+//
+// 功能：
+// - 把物体的pickID写入R32_UINT附件（0 = 没有物体）
+
+layout(push_constant) uniform PushConstants {
+    mat4 mvp;
+    uint pickID;
+} push;
+
+layout(location = 0) out uint outPickID;
+
+void main() {
+    outPickID = push.pickID;
+}
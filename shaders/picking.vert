@@ -0,0 +1,20 @@
+#version 450
+
+// ============================================================================
+// PICKING VERTEX SHADER
+// ============================================================================
+//
+// 功能：
+// - 只用位置，应用MVP变换
+// - pickID在fragment shader里从push constants读取
+
+layout(location = 0) in vec3 inPosition;
+
+layout(push_constant) uniform PushConstants {
+    mat4 mvp;
+    uint pickID;
+} push;
+
+void main() {
+    gl_Position = push.mvp * vec4(inPosition, 1.0);
+}
@@ -0,0 +1,37 @@
+#version 450
+
+// ============================================================================
+// SIMPLE VERTEX SHADER (INSTANCED)
+// ============================================================================
+//
+// 功能：
+// - 和simple.vert相同，但model矩阵来自实例缓冲（binding 1）
+// - push constant里是ViewProjection，而不是MVP
+// - 片段着色器用simple.frag
+
+// 输入（来自Vertex结构体，binding 0）
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec2 inTexCoord;
+
+// 输入（来自InstanceData，binding 1，每实例）
+layout(location = 4) in mat4 inModel;
+
+// Push Constants（ViewProjection矩阵）
+layout(push_constant) uniform PushConstants {
+    mat4 viewProjection;
+} push;
+
+// 输出到片段着色器
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+
+void main() {
+    gl_Position = push.viewProjection * inModel * vec4(inPosition, 1.0);
+
+    fragColor = inColor;
+    fragNormal = mat3(inModel) * inNormal;
+    fragTexCoord = inTexCoord;
+}
@@ -0,0 +1,225 @@
+#include "Core/ShaderLibrary.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// 只读内存映射；析构时解除映射
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0) return;
+        m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) return;
+        void* view = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) return;
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd < 0) return;
+        struct stat info;
+        if (fstat(m_fd, &info) != 0 || info.st_size == 0) return;
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (view == MAP_FAILED) return;
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = static_cast<size_t>(info.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (m_data) UnmapViewOfFile(m_data);
+        if (m_mapping) CloseHandle(m_mapping);
+        if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+        if (m_data) munmap(const_cast<uint8_t*>(m_data), m_size);
+        if (m_fd >= 0) close(m_fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 打开失败或空文件时为nullptr
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_fd = -1;
+#endif
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace
+
+ShaderLibrary::~ShaderLibrary() {
+    cleanup();
+}
+
+void ShaderLibrary::initialize(VkDevice device) {
+    m_device = device;
+    m_stats = Stats{};
+}
+
+void ShaderLibrary::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& entry : m_modules) {
+        vkDestroyShaderModule(m_device, entry.second.module, nullptr);
+    }
+    m_modules.clear();
+    m_shaders.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+const ShaderLibrary::Shader& ShaderLibrary::get(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_shaders.find(path);
+        if (it != m_shaders.end()) {
+            m_stats.hits++;
+            return it->second;
+        }
+    }
+    return load(path);
+}
+
+uint64_t ShaderLibrary::getContentHash(const std::string& path) {
+    try {
+        return get(path).contentHash;
+    } catch (const std::exception&) {
+        return 0;
+    }
+}
+
+ShaderLibrary::Stats ShaderLibrary::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+const ShaderLibrary::Shader& ShaderLibrary::load(const std::string& path) {
+    // 读文件、检查、反射都不持锁：其他线程取已加载的着色器不用等
+    MappedFile file(path);
+    if (!file.data()) {
+        throw std::runtime_error("Failed to open shader file: " + path);
+    }
+
+    // SPIR-V是32位字的数组，开头是魔数和4个字的文件头
+    uint32_t magic;
+    if (file.size() < SPIRV_HEADER_SIZE || file.size() % sizeof(uint32_t) != 0) {
+        throw std::runtime_error("Invalid SPIR-V size: " + path);
+    }
+    std::memcpy(&magic, file.data(), sizeof(magic));
+    if (magic != SPIRV_MAGIC) {
+        throw std::runtime_error("Invalid SPIR-V magic number: " + path);
+    }
+
+    const uint32_t* code = reinterpret_cast<const uint32_t*>(file.data());   // 映射按页对齐
+    size_t wordCount = file.size() / sizeof(uint32_t);
+
+    Shader shader;
+    shader.codeSize = file.size();
+    shader.reflection = ShaderReflection::reflect(code, wordCount);
+    shader.contentHash = computeHash(file.data(), file.size());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (const Shader* loaded = findLoaded(path)) return *loaded;
+
+        shader.module = findModule(shader.contentHash, code, wordCount);
+        if (shader.module != VK_NULL_HANDLE) {
+            return insertShader(path, shader);
+        }
+    }
+
+    // 驱动创建module也不持锁
+    VkShaderModuleCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = file.size();
+    createInfo.pCode = code;
+
+    VkShaderModule module = VK_NULL_HANDLE;
+    if (vkCreateShaderModule(m_device, &createInfo, nullptr, &module) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module: " + path);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // 解锁期间别的线程可能已经加载了同一个文件或相同的内容：用它的，销毁自己的
+    const Shader* loaded = findLoaded(path);
+    VkShaderModule existing = loaded ? loaded->module : findModule(shader.contentHash, code, wordCount);
+    if (existing != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(m_device, module, nullptr);
+        if (loaded) return *loaded;
+        shader.module = existing;
+        return insertShader(path, shader);
+    }
+
+    // 只有新的module复制一份：映射随file解除，之后比较用副本
+    m_modules.emplace(shader.contentHash, Module{ module, std::vector<uint32_t>(code, code + wordCount) });
+    m_stats.modules++;
+    shader.module = module;
+    return insertShader(path, shader);
+}
+
+const ShaderLibrary::Shader* ShaderLibrary::findLoaded(const std::string& path) {
+    auto it = m_shaders.find(path);
+    if (it == m_shaders.end()) return nullptr;
+    m_stats.hits++;
+    return &it->second;
+}
+
+VkShaderModule ShaderLibrary::findModule(uint64_t contentHash, const uint32_t* code, size_t wordCount) const {
+    // 哈希相同还要逐字节比较：不同的着色器哈希碰撞时不能共用module
+    auto range = m_modules.equal_range(contentHash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const std::vector<uint32_t>& other = it->second.code;
+        if (other.size() == wordCount && std::memcmp(other.data(), code, wordCount * sizeof(uint32_t)) == 0) {
+            return it->second.module;
+        }
+    }
+    return VK_NULL_HANDLE;
+}
+
+const ShaderLibrary::Shader& ShaderLibrary::insertShader(const std::string& path, const Shader& shader) {
+    m_stats.files++;
+    m_stats.bytes += shader.codeSize;
+    return m_shaders.emplace(path, shader).first->second;
+}
+
+uint64_t ShaderLibrary::computeHash(const uint8_t* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
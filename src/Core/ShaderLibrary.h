@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Core/SpirvReflection.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief SPIR-V着色器库 - 每个文件只加载、检查、创建一次VkShaderModule
+ *
+ * 没有它时每次build()都要读一遍.spv文件、再让驱动创建一次shader module，
+ * 同一个着色器被几十个管线使用时，这些工作重复几十次。
+ *
+ * - 文件用内存映射读取：检查、哈希、反射和vkCreateShaderModule都直接用映射
+ *   （按页对齐，可以直接当uint32_t数组用），不经过读缓冲
+ * - 第一次加载时检查SPIR-V魔数和大小（4的倍数、至少有文件头），不合法时抛异常
+ * - 内容相同的文件共用同一个VkShaderModule（哈希相同时再逐字节比较，碰撞不会共用）。
+ *   比较用的SPIR-V每个module在堆上留一份副本（映射在加载后就解除，
+ *   运行中重新编译着色器不会改到它）；和已有module内容相同的文件不复制
+ * - 加载时做一次反射（ShaderReflection）：pipeline layout和顶点输入可以从着色器推导
+ * - getContentHash()：内容的哈希，VulkanPipelineBuilder用它作为管线的键
+ *   （不同路径下相同的着色器键相同）
+ *
+ * module属于着色器库，使用它的管线创建完成后就不再需要：
+ * 所有管线编译完成之后才能cleanup()。线程安全（后台编译的管线在工作线程上取module）：
+ * 读文件和vkCreateShaderModule都在锁外，锁只保护查找和插入。两个线程同时加载同一个
+ * 文件时都会读一遍，后插入的销毁自己的module、用先插入的。
+ *
+ * 使用方法：
+ *   ShaderLibrary shaders;
+ *   shaders.initialize(device);
+ *   builder.setShaders("shaders/compiled/simple.vert.spv", "shaders/compiled/simple.frag.spv")
+ *          .setShaderLibrary(&shaders);
+ */
+class ShaderLibrary {
+public:
+    struct Shader {
+        VkShaderModule module = VK_NULL_HANDLE;
+        uint64_t contentHash = 0;
+        size_t codeSize = 0;        // 字节
+        ShaderReflection reflection;
+    };
+
+    struct Stats {
+        uint32_t files = 0;         // 加载过的文件
+        uint32_t modules = 0;       // 创建的VkShaderModule（内容相同的文件共用）
+        uint32_t hits = 0;          // 直接返回已加载的着色器
+        size_t bytes = 0;           // 映射读取的字节数
+    };
+
+    ShaderLibrary() = default;
+    ~ShaderLibrary();
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    void initialize(VkDevice device);
+
+    // 销毁所有shader module
+    void cleanup();
+
+    // 第一次调用时加载；文件不存在或不是SPIR-V时抛异常
+    const Shader& get(const std::string& path);
+    VkShaderModule getModule(const std::string& path) { return get(path).module; }
+
+    // 加载失败时返回0（不抛异常：只用来算键，真正的错误在build()时报告）
+    uint64_t getContentHash(const std::string& path);
+
+    Stats getStats() const;
+
+private:
+    static constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    static constexpr size_t SPIRV_HEADER_SIZE = 5 * sizeof(uint32_t);
+
+    // 一个VkShaderModule和创建它的SPIR-V的副本（哈希相同时逐字节比较用）
+    struct Module {
+        VkShaderModule module = VK_NULL_HANDLE;
+        std::vector<uint32_t> code;
+    };
+
+    static uint64_t computeHash(const uint8_t* data, size_t size);
+
+    // 调用时不持有m_mutex
+    const Shader& load(const std::string& path);
+
+    // 以下调用时已持有m_mutex
+    const Shader* findLoaded(const std::string& path);
+    VkShaderModule findModule(uint64_t contentHash, const uint32_t* code, size_t wordCount) const;
+    const Shader& insertShader(const std::string& path, const Shader& shader);
+
+    VkDevice m_device = VK_NULL_HANDLE;
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::string, Shader> m_shaders;            // 路径 -> 着色器（节点稳定，可以返回引用）
+    std::unordered_multimap<uint64_t, Module> m_modules;          // 内容哈希 -> module
+    Stats m_stats;
+};
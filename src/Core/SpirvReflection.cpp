@@ -0,0 +1,412 @@
+#include "Core/SpirvReflection.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+constexpr size_t SPIRV_HEADER_WORDS = 5;
+
+// 只列出用到的指令/枚举（SPIR-V规范的数值）
+enum Op : uint32_t {
+    OpEntryPoint = 15,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpFunction = 54,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72
+};
+
+enum Decoration : uint32_t {
+    DecorationBlock = 2,
+    DecorationBufferBlock = 3,
+    DecorationArrayStride = 6,
+    DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11,
+    DecorationLocation = 30,
+    DecorationBinding = 33,
+    DecorationDescriptorSet = 34,
+    DecorationOffset = 35
+};
+
+enum StorageClass : uint32_t {
+    StorageUniformConstant = 0,
+    StorageInput = 1,
+    StorageUniform = 2,
+    StoragePushConstant = 9,
+    StorageStorageBuffer = 12
+};
+
+enum ImageDim : uint32_t {
+    DimBuffer = 5,
+    DimSubpassData = 6
+};
+
+struct Member {
+    uint32_t offset = 0;
+    uint32_t matrixStride = 0;
+    bool builtIn = false;
+};
+
+// 一个id的定义和装饰
+struct Id {
+    uint32_t opcode = 0;
+    uint32_t type = 0;                  // OpConstant/OpVariable的结果类型
+    std::vector<uint32_t> operands;     // result id之后的字
+
+    uint32_t location = UINT32_MAX;
+    uint32_t binding = UINT32_MAX;
+    uint32_t set = 0;
+    uint32_t arrayStride = 0;
+    bool block = false;
+    bool bufferBlock = false;
+    bool builtIn = false;
+    std::vector<Member> members;
+};
+
+class Parser {
+public:
+    Parser(const uint32_t* code, size_t wordCount) : m_code(code), m_wordCount(wordCount) {}
+
+    ShaderReflection parse();
+
+private:
+    [[noreturn]] static void fail(const std::string& message) {
+        throw std::runtime_error("Invalid SPIR-V: " + message);
+    }
+
+    Id& id(uint32_t index) {
+        if (index >= m_ids.size()) fail("id out of bounds");
+        return m_ids[index];
+    }
+
+    uint32_t operand(const Id& definition, size_t index) const {
+        if (index >= definition.operands.size()) fail("missing operand");
+        return definition.operands[index];
+    }
+
+    Member& member(uint32_t structId, uint32_t index) {
+        std::vector<Member>& members = id(structId).members;
+        if (index >= members.size()) members.resize(index + 1);
+        return members[index];
+    }
+
+    void parseInstructions();
+    uint32_t getConstant(uint32_t constantId);
+    uint32_t getSize(uint32_t typeId, uint32_t matrixStride);
+    bool hasBuiltInMember(uint32_t typeId);
+
+    void addDescriptor(const Id& variable, uint32_t storageClass, uint32_t typeId);
+    void addPushConstants(uint32_t typeId);
+    void addVertexInput(const Id& variable, uint32_t typeId);
+
+    const uint32_t* m_code;
+    size_t m_wordCount;
+
+    std::vector<Id> m_ids;
+    uint32_t m_executionModel = UINT32_MAX;
+    std::vector<uint32_t> m_interface;
+
+    ShaderReflection m_result;
+};
+
+ShaderReflection Parser::parse() {
+    if (!m_code || m_wordCount < SPIRV_HEADER_WORDS || m_code[0] != SPIRV_MAGIC) {
+        fail("bad header");
+    }
+    m_ids.resize(m_code[3]);   // id上界
+    parseInstructions();
+
+    switch (m_executionModel) {
+        case 0: m_result.stage = VK_SHADER_STAGE_VERTEX_BIT; break;
+        case 1: m_result.stage = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT; break;
+        case 2: m_result.stage = VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT; break;
+        case 3: m_result.stage = VK_SHADER_STAGE_GEOMETRY_BIT; break;
+        case 4: m_result.stage = VK_SHADER_STAGE_FRAGMENT_BIT; break;
+        case 5: m_result.stage = VK_SHADER_STAGE_COMPUTE_BIT; break;
+        default: fail("no supported entry point");
+    }
+
+    for (uint32_t index = 0; index < m_ids.size(); index++) {
+        const Id& variable = m_ids[index];
+        if (variable.opcode != OpVariable) continue;
+
+        const Id& pointer = id(variable.type);
+        if (pointer.opcode != OpTypePointer) fail("variable without pointer type");
+        uint32_t storageClass = operand(variable, 0);
+        uint32_t typeId = operand(pointer, 1);
+
+        switch (storageClass) {
+            case StorageUniformConstant:
+            case StorageUniform:
+            case StorageStorageBuffer:
+                if (variable.binding != UINT32_MAX) addDescriptor(variable, storageClass, typeId);
+                break;
+            case StoragePushConstant:
+                addPushConstants(typeId);
+                break;
+            case StorageInput:
+                // 同一个模块里可能有多个入口点：只要第一个的接口变量
+                if (m_result.stage == VK_SHADER_STAGE_VERTEX_BIT &&
+                    std::find(m_interface.begin(), m_interface.end(), index) != m_interface.end()) {
+                    addVertexInput(variable, typeId);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    std::sort(m_result.bindings.begin(), m_result.bindings.end(),
+        [](const ShaderReflection::DescriptorBinding& a, const ShaderReflection::DescriptorBinding& b) {
+            return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+        });
+    std::sort(m_result.vertexInputs.begin(), m_result.vertexInputs.end(),
+        [](const ShaderReflection::VertexInput& a, const ShaderReflection::VertexInput& b) {
+            return a.location < b.location;
+        });
+    return m_result;
+}
+
+void Parser::parseInstructions() {
+    size_t offset = SPIRV_HEADER_WORDS;
+    while (offset < m_wordCount) {
+        uint32_t opcode = m_code[offset] & 0xFFFF;
+        uint32_t length = m_code[offset] >> 16;
+        if (length == 0 || offset + length > m_wordCount) fail("truncated instruction");
+        const uint32_t* words = m_code + offset;
+        offset += length;
+
+        // 函数体里没有需要的信息（类型、变量和装饰都在第一个函数之前）
+        if (opcode == OpFunction) break;
+
+        switch (opcode) {
+            case OpEntryPoint: {
+                if (m_executionModel != UINT32_MAX || length < 4) break;
+                m_executionModel = words[1];
+                // 名字是以0结尾的字符串，按字对齐；之后是接口变量
+                size_t word = 3;
+                while (word < length && (words[word] >> 24) != 0) word++;
+                for (word++; word < length; word++) m_interface.push_back(words[word]);
+                break;
+            }
+            case OpTypeInt: case OpTypeFloat: case OpTypeVector: case OpTypeMatrix:
+            case OpTypeImage: case OpTypeSampler: case OpTypeSampledImage: case OpTypeArray:
+            case OpTypeRuntimeArray: case OpTypeStruct: case OpTypePointer: {
+                if (length < 2) fail("truncated type");
+                Id& definition = id(words[1]);
+                definition.opcode = opcode;
+                definition.operands.assign(words + 2, words + length);
+                break;
+            }
+            case OpConstant: case OpVariable: {
+                if (length < 4) fail("truncated instruction");
+                Id& definition = id(words[2]);
+                definition.opcode = opcode;
+                definition.type = words[1];
+                definition.operands.assign(words + 3, words + length);
+                break;
+            }
+            case OpDecorate: {
+                if (length < 3) fail("truncated decoration");
+                Id& target = id(words[1]);
+                uint32_t value = length > 3 ? words[3] : 0;
+                switch (words[2]) {
+                    case DecorationBlock: target.block = true; break;
+                    case DecorationBufferBlock: target.bufferBlock = true; break;
+                    case DecorationArrayStride: target.arrayStride = value; break;
+                    case DecorationBuiltIn: target.builtIn = true; break;
+                    case DecorationLocation: target.location = value; break;
+                    case DecorationBinding: target.binding = value; break;
+                    case DecorationDescriptorSet: target.set = value; break;
+                    default: break;
+                }
+                break;
+            }
+            case OpMemberDecorate: {
+                if (length < 4) fail("truncated decoration");
+                Member& target = member(words[1], words[2]);
+                uint32_t value = length > 4 ? words[4] : 0;
+                switch (words[3]) {
+                    case DecorationOffset: target.offset = value; break;
+                    case DecorationMatrixStride: target.matrixStride = value; break;
+                    case DecorationBuiltIn: target.builtIn = true; break;
+                    default: break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+uint32_t Parser::getConstant(uint32_t constantId) {
+    const Id& constant = id(constantId);
+    if (constant.opcode != OpConstant) fail("array length is not a constant");   // 特化常量不支持
+    return operand(constant, 0);
+}
+
+uint32_t Parser::getSize(uint32_t typeId, uint32_t matrixStride) {
+    const Id& type = id(typeId);
+    switch (type.opcode) {
+        case OpTypeInt:
+        case OpTypeFloat:
+            return operand(type, 0) / 8;
+        case OpTypeVector:
+            return operand(type, 1) * getSize(operand(type, 0), 0);
+        case OpTypeMatrix: {
+            uint32_t columnSize = matrixStride ? matrixStride : getSize(operand(type, 0), 0);
+            return operand(type, 1) * columnSize;
+        }
+        case OpTypeArray: {
+            uint32_t stride = type.arrayStride ? type.arrayStride : getSize(operand(type, 0), matrixStride);
+            return getConstant(operand(type, 1)) * stride;
+        }
+        case OpTypeStruct: {
+            uint32_t size = 0;
+            for (uint32_t i = 0; i < type.operands.size(); i++) {
+                Member layout = i < type.members.size() ? type.members[i] : Member{};
+                size = std::max(size, layout.offset + getSize(type.operands[i], layout.matrixStride));
+            }
+            return size;
+        }
+        default:
+            fail("unsupported type in block");
+    }
+}
+
+bool Parser::hasBuiltInMember(uint32_t typeId) {
+    for (const Member& layout : id(typeId).members) {
+        if (layout.builtIn) return true;
+    }
+    return false;
+}
+
+void Parser::addDescriptor(const Id& variable, uint32_t storageClass, uint32_t typeId) {
+    ShaderReflection::DescriptorBinding descriptor;
+    descriptor.set = variable.set;
+    descriptor.binding = variable.binding;
+    descriptor.stages = m_result.stage;
+
+    // 数组：descriptorCount是元素数
+    const Id* type = &id(typeId);
+    while (type->opcode == OpTypeArray || type->opcode == OpTypeRuntimeArray) {
+        descriptor.count = type->opcode == OpTypeArray ? descriptor.count * getConstant(operand(*type, 1)) : 0;
+        type = &id(operand(*type, 0));
+    }
+
+    switch (type->opcode) {
+        case OpTypeStruct:
+            if (storageClass == StorageStorageBuffer || type->bufferBlock) {
+                descriptor.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            } else {
+                descriptor.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            }
+            break;
+        case OpTypeSampler:
+            descriptor.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+            break;
+        case OpTypeSampledImage: {
+            const Id& image = id(operand(*type, 0));
+            descriptor.type = operand(image, 1) == DimBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+                                                             : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            break;
+        }
+        case OpTypeImage: {
+            // 操作数：sampled type, dim, depth, arrayed, MS, sampled（2 = storage）, format
+            uint32_t dim = operand(*type, 1);
+            bool storage = operand(*type, 5) == 2;
+            if (dim == DimSubpassData) {
+                descriptor.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            } else if (dim == DimBuffer) {
+                descriptor.type = storage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            } else {
+                descriptor.type = storage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            }
+            break;
+        }
+        default:
+            return;   // 加速结构等：不反射
+    }
+    m_result.bindings.push_back(descriptor);
+}
+
+void Parser::addPushConstants(uint32_t typeId) {
+    const Id& type = id(typeId);
+    if (type.opcode != OpTypeStruct) fail("push constant is not a block");
+
+    uint32_t begin = UINT32_MAX;
+    for (uint32_t i = 0; i < type.operands.size(); i++) {
+        begin = std::min(begin, i < type.members.size() ? type.members[i].offset : 0u);
+    }
+    uint32_t end = getSize(typeId, 0);
+
+    m_result.pushConstants.stageFlags = m_result.stage;
+    m_result.pushConstants.offset = begin == UINT32_MAX ? 0 : begin;
+    m_result.pushConstants.size = end - m_result.pushConstants.offset;
+}
+
+void Parser::addVertexInput(const Id& variable, uint32_t typeId) {
+    // gl_VertexIndex等内置输入不来自顶点缓冲
+    if (variable.builtIn || hasBuiltInMember(typeId)) return;
+    if (variable.location == UINT32_MAX) fail("vertex input without location");
+
+    const Id* type = &id(typeId);
+    uint32_t columns = 1;
+    if (type->opcode == OpTypeMatrix) {
+        // 矩阵每列占一个location
+        columns = operand(*type, 1);
+        type = &id(operand(*type, 0));
+    }
+
+    uint32_t components = 1;
+    if (type->opcode == OpTypeVector) {
+        components = operand(*type, 1);
+        type = &id(operand(*type, 0));
+    }
+
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    if ((type->opcode == OpTypeFloat || type->opcode == OpTypeInt) && operand(*type, 0) == 32 && components <= 4) {
+        static const VkFormat floatFormats[] = { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT,
+                                                 VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT };
+        static const VkFormat intFormats[] = { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT,
+                                               VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT };
+        static const VkFormat uintFormats[] = { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT,
+                                                VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT };
+        if (type->opcode == OpTypeFloat) {
+            format = floatFormats[components - 1];
+        } else {
+            format = operand(*type, 1) ? intFormats[components - 1] : uintFormats[components - 1];
+        }
+    }
+
+    for (uint32_t column = 0; column < columns; column++) {
+        m_result.vertexInputs.push_back({ variable.location + column, format });
+    }
+}
+
+} // namespace
+
+ShaderReflection ShaderReflection::reflect(const uint32_t* code, size_t wordCount) {
+    return Parser(code, wordCount).parse();
+}
+
+bool ShaderReflection::hasVertexInput(uint32_t location) const {
+    for (const VertexInput& input : vertexInputs) {
+        if (input.location == location) return true;
+    }
+    return false;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief SPIR-V反射 - 从编译好的着色器里读出它使用的资源
+ *
+ * 手写的pipeline layout和顶点属性必须和着色器一致（push constant大小、
+ * descriptor的set/binding、顶点输入的location），改了着色器忘了改C++就是验证层错误或者花屏。
+ * 这里直接解析SPIR-V指令（不依赖SPIRV-Cross），只取构建管线需要的信息：
+ * - descriptor binding：set、binding、类型、数量
+ * - push constant块的范围
+ * - 顶点着色器的输入：location和格式（mat4展开成4个连续location）
+ *
+ * 只看第一个入口点。不支持的类型（64位顶点输入等）格式为VK_FORMAT_UNDEFINED。
+ * 不合法的SPIR-V抛std::runtime_error。
+ */
+struct ShaderReflection {
+    struct DescriptorBinding {
+        uint32_t set = 0;
+        uint32_t binding = 0;
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uint32_t count = 1;              // 0 = 运行时大小的数组
+        VkShaderStageFlags stages = 0;
+    };
+
+    struct VertexInput {
+        uint32_t location = 0;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+    };
+
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_VERTEX_BIT;
+    std::vector<DescriptorBinding> bindings;     // 按(set, binding)排序
+    VkPushConstantRange pushConstants{};         // size = 0：没有push constant
+    std::vector<VertexInput> vertexInputs;       // 按location排序；只有顶点着色器有
+
+    static ShaderReflection reflect(const uint32_t* code, size_t wordCount);
+
+    // 着色器声明了这个location的输入
+    bool hasVertexInput(uint32_t location) const;
+};
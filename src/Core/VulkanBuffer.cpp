@@ -1,10 +1,31 @@
 #include "Core/VulkanBuffer.h"
 #include <stdexcept>
+#include <utility>
 
 VulkanBuffer::~VulkanBuffer() {
     cleanup();
 }
 
+VulkanBuffer::VulkanBuffer(VulkanBuffer&& other) noexcept
+    : m_buffer(std::exchange(other.m_buffer, VK_NULL_HANDLE))
+    , m_allocation(std::exchange(other.m_allocation, VK_NULL_HANDLE))
+    , m_allocator(std::exchange(other.m_allocator, VK_NULL_HANDLE))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_mapped(std::exchange(other.m_mapped, false)) {
+}
+
+VulkanBuffer& VulkanBuffer::operator=(VulkanBuffer&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+        m_buffer = std::exchange(other.m_buffer, VK_NULL_HANDLE);
+        m_allocation = std::exchange(other.m_allocation, VK_NULL_HANDLE);
+        m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+    }
+    return *this;
+}
+
 void VulkanBuffer::cleanup() {
     if (m_buffer != VK_NULL_HANDLE && m_allocator != VK_NULL_HANDLE) {
         vmaDestroyBuffer(m_allocator, m_buffer, m_allocation);
@@ -77,6 +98,14 @@ void VulkanBuffer::unmap() {
     m_mapped = false;
 }
 
+void VulkanBuffer::flush(VkDeviceSize offset, VkDeviceSize size) {
+    vmaFlushAllocation(m_allocator, m_allocation, offset, size);
+}
+
+void VulkanBuffer::invalidate(VkDeviceSize offset, VkDeviceSize size) {
+    vmaInvalidateAllocation(m_allocator, m_allocation, offset, size);
+}
+
 // ============================================================================
 // [TODO 3] COPY FROM BUFFER
 // ============================================================================
@@ -109,6 +138,46 @@ void VulkanBuffer::copyFrom(
     );
 }
 
+void VulkanBuffer::copyRegionsFrom(
+    VkDevice device,
+    VkQueue queue,
+    VkCommandPool commandPool,
+    const VulkanBuffer& srcBuffer,
+    const VkBufferCopy* regions,
+    uint32_t regionCount
+) {
+    if (regionCount == 0) return;
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer;
+    if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate copy command buffer!");
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    vkCmdCopyBuffer(commandBuffer, srcBuffer.getHandle(), m_buffer, regionCount, regions);
+    vkEndCommandBuffer(commandBuffer);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+
+    vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(queue);
+
+    vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+}
+
 // ============================================================================
 // Helper Function
 // ============================================================================
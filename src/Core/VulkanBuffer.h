@@ -48,6 +48,12 @@ public:
     VulkanBuffer() = default;
     ~VulkanBuffer();
 
+    // 拥有VkBuffer和它的内存，只能移动（被移动的对象变成空缓冲）
+    VulkanBuffer(const VulkanBuffer&) = delete;
+    VulkanBuffer& operator=(const VulkanBuffer&) = delete;
+    VulkanBuffer(VulkanBuffer&& other) noexcept;
+    VulkanBuffer& operator=(VulkanBuffer&& other) noexcept;
+
     // ========================================================================
     // [TODO 1] 创建缓冲区
     // ========================================================================
@@ -115,6 +121,11 @@ public:
     void* map();
     void unmap();
 
+    // CPU写入后、GPU读取前调用（CPU_TO_GPU的内存可能不是HOST_COHERENT）
+    void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+    // GPU写入后、CPU读取前调用（GPU_TO_CPU的内存可能不是HOST_COHERENT）
+    void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
     // ========================================================================
     // [TODO 3] 从另一个缓冲复制数据
     // ========================================================================
@@ -147,6 +158,17 @@ public:
         VkDeviceSize size
     );
 
+    // 同上，但复制任意多个区域（各自的srcOffset/dstOffset），一次提交
+    // 同样是同步操作：返回时复制已经完成
+    void copyRegionsFrom(
+        VkDevice device,
+        VkQueue queue,
+        VkCommandPool commandPool,
+        const VulkanBuffer& srcBuffer,
+        const VkBufferCopy* regions,
+        uint32_t regionCount
+    );
+
     // Getters
     VkBuffer getHandle() const { return m_buffer; }
     VkDeviceSize getSize() const { return m_size; }
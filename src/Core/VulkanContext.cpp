@@ -1,4 +1,5 @@
 #include "Core/VulkanContext.h"
+#include "Core/VulkanPipelineCache.h"
 #include "Core/VulkanSwapchain.h"
 #include "Framework/Window.h"
 #include <stdexcept>
@@ -10,7 +11,7 @@ VulkanContext::~VulkanContext() {
     cleanup();
 }
 
-void VulkanContext::initialize(Window* window, bool enableValidation) {
+void VulkanContext::initialize(Window* window, bool enableValidation, const std::string& pipelineCachePath) {
     m_window = window;
     m_enableValidation = enableValidation;
 
@@ -21,8 +22,19 @@ void VulkanContext::initialize(Window* window, bool enableValidation) {
     setupDebugMessenger();
     createSurface(m_window);
     pickPhysicalDevice();
+    // Uploads go to a dedicated transfer queue when the device has one (see TODO 5)
+    m_queueFamilies.transferFamily = findDedicatedTransferFamily(m_physicalDevice);
     createLogicalDevice();
 
+    // Pipeline cache (before any pipeline is created)
+    m_pipelineCache = std::make_unique<VulkanPipelineCache>();
+    m_pipelineCache->initialize(m_device, m_physicalDevice, pipelineCachePath);
+    if (m_pipelineCache->getStats().loaded) {
+        std::cout << "Pipeline cache loaded: " << m_pipelineCache->getStats().loadedBytes << " bytes" << std::endl;
+    } else {
+        std::cout << "Pipeline cache empty (" << m_pipelineCache->getStats().rejectReason << ")" << std::endl;
+    }
+
     // Create swapchain
     m_swapchain = std::make_unique<VulkanSwapchain>();
     m_swapchain->initialize(m_physicalDevice, m_device, m_surface, m_window);
@@ -30,6 +42,14 @@ void VulkanContext::initialize(Window* window, bool enableValidation) {
     std::cout << "Vulkan Context initialized successfully!" << std::endl;
 }
 
+VkPipelineCache VulkanContext::getPipelineCache() const {
+    return m_pipelineCache ? m_pipelineCache->getHandle() : VK_NULL_HANDLE;
+}
+
+bool VulkanContext::isGPUDrivenSupported() const {
+    return m_physicalDevice != VK_NULL_HANDLE && supportsGPUDrivenDrawing(m_physicalDevice);
+}
+
 void VulkanContext::cleanup() {
     // Cleanup swapchain first
     if (m_swapchain) {
@@ -37,6 +57,12 @@ void VulkanContext::cleanup() {
         m_swapchain.reset();
     }
 
+    // Write the pipeline cache back to disk while the device still exists
+    if (m_pipelineCache) {
+        m_pipelineCache->cleanup();
+        m_pipelineCache.reset();
+    }
+
     if (m_device != VK_NULL_HANDLE) {
         vkDestroyDevice(m_device, nullptr);
         m_device = VK_NULL_HANDLE;
@@ -216,6 +242,39 @@ VulkanContext::QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDev
     return {};  // Placeholder
 }
 
+std::optional<uint32_t> VulkanContext::findDedicatedTransferFamily(VkPhysicalDevice device) {
+    uint32_t count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
+    std::vector<VkQueueFamilyProperties> families(count);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &count, families.data());
+
+    for (uint32_t i = 0; i < count; ++i) {
+        VkQueueFlags flags = families[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) &&
+            !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) &&
+            families[i].queueCount > 0) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+bool VulkanContext::supportsGPUDrivenDrawing(VkPhysicalDevice device) {
+    // vkGetPhysicalDeviceFeatures2 and VkPhysicalDeviceVulkan12Features need a 1.2 device
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(device, &properties);
+    if (properties.apiVersion < VK_API_VERSION_1_2) return false;
+
+    VkPhysicalDeviceVulkan12Features features12{};
+    features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &features12;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+
+    return features12.drawIndirectCount == VK_TRUE && features.features.drawIndirectFirstInstance == VK_TRUE;
+}
+
 bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
     // TODO: Implement device suitability check
     // This is needed for pickPhysicalDevice
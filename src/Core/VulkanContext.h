@@ -4,10 +4,12 @@
 #include <vector>
 #include <optional>
 #include <memory>
+#include <string>
 
 // Forward declarations
 class Window;
 class VulkanSwapchain;
+class VulkanPipelineCache;
 
 /**
  * ============================================================================
@@ -39,7 +41,8 @@ public:
     ~VulkanContext();
 
     // Main initialization function
-    void initialize(Window* window, bool enableValidation = true);
+    // pipelineCachePath: where the VkPipelineCache is loaded from and saved to ("" = memory only)
+    void initialize(Window* window, bool enableValidation = true, const std::string& pipelineCachePath = "");
     void cleanup();
 
     // Getters
@@ -49,12 +52,27 @@ public:
     VkSurfaceKHR getSurface() const { return m_surface; }
     VkQueue getGraphicsQueue() const { return m_graphicsQueue; }
     VkQueue getPresentQueue() const { return m_presentQueue; }
+    // Dedicated transfer queue, or the graphics queue if the device has none (used by VulkanUploader)
+    VkQueue getTransferQueue() const { return m_transferQueue != VK_NULL_HANDLE ? m_transferQueue : m_graphicsQueue; }
+    // Queue family of getTransferQueue()
+    uint32_t getTransferQueueFamily() const {
+        return m_queueFamilies.transferFamily.value_or(m_queueFamilies.graphicsFamily.value_or(0));
+    }
     VulkanSwapchain* getSwapchain() const { return m_swapchain.get(); }
+    // Shared by every pipeline build (pass it to VulkanPipelineBuilder::setPipelineCache)
+    VkPipelineCache getPipelineCache() const;
+    // True if the selected device supports GPU driven rendering
+    // (createLogicalDevice enables the features in that case)
+    bool isGPUDrivenSupported() const;
 
     // Queue family indices
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        // Transfer-only family (no GRAPHICS/COMPUTE), usually a separate DMA engine.
+        // Optional: uploads use the graphics queue without it.
+        // Filled by initialize() (findDedicatedTransferFamily) before createLogicalDevice()
+        std::optional<uint32_t> transferFamily;
 
         bool isComplete() const {
             return graphicsFamily.has_value() && presentFamily.has_value();
@@ -76,6 +94,8 @@ private:
     //
     // HINT: Required extensions are returned by getRequiredExtensions()
     // HINT: Validation layers are in getValidationLayers()
+    // HINT: Set VkApplicationInfo::apiVersion = VK_API_VERSION_1_2
+    //       (timeline semaphores and drawIndirectCount are Vulkan 1.2)
     //
     // VALIDATION: After implementing, you should see Vulkan instance created
     //             with no errors in the console.
@@ -141,6 +161,17 @@ private:
     //
     // HINT: Queue families are in m_queueFamilies
     // HINT: Required extensions: VK_KHR_SWAPCHAIN_EXTENSION_NAME
+    // HINT: If m_queueFamilies.transferFamily has a value, create one queue
+    //       from it too and store it in m_transferQueue (used for uploads;
+    //       initialize() fills transferFamily in before calling this)
+    // HINT: VulkanUploader needs the Vulkan 1.2 timelineSemaphore feature
+    //       (VkPhysicalDeviceVulkan12Features::timelineSemaphore = VK_TRUE)
+    // HINT: GPU driven rendering (IndirectRenderer) needs drawIndirectCount
+    //       (VkPhysicalDeviceVulkan12Features) and drawIndirectFirstInstance
+    //       (VkPhysicalDeviceFeatures). Enable them only when
+    //       supportsGPUDrivenDrawing(m_physicalDevice) is true; chain the
+    //       Vulkan12 struct through VkPhysicalDeviceFeatures2 in pNext
+    //       (pEnabledFeatures must then be nullptr)
     //
     // VALIDATION: Device created, queues retrieved successfully
     // ========================================================================
@@ -153,6 +184,13 @@ private:
     // Find queue families that support graphics and present
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 
+    // Find a transfer-only queue family (no graphics/compute), if the device has one
+    static std::optional<uint32_t> findDedicatedTransferFamily(VkPhysicalDevice device);
+
+    // Check if device supports GPU driven rendering: Vulkan 1.2 with
+    // drawIndirectCount and drawIndirectFirstInstance
+    static bool supportsGPUDrivenDrawing(VkPhysicalDevice device);
+
     // Check if device has required features
     bool isDeviceSuitable(VkPhysicalDevice device);
 
@@ -189,6 +227,7 @@ private:
 
     VkQueue m_graphicsQueue = VK_NULL_HANDLE;
     VkQueue m_presentQueue = VK_NULL_HANDLE;
+    VkQueue m_transferQueue = VK_NULL_HANDLE;   // 没有专用传输队列族时为空
 
     QueueFamilyIndices m_queueFamilies;
 
@@ -196,4 +235,5 @@ private:
     bool m_enableValidation = true;
 
     std::unique_ptr<VulkanSwapchain> m_swapchain;
+    std::unique_ptr<VulkanPipelineCache> m_pipelineCache;
 };
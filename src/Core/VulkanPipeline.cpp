@@ -1,7 +1,149 @@
 #include "Core/VulkanPipeline.h"
+#include "Core/ShaderLibrary.h"
 #include "Rendering/Mesh.h"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
+namespace {
+
+// FNV-1a，逐个字段累加
+struct StateHasher {
+    uint64_t hash = 14695981039346656037ull;
+
+    void addBytes(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    }
+
+    template <typename T>
+    void add(const T& value) { addBytes(&value, sizeof(value)); }
+
+    void add(const std::string& value) {
+        add(value.size());
+        addBytes(value.data(), value.size());
+    }
+
+    // 顶点输入描述都是uint32_t/枚举字段，没有填充字节
+    template <typename T>
+    void add(const std::vector<T>& values) {
+        add(values.size());
+        addBytes(values.data(), values.size() * sizeof(T));
+    }
+};
+
+template <typename T>
+bool sameElements(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+// 各阶段的push constant合并成一个范围，stageFlags是用到它的阶段（size = 0：都没有）
+VkPushConstantRange mergePushConstants(const std::vector<const ShaderReflection*>& stages) {
+    VkPushConstantRange pushConstants{};
+    uint32_t pushConstantEnd = 0;
+    for (const ShaderReflection* stage : stages) {
+        if (stage->pushConstants.size == 0) continue;
+
+        uint32_t begin = stage->pushConstants.offset;
+        uint32_t end = begin + stage->pushConstants.size;
+        pushConstants.offset = pushConstants.stageFlags ? std::min(pushConstants.offset, begin) : begin;
+        pushConstantEnd = std::max(pushConstantEnd, end);
+        pushConstants.stageFlags |= stage->pushConstants.stageFlags;
+    }
+    pushConstants.size = pushConstantEnd - pushConstants.offset;
+    return pushConstants;
+}
+
+// 从各阶段的反射结果创建pipeline layout：相同(set, binding)合并，每个set一个
+// VkDescriptorSetLayout（中间没用到的set是空layout），写到setLayouts。
+// set0Layout不为空时set 0直接用它（不创建）
+VkPipelineLayout createLayoutFromReflection(VkDevice device, const std::vector<const ShaderReflection*>& stages,
+                                            VkDescriptorSetLayout set0Layout,
+                                            std::vector<VkDescriptorSetLayout>& setLayouts) {
+    // 相同(set, binding)的类型必须一致
+    std::vector<ShaderReflection::DescriptorBinding> bindings;
+    for (const ShaderReflection* stage : stages) {
+        for (const ShaderReflection::DescriptorBinding& binding : stage->bindings) {
+            auto it = std::find_if(bindings.begin(), bindings.end(), [&](const ShaderReflection::DescriptorBinding& other) {
+                return other.set == binding.set && other.binding == binding.binding;
+            });
+            if (it == bindings.end()) {
+                bindings.push_back(binding);
+            } else if (it->type != binding.type || it->count != binding.count) {
+                throw std::runtime_error("Descriptor set " + std::to_string(binding.set) + " binding " +
+                                         std::to_string(binding.binding) + " differs between shader stages!");
+            } else {
+                it->stages |= binding.stages;
+            }
+        }
+    }
+    VkPushConstantRange pushConstants = mergePushConstants(stages);
+
+    uint32_t setCount = set0Layout != VK_NULL_HANDLE ? 1 : 0;
+    for (const ShaderReflection::DescriptorBinding& binding : bindings) {
+        setCount = std::max(setCount, binding.set + 1);
+    }
+
+    setLayouts.assign(setCount, VK_NULL_HANDLE);
+    for (uint32_t set = 0; set < setCount; set++) {
+        if (set == 0 && set0Layout != VK_NULL_HANDLE) {
+            setLayouts[set] = set0Layout;
+            continue;
+        }
+
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+        for (const ShaderReflection::DescriptorBinding& binding : bindings) {
+            if (binding.set != set) continue;
+            if (binding.count == 0) {
+                throw std::runtime_error("Runtime-sized descriptor arrays need an explicit descriptor set layout!");
+            }
+            VkDescriptorSetLayoutBinding layoutBinding{};
+            layoutBinding.binding = binding.binding;
+            layoutBinding.descriptorType = binding.type;
+            layoutBinding.descriptorCount = binding.count;
+            layoutBinding.stageFlags = binding.stages;
+            layoutBindings.push_back(layoutBinding);
+        }
+
+        VkDescriptorSetLayoutCreateInfo setLayoutInfo{};
+        setLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setLayoutInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+        setLayoutInfo.pBindings = layoutBindings.empty() ? nullptr : layoutBindings.data();
+
+        if (vkCreateDescriptorSetLayout(device, &setLayoutInfo, nullptr, &setLayouts[set]) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create descriptor set layout!");
+        }
+    }
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = setCount;
+    layoutInfo.pSetLayouts = setLayouts.empty() ? nullptr : setLayouts.data();
+    layoutInfo.pushConstantRangeCount = pushConstants.size > 0 ? 1 : 0;
+    layoutInfo.pPushConstantRanges = pushConstants.size > 0 ? &pushConstants : nullptr;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+    return layout;
+}
+
+// 销毁createLayoutFromReflection()创建的set layout（不包括调用者传入的set0Layout）
+void destroySetLayouts(VkDevice device, std::vector<VkDescriptorSetLayout>& setLayouts, VkDescriptorSetLayout set0Layout) {
+    for (VkDescriptorSetLayout setLayout : setLayouts) {
+        if (setLayout != VK_NULL_HANDLE && setLayout != set0Layout) {
+            vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+        }
+    }
+    setLayouts.clear();
+}
+
+} // namespace
+
 VulkanPipelineBuilder::VulkanPipelineBuilder(VkDevice device)
     : m_device(device) {
 }
@@ -79,17 +221,164 @@ VulkanPipelineBuilder& VulkanPipelineBuilder::setDescriptorSetLayout(VkDescripto
     return *this;
 }
 
+VulkanPipelineBuilder& VulkanPipelineBuilder::setPipelineLayout(VkPipelineLayout layout) {
+    m_externalLayout = layout;
+    return *this;
+}
+
 VulkanPipelineBuilder& VulkanPipelineBuilder::setRenderPass(VkRenderPass renderPass, uint32_t subpass) {
     m_renderPass = renderPass;
     m_subpass = subpass;
     return *this;
 }
 
+VulkanPipelineBuilder& VulkanPipelineBuilder::setPipelineCache(VkPipelineCache pipelineCache) {
+    m_pipelineCache = pipelineCache;
+    return *this;
+}
+
+VulkanPipelineBuilder& VulkanPipelineBuilder::setShaderLibrary(ShaderLibrary* shaderLibrary) {
+    m_shaderLibrary = shaderLibrary;
+    return *this;
+}
+
+uint64_t VulkanPipelineBuilder::getShaderKey(const std::string& path) const {
+    return m_shaderLibrary ? m_shaderLibrary->getContentHash(path) : 0;
+}
+
+VkShaderModule VulkanPipelineBuilder::getSharedModule(const std::string& path) const {
+    if (!m_shaderLibrary) return VK_NULL_HANDLE;
+    try {
+        return m_shaderLibrary->getModule(path);
+    } catch (const std::exception&) {
+        return VK_NULL_HANDLE;
+    }
+}
+
+bool VulkanPipelineBuilder::sameShader(const std::string& path, const VulkanPipelineBuilder& other,
+                                       const std::string& otherPath) const {
+    // 同一个module就是逐字节相同的SPIR-V（内容哈希也就相同，和hashState()一致）
+    VkShaderModule module = getSharedModule(path);
+    VkShaderModule otherModule = other.getSharedModule(otherPath);
+    if (module != VK_NULL_HANDLE || otherModule != VK_NULL_HANDLE) {
+        return module == otherModule;
+    }
+    return path == otherPath;
+}
+
+size_t VulkanPipelineBuilder::hashState() const {
+    StateHasher hasher;
+    // 内容相同的着色器键相同，不管路径
+    for (const std::string* path : { &m_vertShaderPath, &m_fragShaderPath }) {
+        uint64_t shaderKey = getShaderKey(*path);
+        hasher.add(shaderKey);
+        if (shaderKey == 0) hasher.add(*path);
+    }
+    hasher.add(m_vertexBindings);
+    hasher.add(m_vertexAttributes);
+    hasher.add(m_topology);
+    hasher.add(m_primitiveRestart);
+    hasher.add(m_extent.width);
+    hasher.add(m_extent.height);
+    hasher.add(m_polygonMode);
+    hasher.add(m_cullMode);
+    hasher.add(m_frontFace);
+    hasher.add(m_samples);
+    hasher.add(m_depthTest);
+    hasher.add(m_depthWrite);
+    hasher.add(m_depthCompare);
+    hasher.add(m_blendEnable);
+    hasher.add(m_descriptorSetLayout);
+    hasher.add(m_externalLayout);
+    hasher.add(m_renderPass);
+    hasher.add(m_subpass);
+    return static_cast<size_t>(hasher.hash);
+}
+
+bool VulkanPipelineBuilder::hasSameState(const VulkanPipelineBuilder& other) const {
+    return sameShader(m_vertShaderPath, other, other.m_vertShaderPath) &&
+           sameShader(m_fragShaderPath, other, other.m_fragShaderPath) &&
+           sameElements(m_vertexBindings, other.m_vertexBindings) &&
+           sameElements(m_vertexAttributes, other.m_vertexAttributes) &&
+           m_topology == other.m_topology &&
+           m_primitiveRestart == other.m_primitiveRestart &&
+           m_extent.width == other.m_extent.width &&
+           m_extent.height == other.m_extent.height &&
+           m_polygonMode == other.m_polygonMode &&
+           m_cullMode == other.m_cullMode &&
+           m_frontFace == other.m_frontFace &&
+           m_samples == other.m_samples &&
+           m_depthTest == other.m_depthTest &&
+           m_depthWrite == other.m_depthWrite &&
+           m_depthCompare == other.m_depthCompare &&
+           m_blendEnable == other.m_blendEnable &&
+           m_descriptorSetLayout == other.m_descriptorSetLayout &&
+           m_externalLayout == other.m_externalLayout &&
+           m_renderPass == other.m_renderPass &&
+           m_subpass == other.m_subpass;
+}
+
 void VulkanPipelineBuilder::cleanup() {
     if (m_pipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
         m_pipelineLayout = VK_NULL_HANDLE;
     }
+    destroySetLayouts(m_device, m_reflectedSetLayouts, m_descriptorSetLayout);
+}
+
+std::vector<const ShaderReflection*> VulkanPipelineBuilder::getReflections() const {
+    if (!m_shaderLibrary) {
+        throw std::runtime_error("Shader reflection requires a shader library!");
+    }
+    return {
+        &m_shaderLibrary->get(m_vertShaderPath).reflection,
+        &m_shaderLibrary->get(m_fragShaderPath).reflection
+    };
+}
+
+void VulkanPipelineBuilder::createReflectedLayout() {
+    m_pipelineLayout = createLayoutFromReflection(m_device, getReflections(), m_descriptorSetLayout, m_reflectedSetLayouts);
+}
+
+VkPushConstantRange VulkanPipelineBuilder::getReflectedPushConstants() const {
+    if (!m_shaderLibrary) return {};
+
+    // 着色器加载失败时返回空范围，错误由build()报告
+    try {
+        return mergePushConstants(getReflections());
+    } catch (const std::exception&) {
+        return {};
+    }
+}
+
+std::vector<VkVertexInputAttributeDescription> VulkanPipelineBuilder::getActiveVertexAttributes() const {
+    if (!m_shaderLibrary) return m_vertexAttributes;
+
+    // 着色器加载失败时不裁剪，错误由build()报告
+    const ShaderReflection* vertexReflection = nullptr;
+    try {
+        vertexReflection = &m_shaderLibrary->get(m_vertShaderPath).reflection;
+    } catch (const std::exception&) {
+        return m_vertexAttributes;
+    }
+    const ShaderReflection& reflection = *vertexReflection;
+
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    for (const VkVertexInputAttributeDescription& attribute : m_vertexAttributes) {
+        if (reflection.hasVertexInput(attribute.location)) {
+            attributes.push_back(attribute);
+        }
+    }
+
+    for (const ShaderReflection::VertexInput& input : reflection.vertexInputs) {
+        bool provided = std::any_of(attributes.begin(), attributes.end(),
+            [&](const VkVertexInputAttributeDescription& attribute) { return attribute.location == input.location; });
+        if (!provided) {
+            throw std::runtime_error("Vertex input location " + std::to_string(input.location) +
+                                     " is not provided for " + m_vertShaderPath);
+        }
+    }
+    return attributes;
 }
 
 // ============================================================================
@@ -145,27 +434,225 @@ void VulkanPipelineBuilder::createPipelineLayout() {
 }
 
 // ============================================================================
-// [TODO 3] BUILD PIPELINE
+// BUILD PIPELINE
 // ============================================================================
 VkPipeline VulkanPipelineBuilder::build() {
-    throw std::runtime_error(
-        "\n"
-        "========================================\n"
-        "TODO NOT IMPLEMENTED:\n"
-        "  build() in VulkanPipeline.cpp\n"
-        "\n"
-        "TASK:\n"
-        "  Build graphics pipeline from all configurations\n"
-        "\n"
-        "LOCATION:\n"
-        "  src/Core/VulkanPipeline.cpp:155\n"
-        "\n"
-        "REFERENCE:\n"
-        "  - VulkanPipeline.h (TODO 3 comments)\n"
-        "  - https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Conclusion\n"
-        "\n"
-        "GUIDE:\n"
-        "  docs/PHASE1_GUIDE.md - Step 3.3\n"
-        "========================================\n"
-    );
+    if (m_renderPass == VK_NULL_HANDLE) {
+        throw std::runtime_error("Graphics pipeline requires a render pass: " + m_vertShaderPath);
+    }
+
+    // 1. layout和顶点属性在加载着色器之前确定：它们抛异常时不用清理module
+    if (m_externalLayout == VK_NULL_HANDLE && m_pipelineLayout == VK_NULL_HANDLE) {
+        if (m_shaderLibrary) {
+            createReflectedLayout();
+        } else {
+            createPipelineLayout();
+        }
+    }
+    std::vector<VkVertexInputAttributeDescription> attributes = getActiveVertexAttributes();
+
+    // 着色器库的module是共用的；否则自己加载，创建完管线就销毁
+    VkShaderModule vertModule = VK_NULL_HANDLE;
+    VkShaderModule fragModule = VK_NULL_HANDLE;
+    if (m_shaderLibrary) {
+        vertModule = m_shaderLibrary->getModule(m_vertShaderPath);
+        fragModule = m_shaderLibrary->getModule(m_fragShaderPath);
+    } else {
+        vertModule = loadShader(m_vertShaderPath);
+        try {
+            fragModule = loadShader(m_fragShaderPath);
+        } catch (...) {
+            vkDestroyShaderModule(m_device, vertModule, nullptr);
+            throw;
+        }
+    }
+
+    // 2. 着色器阶段
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = vertModule;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = fragModule;
+    stages[1].pName = "main";
+
+    // 3. 固定功能阶段
+    VkPipelineVertexInputStateCreateInfo vertexInput{};
+    vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(m_vertexBindings.size());
+    vertexInput.pVertexBindingDescriptions = m_vertexBindings.empty() ? nullptr : m_vertexBindings.data();
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributes.size());
+    vertexInput.pVertexAttributeDescriptions = attributes.empty() ? nullptr : attributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = m_topology;
+    inputAssembly.primitiveRestartEnable = m_primitiveRestart;
+
+    // viewport是管线状态的一部分（setViewport()），录制时不用vkCmdSetViewport
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(m_extent.width);
+    viewport.height = static_cast<float>(m_extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    VkRect2D scissor{ { 0, 0 }, m_extent };
+
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.pViewports = &viewport;
+    viewportState.scissorCount = 1;
+    viewportState.pScissors = &scissor;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = m_polygonMode;
+    rasterizer.cullMode = m_cullMode;
+    rasterizer.frontFace = m_frontFace;
+    rasterizer.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = m_samples;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = m_depthTest;
+    depthStencil.depthWriteEnable = m_depthWrite;
+    depthStencil.depthCompareOp = m_depthCompare;
+
+    // 一个颜色附件；混合是普通的alpha混合
+    VkPipelineColorBlendAttachmentState blendAttachment{};
+    blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                     VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    blendAttachment.blendEnable = m_blendEnable;
+    blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+    blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = 1;
+    colorBlending.pAttachments = &blendAttachment;
+
+    // 4. 组合
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = stages;
+    pipelineInfo.pVertexInputState = &vertexInput;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.layout = getLayout();
+    pipelineInfo.renderPass = m_renderPass;
+    pipelineInfo.subpass = m_subpass;
+
+    // 5. 命中m_pipelineCache时驱动跳过着色器编译
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+
+    // 6. 自己加载的module不再需要
+    if (!m_shaderLibrary) {
+        vkDestroyShaderModule(m_device, fragModule, nullptr);
+        vkDestroyShaderModule(m_device, vertModule, nullptr);
+    }
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create graphics pipeline: " + m_vertShaderPath + ", " + m_fragShaderPath);
+    }
+    return pipeline;
+}
+
+// ============================================================================
+// VulkanComputePipelineBuilder
+// ============================================================================
+
+VulkanComputePipelineBuilder::VulkanComputePipelineBuilder(VkDevice device)
+    : m_device(device) {
+}
+
+VulkanComputePipelineBuilder::~VulkanComputePipelineBuilder() {
+    cleanup();
+}
+
+void VulkanComputePipelineBuilder::cleanup() {
+    if (m_reflectedLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_reflectedLayout, nullptr);
+        m_reflectedLayout = VK_NULL_HANDLE;
+    }
+    destroySetLayouts(m_device, m_reflectedSetLayouts, VK_NULL_HANDLE);
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::setShader(const std::string& compPath) {
+    m_compShaderPath = compPath;
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::setLayout(VkPipelineLayout layout) {
+    m_pipelineLayout = layout;
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::setPipelineCache(VkPipelineCache pipelineCache) {
+    m_pipelineCache = pipelineCache;
+    return *this;
+}
+
+VulkanComputePipelineBuilder& VulkanComputePipelineBuilder::setShaderLibrary(ShaderLibrary* shaderLibrary) {
+    m_shaderLibrary = shaderLibrary;
+    return *this;
+}
+
+VkPipeline VulkanComputePipelineBuilder::build() {
+    // 没有setLayout()时从着色器反射生成（builder持有）
+    if (m_pipelineLayout == VK_NULL_HANDLE && m_reflectedLayout == VK_NULL_HANDLE && m_shaderLibrary) {
+        std::vector<const ShaderReflection*> stages = { &m_shaderLibrary->get(m_compShaderPath).reflection };
+        m_reflectedLayout = createLayoutFromReflection(m_device, stages, VK_NULL_HANDLE, m_reflectedSetLayouts);
+    }
+
+    VkPipelineLayout layout = getLayout();
+    if (layout == VK_NULL_HANDLE) {
+        throw std::runtime_error("Compute pipeline requires a pipeline layout or a shader library!");
+    }
+
+    // 着色器库的module是共用的；否则SPIR-V加载和图形管线共用一份实现
+    VkShaderModule shaderModule;
+    if (m_shaderLibrary) {
+        shaderModule = m_shaderLibrary->getModule(m_compShaderPath);
+    } else {
+        VulkanPipelineBuilder loader(m_device);
+        shaderModule = loader.loadShader(m_compShaderPath);
+    }
+
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    stageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stageInfo.module = shaderModule;
+    stageInfo.pName = "main";
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage = stageInfo;
+    pipelineInfo.layout = layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateComputePipelines(m_device, m_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
+
+    if (!m_shaderLibrary) {
+        vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    }
+
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create compute pipeline: " + m_compShaderPath);
+    }
+    return pipeline;
 }
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+class ShaderLibrary;
+struct ShaderReflection;
+
 /**
  * @brief Vulkan图形管线构建器
  *
@@ -41,7 +45,7 @@
  * 你需要实现：
  * 1. loadShader() - 加载SPIR-V着色器
  * 2. createPipelineLayout() - 创建管线布局
- * 3. build() - 构建完整的图形管线
+ * build()把它们和固定功能配置组合成完整的图形管线（有着色器库时不需要1和2）
  */
 class VulkanPipelineBuilder {
 public:
@@ -90,11 +94,22 @@ public:
         VkDescriptorSetLayout layout
     );
 
+    // 使用调用者创建的pipeline layout（不属于builder，cleanup()不销毁），build()不再自己创建。
+    // 录制时vkCmdPushConstants/vkCmdBindDescriptorSets用的就是这个layout
+    VulkanPipelineBuilder& setPipelineLayout(VkPipelineLayout layout);
+
     VulkanPipelineBuilder& setRenderPass(
         VkRenderPass renderPass,
         uint32_t subpass = 0
     );
 
+    // 驱动编译结果的缓存（VulkanContext::getPipelineCache()，跨运行保存在磁盘上）
+    VulkanPipelineBuilder& setPipelineCache(VkPipelineCache pipelineCache);
+
+    // 从着色器库取shader module（共用，build()之后不销毁），不再每次读文件。
+    // 设置后管线的键用着色器内容的哈希而不是路径
+    VulkanPipelineBuilder& setShaderLibrary(ShaderLibrary* shaderLibrary);
+
     // ========================================================================
     // [TODO 1] 加载SPIR-V着色器
     // ========================================================================
@@ -138,53 +153,67 @@ public:
     //
     // PHASE 1: 可以先创建空的layout（没有descriptors和push constants）
     // LATER: 添加uniform buffer和texture descriptors
+    //
+    // 有着色器库时不需要手写：createReflectedLayout()从着色器反射生成
     void createPipelineLayout();
 
+    // 从着色器反射生成pipeline layout（需要setShaderLibrary）：
+    // - 两个阶段的descriptor binding合并，每个set创建一个VkDescriptorSetLayout（builder持有）；
+    //   设置了setDescriptorSetLayout时set 0用它
+    // - push constant合并成一个范围，stageFlags是用到它的阶段
+    void createReflectedLayout();
+
+    // 两个阶段合并后的push constant范围。调用者自己创建layout（setPipelineLayout）时用它，
+    // vkCmdPushConstants的stageFlags也用它的。
+    // size = 0：着色器没有push constant，或者没有着色器库/着色器加载失败（错误由build()报告）
+    VkPushConstantRange getReflectedPushConstants() const;
+
+    // 顶点着色器实际声明的属性（没有着色器库或着色器加载失败时返回全部）。
+    // 着色器不读的属性（比如只写深度的Pass不要颜色/法线/UV）不再抓取；
+    // 着色器要的location没有提供时抛异常
+    std::vector<VkVertexInputAttributeDescription> getActiveVertexAttributes() const;
+
     // ========================================================================
-    // [TODO 3] 构建图形管线
+    // 构建图形管线
     // ========================================================================
-    // CONCEPT: 将所有配置组合成最终的VkPipeline
-    //
-    // 主要步骤：
-    // 1. Shader Stages：配置顶点和片段着色器
-    // 2. Vertex Input：顶点数据格式
-    // 3. Input Assembly：如何组装顶点
-    // 4. Viewport & Scissor：渲染区域
-    // 5. Rasterization：光栅化设置
-    // 6. Multisampling：多重采样（抗锯齿）
-    // 7. Depth/Stencil：深度测试
-    // 8. Color Blending：颜色混合
-    // 9. Dynamic State：可以动态修改的状态（viewport, scissor等）
-    //
-    // YOU NEED TO:
-    // 1. 加载着色器（调用loadShader）
-    // 2. 创建 VkPipelineShaderStageCreateInfo[] 数组（vertex + fragment）
-    // 3. 填充所有固定功能阶段的CreateInfo结构体：
-    //    - VkPipelineVertexInputStateCreateInfo
-    //    - VkPipelineInputAssemblyStateCreateInfo
-    //    - VkPipelineViewportStateCreateInfo
-    //    - VkPipelineRasterizationStateCreateInfo
-    //    - VkPipelineMultisampleStateCreateInfo
-    //    - VkPipelineDepthStencilStateCreateInfo
-    //    - VkPipelineColorBlendStateCreateInfo
-    //    - VkPipelineDynamicStateCreateInfo（可选）
-    // 4. 填充 VkGraphicsPipelineCreateInfo
-    // 5. 调用 vkCreateGraphicsPipelines()
-    // 6. 销毁shader modules（pipeline创建后不再需要）
-    //
-    // TIPS:
-    // - 使用builder模式收集的配置（m_xxx成员变量）
-    // - Dynamic state可以让viewport和scissor在运行时修改
+    // 将所有配置组合成最终的VkPipeline：
+    // 1. layout：setPipelineLayout()的m_externalLayout；否则有着色器库时
+    //    createReflectedLayout()，没有时createPipelineLayout()（TODO 2）
+    // 2. 顶点属性用getActiveVertexAttributes()（去掉着色器不读的）
+    // 3. 着色器：有着色器库时用它的module（共用，不销毁）；
+    //    否则loadShader()（TODO 1），管线创建后销毁
+    // 4. 固定功能阶段来自builder方法；viewport/scissor是静态的（setViewport()），
+    //    一个颜色附件，setColorBlending(VK_TRUE)是普通的alpha混合
+    // 5. vkCreateGraphicsPipelines()传m_pipelineCache：命中缓存时驱动跳过着色器编译
     //
     // VULKAN TUTORIAL: https://vulkan-tutorial.com/Drawing_a_triangle/Graphics_pipeline_basics/Conclusion
     VkPipeline build();
 
     // Getters
-    VkPipelineLayout getLayout() const { return m_pipelineLayout; }
+    VkPipelineLayout getLayout() const { return m_externalLayout != VK_NULL_HANDLE ? m_externalLayout : m_pipelineLayout; }
+    // createReflectedLayout()之后：按set编号，分配descriptor set用
+    const std::vector<VkDescriptorSetLayout>& getSetLayouts() const { return m_reflectedSetLayouts; }
+
+    // 管线配置的哈希和比较（PipelineRegistry用来合并相同的管线）。
+    // 只看决定管线内容的配置：不包括pipeline cache和build()创建的对象。
+    // 有着色器库时着色器按内容：哈希用内容哈希，比较看是不是同一个module
+    // （库里内容逐字节相同才共用module，哈希碰撞不会合并）；没有库或加载失败时按路径。
+    // 着色器还没加载时会加载（材质创建builder时反射已经加载过，通常只是查找）
+    size_t hashState() const;
+    bool hasSameState(const VulkanPipelineBuilder& other) const;
 
     void cleanup();
 
 private:
+    // 着色器的键：着色器库里的内容哈希；没有着色器库或加载失败时为0（改用路径）
+    uint64_t getShaderKey(const std::string& path) const;
+    // 着色器库里的module；没有着色器库或加载失败时为VK_NULL_HANDLE
+    VkShaderModule getSharedModule(const std::string& path) const;
+    bool sameShader(const std::string& path, const VulkanPipelineBuilder& other, const std::string& otherPath) const;
+
+    // 两个阶段的反射结果（需要setShaderLibrary，否则抛异常）
+    std::vector<const ShaderReflection*> getReflections() const;
+
     VkDevice m_device;
 
     // 管线配置（由builder方法设置）
@@ -204,9 +233,69 @@ private:
     VkCompareOp m_depthCompare = VK_COMPARE_OP_LESS;
     VkBool32 m_blendEnable = VK_FALSE;
     VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout m_externalLayout = VK_NULL_HANDLE;    // setPipelineLayout()，不属于builder
     VkRenderPass m_renderPass = VK_NULL_HANDLE;
     uint32_t m_subpass = 0;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    ShaderLibrary* m_shaderLibrary = nullptr;
 
     // Vulkan对象
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> m_reflectedSetLayouts;   // createReflectedLayout()创建的
+};
+
+/**
+ * @brief Vulkan计算管线构建器
+ *
+ * 计算管线只有一个阶段（compute shader），没有固定功能状态，
+ * 所以比图形管线简单得多：shader + pipeline layout就够了。
+ *
+ * pipeline layout通常由调用者创建并持有（setLayout）：
+ * 计算管线通常和图形管线共享descriptor set layout，
+ * 调用者需要用同一个layout去vkCmdBindDescriptorSets / vkCmdPushConstants。
+ * 没有setLayout()但有着色器库时，build()从着色器反射生成layout，
+ * 这个layout属于builder（getLayout()取，builder要活得和管线一样久）。
+ *
+ * 使用方法：
+ *   VulkanComputePipelineBuilder builder(device);
+ *   VkPipeline pipeline = builder
+ *       .setShader("shaders/compiled/gpu_cull.comp.spv")
+ *       .setLayout(pipelineLayout)
+ *       .build();
+ */
+class VulkanComputePipelineBuilder {
+public:
+    VulkanComputePipelineBuilder(VkDevice device);
+    ~VulkanComputePipelineBuilder();
+
+    VulkanComputePipelineBuilder(const VulkanComputePipelineBuilder&) = delete;
+    VulkanComputePipelineBuilder& operator=(const VulkanComputePipelineBuilder&) = delete;
+
+    VulkanComputePipelineBuilder& setShader(const std::string& compPath);
+
+    VulkanComputePipelineBuilder& setLayout(VkPipelineLayout layout);
+
+    VulkanComputePipelineBuilder& setPipelineCache(VkPipelineCache pipelineCache);
+
+    VulkanComputePipelineBuilder& setShaderLibrary(ShaderLibrary* shaderLibrary);
+
+    // 创建计算管线（自己加载的shader module在创建后立即销毁，着色器库的保留）
+    VkPipeline build();
+
+    // setLayout()的layout，或者build()反射生成的
+    VkPipelineLayout getLayout() const { return m_pipelineLayout != VK_NULL_HANDLE ? m_pipelineLayout : m_reflectedLayout; }
+    const std::vector<VkDescriptorSetLayout>& getSetLayouts() const { return m_reflectedSetLayouts; }
+
+    // 销毁反射生成的layout（调用者的layout不销毁）
+    void cleanup();
+
+private:
+    VkDevice m_device;
+    std::string m_compShaderPath;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    ShaderLibrary* m_shaderLibrary = nullptr;
+
+    VkPipelineLayout m_reflectedLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> m_reflectedSetLayouts;
 };
@@ -0,0 +1,202 @@
+#include "Core/VulkanPipelineCache.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+VulkanPipelineCache::~VulkanPipelineCache() {
+    cleanup();
+}
+
+void VulkanPipelineCache::initialize(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path) {
+    m_device = device;
+    m_path = path;
+    m_stats = Stats{};
+
+    // driverUUID在VkPhysicalDeviceIDProperties里（Vulkan 1.1）
+    VkPhysicalDeviceIDProperties idProperties{};
+    idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &idProperties;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &properties2);
+
+    m_properties = properties2.properties;
+    std::memcpy(m_driverUUID, idProperties.driverUUID, VK_UUID_SIZE);
+
+    std::vector<uint8_t> initialData;
+    if (!m_path.empty()) {
+        initialData = loadFile();
+    } else {
+        m_stats.rejectReason = "no cache path";
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = initialData.size();
+    cacheInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+    VkResult result = vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache);
+    if (result != VK_SUCCESS && !initialData.empty()) {
+        // 驱动不接受这份数据：从空缓存开始
+        m_stats.rejectReason = "rejected by driver";
+        initialData.clear();
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(m_device, &cacheInfo, nullptr, &m_cache);
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline cache!");
+    }
+
+    if (!initialData.empty()) {
+        m_stats.loaded = true;
+        m_stats.loadedBytes = initialData.size();
+        m_loadedChecksum = computeChecksum(initialData.data(), initialData.size());
+    }
+}
+
+void VulkanPipelineCache::cleanup() {
+    if (m_cache == VK_NULL_HANDLE) return;
+
+    save();
+    vkDestroyPipelineCache(m_device, m_cache, nullptr);
+    m_cache = VK_NULL_HANDLE;
+    m_device = VK_NULL_HANDLE;
+}
+
+bool VulkanPipelineCache::save() {
+    if (m_cache == VK_NULL_HANDLE || m_path.empty()) return false;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        return false;
+    }
+    std::vector<uint8_t> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_cache, &dataSize, data.data()) != VK_SUCCESS) {
+        return false;
+    }
+    data.resize(dataSize);
+
+    FileHeader header = makeHeader();
+    header.dataSize = dataSize;
+    header.checksum = computeChecksum(data.data(), dataSize);
+
+    // 这次运行没有编译新的管线：文件已经是最新的
+    if (m_stats.loaded && dataSize == m_stats.loadedBytes && header.checksum == m_loadedChecksum) {
+        return true;
+    }
+
+    // 临时文件名每个进程不同，rename是原子替换
+    std::string tempPath = m_path + ".tmp" +
+        std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(dataSize));
+        file.flush();
+        if (!file) {
+            file.close();
+            std::error_code ignored;
+            std::filesystem::remove(tempPath, ignored);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    if (error) {
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+        return false;
+    }
+
+    m_stats.savedBytes = dataSize;
+    m_stats.loaded = true;
+    m_stats.loadedBytes = dataSize;
+    m_loadedChecksum = header.checksum;
+    return true;
+}
+
+std::vector<uint8_t> VulkanPipelineCache::loadFile() {
+    std::ifstream file(m_path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        m_stats.rejectReason = "no cache file";
+        return {};
+    }
+
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamoff>(sizeof(FileHeader))) {
+        m_stats.rejectReason = "truncated header";
+        return {};
+    }
+
+    FileHeader header;
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    FileHeader expected = makeHeader();
+    if (!file || header.magic != FILE_MAGIC || header.version != FILE_VERSION) {
+        m_stats.rejectReason = "not a pipeline cache file";
+        return {};
+    }
+    if (header.vendorID != expected.vendorID || header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        std::memcmp(header.driverUUID, expected.driverUUID, VK_UUID_SIZE) != 0) {
+        m_stats.rejectReason = "different device or driver";
+        return {};
+    }
+    if (header.dataSize != static_cast<uint64_t>(fileSize) - sizeof(FileHeader)) {
+        m_stats.rejectReason = "truncated data";
+        return {};
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(header.dataSize));
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file || computeChecksum(data.data(), data.size()) != header.checksum) {
+        m_stats.rejectReason = "checksum mismatch";
+        return {};
+    }
+
+    // 驱动自己的头（数据开头的VkPipelineCacheHeaderVersionOne）
+    VkPipelineCacheHeaderVersionOne driverHeader;
+    if (data.size() < sizeof(driverHeader)) {
+        m_stats.rejectReason = "truncated driver header";
+        return {};
+    }
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != m_properties.vendorID || driverHeader.deviceID != m_properties.deviceID ||
+        std::memcmp(driverHeader.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        m_stats.rejectReason = "driver header mismatch";
+        return {};
+    }
+
+    return data;
+}
+
+VulkanPipelineCache::FileHeader VulkanPipelineCache::makeHeader() const {
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_VERSION;
+    header.vendorID = m_properties.vendorID;
+    header.deviceID = m_properties.deviceID;
+    header.driverVersion = m_properties.driverVersion;
+    std::memcpy(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE);
+    std::memcpy(header.driverUUID, m_driverUUID, VK_UUID_SIZE);
+    return header;
+}
+
+uint64_t VulkanPipelineCache::computeChecksum(const uint8_t* data, size_t size) {
+    // FNV-1a：只用来发现截断和损坏
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 持久化到磁盘的VkPipelineCache
+ *
+ * 驱动创建管线时要把SPIR-V编译成GPU指令，这一步很慢。
+ * VkPipelineCache保存编译结果：同一个进程里第二次创建相同的管线直接命中，
+ * 把缓存数据写到磁盘，下次启动也能命中（冷启动不再重新编译）。
+ *
+ * 磁盘文件 = 我们的文件头 + vkGetPipelineCacheData()的数据：
+ * - 文件头记录vendorID/deviceID/driverVersion/pipelineCacheUUID/driverUUID和数据的校验和
+ * - 换了显卡、驱动升级或者文件被截断/损坏，加载时丢弃，从空缓存开始
+ *   （有的驱动遇到不匹配的数据会崩溃，不能完全依赖驱动自己的检查）
+ * - 数据本身的VkPipelineCacheHeaderVersionOne也检查一遍
+ *
+ * 保存是原子的：先写临时文件再rename覆盖。多个进程同时退出
+ * （CI并行跑渲染测试）时最后一个rename的胜出，不会留下写了一半的文件。
+ * 数据和加载时相同就不写。
+ *
+ * 缓存只有传给vkCreate*Pipelines()才起作用：图形管线和计算管线的build()
+ * 都把setPipelineCache()的句柄传给驱动，没有设置的管线不经过缓存。
+ *
+ * 使用方法：
+ *   VulkanPipelineCache cache;
+ *   cache.initialize(device, physicalDevice, "pipeline_cache.bin");
+ *   builder.setPipelineCache(cache.getHandle());
+ *   ...
+ *   cache.cleanup();   // 保存并销毁（在vkDestroyDevice之前）
+ */
+class VulkanPipelineCache {
+public:
+    struct Stats {
+        bool loaded = false;            // 磁盘上的缓存被接受
+        size_t loadedBytes = 0;
+        size_t savedBytes = 0;
+        std::string rejectReason;       // 磁盘缓存被丢弃的原因（调试用）
+    };
+
+    VulkanPipelineCache() = default;
+    ~VulkanPipelineCache();
+
+    VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+    VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+    // path为空：只在内存里缓存，不读写磁盘
+    void initialize(VkDevice device, VkPhysicalDevice physicalDevice, const std::string& path);
+
+    // 保存到磁盘并销毁
+    void cleanup();
+
+    // 写回磁盘；失败时返回false（不抛异常，缓存只是优化）
+    bool save();
+
+    VkPipelineCache getHandle() const { return m_cache; }
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    static constexpr uint32_t FILE_MAGIC = 0x43504B56;   // "VKPC"
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint32_t reserved;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+        uint8_t driverUUID[VK_UUID_SIZE];
+        uint64_t dataSize;
+        uint64_t checksum;
+    };
+
+    static uint64_t computeChecksum(const uint8_t* data, size_t size);
+
+    // 读取并检查磁盘文件；不能用时返回空并设置rejectReason
+    std::vector<uint8_t> loadFile();
+    FileHeader makeHeader() const;
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_cache = VK_NULL_HANDLE;
+    std::string m_path;
+
+    // 当前设备的身份
+    VkPhysicalDeviceProperties m_properties{};
+    uint8_t m_driverUUID[VK_UUID_SIZE] = {};
+
+    uint64_t m_loadedChecksum = 0;   // 数据没变就不用写
+    Stats m_stats;
+};
@@ -0,0 +1,480 @@
+#include "Core/VulkanUploader.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// 获取屏障之后图形队列可能的读取方式（上传的数据可能是顶点、索引、uniform、间接命令……）
+constexpr VkAccessFlags CONSUMER_ACCESS =
+    VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+    VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+
+} // namespace
+
+VulkanUploader::~VulkanUploader() {
+    cleanup();
+}
+
+void VulkanUploader::initialize(
+    VmaAllocator allocator,
+    VkDevice device,
+    VkQueue queue,
+    uint32_t queueFamily,
+    uint32_t graphicsFamily,
+    VkDeviceSize ringSize
+) {
+    m_allocator = allocator;
+    m_device = device;
+    m_queue = queue;
+    m_queueFamily = queueFamily;
+    m_graphicsFamily = graphicsFamily;
+    m_ringSpace = RingSpace{};
+    m_ringSpace.size = alignUp(ringSize, COPY_ALIGNMENT);
+    m_batchRingBegin = 0;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+    if (vkCreateCommandPool(device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload command pool!");
+    }
+
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &m_semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create upload timeline semaphore!");
+    }
+
+    // 常驻映射：上传只是memcpy
+    m_ring.create(allocator, m_ringSpace.size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+    m_ringMapped = static_cast<uint8_t*>(m_ring.map());
+}
+
+void VulkanUploader::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    // 没提交的复制直接丢弃；已提交的要等完成才能销毁staging
+    m_copies.clear();
+    m_stagings.clear();
+    wait(m_submittedValue);
+    m_batches.clear();
+    m_pendingAcquires.clear();
+
+    if (m_ringMapped) {
+        m_ring.unmap();
+        m_ringMapped = nullptr;
+    }
+    m_ring.cleanup();
+
+    vkDestroySemaphore(m_device, m_semaphore, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);   // 同时释放所有命令缓冲
+    m_semaphore = VK_NULL_HANDLE;
+    m_commandPool = VK_NULL_HANDLE;
+    m_freeCommandBuffers.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+uint64_t VulkanUploader::upload(const VulkanBuffer& dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size) {
+    if (size == 0) return m_submittedValue;
+
+    if (size > m_ringSpace.size / 2) {
+        // 放进环形缓冲会把其他上传都挤出去：单独一个staging缓冲
+        auto staging = std::make_unique<VulkanBuffer>();
+        staging->create(m_allocator, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+        std::memcpy(staging->map(), data, size);
+        staging->flush();
+        staging->unmap();
+
+        m_copies.push_back({ staging->getHandle(), dst.getHandle(), { 0, dstOffset, size } });
+        m_stagings.push_back(std::move(staging));
+        m_stats.dedicatedStagings++;
+    } else {
+        // 可能提交当前批次：这个复制在它之后才排队，属于下一个批次
+        VkDeviceSize offset = allocateRing(size);
+        std::memcpy(m_ringMapped + offset, data, size);
+        m_copies.push_back({ m_ring.getHandle(), dst.getHandle(), { offset, dstOffset, size } });
+    }
+
+    m_stats.bytes += size;
+    m_stats.copies++;
+    return m_submittedValue + 1;
+}
+
+bool VulkanUploader::RingSpace::tryAllocate(VkDeviceSize bytes, VkDeviceSize& offset) {
+    uint64_t begin = alignUp(head, COPY_ALIGNMENT);
+    uint64_t physical = begin % size;
+    if (physical + bytes > size) {
+        begin += size - physical;   // 一次复制不能跨过缓冲末尾，从开头开始
+    }
+    if (begin + bytes - tail > size) return false;
+
+    head = begin + bytes;
+    offset = begin % size;
+    return true;
+}
+
+void VulkanUploader::RingSpace::restart() {
+    head = tail = alignUp(head, size);
+}
+
+VkDeviceSize VulkanUploader::allocateRing(VkDeviceSize size) {
+    VkDeviceSize offset = 0;
+    while (!m_ringSpace.tryAllocate(size, offset)) {
+        // 空间不够：先回收已经完成的批次
+        reclaim();
+        if (m_ringSpace.tryAllocate(size, offset)) break;
+
+        if (m_batches.empty()) {
+            if (m_ringSpace.isIdle()) {
+                m_ringSpace.restart();
+                m_batchRingBegin = m_ringSpace.head;
+                continue;
+            }
+            // 占着空间的只有当前批次自己
+            submit();
+        }
+
+        m_stats.ringWaits++;
+        wait(m_batches.front().value);
+    }
+    return offset;
+}
+
+void VulkanUploader::reclaim() {
+    if (m_batches.empty()) return;
+
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(m_device, m_semaphore, &completed);
+
+    while (!m_batches.empty() && m_batches.front().value <= completed) {
+        Batch& batch = m_batches.front();
+        m_ringSpace.tail = batch.ringEnd;
+        for (auto& staging : batch.stagings) {
+            staging->cleanup();
+        }
+        m_freeCommandBuffers.push_back(batch.cmd);
+        m_batches.pop_front();
+    }
+}
+
+void VulkanUploader::flushRing(uint64_t begin, uint64_t end) {
+    if (begin == end) return;
+    if (end - begin >= m_ringSpace.size) {
+        m_ring.flush();
+        return;
+    }
+
+    VkDeviceSize first = begin % m_ringSpace.size;
+    VkDeviceSize last = end % m_ringSpace.size;
+    if (first < last) {
+        m_ring.flush(first, last - first);
+    } else {
+        // 绕回了开头：两段
+        m_ring.flush(first, VK_WHOLE_SIZE);
+        if (last > 0) m_ring.flush(0, last);
+    }
+}
+
+VkCommandBuffer VulkanUploader::acquireCommandBuffer() {
+    if (!m_freeCommandBuffers.empty()) {
+        VkCommandBuffer cmd = m_freeCommandBuffers.back();
+        m_freeCommandBuffers.pop_back();
+        vkResetCommandBuffer(cmd, 0);
+        return cmd;
+    }
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer cmd;
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, &cmd) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate upload command buffer!");
+    }
+    return cmd;
+}
+
+void VulkanUploader::planCopies(const std::vector<Copy>& copies, std::vector<VkBufferCopy>& regions,
+                                std::vector<CopyCommand>& commands) {
+    regions.clear();
+    commands.clear();
+
+    std::vector<Copy> segment;
+    // 段内已写的目标区间：(缓冲, 起点) -> 终点，互不重叠
+    std::map<std::pair<VkBuffer, VkDeviceSize>, VkDeviceSize> written;
+
+    auto overlapsWritten = [&](const Copy& copy) {
+        VkDeviceSize begin = copy.region.dstOffset;
+        VkDeviceSize end = begin + copy.region.size;
+        auto next = written.lower_bound({ copy.dst, begin });
+        if (next != written.end() && next->first.first == copy.dst && next->first.second < end) return true;
+        if (next != written.begin()) {
+            auto previous = std::prev(next);
+            if (previous->first.first == copy.dst && previous->second > begin) return true;
+        }
+        return false;
+    };
+
+    // 段内相同源和目标的复制合并成一次vkCmdCopyBuffer（段内没有重叠，顺序无关）
+    auto flushSegment = [&](bool barrierBefore) {
+        std::stable_sort(segment.begin(), segment.end(), [](const Copy& a, const Copy& b) {
+            if (a.src != b.src) return a.src < b.src;
+            return a.dst < b.dst;
+        });
+        for (size_t i = 0; i < segment.size(); ++i) {
+            if (i == 0 || segment[i].src != segment[i - 1].src || segment[i].dst != segment[i - 1].dst) {
+                commands.push_back({ segment[i].src, segment[i].dst, static_cast<uint32_t>(regions.size()), 0,
+                                     barrierBefore && i == 0 });
+            }
+            regions.push_back(segment[i].region);
+            commands.back().regionCount++;
+        }
+        segment.clear();
+        written.clear();
+    };
+
+    bool firstSegment = true;
+    for (const Copy& copy : copies) {
+        if (copy.region.size == 0) continue;
+        if (overlapsWritten(copy)) {
+            flushSegment(!firstSegment);
+            firstSegment = false;
+        }
+        segment.push_back(copy);
+        written[{ copy.dst, copy.region.dstOffset }] = copy.region.dstOffset + copy.region.size;
+    }
+    flushSegment(!firstSegment);
+}
+
+uint64_t VulkanUploader::submit() {
+    if (m_copies.empty()) return m_submittedValue;
+
+    flushRing(m_batchRingBegin, m_ringSpace.head);
+
+    VkCommandBuffer cmd = acquireCommandBuffer();
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+
+    planCopies(m_copies, m_plannedRegions, m_plannedCommands);
+    for (const CopyCommand& command : m_plannedCommands) {
+        if (command.barrierBefore) {
+            // 后上传的数据覆盖先上传的：等前面的复制写完（WAW）
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+        vkCmdCopyBuffer(cmd, command.src, command.dst, command.regionCount,
+                        m_plannedRegions.data() + command.firstRegion);
+    }
+
+    if (needsOwnershipTransfer()) {
+        recordReleases(cmd);
+    }
+
+    vkEndCommandBuffer(cmd);
+
+    uint64_t value = m_submittedValue + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &value;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &m_semaphore;
+
+    if (vkQueueSubmit(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to submit upload batch!");
+    }
+    m_submittedValue = value;
+
+    Batch batch;
+    batch.cmd = cmd;
+    batch.value = value;
+    batch.ringEnd = m_ringSpace.head;
+    batch.stagings = std::move(m_stagings);
+    m_batches.push_back(std::move(batch));
+
+    m_copies.clear();
+    m_stagings.clear();
+    m_batchRingBegin = m_ringSpace.head;
+    m_stats.batches++;
+    return value;
+}
+
+void VulkanUploader::recordReleases(VkCommandBuffer cmd) {
+    // 每个目标缓冲里相邻/重叠的区域合并成一个屏障。
+    // 不相邻的区域不合并：中间的部分不归传输队列，不能一起转移
+    std::vector<Copy> byTarget = m_copies;
+    std::sort(byTarget.begin(), byTarget.end(), [](const Copy& a, const Copy& b) {
+        if (a.dst != b.dst) return a.dst < b.dst;
+        return a.region.dstOffset < b.region.dstOffset;
+    });
+
+    std::vector<VkBufferMemoryBarrier> releases;
+    for (const Copy& copy : byTarget) {
+        if (!releases.empty()) {
+            VkBufferMemoryBarrier& last = releases.back();
+            if (last.buffer == copy.dst && copy.region.dstOffset <= last.offset + last.size) {
+                last.size = std::max(last.offset + last.size, copy.region.dstOffset + copy.region.size) - last.offset;
+                continue;
+            }
+        }
+
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;                  // 释放时忽略
+        barrier.srcQueueFamilyIndex = m_queueFamily;
+        barrier.dstQueueFamilyIndex = m_graphicsFamily;
+        barrier.buffer = copy.dst;
+        barrier.offset = copy.region.dstOffset;
+        barrier.size = copy.region.size;
+        releases.push_back(barrier);
+    }
+
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, static_cast<uint32_t>(releases.size()), releases.data(), 0, nullptr);
+
+    // 获取屏障必须和释放屏障的缓冲/区间/队列族完全一致
+    for (VkBufferMemoryBarrier acquire : releases) {
+        acquire.srcAccessMask = 0;                  // 获取时忽略
+        acquire.dstAccessMask = CONSUMER_ACCESS;
+        m_pendingAcquires.push_back(acquire);
+    }
+}
+
+bool VulkanUploader::isComplete(uint64_t value) const {
+    if (value == 0) return true;
+    uint64_t completed = 0;
+    vkGetSemaphoreCounterValue(m_device, m_semaphore, &completed);
+    return completed >= value;
+}
+
+void VulkanUploader::wait(uint64_t value) {
+    if (value > m_submittedValue) {
+        submit();   // 等待的是当前批次
+    }
+    if (value > 0) {
+        VkSemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_semaphore;
+        waitInfo.pValues = &value;
+        vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+    }
+    reclaim();
+}
+
+void VulkanUploader::finish(VkQueue graphicsQueue, VkCommandPool graphicsPool) {
+    uint64_t value = submit();
+    wait(value);
+    if (m_pendingAcquires.empty()) return;
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = graphicsPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    VkCommandBuffer cmd;
+    if (vkAllocateCommandBuffers(m_device, &allocInfo, &cmd) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate upload acquire command buffer!");
+    }
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    recordAcquires(cmd);
+    vkEndCommandBuffer(cmd);
+
+    // CPU等到了不代表图形队列能看到写入：提交里仍然等待信号量
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = 1;
+    timelineInfo.pWaitSemaphoreValues = &value;
+
+    VkPipelineStageFlags waitStage = CONSUMER_STAGES;
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &m_semaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+
+    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+    vkQueueWaitIdle(graphicsQueue);
+
+    vkFreeCommandBuffers(m_device, graphicsPool, 1, &cmd);
+}
+
+void VulkanUploader::recordAcquires(VkCommandBuffer cmd) {
+    if (m_pendingAcquires.empty()) return;
+
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, CONSUMER_STAGES,
+        0, 0, nullptr, static_cast<uint32_t>(m_pendingAcquires.size()), m_pendingAcquires.data(), 0, nullptr);
+    m_pendingAcquires.clear();
+}
+
+uint64_t VulkanUploader::takeGraphicsWaitValue() {
+    if (m_submittedValue <= m_graphicsWaitValue) return 0;
+    m_graphicsWaitValue = m_submittedValue;
+    return m_graphicsWaitValue;
+}
+
+// ============================================================================
+// Helper Function
+// ============================================================================
+VulkanBuffer createBufferWithData(
+    VmaAllocator allocator,
+    VulkanUploader& uploader,
+    const void* data,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    uint64_t* ticket
+) {
+    VulkanBuffer deviceBuffer;
+    deviceBuffer.create(
+        allocator,
+        size,
+        usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VulkanBuffer::MemoryLocation::GPU_ONLY
+    );
+
+    uint64_t value = uploader.upload(deviceBuffer, 0, data, size);
+    if (ticket) *ticket = value;
+
+    return deviceBuffer;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Core/VulkanBuffer.h"
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 异步上传管理器 - staging环形缓冲 + 传输队列 + timeline信号量
+ *
+ * createBufferWithData/copyFrom每次上传都要创建一个临时staging缓冲、
+ * 单独提交一次、再vkQueueWaitIdle：每个缓冲一次完整的GPU停顿。
+ * 这里改成：
+ *
+ * 1. 一个常驻映射的staging环形缓冲。upload()把数据memcpy进去，
+ *    只记录一个复制区域，不提交
+ * 2. submit()把排队的所有复制录制进一个命令缓冲，一次提交到传输队列
+ *    （VulkanContext找到专用传输队列族时是它，否则是图形队列）
+ * 3. 每次提交给timeline信号量signal一个递增的值。CPU用isComplete()查询、
+ *    图形队列在提交时等待这个值，都不需要vkQueueWaitIdle
+ *
+ * 环形缓冲用只增不减的虚拟偏移（物理偏移 = 虚拟偏移 % 大小）：
+ * head是下一次分配的位置，tail是最早的未完成批次的起点。
+ * 批次完成（信号量到达它的值）后tail推进到它的末尾。
+ * 只有环形缓冲满了CPU才会等待最早的批次；比环形缓冲一半还大的上传
+ * 用单独的staging缓冲，批次完成后销毁。
+ *
+ * 同一批次里目标区域重叠的上传（同一块区域先后上传两次）按上传顺序生效：
+ * 批次按上传顺序切成几段，段内目标区域互不重叠、可以随意合并，
+ * 段之间有一个TRANSFER→TRANSFER屏障（见planCopies）。
+ *
+ * 队列族所有权：
+ * 传输队列族和图形队列族不同时，缓冲（EXCLUSIVE）的所有权要转移：
+ * submit()在复制之后录制释放屏障，recordAcquires()在图形队列的命令缓冲里
+ * 录制对应的获取屏障。Renderer每帧自动做这件事（见Renderer::render）。
+ *
+ * 限制：
+ * - 单线程：upload/submit和Renderer::render在同一个线程调用
+ * - 目标区域不能正在被GPU读取（新创建的缓冲、新分配的MeshArena区间）
+ * - 目标缓冲要活到使用它的那一帧（获取屏障引用它）
+ * - 需要Vulkan 1.2的timelineSemaphore特性
+ *
+ * 使用方法：
+ *   uint64_t ticket = uploader.upload(vertexBuffer, 0, vertices.data(), bytes);
+ *   ...                                  // 更多上传，合并成一个批次
+ *   uploader.submit();                   // Renderer::render()每帧也会调用
+ *   if (uploader.isComplete(ticket)) ... // 不阻塞的查询
+ */
+class VulkanUploader {
+public:
+    struct Stats {
+        uint64_t bytes = 0;              // upload()的总字节数
+        uint32_t copies = 0;             // 复制区域数
+        uint32_t batches = 0;            // 提交次数（每次一个命令缓冲）
+        uint32_t ringWaits = 0;          // 环形缓冲满了，CPU等待最早批次的次数
+        uint32_t dedicatedStagings = 0;  // 太大而单独创建staging缓冲的上传
+    };
+
+    static constexpr VkDeviceSize DEFAULT_RING_SIZE = 32ull << 20;
+    static constexpr VkDeviceSize COPY_ALIGNMENT = 16;
+
+    // 图形队列上读取上传数据的阶段：等待timeline信号量和获取屏障都用它
+    static constexpr VkPipelineStageFlags CONSUMER_STAGES =
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    VulkanUploader() = default;
+    ~VulkanUploader();
+
+    VulkanUploader(const VulkanUploader&) = delete;
+    VulkanUploader& operator=(const VulkanUploader&) = delete;
+
+    /**
+     * @param queue 提交复制的队列（VulkanContext::getTransferQueue()）
+     * @param queueFamily queue所属的队列族
+     * @param graphicsFamily 使用上传数据的队列族，和queueFamily不同时做所有权转移
+     */
+    void initialize(
+        VmaAllocator allocator,
+        VkDevice device,
+        VkQueue queue,
+        uint32_t queueFamily,
+        uint32_t graphicsFamily,
+        VkDeviceSize ringSize = DEFAULT_RING_SIZE
+    );
+
+    void cleanup();
+
+    /**
+     * @brief 把data复制到dst的[dstOffset, dstOffset + size)
+     *
+     * 数据立刻复制进staging，调用返回后data可以释放。
+     * dst需要VK_BUFFER_USAGE_TRANSFER_DST_BIT。
+     *
+     * @return 完成时信号量的值（传给isComplete/wait）
+     */
+    uint64_t upload(const VulkanBuffer& dst, VkDeviceSize dstOffset, const void* data, VkDeviceSize size);
+
+    // 提交排队的复制（没有就什么都不做），返回最后一次提交的值
+    uint64_t submit();
+
+    bool isComplete(uint64_t value) const;
+    // 阻塞等待（只用于加载阶段，比如MeshArena整理之前）
+    void wait(uint64_t value);
+
+    /**
+     * @brief 同步完成所有上传，并在图形队列上获取所有权
+     *
+     * 返回时所有上传过的数据都可以在graphicsQueue上使用（包括被复制）。
+     * 要销毁或读取上传目标的代码（MeshArena::relocate）先调用这个。
+     */
+    void finish(VkQueue graphicsQueue, VkCommandPool graphicsPool);
+
+    // ---- 图形队列这一侧（Renderer每帧调用） ----
+
+    bool hasPendingAcquires() const { return !m_pendingAcquires.empty(); }
+    // 把已提交批次的获取屏障录制进cmd（必须在等待了getGraphicsWaitValue()的提交里执行）
+    void recordAcquires(VkCommandBuffer cmd);
+    // 这一帧的图形提交需要等待的值；上次调用之后没有新的提交时返回0
+    uint64_t takeGraphicsWaitValue();
+
+    VkSemaphore getSemaphore() const { return m_semaphore; }
+    uint64_t getSubmittedValue() const { return m_submittedValue; }
+    bool needsOwnershipTransfer() const { return m_queueFamily != m_graphicsFamily; }
+    const Stats& getStats() const { return m_stats; }
+
+    // ---- 只有整数运算、不碰Vulkan对象的部分（没有设备也能测试） ----
+
+    // 环形缓冲的占用：[tail, head)是已分配、所在批次还没完成的虚拟区间
+    struct RingSpace {
+        VkDeviceSize size = 0;      // 物理大小，COPY_ALIGNMENT的倍数
+        uint64_t head = 0;          // 下一次分配的位置
+        uint64_t tail = 0;          // 最早的未完成批次的起点
+
+        // 放得下就分配bytes字节（按COPY_ALIGNMENT对齐、不跨过缓冲末尾），返回物理偏移；
+        // 放不下返回false，head不变
+        bool tryAllocate(VkDeviceSize bytes, VkDeviceSize& offset);
+        bool isIdle() const { return head == tail; }
+        // 空闲时从下一个物理起点重新开始：绕回时跳过的末尾不再算占用
+        void restart();
+    };
+
+    struct Copy {
+        VkBuffer src;
+        VkBuffer dst;
+        VkBufferCopy region;
+    };
+
+    // 一次vkCmdCopyBuffer：regions里从firstRegion开始的regionCount个区域
+    struct CopyCommand {
+        VkBuffer src;
+        VkBuffer dst;
+        uint32_t firstRegion;
+        uint32_t regionCount;
+        bool barrierBefore;         // 前面有目标区域重叠的复制，先等它们写完
+    };
+
+    // 把一个批次的复制（按上传顺序）排成命令：按顺序切段，目标区域和段内已有的重叠时开新段；
+    // 段内相同源和目标的复制合并成一条命令
+    static void planCopies(const std::vector<Copy>& copies, std::vector<VkBufferCopy>& regions,
+                           std::vector<CopyCommand>& commands);
+
+private:
+
+    // 已提交、可能还没完成的批次
+    struct Batch {
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        uint64_t value = 0;
+        uint64_t ringEnd = 0;     // 完成后tail推进到这里
+        std::vector<std::unique_ptr<VulkanBuffer>> stagings;
+    };
+
+    // 在环形缓冲里分配size字节，返回物理偏移；空间不够时回收/等待已提交的批次
+    VkDeviceSize allocateRing(VkDeviceSize size);
+    // 回收所有已完成的批次
+    void reclaim();
+    void flushRing(uint64_t begin, uint64_t end);
+    VkCommandBuffer acquireCommandBuffer();
+    // 复制之后的释放屏障，同时记下对应的获取屏障
+    void recordReleases(VkCommandBuffer cmd);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    uint32_t m_queueFamily = 0;
+    uint32_t m_graphicsFamily = 0;
+
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> m_freeCommandBuffers;
+    VkSemaphore m_semaphore = VK_NULL_HANDLE;   // timeline
+    uint64_t m_submittedValue = 0;
+    uint64_t m_graphicsWaitValue = 0;
+
+    VulkanBuffer m_ring;
+    uint8_t* m_ringMapped = nullptr;
+    RingSpace m_ringSpace;
+    uint64_t m_batchRingBegin = 0;  // 当前（未提交）批次在环形缓冲里的起点（虚拟偏移）
+
+    // 当前批次
+    std::vector<Copy> m_copies;
+    std::vector<std::unique_ptr<VulkanBuffer>> m_stagings;
+    // submit()复用
+    std::vector<VkBufferCopy> m_plannedRegions;
+    std::vector<CopyCommand> m_plannedCommands;
+
+    std::deque<Batch> m_batches;
+    std::vector<VkBufferMemoryBarrier> m_pendingAcquires;
+
+    Stats m_stats;
+};
+
+/**
+ * @brief createBufferWithData的异步版本
+ *
+ * 返回时数据只是排进了uploader，还没有复制。Renderer提交的帧会等待它，
+ * 所以直接在下一帧绘制是安全的；其他队列上使用要先检查返回的ticket。
+ */
+VulkanBuffer createBufferWithData(
+    VmaAllocator allocator,
+    VulkanUploader& uploader,
+    const void* data,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    uint64_t* ticket = nullptr
+);
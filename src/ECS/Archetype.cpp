@@ -0,0 +1,151 @@
+#include "ECS/Archetype.h"
+#include <algorithm>
+
+namespace {
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+Archetype::Archetype(std::vector<ComponentPool*> pools)
+    : m_pools(std::move(pools)) {
+    size_t rowBytes = 0;
+    for (ComponentPool* pool : m_pools) {
+        m_types.push_back(pool->getTypeID());
+        m_columnSizes.push_back(pool->getInfo().size);
+        rowBytes += pool->getInfo().size;
+    }
+
+    // Entities without components still need rows (for their entity list),
+    // but they never touch chunk memory.
+    if (rowBytes == 0) {
+        m_chunkCapacity = static_cast<uint32_t>(CHUNK_SIZE);
+        return;
+    }
+
+    m_chunkCapacity = static_cast<uint32_t>(std::max<size_t>(1, CHUNK_SIZE / rowBytes));
+
+    // Lay out one array per component inside the chunk
+    size_t offset = 0;
+    for (ComponentPool* pool : m_pools) {
+        offset = alignUp(offset, std::min(pool->getInfo().alignment, CHUNK_ALIGNMENT));
+        m_columnOffsets.push_back(offset);
+        offset += pool->getInfo().size * m_chunkCapacity;
+    }
+    m_chunkBytes = alignUp(offset, CHUNK_ALIGNMENT);
+}
+
+Archetype::~Archetype() {
+    // Destroy every live component (this is what makes NameComponent's string get freed)
+    for (uint32_t row = 0; row < size(); ++row) {
+        for (size_t column = 0; column < m_pools.size(); ++column) {
+            m_pools[column]->destroy(getComponent(static_cast<int>(column), row));
+        }
+    }
+
+    while (!m_chunks.empty()) {
+        releaseChunk();
+    }
+}
+
+int Archetype::findColumn(ComponentTypeID typeID) const {
+    // Component sets are small and sorted, binary search is cheaper than hashing
+    auto it = std::lower_bound(m_types.begin(), m_types.end(), typeID);
+    if (it != m_types.end() && *it == typeID) {
+        return static_cast<int>(it - m_types.begin());
+    }
+    return -1;
+}
+
+bool Archetype::hasAll(const ComponentTypeID* typeIDs, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        if (findColumn(typeIDs[i]) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Archetype::hasAny(const ComponentTypeID* typeIDs, size_t count) const {
+    for (size_t i = 0; i < count; ++i) {
+        if (findColumn(typeIDs[i]) >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t Archetype::allocateRow(Entity entity) {
+    uint32_t row = size();
+
+    // Grow by one chunk when the last one is full
+    if (m_chunkBytes > 0 && row / m_chunkCapacity >= m_chunks.size()) {
+        allocateChunk();
+    }
+
+    m_entities.push_back(entity);
+    return row;
+}
+
+Entity Archetype::removeRow(uint32_t row) {
+    uint32_t last = size() - 1;
+
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        ComponentPool* pool = m_pools[i];
+        int column = static_cast<int>(i);
+        void* hole = getComponent(column, row);
+        pool->destroy(hole);
+
+        if (row != last) {
+            void* tail = getComponent(column, last);
+            pool->moveConstruct(hole, tail);
+            pool->destroy(tail);
+        }
+    }
+
+    Entity moved = INVALID_ENTITY;
+    if (row != last) {
+        m_entities[row] = m_entities[last];
+        moved = m_entities[row];
+    }
+    m_entities.pop_back();
+
+    // Free trailing empty chunks, keeping one spare so an entity bouncing
+    // across a chunk boundary doesn't allocate/free every frame
+    while (m_chunks.size() > getChunkCount() + 1) {
+        releaseChunk();
+    }
+
+    return moved;
+}
+
+void Archetype::moveRowTo(uint32_t row, Archetype& dst, uint32_t dstRow) {
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        int dstColumn = dst.findColumn(m_types[i]);
+        if (dstColumn >= 0) {
+            m_pools[i]->moveConstruct(dst.getComponent(dstColumn, dstRow), getComponent(static_cast<int>(i), row));
+        }
+    }
+}
+
+uint32_t Archetype::getChunkRowCount(size_t chunk) const {
+    size_t begin = chunk * m_chunkCapacity;
+    return static_cast<uint32_t>(std::min<size_t>(m_chunkCapacity, m_entities.size() - begin));
+}
+
+void Archetype::allocateChunk() {
+    m_chunks.emplace_back(static_cast<std::byte*>(
+        ::operator new(m_chunkBytes, std::align_val_t(CHUNK_ALIGNMENT))));
+
+    for (ComponentPool* pool : m_pools) {
+        pool->onReserve(m_chunkCapacity);
+    }
+}
+
+void Archetype::releaseChunk() {
+    m_chunks.pop_back();
+
+    for (ComponentPool* pool : m_pools) {
+        pool->onRelease(m_chunkCapacity);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ECS/Entity.h"
+#include "ECS/ComponentPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Storage for all entities that share exactly the same component set
+ *
+ * Rows are packed into fixed-size chunks (~16 KB). Inside a chunk every
+ * component type has its own contiguous array (SoA), so iterating one
+ * component type over an archetype walks memory linearly:
+ *
+ *   Chunk 0: [Transform x N][Mesh x N][Material x N]
+ *   Chunk 1: [Transform x N][Mesh x N][Material x N]
+ *
+ * Row r lives in chunk (r / N) at slot (r % N). Removing a row moves the
+ * last row into the hole (swap-and-pop), so rows stay dense. Chunks that
+ * become empty are freed again (one spare is kept to avoid thrashing).
+ *
+ * Component lifetimes go through the type's ComponentPool, which also
+ * tracks how much chunk memory is reserved for that type.
+ *
+ * Archetypes are owned by ECS; you normally don't use this class directly.
+ */
+class Archetype {
+public:
+    static constexpr size_t CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+    // pools must be sorted by component type ID
+    explicit Archetype(std::vector<ComponentPool*> pools);
+    ~Archetype();
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    // Component set
+    const std::vector<ComponentTypeID>& getTypes() const { return m_types; }
+    const std::vector<ComponentPool*>& getPools() const { return m_pools; }
+    int findColumn(ComponentTypeID typeID) const;
+    bool hasAll(const ComponentTypeID* typeIDs, size_t count) const;
+    bool hasAny(const ComponentTypeID* typeIDs, size_t count) const;
+
+    // Row management
+    // allocateRow() returns a row whose component memory is uninitialised
+    uint32_t allocateRow(Entity entity);
+    // Destroys the row's components; returns the entity moved into 'row' (or INVALID_ENTITY)
+    Entity removeRow(uint32_t row);
+    // Move-constructs every component shared with 'dst' into dst's row
+    void moveRowTo(uint32_t row, Archetype& dst, uint32_t dstRow);
+
+    void* getComponent(int column, uint32_t row) {
+        return m_chunks[row / m_chunkCapacity].get() + m_columnOffsets[column] + (row % m_chunkCapacity) * m_columnSizes[column];
+    }
+
+    // Chunk iteration
+    size_t getChunkCount() const { return (m_entities.size() + m_chunkCapacity - 1) / m_chunkCapacity; }
+    uint32_t getChunkCapacity() const { return m_chunkCapacity; }
+    uint32_t getChunkRowCount(size_t chunk) const;
+    void* getColumnData(size_t chunk, int column) { return m_chunks[chunk].get() + m_columnOffsets[column]; }
+    const Entity* getChunkEntities(size_t chunk) const { return m_entities.data() + chunk * m_chunkCapacity; }
+
+    uint32_t size() const { return static_cast<uint32_t>(m_entities.size()); }
+    size_t getAllocatedChunkCount() const { return m_chunks.size(); }
+    size_t getAllocatedBytes() const { return m_chunks.size() * m_chunkBytes; }
+    const std::vector<Entity>& getEntities() const { return m_entities; }
+
+    // Archetype graph edges (cached transitions when adding/removing one component)
+    std::unordered_map<ComponentTypeID, Archetype*> addEdges;
+    std::unordered_map<ComponentTypeID, Archetype*> removeEdges;
+
+private:
+    struct ChunkDeleter {
+        void operator()(std::byte* ptr) const {
+            ::operator delete(ptr, std::align_val_t(CHUNK_ALIGNMENT));
+        }
+    };
+    using ChunkPtr = std::unique_ptr<std::byte, ChunkDeleter>;
+
+    void allocateChunk();
+    void releaseChunk();
+
+    std::vector<ComponentTypeID> m_types;
+    std::vector<ComponentPool*> m_pools;
+    std::vector<size_t> m_columnSizes;
+    std::vector<size_t> m_columnOffsets;
+
+    uint32_t m_chunkCapacity = 0;
+    size_t m_chunkBytes = 0;
+    std::vector<ChunkPtr> m_chunks;
+
+    // Row -> Entity
+    std::vector<Entity> m_entities;
+};
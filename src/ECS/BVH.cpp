@@ -0,0 +1,463 @@
+#include "ECS/BVH.h"
+#include <cfloat>
+
+namespace {
+    constexpr int BIN_COUNT = 16;
+
+    struct Bounds {
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+
+        void grow(const glm::vec3& point) {
+            min = glm::vec3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+            max = glm::vec3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+        }
+        void grow(const Bounds& other) {
+            grow(other.min);
+            grow(other.max);
+        }
+        float area() const {
+            if (min.x > max.x) return 0.0f;
+            glm::vec3 d(max.x - min.x, max.y - min.y, max.z - min.z);
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    // One pending subtree of the top-down build
+    struct BuildTask {
+        size_t begin;
+        size_t end;
+        int32_t node;
+    };
+}
+
+BVH::BVH(float margin)
+    : m_margin(margin) {
+}
+
+void BVH::clear() {
+    m_nodes.clear();
+    m_root = NULL_NODE;
+    m_freeList = NULL_NODE;
+    m_leafOf.clear();
+}
+
+int32_t BVH::allocateNode() {
+    int32_t index;
+    if (m_freeList != NULL_NODE) {
+        index = m_freeList;
+        m_freeList = m_nodes[index].parent;
+    } else {
+        index = static_cast<int32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.parent = NULL_NODE;
+    node.child1 = NULL_NODE;
+    node.child2 = NULL_NODE;
+    node.entity = INVALID_ENTITY;
+    node.height = 0;
+    return index;
+}
+
+void BVH::freeNode(int32_t index) {
+    m_nodes[index].parent = m_freeList;
+    m_nodes[index].height = -1;
+    m_freeList = index;
+}
+
+void BVH::setFatBounds(Node& node, const AABBComponent& bounds) const {
+    node.min = glm::vec3(bounds.min.x - m_margin, bounds.min.y - m_margin, bounds.min.z - m_margin);
+    node.max = glm::vec3(bounds.max.x + m_margin, bounds.max.y + m_margin, bounds.max.z + m_margin);
+}
+
+void BVH::setUnion(Node& node, int32_t a, int32_t b) {
+    const Node& nodeA = m_nodes[a];
+    const Node& nodeB = m_nodes[b];
+    node.min = glm::vec3(std::min(nodeA.min.x, nodeB.min.x), std::min(nodeA.min.y, nodeB.min.y), std::min(nodeA.min.z, nodeB.min.z));
+    node.max = glm::vec3(std::max(nodeA.max.x, nodeB.max.x), std::max(nodeA.max.y, nodeB.max.y), std::max(nodeA.max.z, nodeB.max.z));
+}
+
+void BVH::build(const std::vector<Entity>& entities, const std::vector<AABBComponent>& bounds) {
+    clear();
+    size_t count = entities.size();
+    if (count == 0) return;
+
+    // Leaves first (indices 0..count-1), then internal nodes in build order
+    m_nodes.reserve(count * 2 - 1);
+    m_leafOf.reserve(count);
+
+    std::vector<int32_t> leaves(count);
+    std::vector<glm::vec3> centroids(count);
+    for (size_t i = 0; i < count; ++i) {
+        int32_t leaf = allocateNode();
+        setFatBounds(m_nodes[leaf], bounds[i]);
+        m_nodes[leaf].entity = entities[i];
+        m_leafOf[entities[i]] = leaf;
+
+        leaves[i] = leaf;
+        centroids[leaf] = bounds[i].getCenter();
+    }
+
+    if (count == 1) {
+        m_root = leaves[0];
+        return;
+    }
+
+    // Iterative (a skewed split can't overflow the call stack). Each task
+    // owns leaves[begin, end) and an already allocated node to fill.
+    m_root = allocateNode();
+    std::vector<BuildTask> tasks;
+    tasks.push_back({ 0, count, m_root });
+
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        Bounds centroidBounds;
+        for (size_t i = task.begin; i < task.end; ++i) {
+            centroidBounds.grow(centroids[leaves[i]]);
+        }
+
+        // Split along the axis where centroids spread the most
+        glm::vec3 spread(centroidBounds.max.x - centroidBounds.min.x,
+                         centroidBounds.max.y - centroidBounds.min.y,
+                         centroidBounds.max.z - centroidBounds.min.z);
+        int axis = 0;
+        if (spread.y > spread[axis]) axis = 1;
+        if (spread.z > spread[axis]) axis = 2;
+
+        size_t middle = task.begin;
+        if (spread[axis] > 0.0f) {
+            // Binned SAH: cost(split) = leftCount * leftArea + rightCount * rightArea
+            float binScale = BIN_COUNT / spread[axis];
+            auto binOf = [&](int32_t leaf) {
+                int bin = static_cast<int>((centroids[leaf][axis] - centroidBounds.min[axis]) * binScale);
+                return std::min(bin, BIN_COUNT - 1);
+            };
+
+            Bounds binBounds[BIN_COUNT];
+            size_t binCounts[BIN_COUNT] = {};
+            for (size_t i = task.begin; i < task.end; ++i) {
+                const Node& leaf = m_nodes[leaves[i]];
+                int bin = binOf(leaves[i]);
+                binCounts[bin]++;
+                binBounds[bin].grow(leaf.min);
+                binBounds[bin].grow(leaf.max);
+            }
+
+            // Sweep from the right to get the right-side area of every split
+            float rightAreas[BIN_COUNT];
+            size_t rightCounts[BIN_COUNT];
+            Bounds right;
+            size_t rightCount = 0;
+            for (int bin = BIN_COUNT - 1; bin > 0; --bin) {
+                right.grow(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightAreas[bin] = right.area();
+                rightCounts[bin] = rightCount;
+            }
+
+            // Split k puts bins [0, k) left and [k, BIN_COUNT) right
+            Bounds left;
+            size_t leftCount = 0;
+            float bestCost = FLT_MAX;
+            int bestSplit = 0;
+            for (int split = 1; split < BIN_COUNT; ++split) {
+                left.grow(binBounds[split - 1]);
+                leftCount += binCounts[split - 1];
+                if (leftCount == 0 || rightCounts[split] == 0) continue;
+
+                float cost = leftCount * left.area() + rightCounts[split] * rightAreas[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = split;
+                }
+            }
+
+            if (bestSplit > 0) {
+                middle = std::partition(leaves.begin() + task.begin, leaves.begin() + task.end,
+                    [&](int32_t leaf) { return binOf(leaf) < bestSplit; }) - leaves.begin();
+            }
+        }
+
+        // All centroids in one bin (or identical): split in the middle
+        if (middle == task.begin || middle == task.end) {
+            middle = task.begin + (task.end - task.begin) / 2;
+        }
+
+        int32_t children[2];
+        size_t ranges[2][2] = { { task.begin, middle }, { middle, task.end } };
+        for (int side = 0; side < 2; ++side) {
+            size_t begin = ranges[side][0];
+            size_t end = ranges[side][1];
+            if (end - begin == 1) {
+                children[side] = leaves[begin];
+            } else {
+                children[side] = allocateNode();
+                tasks.push_back({ begin, end, children[side] });
+            }
+            m_nodes[children[side]].parent = task.node;
+        }
+        m_nodes[task.node].child1 = children[0];
+        m_nodes[task.node].child2 = children[1];
+    }
+
+    // Internal nodes were allocated parent-before-child, so walking them
+    // backwards fills in boxes and heights bottom-up
+    for (int32_t index = static_cast<int32_t>(m_nodes.size()) - 1; index >= static_cast<int32_t>(count); --index) {
+        Node& node = m_nodes[index];
+        setUnion(node, node.child1, node.child2);
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+    }
+}
+
+void BVH::insert(Entity entity, const AABBComponent& bounds) {
+    if (contains(entity)) {
+        update(entity, bounds);
+        return;
+    }
+
+    int32_t leaf = allocateNode();
+    setFatBounds(m_nodes[leaf], bounds);
+    m_nodes[leaf].entity = entity;
+    m_leafOf[entity] = leaf;
+    insertLeaf(leaf);
+}
+
+void BVH::remove(Entity entity) {
+    auto it = m_leafOf.find(entity);
+    if (it == m_leafOf.end()) return;
+
+    removeLeaf(it->second);
+    freeNode(it->second);
+    m_leafOf.erase(it);
+}
+
+bool BVH::update(Entity entity, const AABBComponent& bounds) {
+    auto it = m_leafOf.find(entity);
+    if (it == m_leafOf.end()) {
+        insert(entity, bounds);
+        return true;
+    }
+
+    int32_t leaf = it->second;
+    const Node& node = m_nodes[leaf];
+    if (node.min.x <= bounds.min.x && node.min.y <= bounds.min.y && node.min.z <= bounds.min.z &&
+        bounds.max.x <= node.max.x && bounds.max.y <= node.max.y && bounds.max.z <= node.max.z) {
+        return false;
+    }
+
+    removeLeaf(leaf);
+    setFatBounds(m_nodes[leaf], bounds);
+    insertLeaf(leaf);
+    return true;
+}
+
+void BVH::insertLeaf(int32_t leaf) {
+    if (m_root == NULL_NODE) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // Descend towards the sibling with the lowest SAH cost increase
+    glm::vec3 leafMin = m_nodes[leaf].min;
+    glm::vec3 leafMax = m_nodes[leaf].max;
+    auto unionArea = [&](const Node& node) {
+        return surfaceArea(
+            glm::vec3(std::min(node.min.x, leafMin.x), std::min(node.min.y, leafMin.y), std::min(node.min.z, leafMin.z)),
+            glm::vec3(std::max(node.max.x, leafMax.x), std::max(node.max.y, leafMax.y), std::max(node.max.z, leafMax.z)));
+    };
+
+    int32_t index = m_root;
+    while (!m_nodes[index].isLeaf()) {
+        const Node& node = m_nodes[index];
+        float area = surfaceArea(node.min, node.max);
+        float combinedArea = unionArea(node);
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // Every ancestor grows by at least this much if we go further down
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t childIndex) {
+            const Node& child = m_nodes[childIndex];
+            if (child.isLeaf()) {
+                return unionArea(child) + inheritanceCost;
+            }
+            return unionArea(child) - surfaceArea(child.min, child.max) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_nodes[sibling].parent;
+    int32_t newParent = allocateNode();
+
+    Node& parent = m_nodes[newParent];
+    parent.parent = oldParent;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    parent.height = m_nodes[sibling].height + 1;
+    setUnion(parent, sibling, leaf);
+
+    if (oldParent != NULL_NODE) {
+        Node& grandParent = m_nodes[oldParent];
+        if (grandParent.child1 == sibling) grandParent.child1 = newParent;
+        else grandParent.child2 = newParent;
+    } else {
+        m_root = newParent;
+    }
+    m_nodes[sibling].parent = newParent;
+    m_nodes[leaf].parent = newParent;
+
+    refitUpwards(newParent);
+}
+
+void BVH::removeLeaf(int32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = m_nodes[leaf].parent;
+    int32_t grandParent = m_nodes[parent].parent;
+    int32_t sibling = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    // The sibling takes the parent's place
+    if (grandParent != NULL_NODE) {
+        Node& node = m_nodes[grandParent];
+        if (node.child1 == parent) node.child1 = sibling;
+        else node.child2 = sibling;
+        m_nodes[sibling].parent = grandParent;
+        freeNode(parent);
+        refitUpwards(grandParent);
+    } else {
+        m_root = sibling;
+        m_nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void BVH::refitUpwards(int32_t index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = m_nodes[index];
+        node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+        setUnion(node, node.child1, node.child2);
+
+        index = node.parent;
+    }
+}
+
+int32_t BVH::balance(int32_t indexA) {
+    Node& a = m_nodes[indexA];
+    if (a.isLeaf() || a.height < 2) {
+        return indexA;
+    }
+
+    int32_t indexB = a.child1;
+    int32_t indexC = a.child2;
+    Node& b = m_nodes[indexB];
+    Node& c = m_nodes[indexC];
+
+    // Replaces A with its child 'up' in A's parent
+    auto replaceInParent = [&](Node& up, int32_t indexUp) {
+        up.parent = a.parent;
+        a.parent = indexUp;
+        if (up.parent != NULL_NODE) {
+            Node& parent = m_nodes[up.parent];
+            if (parent.child1 == indexA) parent.child1 = indexUp;
+            else parent.child2 = indexUp;
+        } else {
+            m_root = indexUp;
+        }
+    };
+
+    int32_t heightDifference = c.height - b.height;
+
+    // C is too deep: rotate C up
+    if (heightDifference > 1) {
+        int32_t indexF = c.child1;
+        int32_t indexG = c.child2;
+        Node& f = m_nodes[indexF];
+        Node& g = m_nodes[indexG];
+
+        c.child1 = indexA;
+        replaceInParent(c, indexC);
+
+        // The taller grandchild stays under C, the shorter one moves to A
+        if (f.height > g.height) {
+            c.child2 = indexF;
+            a.child2 = indexG;
+            g.parent = indexA;
+            setUnion(a, indexB, indexG);
+            setUnion(c, indexA, indexF);
+            a.height = 1 + std::max(b.height, g.height);
+            c.height = 1 + std::max(a.height, f.height);
+        } else {
+            c.child2 = indexG;
+            a.child2 = indexF;
+            f.parent = indexA;
+            setUnion(a, indexB, indexF);
+            setUnion(c, indexA, indexG);
+            a.height = 1 + std::max(b.height, f.height);
+            c.height = 1 + std::max(a.height, g.height);
+        }
+        return indexC;
+    }
+
+    // B is too deep: rotate B up
+    if (heightDifference < -1) {
+        int32_t indexD = b.child1;
+        int32_t indexE = b.child2;
+        Node& d = m_nodes[indexD];
+        Node& e = m_nodes[indexE];
+
+        b.child1 = indexA;
+        replaceInParent(b, indexB);
+
+        if (d.height > e.height) {
+            b.child2 = indexD;
+            a.child1 = indexE;
+            e.parent = indexA;
+            setUnion(a, indexC, indexE);
+            setUnion(b, indexA, indexD);
+            a.height = 1 + std::max(c.height, e.height);
+            b.height = 1 + std::max(a.height, d.height);
+        } else {
+            b.child2 = indexE;
+            a.child1 = indexD;
+            d.parent = indexA;
+            setUnion(a, indexC, indexD);
+            setUnion(b, indexA, indexE);
+            a.height = 1 + std::max(c.height, d.height);
+            b.height = 1 + std::max(a.height, e.height);
+        }
+        return indexB;
+    }
+
+    return indexA;
+}
+
+float BVH::getAreaRatio() const {
+    if (m_root == NULL_NODE) return 0.0f;
+
+    float rootArea = surfaceArea(m_nodes[m_root].min, m_nodes[m_root].max);
+    if (rootArea <= 0.0f) return 0.0f;
+
+    float totalArea = 0.0f;
+    for (const Node& node : m_nodes) {
+        if (node.height > 0) {
+            totalArea += surfaceArea(node.min, node.max);
+        }
+    }
+    return totalArea / rootArea;
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "ECS/Entity.h"
+#include "ECS/Components.h"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Dynamic bounding volume hierarchy over entity AABBs
+ *
+ * A binary tree with one entity per leaf. All nodes live in one flat
+ * array and refer to each other by index (48 bytes per node, freed nodes
+ * are recycled), so traversal never chases heap pointers.
+ *
+ * - build(): top-down binned SAH build, for (re)creating the whole tree
+ * - insert()/remove(): incremental; insertion descends by SAH cost and
+ *   the path back up is rebalanced with tree rotations
+ * - update(): leaves store a "fat" box (the entity's box grown by a
+ *   margin). Moving inside the fat box costs nothing; leaving it
+ *   re-inserts the leaf. Internal boxes are refit on the way up.
+ *
+ * Queries visit O(log n) nodes for small query regions:
+ *   bvh.queryAABB(box, [](Entity e) { ... });
+ *   bvh.queryFrustum(frustum.planes, [](Entity e) { ... });
+ *   bvh.raycast(origin, dir, maxDistance, [](Entity e, float entry) { return maxDistance; });
+ *
+ * Results are tested against fat boxes, so they are conservative: an
+ * entity up to 'margin' outside the query can be reported. Callers that
+ * need exact answers test the reported entities themselves.
+ */
+class BVH {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    struct Node {
+        glm::vec3 min;
+        int32_t parent;     // or next free node while on the free list
+        glm::vec3 max;
+        int32_t child1;     // NULL_NODE for leaves
+        Entity entity;      // leaves only
+        int32_t child2;
+        int32_t height;     // leaves are 0
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    explicit BVH(float margin = 0.1f);
+
+    // Replace the whole tree with a SAH build over these entities
+    void build(const std::vector<Entity>& entities, const std::vector<AABBComponent>& bounds);
+    void clear();
+
+    void insert(Entity entity, const AABBComponent& bounds);
+    void remove(Entity entity);
+    // Returns true if the entity left its fat box and was re-inserted
+    bool update(Entity entity, const AABBComponent& bounds);
+    bool contains(Entity entity) const { return m_leafOf.count(entity) != 0; }
+
+    // func(Entity) for every entity whose fat box overlaps 'box'
+    template<typename Func>
+    void queryAABB(const AABBComponent& box, Func&& func) const;
+
+    // func(Entity) for every entity whose fat box is not fully outside one of the
+    // planes. Planes are (normal, d) with normals pointing inwards.
+    template<typename Func>
+    void queryFrustum(const glm::vec4 planes[6], Func&& func) const;
+
+    // func(Entity, float entryDistance) -> float for every fat box the ray enters
+    // within maxDistance, roughly nearest first. Return maxDistance to keep going,
+    // a smaller value to clip the ray (closest hit), or 0 to stop.
+    template<typename Func>
+    void raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Func&& func) const;
+
+    // Statistics
+    size_t size() const { return m_leafOf.size(); }
+    const std::vector<Node>& getNodes() const { return m_nodes; }
+    int32_t getRoot() const { return m_root; }
+    int32_t getHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+    // Sum of internal node surface areas / root surface area (lower = better tree)
+    float getAreaRatio() const;
+
+private:
+    // Small DFS stack; spills to the heap only for unusually deep trees
+    class TraversalStack {
+    public:
+        void push(int32_t value) {
+            if (m_size < INLINE_CAPACITY) m_inline[m_size] = value;
+            else m_overflow.push_back(value);
+            m_size++;
+        }
+        int32_t pop() {
+            m_size--;
+            if (m_size < INLINE_CAPACITY) return m_inline[m_size];
+            int32_t value = m_overflow.back();
+            m_overflow.pop_back();
+            return value;
+        }
+        bool empty() const { return m_size == 0; }
+
+    private:
+        static constexpr size_t INLINE_CAPACITY = 128;
+        int32_t m_inline[INLINE_CAPACITY];
+        std::vector<int32_t> m_overflow;
+        size_t m_size = 0;
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t index);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    // Walks from 'index' to the root, rebalancing and refitting boxes
+    void refitUpwards(int32_t index);
+    int32_t balance(int32_t index);
+
+    void setFatBounds(Node& node, const AABBComponent& bounds) const;
+    void setUnion(Node& node, int32_t a, int32_t b);
+
+    static float surfaceArea(const glm::vec3& min, const glm::vec3& max) {
+        glm::vec3 d(max.x - min.x, max.y - min.y, max.z - min.z);
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    std::vector<Node> m_nodes;
+    int32_t m_root = NULL_NODE;
+    int32_t m_freeList = NULL_NODE;
+    std::unordered_map<Entity, int32_t> m_leafOf;
+    float m_margin;
+};
+
+// Template implementations
+
+template<typename Func>
+void BVH::queryAABB(const AABBComponent& box, Func&& func) const {
+    if (m_root == NULL_NODE) return;
+
+    TraversalStack stack;
+    stack.push(m_root);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.pop()];
+        if (node.max.x < box.min.x || node.min.x > box.max.x ||
+            node.max.y < box.min.y || node.min.y > box.max.y ||
+            node.max.z < box.min.z || node.min.z > box.max.z) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            func(node.entity);
+        } else {
+            stack.push(node.child1);
+            stack.push(node.child2);
+        }
+    }
+}
+
+template<typename Func>
+void BVH::queryFrustum(const glm::vec4 planes[6], Func&& func) const {
+    if (m_root == NULL_NODE) return;
+
+    // Low bit of a stack entry = "already known to be fully inside", so the
+    // whole subtree is reported without testing any more planes
+    TraversalStack stack;
+    stack.push(m_root << 1);
+    while (!stack.empty()) {
+        int32_t entry = stack.pop();
+        const Node& node = m_nodes[entry >> 1];
+        bool inside = (entry & 1) != 0;
+
+        if (!inside) {
+            glm::vec3 center((node.min.x + node.max.x) * 0.5f, (node.min.y + node.max.y) * 0.5f, (node.min.z + node.max.z) * 0.5f);
+            glm::vec3 extents(node.max.x - center.x, node.max.y - center.y, node.max.z - center.z);
+
+            bool outside = false;
+            inside = true;
+            for (int i = 0; i < 6; ++i) {
+                const glm::vec4& plane = planes[i];
+                float dist = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+                float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+                if (dist + radius < 0.0f) {
+                    outside = true;
+                    break;
+                }
+                if (dist - radius < 0.0f) {
+                    inside = false;
+                }
+            }
+            if (outside) continue;
+        }
+
+        if (node.isLeaf()) {
+            func(node.entity);
+        } else {
+            stack.push((node.child1 << 1) | (inside ? 1 : 0));
+            stack.push((node.child2 << 1) | (inside ? 1 : 0));
+        }
+    }
+}
+
+template<typename Func>
+void BVH::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Func&& func) const {
+    if (m_root == NULL_NODE) return;
+
+    glm::vec3 inverse(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+    // Slab test; returns the entry distance, or a negative value on a miss
+    auto entryDistance = [&](const Node& node) {
+        float tx1 = (node.min.x - origin.x) * inverse.x, tx2 = (node.max.x - origin.x) * inverse.x;
+        float ty1 = (node.min.y - origin.y) * inverse.y, ty2 = (node.max.y - origin.y) * inverse.y;
+        float tz1 = (node.min.z - origin.z) * inverse.z, tz2 = (node.max.z - origin.z) * inverse.z;
+        float tNear = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f });
+        float tFar = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxDistance });
+        return tNear <= tFar ? tNear : -1.0f;
+    };
+
+    TraversalStack stack;
+    stack.push(m_root);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.pop()];
+        float entry = entryDistance(node);
+        if (entry < 0.0f) continue;
+
+        if (node.isLeaf()) {
+            maxDistance = func(node.entity, entry);
+            if (maxDistance <= 0.0f) return;
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is visited first
+        float entry1 = entryDistance(m_nodes[node.child1]);
+        float entry2 = entryDistance(m_nodes[node.child2]);
+        if (entry1 >= 0.0f && entry2 >= 0.0f) {
+            stack.push(entry1 <= entry2 ? node.child2 : node.child1);
+            stack.push(entry1 <= entry2 ? node.child1 : node.child2);
+        } else if (entry1 >= 0.0f) {
+            stack.push(node.child1);
+        } else if (entry2 >= 0.0f) {
+            stack.push(node.child2);
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#include "ECS/ComponentPool.h"
+#include <algorithm>
+#include <atomic>
+
+namespace detail {
+    ComponentTypeID nextComponentTypeID() {
+        static std::atomic<ComponentTypeID> s_nextID{0};
+        return s_nextID++;
+    }
+}
+
+void ComponentPool::onReserve(size_t componentCount) {
+    m_reservedCount += componentCount;
+    m_peakReservedCount = std::max(m_peakReservedCount, m_reservedCount);
+}
+
+void ComponentPool::onRelease(size_t componentCount) {
+    m_reservedCount -= componentCount;
+}
+
+ComponentPool::Stats ComponentPool::getStats() const {
+    Stats stats;
+    stats.name = m_info.name;
+    stats.liveCount = m_liveCount;
+    stats.usedBytes = m_liveCount * m_info.size;
+    stats.reservedBytes = m_reservedCount * m_info.size;
+    stats.peakReservedBytes = m_peakReservedCount * m_info.size;
+    return stats;
+}
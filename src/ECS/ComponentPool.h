@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <typeinfo>
+#include <utility>
+
+using ComponentTypeID = uint32_t;
+
+/**
+ * @brief Type-erased description of a component type
+ *
+ * Archetype storage keeps components as raw bytes, so it needs to know
+ * how big a component is and how to move/destroy it without knowing T.
+ * One ComponentInfo exists per component type (see componentInfo<T>()).
+ */
+struct ComponentInfo {
+    ComponentTypeID id;
+    size_t size;
+    size_t alignment;
+    void (*copyConstruct)(void* dst, const void* src);
+    void (*moveConstruct)(void* dst, void* src);
+    void (*destroy)(void* ptr);
+    const char* name;
+};
+
+namespace detail {
+    ComponentTypeID nextComponentTypeID();
+}
+
+template<typename T>
+const ComponentInfo& componentInfo() {
+    static const ComponentInfo info = {
+        detail::nextComponentTypeID(),
+        sizeof(T),
+        alignof(T),
+        [](void* dst, const void* src) { new (dst) T(*static_cast<const T*>(src)); },
+        [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); },
+        [](void* ptr) { static_cast<T*>(ptr)->~T(); },
+        typeid(T).name()
+    };
+    return info;
+}
+
+template<typename T>
+ComponentTypeID componentTypeID() {
+    return componentInfo<T>().id;
+}
+
+/**
+ * @brief Per-component-type pool: lifetime operations + memory accounting
+ *
+ * The ECS owns one pool per component type. Every construct/move/destroy
+ * of a component goes through its pool, and archetypes report the chunk
+ * memory they reserve for the type, so the pool always knows:
+ * - how many components of this type are alive
+ * - how many bytes they use vs. how many bytes are reserved in chunks
+ *
+ * Only the component structs themselves are counted; heap memory owned by
+ * a component (e.g. NameComponent's std::string) is freed by its
+ * destructor but not tracked here.
+ */
+class ComponentPool {
+public:
+    struct Stats {
+        const char* name = nullptr;
+        size_t liveCount = 0;        // components currently alive
+        size_t usedBytes = 0;        // liveCount * sizeof(T)
+        size_t reservedBytes = 0;    // chunk memory reserved for this type
+        size_t peakReservedBytes = 0;
+    };
+
+    explicit ComponentPool(const ComponentInfo& info) : m_info(info) {}
+
+    ComponentPool(const ComponentPool&) = delete;
+    ComponentPool& operator=(const ComponentPool&) = delete;
+
+    const ComponentInfo& getInfo() const { return m_info; }
+    ComponentTypeID getTypeID() const { return m_info.id; }
+
+    // Lifetime operations (dst/ptr point into archetype chunk memory)
+    void copyConstruct(void* dst, const void* src) {
+        m_info.copyConstruct(dst, src);
+        ++m_liveCount;
+        ++m_layoutVersion;
+    }
+
+    void moveConstruct(void* dst, void* src) {
+        m_info.moveConstruct(dst, src);
+        ++m_liveCount;
+        ++m_layoutVersion;
+    }
+
+    void destroy(void* ptr) {
+        m_info.destroy(ptr);
+        --m_liveCount;
+        ++m_layoutVersion;
+    }
+
+    // Bumped by every construct/move/destroy above: while it stays the same,
+    // no component of this type was added, removed or moved to another row
+    uint64_t getLayoutVersion() const { return m_layoutVersion; }
+
+    // Chunk memory accounting (called by Archetype)
+    void onReserve(size_t componentCount);
+    void onRelease(size_t componentCount);
+
+    Stats getStats() const;
+
+private:
+    const ComponentInfo& m_info;
+
+    size_t m_liveCount = 0;
+    size_t m_reservedCount = 0;
+    size_t m_peakReservedCount = 0;
+    uint64_t m_layoutVersion = 0;
+};
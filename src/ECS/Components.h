@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ECS/Entity.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cmath>
 #include <string>
 
 // Forward declarations
@@ -9,13 +12,55 @@ class Mesh;
 class Material;
 
 /**
- * @brief Transform component - Position, Rotation, Scale
+ * @brief Transform component - Local position/rotation/scale plus cached world matrix
  *
- * Stores the transformation matrix for an entity.
- * You can extend this to store position/rotation/scale separately if needed.
+ * Local values are relative to 'parent' (or to the world for roots).
+ * TransformSystem turns them into 'transform', the world matrix used for
+ * rendering, once per frame - but only for entities whose local values
+ * changed or whose parent's world matrix changed.
+ *
+ * Change local values and the parent through the setters so the entity gets
+ * marked dirty; TransformSystem only looks for reparented nodes among dirty
+ * ones. The change takes effect on the next TransformSystem update.
  */
 struct TransformComponent {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+
+    Entity parent = INVALID_ENTITY;
+
+    // World matrix (written by TransformSystem)
     glm::mat4 transform = glm::mat4(1.0f);
+    // Bumped every time TransformSystem rewrites 'transform'
+    uint32_t version = 0;
+
+    // Local values changed since the last TransformSystem update
+    bool dirty = true;
+
+    void setPosition(const glm::vec3& value) { position = value; dirty = true; }
+    void setRotation(const glm::quat& value) { rotation = value; dirty = true; }
+    void setRotation(const glm::vec3& eulerRadians) { rotation = fromEuler(eulerRadians); dirty = true; }
+    void setScale(const glm::vec3& value) { scale = value; dirty = true; }
+    void setParent(Entity value) { parent = value; dirty = true; }
+
+    // T * R * S, written straight from the quaternion's rotation matrix
+    glm::mat4 getLocalMatrix() const {
+        glm::mat3 basis = glm::mat3_cast(rotation);
+        glm::mat4 mat(1.0f);
+        mat[0] = glm::vec4(basis[0] * scale.x, 0.0f);
+        mat[1] = glm::vec4(basis[1] * scale.y, 0.0f);
+        mat[2] = glm::vec4(basis[2] * scale.z, 0.0f);
+        mat[3] = glm::vec4(position, 1.0f);
+        return mat;
+    }
+
+    // Same rotation order as before quaternions: X, then Y, then Z (local axes)
+    static glm::quat fromEuler(const glm::vec3& eulerRadians) {
+        return glm::angleAxis(eulerRadians.x, glm::vec3(1, 0, 0))
+             * glm::angleAxis(eulerRadians.y, glm::vec3(0, 1, 0))
+             * glm::angleAxis(eulerRadians.z, glm::vec3(0, 0, 1));
+    }
 
     // Helper functions to build transform from components
     static glm::mat4 fromPositionRotationScale(
@@ -23,13 +68,11 @@ struct TransformComponent {
         const glm::vec3& rotation,  // Euler angles in radians
         const glm::vec3& scale
     ) {
-        glm::mat4 mat = glm::mat4(1.0f);
-        mat = glm::translate(mat, position);
-        mat = glm::rotate(mat, rotation.x, glm::vec3(1, 0, 0));
-        mat = glm::rotate(mat, rotation.y, glm::vec3(0, 1, 0));
-        mat = glm::rotate(mat, rotation.z, glm::vec3(0, 0, 1));
-        mat = glm::scale(mat, scale);
-        return mat;
+        TransformComponent local;
+        local.position = position;
+        local.rotation = fromEuler(rotation);
+        local.scale = scale;
+        return local.getLocalMatrix();
     }
 };
 
@@ -75,8 +118,8 @@ struct NameComponent {
 /**
  * @brief AABB component - Axis-Aligned Bounding Box
  *
- * Used for frustum culling and ray-casting picking.
- * You'll implement this in Phase 2.
+ * Local-space bounds of the entity (before its TransformComponent).
+ * Used for frustum culling, the scene BVH and ray-casting picking.
  */
 struct AABBComponent {
     glm::vec3 min = glm::vec3(-0.5f);
@@ -89,6 +132,24 @@ struct AABBComponent {
     glm::vec3 getExtents() const {
         return (max - min) * 0.5f;
     }
+
+    // Smallest AABB containing this box after 'matrix' (Arvo's method:
+    // the center is transformed, the extents go through |matrix|)
+    AABBComponent transformed(const glm::mat4& matrix) const {
+        glm::vec3 center = getCenter();
+        glm::vec3 extents = getExtents();
+
+        glm::vec3 worldCenter, worldExtents;
+        for (int i = 0; i < 3; ++i) {
+            worldCenter[i] = matrix[0][i] * center.x + matrix[1][i] * center.y + matrix[2][i] * center.z + matrix[3][i];
+            worldExtents[i] = std::abs(matrix[0][i]) * extents.x + std::abs(matrix[1][i]) * extents.y + std::abs(matrix[2][i]) * extents.z;
+        }
+
+        AABBComponent result;
+        result.min = worldCenter - worldExtents;
+        result.max = worldCenter + worldExtents;
+        return result;
+    }
 };
 
 // Future components you can add:
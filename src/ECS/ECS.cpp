@@ -2,45 +2,198 @@
 #include <algorithm>
 
 ECS::ECS() {
+    // Entities without components live in the empty archetype
+    m_emptyArchetype = getOrCreateArchetype({});
 }
 
 ECS::~ECS() {
-    // Clean up all components
-    for (auto& [entity, components] : m_components) {
-        for (auto& [typeID, componentPtr] : components) {
-            // We don't know the actual type here, so we can't properly delete
-            // In a production system, you'd store destructors alongside the data
-            // For now, this is a known limitation - components leak on ECS destruction
-            // (but the OS will clean up when the program exits)
-        }
-    }
+    // Archetypes destroy every remaining component through its pool,
+    // so they must go before the pools do.
+    m_archetypeIndex.clear();
+    m_archetypes.clear();
+    m_pools.clear();
 }
 
 Entity ECS::createEntity() {
-    Entity newEntity = m_nextEntityID++;
+    // Reuse a destroyed slot if there is one
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    EntityRecord& record = m_records[index];
+    Entity newEntity = makeEntity(index, record.generation);
+
+    record.archetype = m_emptyArchetype;
+    record.row = m_emptyArchetype->allocateRow(newEntity);
+    record.denseIndex = static_cast<uint32_t>(m_entities.size());
     m_entities.push_back(newEntity);
+    m_structureVersion++;
+
     return newEntity;
 }
 
 void ECS::destroyEntity(Entity entity) {
-    // Remove from entity list
-    auto it = std::find(m_entities.begin(), m_entities.end(), entity);
-    if (it != m_entities.end()) {
-        m_entities.erase(it);
-    }
+    EntityRecord* record = findRecord(entity);
+    if (!record) return;
 
-    // Clean up all components for this entity
-    auto compIt = m_components.find(entity);
-    if (compIt != m_components.end()) {
-        // Note: Proper deletion would require storing type information
-        // This is simplified for the learning framework
-        m_components.erase(compIt);
+    // Destroy all components for this entity
+    Entity moved = record->archetype->removeRow(record->row);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].row = record->row;
     }
 
-    // Remove from entity components tracking
-    m_entityComponents.erase(entity);
+    // Remove from entity list (swap with last)
+    Entity last = m_entities.back();
+    m_entities[record->denseIndex] = last;
+    m_records[entityIndex(last)].denseIndex = record->denseIndex;
+    m_entities.pop_back();
+
+    // Invalidate outstanding handles and recycle the slot
+    record->archetype = nullptr;
+    record->generation++;
+    if (record->generation == 0) {
+        record->generation = 1;
+    }
+    m_freeIndices.push_back(entityIndex(entity));
+    m_structureVersion++;
 }
 
 bool ECS::isEntityValid(Entity entity) const {
-    return std::find(m_entities.begin(), m_entities.end(), entity) != m_entities.end();
+    return findRecord(entity) != nullptr;
+}
+
+ECS::EntityRecord* ECS::findRecord(Entity entity) {
+    uint32_t index = entityIndex(entity);
+    if (index >= m_records.size()) {
+        return nullptr;
+    }
+
+    EntityRecord& record = m_records[index];
+    if (record.archetype == nullptr || record.generation != entityGeneration(entity)) {
+        return nullptr;
+    }
+    return &record;
+}
+
+const ECS::EntityRecord* ECS::findRecord(Entity entity) const {
+    return const_cast<ECS*>(this)->findRecord(entity);
+}
+
+ComponentPool* ECS::getOrCreatePool(const ComponentInfo& info) {
+    if (info.id >= m_pools.size()) {
+        m_pools.resize(info.id + 1);
+    }
+    if (!m_pools[info.id]) {
+        m_pools[info.id] = std::make_unique<ComponentPool>(info);
+    }
+    return m_pools[info.id].get();
+}
+
+std::vector<ComponentPool::Stats> ECS::getPoolStats() const {
+    std::vector<ComponentPool::Stats> stats;
+    for (const auto& pool : m_pools) {
+        if (pool) {
+            stats.push_back(pool->getStats());
+        }
+    }
+    return stats;
+}
+
+size_t ECS::getAllocatedChunkBytes() const {
+    size_t total = 0;
+    for (const auto& archetype : m_archetypes) {
+        total += archetype->getAllocatedBytes();
+    }
+    return total;
+}
+
+Archetype* ECS::getOrCreateArchetype(std::vector<ComponentPool*> pools) {
+    std::sort(pools.begin(), pools.end(),
+        [](const ComponentPool* a, const ComponentPool* b) { return a->getTypeID() < b->getTypeID(); });
+
+    std::vector<ComponentTypeID> key;
+    key.reserve(pools.size());
+    for (const ComponentPool* pool : pools) {
+        key.push_back(pool->getTypeID());
+    }
+
+    auto it = m_archetypeIndex.find(key);
+    if (it != m_archetypeIndex.end()) {
+        return it->second;
+    }
+
+    m_archetypes.push_back(std::make_unique<Archetype>(std::move(pools)));
+    Archetype* archetype = m_archetypes.back().get();
+    m_archetypeIndex.emplace(std::move(key), archetype);
+    return archetype;
+}
+
+Archetype* ECS::archetypeWith(Archetype* source, ComponentPool* pool) {
+    ComponentTypeID typeID = pool->getTypeID();
+    auto edge = source->addEdges.find(typeID);
+    if (edge != source->addEdges.end()) {
+        return edge->second;
+    }
+
+    std::vector<ComponentPool*> pools = source->getPools();
+    pools.push_back(pool);
+
+    Archetype* target = getOrCreateArchetype(std::move(pools));
+    source->addEdges[typeID] = target;
+    target->removeEdges[typeID] = source;
+    return target;
+}
+
+Archetype* ECS::archetypeWithout(Archetype* source, ComponentTypeID typeID) {
+    auto edge = source->removeEdges.find(typeID);
+    if (edge != source->removeEdges.end()) {
+        return edge->second;
+    }
+
+    std::vector<ComponentPool*> pools;
+    for (ComponentPool* pool : source->getPools()) {
+        if (pool->getTypeID() != typeID) {
+            pools.push_back(pool);
+        }
+    }
+
+    Archetype* target = getOrCreateArchetype(std::move(pools));
+    source->removeEdges[typeID] = target;
+    target->addEdges[typeID] = source;
+    return target;
+}
+
+uint32_t ECS::moveEntity(Entity entity, Archetype* target) {
+    EntityRecord& record = m_records[entityIndex(entity)];
+    Archetype* source = record.archetype;
+
+    uint32_t newRow = target->allocateRow(entity);
+    source->moveRowTo(record.row, *target, newRow);
+
+    // Destroys the moved-from components (and anything the target doesn't have)
+    Entity moved = source->removeRow(record.row);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].row = record.row;
+    }
+
+    record.archetype = target;
+    record.row = newRow;
+    m_structureVersion++;
+    return newRow;
+}
+
+std::vector<Entity> ECS::collectEntities(const ComponentTypeID* typeIDs, size_t count) const {
+    std::vector<Entity> result;
+    for (const auto& archetype : m_archetypes) {
+        if (archetype->size() > 0 && archetype->hasAll(typeIDs, count)) {
+            const auto& entities = archetype->getEntities();
+            result.insert(result.end(), entities.begin(), entities.end());
+        }
+    }
+    return result;
 }
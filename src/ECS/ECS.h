@@ -1,14 +1,12 @@
 #pragma once
 
+#include "ECS/Archetype.h"
 #include <cstdint>
 #include <vector>
-#include <unordered_map>
-#include <typeindex>
+#include <map>
 #include <memory>
-
-// Entity is just a unique ID
-using Entity = uint32_t;
-using ComponentTypeID = std::type_index;
+#include <tuple>
+#include <utility>
 
 /**
  * @brief Simple Entity-Component-System (ECS) implementation
@@ -18,14 +16,38 @@ using ComponentTypeID = std::type_index;
  * - Add new systems by creating classes that operate on components
  * - Query entities by component types
  *
- * The implementation uses a simple map-based storage. This can be
- * optimized later to use archetype-based or SoA storage if needed.
+ * Storage is archetype-based: entities with the same set of component
+ * types share one Archetype, which keeps their components in contiguous
+ * chunked SoA arrays (see Archetype.h). Adding or removing a component
+ * moves the entity to another archetype; lookups are an array index plus
+ * a tiny binary search instead of two hash lookups.
+ *
+ * Each component type has a ComponentPool that runs its constructors and
+ * destructors and counts its memory (getPoolStats()), so components are
+ * destroyed on removeComponent(), destroyEntity() and ECS teardown.
+ *
+ * Entities are generational handles (see Entity.h). Creating, destroying
+ * and validating an entity is O(1); destroyed slots are recycled through
+ * a free list, and handles to destroyed entities are rejected everywhere.
+ *
+ * Iterating:
+ *   ecs.view<TransformComponent, MeshComponent>().each(
+ *       [](Entity e, TransformComponent& t, MeshComponent& m) { ... });
+ *
+ * each() walks matching archetype chunks directly, so it allocates nothing
+ * and hands out component references without any per-entity lookup.
  */
+template<typename... Ts>
+class View;
+
 class ECS {
 public:
     ECS();
     ~ECS();
 
+    ECS(const ECS&) = delete;
+    ECS& operator=(const ECS&) = delete;
+
     // Entity management
     Entity createEntity();
     void destroyEntity(Entity entity);
@@ -48,127 +70,242 @@ public:
     bool hasComponent(Entity entity) const;
 
     // Query entities with specific components
-    template<typename T>
+    // (allocates a vector - prefer view<Ts...>().each() in per-frame code)
+    template<typename... Ts>
     std::vector<Entity> entitiesWith() const;
 
-    template<typename T1, typename T2>
-    std::vector<Entity> entitiesWith() const;
+    // Iterate entities with specific components, no allocation
+    template<typename... Ts>
+    View<Ts...> view() { return View<Ts...>(*this); }
 
-    template<typename T1, typename T2, typename T3>
-    std::vector<Entity> entitiesWith() const;
+    template<typename... Ts, typename Func>
+    void each(Func&& func) { view<Ts...>().each(std::forward<Func>(func)); }
 
-    // Get all entities
+    // Get all entities (order changes when entities are destroyed)
     const std::vector<Entity>& getAllEntities() const { return m_entities; }
+    size_t getEntityCount() const { return m_entities.size(); }
+
+    // Archetypes (for systems that want to iterate storage directly)
+    const std::vector<std::unique_ptr<Archetype>>& getArchetypes() const { return m_archetypes; }
+
+    // Memory statistics, one entry per component type that was ever added
+    template<typename T>
+    ComponentPool::Stats getPoolStats() const;
+    std::vector<ComponentPool::Stats> getPoolStats() const;
+    size_t getAllocatedChunkBytes() const;
+
+    // Bumped on every structural change (entity created/destroyed, component
+    // added/removed). Component pointers obtained while the version stays
+    // the same remain valid, so systems can cache them across frames.
+    uint64_t getStructureVersion() const { return m_structureVersion; }
+
+    // Same guarantee for one component type only: bumped when a T is added,
+    // removed, or moved because its entity changed archetype. Changes to
+    // entities without a T leave it alone.
+    template<typename T>
+    uint64_t getLayoutVersion() const;
 
 private:
-    uint32_t m_nextEntityID = 1;
+    // Entity slot: where the entity's components live
+    struct EntityRecord {
+        Archetype* archetype = nullptr;   // nullptr = slot is free
+        uint32_t row = 0;
+        uint32_t generation = 1;
+        uint32_t denseIndex = 0;          // position in m_entities
+    };
+
+    EntityRecord* findRecord(Entity entity);
+    const EntityRecord* findRecord(Entity entity) const;
+
+    ComponentPool* getOrCreatePool(const ComponentInfo& info);
+
+    Archetype* getOrCreateArchetype(std::vector<ComponentPool*> pools);
+    Archetype* archetypeWith(Archetype* source, ComponentPool* pool);
+    Archetype* archetypeWithout(Archetype* source, ComponentTypeID typeID);
+
+    // Moves the entity's row to 'target', returns the new row
+    uint32_t moveEntity(Entity entity, Archetype* target);
+
+    std::vector<Entity> collectEntities(const ComponentTypeID* typeIDs, size_t count) const;
+
+    // Live entities, densely packed
     std::vector<Entity> m_entities;
 
-    // Component storage: Entity -> (ComponentType -> Component*)
-    std::unordered_map<Entity, std::unordered_map<ComponentTypeID, void*>> m_components;
+    // Entity slots, indexed by entityIndex(); free slots are kept in m_freeIndices
+    std::vector<EntityRecord> m_records;
+    std::vector<uint32_t> m_freeIndices;
 
-    // Track which component types an entity has
-    std::unordered_map<Entity, std::vector<ComponentTypeID>> m_entityComponents;
+    // Component pools, indexed by ComponentTypeID (declared before the
+    // archetypes so they outlive them)
+    std::vector<std::unique_ptr<ComponentPool>> m_pools;
+
+    // All archetypes, plus lookup by (sorted) component set
+    std::vector<std::unique_ptr<Archetype>> m_archetypes;
+    std::map<std::vector<ComponentTypeID>, Archetype*> m_archetypeIndex;
+    Archetype* m_emptyArchetype = nullptr;
+
+    uint64_t m_structureVersion = 0;
 };
 
 // Template implementations
 
 template<typename T>
 void ECS::addComponent(Entity entity, const T& component) {
-    ComponentTypeID typeID = std::type_index(typeid(T));
+    EntityRecord* record = findRecord(entity);
+    if (!record) return;
 
-    // Allocate and copy component
-    T* componentPtr = new T(component);
-    m_components[entity][typeID] = componentPtr;
-    m_entityComponents[entity].push_back(typeID);
+    ComponentPool* pool = getOrCreatePool(componentInfo<T>());
+
+    // Already has this component: just overwrite it
+    int column = record->archetype->findColumn(pool->getTypeID());
+    if (column >= 0) {
+        *static_cast<T*>(record->archetype->getComponent(column, record->row)) = component;
+        return;
+    }
+
+    Archetype* target = archetypeWith(record->archetype, pool);
+    uint32_t row = moveEntity(entity, target);
+    pool->copyConstruct(target->getComponent(target->findColumn(pool->getTypeID()), row), &component);
 }
 
 template<typename T>
 void ECS::removeComponent(Entity entity) {
-    ComponentTypeID typeID = std::type_index(typeid(T));
-
-    auto entityIt = m_components.find(entity);
-    if (entityIt != m_components.end()) {
-        auto compIt = entityIt->second.find(typeID);
-        if (compIt != entityIt->second.end()) {
-            delete static_cast<T*>(compIt->second);
-            entityIt->second.erase(compIt);
-        }
-    }
+    EntityRecord* record = findRecord(entity);
+    if (!record) return;
+
+    ComponentTypeID typeID = componentTypeID<T>();
+    if (record->archetype->findColumn(typeID) < 0) return;
 
-    // Remove from entity component list
-    auto& compList = m_entityComponents[entity];
-    compList.erase(std::remove(compList.begin(), compList.end(), typeID), compList.end());
+    // The component is destroyed when the entity leaves its old archetype
+    moveEntity(entity, archetypeWithout(record->archetype, typeID));
 }
 
 template<typename T>
 T* ECS::getComponent(Entity entity) {
-    ComponentTypeID typeID = std::type_index(typeid(T));
+    EntityRecord* record = findRecord(entity);
+    if (!record) return nullptr;
 
-    auto entityIt = m_components.find(entity);
-    if (entityIt != m_components.end()) {
-        auto compIt = entityIt->second.find(typeID);
-        if (compIt != entityIt->second.end()) {
-            return static_cast<T*>(compIt->second);
-        }
-    }
-    return nullptr;
+    int column = record->archetype->findColumn(componentTypeID<T>());
+    if (column < 0) return nullptr;
+    return static_cast<T*>(record->archetype->getComponent(column, record->row));
 }
 
 template<typename T>
 const T* ECS::getComponent(Entity entity) const {
-    ComponentTypeID typeID = std::type_index(typeid(T));
-
-    auto entityIt = m_components.find(entity);
-    if (entityIt != m_components.end()) {
-        auto compIt = entityIt->second.find(typeID);
-        if (compIt != entityIt->second.end()) {
-            return static_cast<const T*>(compIt->second);
-        }
-    }
-    return nullptr;
+    return const_cast<ECS*>(this)->getComponent<T>(entity);
 }
 
 template<typename T>
 bool ECS::hasComponent(Entity entity) const {
-    ComponentTypeID typeID = std::type_index(typeid(T));
+    const EntityRecord* record = findRecord(entity);
+    return record && record->archetype->findColumn(componentTypeID<T>()) >= 0;
+}
 
-    auto entityIt = m_components.find(entity);
-    if (entityIt != m_components.end()) {
-        return entityIt->second.find(typeID) != entityIt->second.end();
+template<typename T>
+ComponentPool::Stats ECS::getPoolStats() const {
+    ComponentTypeID typeID = componentTypeID<T>();
+    if (typeID < m_pools.size() && m_pools[typeID]) {
+        return m_pools[typeID]->getStats();
     }
-    return false;
+
+    ComponentPool::Stats empty;
+    empty.name = componentInfo<T>().name;
+    return empty;
 }
 
 template<typename T>
-std::vector<Entity> ECS::entitiesWith() const {
-    std::vector<Entity> result;
-    for (Entity entity : m_entities) {
-        if (hasComponent<T>(entity)) {
-            result.push_back(entity);
-        }
+uint64_t ECS::getLayoutVersion() const {
+    ComponentTypeID typeID = componentTypeID<T>();
+    if (typeID < m_pools.size() && m_pools[typeID]) {
+        return m_pools[typeID]->getLayoutVersion();
     }
-    return result;
+    return 0;
 }
 
-template<typename T1, typename T2>
+template<typename... Ts>
 std::vector<Entity> ECS::entitiesWith() const {
-    std::vector<Entity> result;
-    for (Entity entity : m_entities) {
-        if (hasComponent<T1>(entity) && hasComponent<T2>(entity)) {
-            result.push_back(entity);
+    static_assert(sizeof...(Ts) > 0, "entitiesWith() needs at least one component type");
+    const ComponentTypeID typeIDs[] = { componentTypeID<Ts>()... };
+    return collectEntities(typeIDs, sizeof...(Ts));
+}
+
+/**
+ * @brief Lightweight query over all entities that have every component in Ts
+ *
+ * A View is just a reference to the ECS; creating one costs nothing.
+ * Don't add/remove components or destroy entities inside each() - that
+ * moves rows between archetypes while they are being iterated.
+ *
+ * exclude<Us...>() skips entities that also have any of Us:
+ *   ecs.view<MeshComponent>().exclude<AABBComponent>().each(...);
+ */
+template<typename... Ts>
+class View {
+    static_assert(sizeof...(Ts) > 0, "View needs at least one component type");
+
+public:
+    static constexpr size_t MAX_EXCLUDED = 4;
+
+    explicit View(ECS& ecs) : m_ecs(&ecs) {}
+
+    // Returns a copy that skips entities with any of Us (replaces a previous exclude())
+    template<typename... Us>
+    View exclude() const {
+        static_assert(sizeof...(Us) <= MAX_EXCLUDED, "Too many excluded component types");
+        View result(*m_ecs);
+        ((result.m_excluded[result.m_excludedCount++] = componentTypeID<Us>()), ...);
+        return result;
+    }
+
+    // func(Entity, Ts&...)
+    template<typename Func>
+    void each(Func&& func) const {
+        const ComponentTypeID typeIDs[] = { componentTypeID<Ts>()... };
+
+        for (const auto& archetype : m_ecs->getArchetypes()) {
+            if (archetype->size() == 0 || !matches(*archetype, typeIDs)) {
+                continue;
+            }
+
+            const int columns[] = { archetype->findColumn(componentTypeID<Ts>())... };
+            for (size_t chunk = 0; chunk < archetype->getChunkCount(); ++chunk) {
+                eachInChunk(*archetype, chunk, columns, func, std::index_sequence_for<Ts...>{});
+            }
         }
     }
-    return result;
-}
 
-template<typename T1, typename T2, typename T3>
-std::vector<Entity> ECS::entitiesWith() const {
-    std::vector<Entity> result;
-    for (Entity entity : m_entities) {
-        if (hasComponent<T1>(entity) && hasComponent<T2>(entity) && hasComponent<T3>(entity)) {
-            result.push_back(entity);
+    // Number of matching entities
+    size_t count() const {
+        const ComponentTypeID typeIDs[] = { componentTypeID<Ts>()... };
+
+        size_t total = 0;
+        for (const auto& archetype : m_ecs->getArchetypes()) {
+            if (matches(*archetype, typeIDs)) {
+                total += archetype->size();
+            }
         }
+        return total;
     }
-    return result;
-}
+
+private:
+    template<typename Func, size_t... I>
+    static void eachInChunk(Archetype& archetype, size_t chunk, const int* columns, Func& func, std::index_sequence<I...>) {
+        // One base pointer per component array; the inner loop is pure pointer arithmetic
+        std::tuple<Ts*...> arrays(static_cast<Ts*>(archetype.getColumnData(chunk, columns[I]))...);
+        const Entity* entities = archetype.getChunkEntities(chunk);
+        uint32_t rowCount = archetype.getChunkRowCount(chunk);
+
+        for (uint32_t row = 0; row < rowCount; ++row) {
+            func(entities[row], std::get<I>(arrays)[row]...);
+        }
+    }
+
+    bool matches(const Archetype& archetype, const ComponentTypeID* typeIDs) const {
+        return archetype.hasAll(typeIDs, sizeof...(Ts))
+            && !archetype.hasAny(m_excluded, m_excludedCount);
+    }
+
+    ECS* m_ecs;
+    ComponentTypeID m_excluded[MAX_EXCLUDED] = {};
+    size_t m_excludedCount = 0;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Entity handle = slot index + generation
+ *
+ * Layout (64 bit):
+ *   [ generation : 32 ][ index : 32 ]
+ *
+ * - index: slot in the ECS entity table, recycled after destroyEntity()
+ * - generation: bumped every time the slot is recycled
+ *
+ * A handle kept after its entity was destroyed has an old generation, so
+ * the ECS detects it as stale instead of silently aliasing the new entity
+ * that reused the slot. Generations start at 1, so 0 is never a live handle.
+ */
+using Entity = uint64_t;
+
+constexpr Entity INVALID_ENTITY = 0;
+
+constexpr uint32_t entityIndex(Entity entity) {
+    return static_cast<uint32_t>(entity & 0xFFFFFFFFull);
+}
+
+constexpr uint32_t entityGeneration(Entity entity) {
+    return static_cast<uint32_t>(entity >> 32);
+}
+
+constexpr Entity makeEntity(uint32_t index, uint32_t generation) {
+    return (static_cast<Entity>(generation) << 32) | index;
+}
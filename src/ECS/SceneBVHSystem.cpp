@@ -0,0 +1,113 @@
+#include "ECS/SceneBVHSystem.h"
+#include "ECS/ECS.h"
+
+void SceneBVHSystem::declareAccess(SystemAccess& access) {
+    access.read<TransformComponent>()
+          .read<AABBComponent>();
+}
+
+void SceneBVHSystem::update(ECS& ecs, float) {
+    m_movedCount = 0;
+    m_reinsertedCount = 0;
+    m_pass++;
+    m_added.clear();
+
+    size_t seenTracked = 0;
+    ecs.view<TransformComponent, AABBComponent>().each(
+        [&](Entity entity, TransformComponent& transform, AABBComponent& bounds) {
+            uint32_t slot = entityIndex(entity);
+            if (slot >= m_proxies.size()) {
+                m_proxies.resize(slot + 1);
+            }
+
+            Proxy& proxy = m_proxies[slot];
+            if (proxy.entity != entity) {
+                // A destroyed entity's slot reused by a new one: drop the old one first
+                if (proxy.entity != INVALID_ENTITY) {
+                    untrack(proxy.entity);
+                }
+                m_added.push_back(Added{ entity, transform.version, bounds, bounds.transformed(transform.transform) });
+                return;
+            }
+
+            proxy.lastSeen = m_pass;
+            seenTracked++;
+            if (!hasChanged(proxy, transform, bounds)) return;
+
+            proxy.transformVersion = transform.version;
+            proxy.localBounds = bounds;
+            m_movedCount++;
+            if (m_bvh.update(entity, bounds.transformed(transform.transform))) {
+                m_reinsertedCount++;
+            }
+        });
+
+    // Tracked entities that were not seen left the query. Only scanned when
+    // the counts say something is missing.
+    if (seenTracked < m_tracked.size()) {
+        for (size_t i = m_tracked.size(); i-- > 0;) {
+            Entity entity = m_tracked[i];
+            if (m_proxies[entityIndex(entity)].lastSeen != m_pass) {
+                untrack(entity);
+            }
+        }
+    }
+
+    if (m_added.empty()) return;
+
+    // Mostly new content (first frame, level load): a SAH build beats n inserts
+    if (m_added.size() * 2 > m_tracked.size() + m_added.size()) {
+        rebuildTree(ecs);
+        return;
+    }
+
+    for (const Added& added : m_added) {
+        m_bvh.insert(added.entity, added.worldBounds);
+        track(added.entity, added.transformVersion, added.localBounds);
+    }
+}
+
+bool SceneBVHSystem::hasChanged(const Proxy& proxy, const TransformComponent& transform, const AABBComponent& bounds) const {
+    return transform.version != proxy.transformVersion
+        || bounds.min != proxy.localBounds.min
+        || bounds.max != proxy.localBounds.max;
+}
+
+void SceneBVHSystem::track(Entity entity, uint32_t transformVersion, const AABBComponent& localBounds) {
+    Proxy& proxy = m_proxies[entityIndex(entity)];
+    proxy.entity = entity;
+    proxy.transformVersion = transformVersion;
+    proxy.localBounds = localBounds;
+    proxy.lastSeen = m_pass;
+    proxy.trackedIndex = static_cast<uint32_t>(m_tracked.size());
+    m_tracked.push_back(entity);
+}
+
+void SceneBVHSystem::untrack(Entity entity) {
+    m_bvh.remove(entity);
+
+    // Swap-and-pop out of the dense list
+    Proxy& proxy = m_proxies[entityIndex(entity)];
+    Entity last = m_tracked.back();
+    m_tracked[proxy.trackedIndex] = last;
+    m_proxies[entityIndex(last)].trackedIndex = proxy.trackedIndex;
+    m_tracked.pop_back();
+    proxy.entity = INVALID_ENTITY;
+}
+
+void SceneBVHSystem::rebuildTree(ECS& ecs) {
+    std::vector<Entity> entities;
+    std::vector<AABBComponent> worldBounds;
+    entities.reserve(m_tracked.size() + m_added.size());
+    worldBounds.reserve(entities.capacity());
+
+    m_tracked.clear();
+    ecs.view<TransformComponent, AABBComponent>().each(
+        [&](Entity entity, TransformComponent& transform, AABBComponent& bounds) {
+            track(entity, transform.version, bounds);
+            entities.push_back(entity);
+            worldBounds.push_back(bounds.transformed(transform.transform));
+        });
+
+    m_bvh.build(entities, worldBounds);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ECS/System.h"
+#include "ECS/BVH.h"
+#include "ECS/Components.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Keeps a BVH of every entity with TransformComponent + AABBComponent
+ *
+ * The tree holds world-space bounds (AABBComponent::transformed() by the
+ * entity's world matrix). Register this after TransformSystem so it sees
+ * the current frame's matrices.
+ *
+ * Each update() walks the matching archetype chunks once (no cached
+ * component pointers, so structural changes elsewhere cost nothing):
+ * - Entities whose transform version or local AABB changed get
+ *   BVH::update() (free while they stay inside their fat box)
+ * - Entities seen for the first time are inserted; tracked entities that
+ *   were not seen (destroyed, or lost a component) are removed. Per-entity
+ *   state lives in an array indexed by entity slot, so a spawn or despawn
+ *   costs one BVH insert/remove, not a pass over the whole tree.
+ * - If most of the tree is new (first frame, level load) it is rebuilt with SAH
+ *
+ * Query it between frames (not while the scheduler is running):
+ *   system->getBVH().raycast(origin, dir, 100.0f, ...);
+ */
+class SceneBVHSystem : public ISystem {
+public:
+    const char* getName() const override { return "SceneBVHSystem"; }
+    void declareAccess(SystemAccess& access) override;
+    void update(ECS& ecs, float deltaTime) override;
+
+    const BVH& getBVH() const { return m_bvh; }
+
+    // Statistics from the last update
+    size_t getMovedCount() const { return m_movedCount; }
+    size_t getReinsertedCount() const { return m_reinsertedCount; }
+
+private:
+    // Tracking state of one entity, indexed by entityIndex()
+    struct Proxy {
+        Entity entity = INVALID_ENTITY;   // INVALID_ENTITY = slot not in the tree
+        uint32_t transformVersion = 0;
+        uint32_t trackedIndex = 0;        // position in m_tracked
+        uint64_t lastSeen = 0;            // m_pass of the last update that saw it
+        AABBComponent localBounds;        // copy, to notice edits of the component
+    };
+
+    bool hasChanged(const Proxy& proxy, const TransformComponent& transform, const AABBComponent& bounds) const;
+    void track(Entity entity, uint32_t transformVersion, const AABBComponent& localBounds);
+    void untrack(Entity entity);
+    void rebuildTree(ECS& ecs);
+
+    BVH m_bvh;
+    std::vector<Proxy> m_proxies;
+    std::vector<Entity> m_tracked;       // every entity in the tree, densely packed
+    uint64_t m_pass = 0;
+
+    // Per-frame scratch: entities seen for the first time
+    struct Added {
+        Entity entity;
+        uint32_t transformVersion;
+        AABBComponent localBounds;
+        AABBComponent worldBounds;
+    };
+    std::vector<Added> m_added;
+
+    size_t m_movedCount = 0;
+    size_t m_reinsertedCount = 0;
+};
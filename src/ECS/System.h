@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ECS/ComponentPool.h"
+#include <algorithm>
+#include <vector>
+
+class ECS;
+
+/**
+ * @brief Which component types a system reads and writes
+ *
+ * The scheduler uses this to decide which systems may run at the same time:
+ * two systems conflict if one writes a component the other reads or writes.
+ *
+ * Example:
+ *   void declareAccess(SystemAccess& access) override {
+ *       access.read<VelocityComponent>()
+ *             .write<TransformComponent>();
+ *   }
+ *
+ * Systems that create/destroy entities or add/remove components change
+ * archetype layout under everyone else's feet, so they must call exclusive().
+ */
+class SystemAccess {
+public:
+    template<typename T>
+    SystemAccess& read() {
+        add(m_reads, componentTypeID<T>());
+        return *this;
+    }
+
+    template<typename T>
+    SystemAccess& write() {
+        add(m_writes, componentTypeID<T>());
+        return *this;
+    }
+
+    // Run alone (structural ECS changes, or anything not expressible above)
+    SystemAccess& exclusive() {
+        m_exclusive = true;
+        return *this;
+    }
+
+    bool isExclusive() const { return m_exclusive; }
+    const std::vector<ComponentTypeID>& getReads() const { return m_reads; }
+    const std::vector<ComponentTypeID>& getWrites() const { return m_writes; }
+
+    bool conflictsWith(const SystemAccess& other) const {
+        if (m_exclusive || other.m_exclusive) return true;
+        return intersects(m_writes, other.m_writes)
+            || intersects(m_writes, other.m_reads)
+            || intersects(m_reads, other.m_writes);
+    }
+
+private:
+    static void add(std::vector<ComponentTypeID>& list, ComponentTypeID typeID) {
+        auto it = std::lower_bound(list.begin(), list.end(), typeID);
+        if (it == list.end() || *it != typeID) {
+            list.insert(it, typeID);
+        }
+    }
+
+    // Both lists are sorted
+    static bool intersects(const std::vector<ComponentTypeID>& a, const std::vector<ComponentTypeID>& b) {
+        auto ia = a.begin();
+        auto ib = b.begin();
+        while (ia != a.end() && ib != b.end()) {
+            if (*ia == *ib) return true;
+            if (*ia < *ib) ++ia; else ++ib;
+        }
+        return false;
+    }
+
+    std::vector<ComponentTypeID> m_reads;
+    std::vector<ComponentTypeID> m_writes;
+    bool m_exclusive = false;
+};
+
+/**
+ * @brief System interface - logic that runs over components every frame
+ *
+ * Extension:
+ * 1. Derive from ISystem
+ * 2. Declare component access in declareAccess()
+ * 3. Iterate components in update() (usually with ecs.view<...>().each())
+ * 4. Register with SystemScheduler::addSystem()
+ *
+ * update() may run on a worker thread, in parallel with other systems
+ * whose access doesn't conflict. Only touch the components you declared.
+ */
+class ISystem {
+public:
+    virtual ~ISystem() = default;
+
+    virtual const char* getName() const = 0;
+    virtual void declareAccess(SystemAccess& access) = 0;
+    virtual void update(ECS& ecs, float deltaTime) = 0;
+};
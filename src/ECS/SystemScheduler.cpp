@@ -0,0 +1,91 @@
+#include "ECS/SystemScheduler.h"
+#include "ECS/ECS.h"
+#include "Framework/JobSystem.h"
+
+SystemScheduler::SystemScheduler(JobSystem& jobSystem)
+    : m_jobSystem(jobSystem) {
+}
+
+SystemScheduler::~SystemScheduler() = default;
+
+ISystem* SystemScheduler::addSystem(std::unique_ptr<ISystem> system) {
+    auto node = std::make_unique<Node>();
+    system->declareAccess(node->access);
+    node->system = std::move(system);
+
+    m_nodes.push_back(std::move(node));
+    m_graphDirty = true;
+    return m_nodes.back()->system.get();
+}
+
+void SystemScheduler::buildGraph() {
+    for (auto& node : m_nodes) {
+        node->dependents.clear();
+        node->dependencyCount = 0;
+    }
+
+    // Earlier-registered system runs first when two systems conflict
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        for (size_t j = i + 1; j < m_nodes.size(); ++j) {
+            if (m_nodes[i]->access.conflictsWith(m_nodes[j]->access)) {
+                m_nodes[i]->dependents.push_back(j);
+                m_nodes[j]->dependencyCount++;
+            }
+        }
+    }
+
+    m_graphDirty = false;
+}
+
+void SystemScheduler::update(ECS& ecs, float deltaTime) {
+    if (m_nodes.empty()) return;
+    if (m_graphDirty) {
+        buildGraph();
+    }
+
+    JobCounter frameCounter;
+    m_frameCounter = &frameCounter;
+    m_ecs = &ecs;
+    m_deltaTime = deltaTime;
+    m_error = nullptr;
+
+    for (auto& node : m_nodes) {
+        node->remaining.store(node->dependencyCount, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i]->dependencyCount == 0) {
+            submit(i);
+        }
+    }
+
+    // The calling thread runs jobs until every system has finished
+    m_jobSystem.wait(frameCounter);
+
+    m_frameCounter = nullptr;
+    m_ecs = nullptr;
+    if (m_error) {
+        std::rethrow_exception(m_error);
+    }
+}
+
+void SystemScheduler::submit(size_t index) {
+    m_jobSystem.run([this, index]() {
+        Node& node = *m_nodes[index];
+
+        try {
+            node.system->update(*m_ecs, m_deltaTime);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+
+        // Submitted before this job completes, so the frame counter can't hit zero early
+        for (size_t dependent : node.dependents) {
+            if (m_nodes[dependent]->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                submit(dependent);
+            }
+        }
+    }, m_frameCounter);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ECS/System.h"
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ECS;
+class JobSystem;
+class JobCounter;
+
+/**
+ * @brief Runs ISystems every frame, in parallel where their access allows
+ *
+ * Ordering rule: if two systems conflict (see SystemAccess), the one added
+ * first runs first. Systems that don't conflict have no ordering and may
+ * run at the same time as jobs on the JobSystem.
+ *
+ * The dependency graph is rebuilt lazily after addSystem(). Each update():
+ * 1. Systems with no dependencies are submitted as jobs
+ * 2. Finishing a system submits each dependent whose inputs are all done
+ * 3. The calling thread helps run jobs until the whole frame is done
+ *
+ * An exception thrown by a system is rethrown from update() after the
+ * frame has drained.
+ */
+class SystemScheduler {
+public:
+    explicit SystemScheduler(JobSystem& jobSystem);
+    ~SystemScheduler();
+
+    SystemScheduler(const SystemScheduler&) = delete;
+    SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+    ISystem* addSystem(std::unique_ptr<ISystem> system);
+
+    template<typename T, typename... Args>
+    T* addSystem(Args&&... args) {
+        return static_cast<T*>(addSystem(std::make_unique<T>(std::forward<Args>(args)...)));
+    }
+
+    void update(ECS& ecs, float deltaTime);
+
+    size_t getSystemCount() const { return m_nodes.size(); }
+
+private:
+    struct Node {
+        std::unique_ptr<ISystem> system;
+        SystemAccess access;
+        std::vector<size_t> dependents;
+        uint32_t dependencyCount = 0;
+        std::atomic<uint32_t> remaining{0};
+    };
+
+    void buildGraph();
+    void submit(size_t index);
+
+    JobSystem& m_jobSystem;
+
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    bool m_graphDirty = false;
+
+    // Current frame
+    JobCounter* m_frameCounter = nullptr;
+    ECS* m_ecs = nullptr;
+    float m_deltaTime = 0.0f;
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+};
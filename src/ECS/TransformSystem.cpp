@@ -0,0 +1,181 @@
+#include "ECS/TransformSystem.h"
+#include "ECS/ECS.h"
+#include "Framework/TransformBatch.h"
+#include <algorithm>
+#include <unordered_map>
+
+void TransformSystem::declareAccess(SystemAccess& access) {
+    access.write<TransformComponent>();
+}
+
+void TransformSystem::update(ECS& ecs, float) {
+    // Component pointers are only valid while no transform was added, removed or moved
+    if (ecs.getLayoutVersion<TransformComponent>() != m_layoutVersion) {
+        rebuild(ecs);
+    }
+
+    // Pass 1: find the nodes to update and gather their local values.
+    // A reparented node changes the depth order: rebuild and gather again
+    // (the rebuild records the new parent, so the second pass succeeds)
+    if (!gatherChanged()) {
+        rebuild(ecs);
+        gatherChanged();
+    }
+    if (m_hasForced) {
+        std::fill(m_forced.begin(), m_forced.end(), 0);
+        m_hasForced = false;
+    }
+
+    // Pass 2: all local matrices in one SIMD batch
+    m_updatedCount = m_updateList.size();
+    m_localMatrices.resize(m_updatedCount);
+    TransformBatch::computeLocalMatrices(
+        m_positions.data(), m_rotations.data(), m_scales.data(), m_localMatrices.data(), m_updatedCount);
+
+    // Pass 3: world = parent.world * local, still in depth order
+    for (size_t k = 0; k < m_updatedCount; ++k) {
+        const Node& node = m_nodes[m_updateList[k]];
+        TransformComponent& transform = *node.transform;
+
+        if (node.parentIndex != NO_PARENT) {
+            TransformBatch::multiply(m_nodes[node.parentIndex].transform->transform, &m_localMatrices[k], &transform.transform, 1);
+        } else {
+            transform.transform = m_localMatrices[k];
+        }
+        transform.dirty = false;
+        transform.version++;
+    }
+}
+
+bool TransformSystem::gatherChanged() {
+    m_updateList.clear();
+    m_positions.clear();
+    m_rotations.clear();
+    m_scales.clear();
+
+    // Parents come first, so m_changed[parentIndex] is already final
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const Node& node = m_nodes[i];
+        const TransformComponent& transform = *node.transform;
+
+        // setParent() marks the node dirty: only dirty nodes can have been reparented
+        if (transform.dirty && transform.parent != node.parent) {
+            return false;
+        }
+
+        bool parentChanged = node.parentIndex != NO_PARENT && m_changed[node.parentIndex];
+        bool changed = transform.dirty || parentChanged || (m_hasForced && m_forced[i]);
+        m_changed[i] = changed ? 1 : 0;
+        if (!changed) continue;
+
+        m_updateList.push_back(static_cast<uint32_t>(i));
+        m_positions.push_back(transform.position);
+        m_rotations.push_back(transform.rotation);
+        m_scales.push_back(transform.scale);
+    }
+    return true;
+}
+
+void TransformSystem::rebuild(ECS& ecs) {
+    // Gather every transform
+    std::vector<Entity> entities;
+    std::vector<TransformComponent*> transforms;
+    ecs.view<TransformComponent>().each([&](Entity entity, TransformComponent& transform) {
+        entities.push_back(entity);
+        transforms.push_back(&transform);
+    });
+
+    uint32_t count = static_cast<uint32_t>(entities.size());
+    std::unordered_map<Entity, uint32_t> indexOf;
+    indexOf.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        indexOf.emplace(entities[i], i);
+    }
+
+    // Resolve parents; missing parents (destroyed, or without a transform) become roots
+    std::vector<uint32_t> parents(count, NO_PARENT);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto it = indexOf.find(transforms[i]->parent);
+        if (it != indexOf.end() && it->second != i) {
+            parents[i] = it->second;
+        }
+    }
+
+    // Depth of every node, walking each chain up only once
+    constexpr uint32_t UNKNOWN = UINT32_MAX;
+    constexpr uint32_t VISITING = UINT32_MAX - 1;
+    std::vector<uint32_t> depths(count, UNKNOWN);
+    std::vector<uint32_t> chain;
+    m_maxDepth = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        chain.clear();
+        uint32_t current = i;
+        while (current != NO_PARENT && depths[current] == UNKNOWN) {
+            depths[current] = VISITING;
+            chain.push_back(current);
+            current = parents[current];
+        }
+
+        uint32_t depth = 0;
+        if (current != NO_PARENT && depths[current] == VISITING) {
+            // Cycle: cut it at the topmost node of this chain
+            parents[chain.back()] = NO_PARENT;
+        } else if (current != NO_PARENT) {
+            depth = depths[current] + 1;
+        }
+
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            depths[*it] = depth++;
+        }
+        if (!chain.empty()) {
+            m_maxDepth = std::max(m_maxDepth, depths[chain.front()]);
+        }
+    }
+
+    // Counting sort by depth (stable, so siblings keep storage order)
+    std::vector<uint32_t> depthStart(m_maxDepth + 2, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        depthStart[depths[i] + 1]++;
+    }
+    for (size_t d = 1; d < depthStart.size(); ++d) {
+        depthStart[d] += depthStart[d - 1];
+    }
+
+    std::vector<uint32_t> sortedIndex(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        sortedIndex[i] = depthStart[depths[i]]++;
+    }
+
+    // Resolved parent of every node in the previous order. Nodes that are new,
+    // or whose parent resolves differently (reparented, parent destroyed,
+    // cycle cut), must be recomputed; the rest keep their world matrix
+    std::unordered_map<Entity, Entity> previousParent;
+    previousParent.reserve(m_nodes.size());
+    for (const Node& node : m_nodes) {
+        Entity parent = node.parentIndex != NO_PARENT ? m_nodes[node.parentIndex].entity : INVALID_ENTITY;
+        previousParent.emplace(node.entity, parent);
+    }
+
+    m_nodes.assign(count, Node{});
+    m_forced.assign(count, 0);
+    m_hasForced = false;
+    for (uint32_t i = 0; i < count; ++i) {
+        Node& node = m_nodes[sortedIndex[i]];
+        node.transform = transforms[i];
+        node.entity = entities[i];
+        node.parent = transforms[i]->parent;
+        node.parentIndex = parents[i] != NO_PARENT ? sortedIndex[parents[i]] : NO_PARENT;
+
+        Entity parent = parents[i] != NO_PARENT ? entities[parents[i]] : INVALID_ENTITY;
+        auto it = previousParent.find(entities[i]);
+        if (it == previousParent.end() || it->second != parent) {
+            m_forced[sortedIndex[i]] = 1;
+            m_hasForced = true;
+        }
+    }
+
+    m_changed.assign(count, 0);
+    m_layoutVersion = ecs.getLayoutVersion<TransformComponent>();
+    m_rebuildCount++;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ECS/System.h"
+#include "ECS/Components.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Computes world matrices for the transform hierarchy
+ *
+ * Every entity with a TransformComponent becomes a node. Nodes are kept in
+ * depth order (roots first, then their children, then grandchildren...),
+ * so parents are always finished before their children and one linear
+ * pass updates the whole hierarchy:
+ *
+ *   world = parent.world * local
+ *
+ * Only nodes that are dirty, or whose parent changed this frame, are
+ * recomputed; an unchanged subtree costs one flag check per node. The
+ * local matrices of all changed nodes are built in one TransformBatch
+ * call (SIMD), then combined with their parents in depth order.
+ *
+ * The order (and cached component pointers) is rebuilt when a
+ * TransformComponent is added, removed or moved between archetypes
+ * (ECS::getLayoutVersion<TransformComponent>()), or when a dirty node's
+ * parent changed (setParent() marks the node dirty, so clean nodes are
+ * never compared). Structural changes to entities without a transform,
+ * e.g. spawning particles or tagging lights, don't trigger a rebuild.
+ * A rebuild only refreshes the order: it recomputes nodes that are new or
+ * whose resolved parent changed, not the whole hierarchy, so spawning or
+ * adding an unrelated component does not bump every transform's version.
+ * A parent that no longer exists (or that would create a cycle) makes the
+ * node a root.
+ */
+class TransformSystem : public ISystem {
+public:
+    const char* getName() const override { return "TransformSystem"; }
+    void declareAccess(SystemAccess& access) override;
+    void update(ECS& ecs, float deltaTime) override;
+
+    // Statistics from the last update
+    size_t getNodeCount() const { return m_nodes.size(); }
+    size_t getUpdatedCount() const { return m_updatedCount; }
+    uint32_t getMaxDepth() const { return m_maxDepth; }
+    size_t getRebuildCount() const { return m_rebuildCount; }
+
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    struct Node {
+        TransformComponent* transform = nullptr;
+        Entity entity = INVALID_ENTITY;
+        Entity parent = INVALID_ENTITY;   // transform->parent when the order was built
+        uint32_t parentIndex = NO_PARENT; // index into m_nodes
+    };
+
+    // Fills m_updateList and the local values; returns false (and stops) if
+    // a dirty node was reparented, which needs a rebuild first
+    bool gatherChanged();
+    void rebuild(ECS& ecs);
+
+    std::vector<Node> m_nodes;
+    std::vector<uint8_t> m_changed;   // per node, world matrix changed this frame
+    std::vector<uint8_t> m_forced;    // per node, new or resolved parent changed in the last rebuild
+    bool m_hasForced = false;
+
+    // Per-frame scratch for the batched update (kept to avoid reallocating)
+    std::vector<uint32_t> m_updateList;
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    std::vector<glm::mat4> m_localMatrices;
+
+    uint64_t m_layoutVersion = UINT64_MAX;
+    size_t m_updatedCount = 0;
+    size_t m_rebuildCount = 0;
+    uint32_t m_maxDepth = 0;
+};
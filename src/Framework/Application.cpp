@@ -2,11 +2,24 @@
 #include "Framework/Window.h"
 #include "Framework/Camera.h"
 #include "Framework/Input.h"
+#include "Framework/JobSystem.h"
 #include "ECS/ECS.h"
+#include "ECS/SystemScheduler.h"
+#include "ECS/TransformSystem.h"
+#include "ECS/SceneBVHSystem.h"
+#include "Rendering/Picking.h"
+#include "Rendering/PickingPass.h"
+#include "Rendering/Renderer.h"
 #include "Core/VulkanContext.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <iostream>
 
+namespace {
+    // GPU拾取读取光标周围(2r+1)^2个像素，细小的物体也容易点中
+    constexpr uint32_t GPU_PICK_RADIUS = 2;
+}
+
 Application::Application(const Config& config)
     : m_config(config) {
 }
@@ -76,18 +89,27 @@ void Application::initialize() {
     );
     m_camera->setPosition(glm::vec3(0.0f, 0.0f, 3.0f));
 
-    // 4. 创建ECS
+    // 4. 创建作业系统（所有多线程工作的基础）
+    m_jobSystem = std::make_unique<JobSystem>();
+    std::cout << "Job system threads: " << m_jobSystem->getThreadCount() << std::endl;
+
+    // 5. 创建ECS
     std::cout << "Creating ECS..." << std::endl;
     m_ecs = std::make_unique<ECS>();
 
-    // 5. 初始化Vulkan（你需要实现这部分）
+    // 系统调度器（按组件读写声明并行运行系统）
+    m_systemScheduler = std::make_unique<SystemScheduler>(*m_jobSystem);
+    m_systemScheduler->addSystem<TransformSystem>();
+    m_sceneBVHSystem = m_systemScheduler->addSystem<SceneBVHSystem>();  // 在TransformSystem之后
+
+    // 6. 初始化Vulkan（你需要实现这部分）
     std::cout << "\n========================================" << std::endl;
     std::cout << "Initializing Vulkan..." << std::endl;
     std::cout << "========================================" << std::endl;
     m_vulkanContext = std::make_unique<VulkanContext>();
 
     try {
-        m_vulkanContext->initialize(m_window.get(), m_config.enableValidation);
+        m_vulkanContext->initialize(m_window.get(), m_config.enableValidation, m_config.pipelineCachePath);
         std::cout << "Vulkan initialized successfully!" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "Failed to initialize Vulkan: " << e.what() << std::endl;
@@ -103,12 +125,16 @@ void Application::cleanup() {
 
     // 清理顺序很重要！
     // Vulkan需要先清理（在ECS之前）
+    m_renderer = nullptr;
     if (m_vulkanContext) {
         m_vulkanContext->cleanup();
         m_vulkanContext.reset();
     }
 
+    m_sceneBVHSystem = nullptr;
+    m_systemScheduler.reset();
     m_ecs.reset();
+    m_jobSystem.reset();
     m_camera.reset();
     m_window.reset();
 
@@ -146,8 +172,13 @@ void Application::update(float deltaTime) {
     // 更新相机
     m_camera->update(deltaTime);
 
-    // TODO: 更新ECS系统
-    // TODO: 更新物理、动画等
+    // 更新ECS系统（互不冲突的系统在工作线程上并行执行）
+    m_systemScheduler->update(*m_ecs, deltaTime);
+
+    // GPU拾取的结果在请求之后一两帧才到
+    pollGPUPicks();
+
+    // TODO: 更新物理、动画等（实现为ISystem并注册到m_systemScheduler）
 }
 
 void Application::render() {
@@ -205,7 +236,65 @@ void Application::onMouseButton(int button, int action, int mods) {
         }
     }
 
-    // TODO: 左键用于对象拾取（Phase 2）
+    // 左键拾取（鼠标被捕获时是在转视角，不拾取）
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS && !m_window->isMouseCaptured()) {
+        pickAtCursor();
+    }
+}
+
+void Application::pickAtCursor() {
+    double x, y;
+    Input::getMousePosition(x, y);
+
+    // GPU拾取：只记下请求，下一帧渲染ID缓冲，结果由pollGPUPicks()取回
+    if (m_renderer && m_renderer->getPickingPass()) {
+        m_renderer->getPickingPass()->requestPick(
+            static_cast<uint32_t>(std::max(x, 0.0)),
+            static_cast<uint32_t>(std::max(y, 0.0)),
+            GPU_PICK_RADIUS
+        );
+        return;
+    }
+
+    Ray ray = Picker::screenPointToRay(
+        *m_camera,
+        static_cast<float>(x),
+        static_cast<float>(y),
+        static_cast<float>(m_window->getWidth()),
+        static_cast<float>(m_window->getHeight())
+    );
+
+    Picker::Hit hit;
+    bool found = Picker::pick(*m_ecs, m_sceneBVHSystem->getBVH(), ray, hit);
+    select(found ? hit.entity : INVALID_ENTITY);
+}
+
+void Application::pollGPUPicks() {
+    if (!m_renderer || !m_renderer->getPickingPass()) return;
+
+    PickingPass::Result result;
+    while (m_renderer->getPickingPass()->pollResult(result)) {
+        // pickID由创建实体的代码分配（非0且唯一）；只在点击时查找，逐个比较就够了
+        Entity picked = INVALID_ENTITY;
+        if (result.pickID != PickingPass::NO_PICK_ID) {
+            m_ecs->view<PickableComponent>().each([&](Entity entity, PickableComponent& pickable) {
+                if (pickable.pickID == result.pickID) picked = entity;
+            });
+        }
+        select(picked);
+    }
+}
+
+void Application::select(Entity entity) {
+    // 取消之前的选中
+    if (PickableComponent* previous = m_ecs->getComponent<PickableComponent>(m_selectedEntity)) {
+        previous->isSelected = false;
+    }
+    m_selectedEntity = entity;
+
+    if (PickableComponent* selected = m_ecs->getComponent<PickableComponent>(entity)) {
+        selected->isSelected = true;
+    }
 }
 
 void Application::onMouseMove(double xpos, double ypos) {
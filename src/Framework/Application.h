@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ECS/Entity.h"
 #include <memory>
 #include <string>
 
@@ -7,7 +8,11 @@
 class Window;
 class Camera;
 class ECS;
+class SystemScheduler;
+class SceneBVHSystem;
+class JobSystem;
 class VulkanContext;
+class Renderer;
 
 /**
  * @brief 主应用程序类 - 已为你实现
@@ -27,6 +32,8 @@ public:
         int windowHeight = 720;
         std::string windowTitle = "Vulkan Sandbox";
         bool enableValidation = true;
+        // 驱动编译好的管线保存在这里，下次启动不用重新编译（空 = 不保存）
+        std::string pipelineCachePath = "pipeline_cache.bin";
     };
 
     Application(const Config& config);
@@ -43,8 +50,16 @@ public:
     Window* getWindow() const { return m_window.get(); }
     Camera* getCamera() const { return m_camera.get(); }
     ECS* getECS() const { return m_ecs.get(); }
+    JobSystem* getJobSystem() const { return m_jobSystem.get(); }
+    SystemScheduler* getSystemScheduler() const { return m_systemScheduler.get(); }
+    SceneBVHSystem* getSceneBVHSystem() const { return m_sceneBVHSystem; }
     VulkanContext* getVulkanContext() const { return m_vulkanContext.get(); }
 
+    // 渲染器由实现render()的代码创建并持有（学习任务）。设置了并且调用过
+    // Renderer::enablePicking()时，左键用GPU拾取（结果一两帧后在update()里取回），
+    // 否则用CPU拾取。Renderer销毁前要设回nullptr
+    void setRenderer(Renderer* renderer) { m_renderer = renderer; }
+
 private:
     void initialize();
     void cleanup();
@@ -59,12 +74,23 @@ private:
     void onMouseMove(double xpos, double ypos);
     void onScroll(double xoffset, double yoffset);
 
+    void pickAtCursor();
+    // 取回GPU拾取已完成的结果，按pickID找到实体并选中
+    void pollGPUPicks();
+    void select(Entity entity);
+
     Config m_config;
 
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Camera> m_camera;
+    std::unique_ptr<JobSystem> m_jobSystem;
     std::unique_ptr<ECS> m_ecs;
+    std::unique_ptr<SystemScheduler> m_systemScheduler;
+    SceneBVHSystem* m_sceneBVHSystem = nullptr;  // 属于m_systemScheduler
     std::unique_ptr<VulkanContext> m_vulkanContext;
+    Renderer* m_renderer = nullptr;
+
+    Entity m_selectedEntity = INVALID_ENTITY;
 
     // 时间管理
     float m_lastFrameTime = 0.0f;
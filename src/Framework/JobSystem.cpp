@@ -0,0 +1,218 @@
+#include "Framework/JobSystem.h"
+#include <algorithm>
+
+namespace {
+    // 当前线程属于哪个JobSystem，以及在其中的编号
+    thread_local const JobSystem* t_owner = nullptr;
+    thread_local uint32_t t_threadIndex = 0;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    // 队列0属于主线程（以及其他外部线程）
+    for (uint32_t i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    for (uint32_t i = 1; i <= workerCount; ++i) {
+        m_workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop.store(true);
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::getCurrentThreadIndex() const {
+    return t_owner == this ? t_threadIndex : 0;
+}
+
+void JobSystem::run(JobFunction job, JobCounter* counter, JobCounter* dependency) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 依赖未完成：挂到依赖计数器上，等它归零时再入队
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+        if (dependency->m_pending.load(std::memory_order_acquire) > 0) {
+            dependency->m_continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+
+    push(Job{ std::move(job), counter });
+}
+
+void JobSystem::runBackground(JobFunction job, JobCounter* counter) {
+    if (counter) {
+        counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+        m_backgroundQueue.jobs.push_back(Job{ std::move(job), counter });
+    }
+    m_queuedJobs.fetch_add(1);
+    wakeWorker();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    uint32_t threadIndex = getCurrentThreadIndex();
+    while (!counter.isDone()) {
+        if (!tryExecuteOne(threadIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // finish()在锁内把计数减到0；拿一次锁保证它已经放手，之后调用者可以安全销毁counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void JobSystem::parallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& body) {
+    if (begin >= end) return;
+
+    uint32_t count = end - begin;
+    if (grainSize == 0) {
+        grainSize = std::max(1u, count / (getThreadCount() * 4));
+    }
+
+    // 只有一块时直接执行，省掉调度开销
+    if (count <= grainSize) {
+        body(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    // 用剩余长度算块尾，end接近UINT32_MAX时chunkBegin + grainSize不会回绕
+    for (uint32_t chunkBegin = begin; chunkBegin < end;) {
+        uint32_t chunkEnd = chunkBegin + std::min(grainSize, end - chunkBegin);
+        run([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); }, &counter);
+        chunkBegin = chunkEnd;
+    }
+    wait(counter);
+}
+
+void JobSystem::push(Job job) {
+    WorkQueue& queue = *m_queues[getCurrentThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_queuedJobs.fetch_add(1);
+    wakeWorker();
+}
+
+void JobSystem::wakeWorker() {
+    // 只有有人在睡觉时才需要加锁唤醒
+    if (m_sleepingWorkers.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.notify_one();
+    }
+}
+
+bool JobSystem::tryPop(uint32_t threadIndex, Job& job) {
+    WorkQueue& queue = *m_queues[threadIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    // 自己的队列：取最新的（LIFO）
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::trySteal(uint32_t threadIndex, Job& job) {
+    uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+    for (uint32_t offset = 1; offset < queueCount; ++offset) {
+        WorkQueue& victim = *m_queues[(threadIndex + offset) % queueCount];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.jobs.empty()) continue;
+
+        // 别人的队列：取最老的（FIFO）
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryPopBackground(Job& job) {
+    std::lock_guard<std::mutex> lock(m_backgroundQueue.mutex);
+    if (m_backgroundQueue.jobs.empty()) return false;
+
+    job = std::move(m_backgroundQueue.jobs.front());
+    m_backgroundQueue.jobs.pop_front();
+    return true;
+}
+
+bool JobSystem::tryExecuteOne(uint32_t threadIndex) {
+    Job job;
+    if (!tryPop(threadIndex, job) && !trySteal(threadIndex, job)) {
+        return false;
+    }
+
+    m_queuedJobs.fetch_sub(1);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job& job) {
+    job.function();
+    finish(job.counter);
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+
+    // 减计数和取走后续作业都在锁内完成：
+    // 计数一旦归零，等待者随时可能销毁counter，解锁之后就不能再碰它
+    std::vector<std::pair<JobFunction, JobCounter*>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        continuations.swap(counter->m_continuations);
+    }
+
+    // 计数归零：释放挂在它上面的作业
+    for (auto& [function, continuationCounter] : continuations) {
+        push(Job{ std::move(function), continuationCounter });
+    }
+}
+
+void JobSystem::workerLoop(uint32_t threadIndex) {
+    t_owner = this;
+    t_threadIndex = threadIndex;
+
+    while (!m_stop.load()) {
+        if (tryExecuteOne(threadIndex)) continue;
+
+        // 普通作业都做完了才取后台作业
+        Job job;
+        if (tryPopBackground(job)) {
+            m_queuedJobs.fetch_sub(1);
+            execute(job);
+            continue;
+        }
+
+        // 没有作业：睡眠直到有新作业或退出
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkers.fetch_add(1);
+        m_wakeCondition.wait(lock, [this]() {
+            return m_stop.load() || m_queuedJobs.load() > 0;
+        });
+        m_sleepingWorkers.fetch_sub(1);
+    }
+}
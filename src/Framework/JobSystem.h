@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * @brief 作业计数器 - 跟踪一组作业是否完成
+ *
+ * - run()时计数+1，作业执行完-1
+ * - JobSystem::wait(counter) 等待计数归零（等待期间调用线程会执行其他作业）
+ * - 作为依赖：run(job, &out, &dependency) 会在dependency归零后才执行job
+ *
+ * 计数器在wait()返回后才能复用。
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_pending{0};
+
+    // 等待本计数器归零的作业
+    std::mutex m_mutex;
+    std::vector<std::pair<std::function<void()>, JobCounter*>> m_continuations;
+};
+
+/**
+ * @brief Work-stealing作业系统 - 框架级线程服务
+ *
+ * 设计：
+ * - 每个线程（主线程 + N个工作线程）有自己的作业队列
+ * - 线程从自己队列的尾部取作业（LIFO，缓存友好）
+ * - 自己队列为空时，从其他线程队列的头部"偷"作业（FIFO，偷大块）
+ * - 主线程在wait()/parallelFor()里也会执行作业，不会空等
+ * - 没有作业时工作线程睡眠，不空转
+ *
+ * 使用方法：
+ *   JobCounter counter;
+ *   jobs.run([]{ ... }, &counter);
+ *   jobs.run([]{ ... }, &counter);
+ *   jobs.wait(counter);
+ *
+ *   jobs.parallelFor(0, count, 256, [&](uint32_t begin, uint32_t end) {
+ *       for (uint32_t i = begin; i < end; ++i) { ... }
+ *   });
+ *
+ * 后台作业（runBackground）：几十毫秒以上的长作业（管线编译等）。只有工作线程在
+ * 没有普通作业时才取它们，wait()/parallelFor()里等待的线程不会执行，
+ * 所以主线程每帧的wait()不会被一个长作业卡住。
+ *
+ * 作业不能抛异常（需要的话在作业内部捕获）。
+ */
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+    using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    // workerCount = 0 表示 (硬件线程数 - 1)，加上主线程正好占满所有核心
+    explicit JobSystem(uint32_t workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 提交作业；dependency不为空时，等它归零后才开始
+    void run(JobFunction job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // 提交后台作业：只由空闲的工作线程执行，不会在wait()里被执行
+    void runBackground(JobFunction job, JobCounter* counter = nullptr);
+
+    // 等待计数器归零（期间执行其他作业，不包括后台作业）
+    void wait(JobCounter& counter);
+
+    // 把[begin, end)切成grainSize大小的块并行执行，返回时全部完成
+    // grainSize = 0 时自动选择（约每线程4块）
+    void parallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeFunction& body);
+
+    // 线程数（包括主线程）
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(m_queues.size()); }
+
+    // 当前线程在本系统中的编号：0 = 主线程/外部线程，1..N = 工作线程
+    uint32_t getCurrentThreadIndex() const;
+
+private:
+    struct Job {
+        JobFunction function;
+        JobCounter* counter = nullptr;
+    };
+
+    // 每线程一个队列；偷取时会被其他线程访问，所以需要锁
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void push(Job job);
+    void wakeWorker();
+    bool tryPop(uint32_t threadIndex, Job& job);
+    bool trySteal(uint32_t threadIndex, Job& job);
+    bool tryPopBackground(Job& job);
+    bool tryExecuteOne(uint32_t threadIndex);
+    void execute(Job& job);
+    void finish(JobCounter* counter);
+    void workerLoop(uint32_t threadIndex);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    WorkQueue m_backgroundQueue;     // 后台作业，FIFO
+    std::vector<std::thread> m_workers;
+
+    // 睡眠/唤醒
+    std::atomic<uint32_t> m_queuedJobs{0};
+    std::atomic<uint32_t> m_sleepingWorkers{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_stop{false};
+};
@@ -0,0 +1,271 @@
+#include "Framework/TransformBatch.h"
+#include <glm/gtc/type_ptr.hpp>
+
+#if defined(__AVX2__)
+    #define TRANSFORM_BATCH_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TRANSFORM_BATCH_SSE 1
+#endif
+
+#if defined(TRANSFORM_BATCH_AVX2)
+    #include <immintrin.h>
+#elif defined(TRANSFORM_BATCH_SSE)
+    #include <xmmintrin.h>
+#endif
+
+namespace {
+    // glm::mat4是列主序：第c列从第4c个float开始，连续4个
+    float* columnData(glm::mat4& m) { return glm::value_ptr(m); }
+    const float* columnData(const glm::mat4& m) { return glm::value_ptr(m); }
+
+    // 标量版本：处理SIMD批次剩下的零头，以及没有SIMD的平台
+    void localMatrixScalar(const glm::vec3& p, const glm::quat& q, const glm::vec3& s, glm::mat4& out) {
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        float* o = columnData(out);
+        o[0]  = (1.0f - 2.0f * (yy + zz)) * s.x;
+        o[1]  = 2.0f * (xy + wz) * s.x;
+        o[2]  = 2.0f * (xz - wy) * s.x;
+        o[3]  = 0.0f;
+        o[4]  = 2.0f * (xy - wz) * s.y;
+        o[5]  = (1.0f - 2.0f * (xx + zz)) * s.y;
+        o[6]  = 2.0f * (yz + wx) * s.y;
+        o[7]  = 0.0f;
+        o[8]  = 2.0f * (xz + wy) * s.z;
+        o[9]  = 2.0f * (yz - wx) * s.z;
+        o[10] = (1.0f - 2.0f * (xx + yy)) * s.z;
+        o[11] = 0.0f;
+        o[12] = p.x;
+        o[13] = p.y;
+        o[14] = p.z;
+        o[15] = 1.0f;
+    }
+
+#if !defined(TRANSFORM_BATCH_SSE)
+    void multiplyScalar(const float* l, const float* r, float* o) {
+        for (int column = 0; column < 4; ++column) {
+            // 先读完这一列再写，允许 o == r
+            float r0 = r[column * 4 + 0], r1 = r[column * 4 + 1];
+            float r2 = r[column * 4 + 2], r3 = r[column * 4 + 3];
+            for (int row = 0; row < 4; ++row) {
+                o[column * 4 + row] = l[row] * r0 + l[4 + row] * r1 + l[8 + row] * r2 + l[12 + row] * r3;
+            }
+        }
+    }
+#endif
+
+#if defined(TRANSFORM_BATCH_SSE)
+    // 4个变换一组：每个分量各占一个__m128的一条lane，算完再转置成4个矩阵的列
+    void localMatrices4(const glm::vec3* p, const glm::quat* q, const glm::vec3* s, glm::mat4* out) {
+        __m128 qx = _mm_setr_ps(q[0].x, q[1].x, q[2].x, q[3].x);
+        __m128 qy = _mm_setr_ps(q[0].y, q[1].y, q[2].y, q[3].y);
+        __m128 qz = _mm_setr_ps(q[0].z, q[1].z, q[2].z, q[3].z);
+        __m128 qw = _mm_setr_ps(q[0].w, q[1].w, q[2].w, q[3].w);
+
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 zero = _mm_setzero_ps();
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        __m128 sx = _mm_setr_ps(s[0].x, s[1].x, s[2].x, s[3].x);
+        __m128 sy = _mm_setr_ps(s[0].y, s[1].y, s[2].y, s[3].y);
+        __m128 sz = _mm_setr_ps(s[0].z, s[1].z, s[2].z, s[3].z);
+
+        // 第0列
+        __m128 c0 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        __m128 c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        __m128 c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+        __m128 c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(columnData(out[0]) + 0, c0);
+        _mm_storeu_ps(columnData(out[1]) + 0, c1);
+        _mm_storeu_ps(columnData(out[2]) + 0, c2);
+        _mm_storeu_ps(columnData(out[3]) + 0, c3);
+
+        // 第1列
+        c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        c1 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+        c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(columnData(out[0]) + 4, c0);
+        _mm_storeu_ps(columnData(out[1]) + 4, c1);
+        _mm_storeu_ps(columnData(out[2]) + 4, c2);
+        _mm_storeu_ps(columnData(out[3]) + 4, c3);
+
+        // 第2列
+        c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        c2 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+        c3 = zero;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(columnData(out[0]) + 8, c0);
+        _mm_storeu_ps(columnData(out[1]) + 8, c1);
+        _mm_storeu_ps(columnData(out[2]) + 8, c2);
+        _mm_storeu_ps(columnData(out[3]) + 8, c3);
+
+        // 第3列：平移
+        c0 = _mm_setr_ps(p[0].x, p[1].x, p[2].x, p[3].x);
+        c1 = _mm_setr_ps(p[0].y, p[1].y, p[2].y, p[3].y);
+        c2 = _mm_setr_ps(p[0].z, p[1].z, p[2].z, p[3].z);
+        c3 = one;
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(columnData(out[0]) + 12, c0);
+        _mm_storeu_ps(columnData(out[1]) + 12, c1);
+        _mm_storeu_ps(columnData(out[2]) + 12, c2);
+        _mm_storeu_ps(columnData(out[3]) + 12, c3);
+    }
+#endif
+
+#if defined(TRANSFORM_BATCH_AVX2)
+    // 列数据不一定16字节对齐：先_mm_loadu_ps，再复制到两个128位lane
+    __m256 broadcastColumn(const float* column) {
+        __m128 v = _mm_loadu_ps(column);
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+    }
+
+    // 8个矩阵的同一列：每个128位lane内做4x4转置，低lane是out[0..3]的，高lane是out[4..7]的
+    void transposeStore8(__m256 c0, __m256 c1, __m256 c2, __m256 c3, glm::mat4* out, int offset) {
+        __m256 t0 = _mm256_unpacklo_ps(c0, c1);
+        __m256 t1 = _mm256_unpackhi_ps(c0, c1);
+        __m256 t2 = _mm256_unpacklo_ps(c2, c3);
+        __m256 t3 = _mm256_unpackhi_ps(c2, c3);
+        __m256 r[4] = {
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+            _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+            _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+        };
+        for (int k = 0; k < 4; ++k) {
+            _mm_storeu_ps(columnData(out[k]) + offset, _mm256_castps256_ps128(r[k]));
+            _mm_storeu_ps(columnData(out[k + 4]) + offset, _mm256_extractf128_ps(r[k], 1));
+        }
+    }
+
+    // 8个变换一组，和localMatrices4相同的算式（不用FMA，结果和SSE/标量版本一致）
+    void localMatrices8(const glm::vec3* p, const glm::quat* q, const glm::vec3* s, glm::mat4* out) {
+        #define TRANSFORM_BATCH_LANES(a, c) \
+            _mm256_setr_ps(a[0].c, a[1].c, a[2].c, a[3].c, a[4].c, a[5].c, a[6].c, a[7].c)
+
+        __m256 qx = TRANSFORM_BATCH_LANES(q, x), qy = TRANSFORM_BATCH_LANES(q, y);
+        __m256 qz = TRANSFORM_BATCH_LANES(q, z), qw = TRANSFORM_BATCH_LANES(q, w);
+        __m256 sx = TRANSFORM_BATCH_LANES(s, x), sy = TRANSFORM_BATCH_LANES(s, y), sz = TRANSFORM_BATCH_LANES(s, z);
+        __m256 px = TRANSFORM_BATCH_LANES(p, x), py = TRANSFORM_BATCH_LANES(p, y), pz = TRANSFORM_BATCH_LANES(p, z);
+
+        #undef TRANSFORM_BATCH_LANES
+
+        __m256 two = _mm256_set1_ps(2.0f);
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 zero = _mm256_setzero_ps();
+
+        __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+        __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+        __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+        // 第0列
+        transposeStore8(_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+                        zero, out, 0);
+        // 第1列
+        transposeStore8(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+                        _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+                        zero, out, 4);
+        // 第2列
+        transposeStore8(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+                        _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+                        _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+                        zero, out, 8);
+        // 第3列：平移
+        transposeStore8(px, py, pz, one, out, 12);
+    }
+#endif
+}
+
+void TransformBatch::computeLocalMatrices(
+    const glm::vec3* positions,
+    const glm::quat* rotations,
+    const glm::vec3* scales,
+    glm::mat4* out,
+    size_t count
+) {
+    size_t i = 0;
+#if defined(TRANSFORM_BATCH_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        localMatrices8(positions + i, rotations + i, scales + i, out + i);
+    }
+#endif
+#if defined(TRANSFORM_BATCH_SSE)
+    for (; i + 4 <= count; i += 4) {
+        localMatrices4(positions + i, rotations + i, scales + i, out + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        localMatrixScalar(positions[i], rotations[i], scales[i], out[i]);
+    }
+}
+
+void TransformBatch::multiply(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count) {
+    const float* l = columnData(lhs);
+
+#if defined(TRANSFORM_BATCH_AVX2)
+    // lhs的每一列复制到两个128位lane里，一次算结果的两列
+    __m256 l0 = broadcastColumn(l + 0);
+    __m256 l1 = broadcastColumn(l + 4);
+    __m256 l2 = broadcastColumn(l + 8);
+    __m256 l3 = broadcastColumn(l + 12);
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* r = columnData(rhs[i]);
+        float* o = columnData(out[i]);
+        for (int column = 0; column < 4; column += 2) {
+            // b = [r列j | r列j+1]，shuffle在每个lane内广播同一个元素
+            __m256 b = _mm256_loadu_ps(r + column * 4);
+            __m256 result = _mm256_mul_ps(l0, _mm256_shuffle_ps(b, b, 0x00));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l1, _mm256_shuffle_ps(b, b, 0x55)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l2, _mm256_shuffle_ps(b, b, 0xAA)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(l3, _mm256_shuffle_ps(b, b, 0xFF)));
+            _mm256_storeu_ps(o + column * 4, result);
+        }
+    }
+#elif defined(TRANSFORM_BATCH_SSE)
+    __m128 l0 = _mm_loadu_ps(l + 0);
+    __m128 l1 = _mm_loadu_ps(l + 4);
+    __m128 l2 = _mm_loadu_ps(l + 8);
+    __m128 l3 = _mm_loadu_ps(l + 12);
+
+    for (size_t i = 0; i < count; ++i) {
+        const float* r = columnData(rhs[i]);
+        float* o = columnData(out[i]);
+        for (int column = 0; column < 4; ++column) {
+            const float* rc = r + column * 4;
+            __m128 result = _mm_mul_ps(l0, _mm_set1_ps(rc[0]));
+            result = _mm_add_ps(result, _mm_mul_ps(l1, _mm_set1_ps(rc[1])));
+            result = _mm_add_ps(result, _mm_mul_ps(l2, _mm_set1_ps(rc[2])));
+            result = _mm_add_ps(result, _mm_mul_ps(l3, _mm_set1_ps(rc[3])));
+            _mm_storeu_ps(o + column * 4, result);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        multiplyScalar(l, columnData(rhs[i]), columnData(out[i]));
+    }
+#endif
+}
+
+const char* TransformBatch::getInstructionSet() {
+#if defined(TRANSFORM_BATCH_AVX2)
+    return "AVX2";
+#elif defined(TRANSFORM_BATCH_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+
+/**
+ * @brief 批量矩阵计算 - 一次处理一整批变换
+ *
+ * 输入是SoA：位置、旋转、缩放各是一个数组，
+ * 第i个变换 = (positions[i], rotations[i], scales[i])。
+ *
+ * 实现（编译期选择，结果一致）：
+ * - SSE（x64默认可用）：局部矩阵一次算4个；矩阵乘法每列4次广播乘加
+ * - AVX2（CMake选项ENABLE_AVX2）：局部矩阵一次算8个（零头用SSE）；矩阵乘法一次算两列
+ * - 其他平台：标量实现
+ *
+ * 数组不要求对齐。multiply()的out可以和rhs是同一个数组（原地计算）。
+ *
+ * 使用方法：
+ *   TransformBatch::computeLocalMatrices(positions, rotations, scales, models, count);
+ *   TransformBatch::multiply(viewProjection, models, mvps, count);
+ */
+class TransformBatch {
+public:
+    // out[i] = T(positions[i]) * R(rotations[i]) * S(scales[i])
+    static void computeLocalMatrices(
+        const glm::vec3* positions,
+        const glm::quat* rotations,
+        const glm::vec3* scales,
+        glm::mat4* out,
+        size_t count
+    );
+
+    // out[i] = lhs * rhs[i]（例如 MVP = VP * model，world = parentWorld * local）
+    static void multiply(const glm::mat4& lhs, const glm::mat4* rhs, glm::mat4* out, size_t count);
+
+    // 当前编译使用的指令集："AVX2" / "SSE" / "Scalar"
+    static const char* getInstructionSet();
+};
@@ -0,0 +1,126 @@
+#include "Rendering/DrawList.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+    constexpr uint64_t mask(uint32_t bits) {
+        return (uint64_t(1) << bits) - 1;
+    }
+}
+
+void DrawList::clear() {
+    m_commands.clear();
+    m_entries.clear();
+    m_pipelineIDs.clear();
+    m_materialIDs.clear();
+    m_meshIDs.clear();
+}
+
+uint32_t DrawList::idOf(std::unordered_map<const void*, uint32_t>& ids, const void* pointer) {
+    auto result = ids.emplace(pointer, static_cast<uint32_t>(ids.size()));
+    return result.first->second;
+}
+
+uint64_t DrawList::makeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+    // 非负float的位模式和数值同序：去掉符号位后取高20位就是量化的深度，不需要知道远平面
+    uint32_t depthBits = 0;
+    if (depth > 0.0f) {
+        std::memcpy(&depthBits, &depth, sizeof(float));
+        depthBits >>= 31 - DEPTH_BITS;
+    }
+
+    uint64_t key = pass & mask(PASS_BITS);
+    key = (key << PIPELINE_BITS) | (pipeline & mask(PIPELINE_BITS));
+    key = (key << MATERIAL_BITS) | (material & mask(MATERIAL_BITS));
+    key = (key << MESH_BITS) | (mesh & mask(MESH_BITS));
+    key = (key << DEPTH_BITS) | (depthBits & mask(DEPTH_BITS));
+    return key;
+}
+
+void DrawList::add(uint32_t pass, Material* material, Mesh* mesh, float depth, uint32_t index) {
+    uint32_t pipelineID = idOf(m_pipelineIDs, material->getPipeline());
+    uint32_t materialID = idOf(m_materialIDs, material);
+    uint32_t meshID = idOf(m_meshIDs, mesh);
+
+    m_entries.push_back({ makeKey(pass, pipelineID, materialID, meshID, depth), static_cast<uint32_t>(m_commands.size()) });
+    m_commands.push_back({ material, mesh, index });
+}
+
+void DrawList::sort() {
+    size_t count = m_entries.size();
+    if (count < 2) return;
+
+    m_scratch.resize(count);
+    SortEntry* source = m_entries.data();
+    SortEntry* destination = m_scratch.data();
+
+    // LSD基数排序，每次8位；稳定，所以键相同的绘制保持添加顺序
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (size_t i = 0; i < count; ++i) {
+            histogram[(source[i].key >> shift) & 0xFF]++;
+        }
+
+        // 所有键在这个字节上都一样（比如只有一个pass），跳过
+        if (histogram[(source[0].key >> shift) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != m_entries.data()) {
+        m_entries.swap(m_scratch);
+    }
+}
+
+size_t DrawList::findRunEnd(size_t position, size_t rangeEnd) const {
+    // 排序后相同材质+网格的绘制是连续的一段
+    const Command& first = m_commands[m_entries[position].command];
+    size_t end = position + 1;
+    while (end < rangeEnd) {
+        const Command& next = m_commands[m_entries[end].command];
+        if (next.material != first.material || next.mesh != first.mesh) break;
+        if ((m_entries[end].key ^ m_entries[position].key) >> (64 - PASS_BITS)) break;   // 不跨pass合并
+        end++;
+    }
+    return end;
+}
+
+void DrawList::bind(VkCommandBuffer cmd, BindState& state, const Command& command, bool instanced, Stats& stats) {
+    if (command.material != state.material || instanced != state.instanced) {
+        VkPipeline pipeline = instanced ? command.material->getInstancedPipeline() : command.material->getPipeline();
+        if (pipeline == VK_NULL_HANDLE) {
+            // 材质不公开pipeline：只能整体绑定
+            command.material->bind(cmd);
+            state.pipeline = VK_NULL_HANDLE;
+            stats.pipelineBinds++;
+        } else {
+            if (pipeline != state.pipeline) {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                state.pipeline = pipeline;
+                stats.pipelineBinds++;
+            }
+            command.material->bindResources(cmd);
+        }
+        state.material = command.material;
+        state.instanced = instanced;
+        stats.materialBinds++;
+    }
+
+    VkBuffer vertexBuffer = command.mesh->getVertexBuffer();
+    VkBuffer indexBuffer = command.mesh->getIndexBuffer();
+    if (vertexBuffer != state.vertexBuffer || indexBuffer != state.indexBuffer) {
+        command.mesh->bind(cmd);
+        state.vertexBuffer = vertexBuffer;
+        state.indexBuffer = indexBuffer;
+        stats.bufferBinds++;
+    }
+}
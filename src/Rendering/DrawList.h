@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Rendering/Material.h"
+#include "Rendering/Mesh.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 绘制列表 - 按64位排序键排序，录制时去掉重复的状态切换
+ *
+ * 排序键（高位到低位）：
+ *   | pass 4 | pipeline 10 | material 14 | mesh 16 | depth 20 |
+ *
+ * 排序后相同pipeline的绘制挨在一起，其次是相同材质、相同网格，
+ * 最后按深度从近到远（不透明物体减少overdraw）。
+ * 排序用LSD基数排序（每次8位，所有键都相同的字节直接跳过）。
+ *
+ * pipeline/材质/网格的编号每帧按第一次出现的顺序分配，超过位数会回绕。
+ * 回绕只影响排序质量，不影响正确性：录制时比较的是真实的指针。
+ *
+ * recordInstanced()把相同材质+网格的连续绘制合并成一次实例化绘制
+ * （排序后它们本来就挨在一起）。
+ *
+ * recordRange()只录制排序后的一段，多个线程可以同时录制不同的段
+ * （各自的command buffer和Stats），见ForwardPass的多线程录制。
+ *
+ * 使用方法：
+ *   drawList.clear();
+ *   drawList.add(0, material, mesh, viewDepth, i);
+ *   drawList.sort();
+ *   drawList.record(cmd, [&](VkCommandBuffer cmd, const DrawList::Command& command) {
+ *       // 设置这个绘制的push constants
+ *   });
+ */
+class DrawList {
+public:
+    struct Command {
+        Material* material;
+        Mesh* mesh;
+        uint32_t index;      // 调用者的数据（比如MVP数组的下标）
+    };
+
+    // 上一次record()的统计
+    struct Stats {
+        uint32_t pipelineBinds = 0;
+        uint32_t materialBinds = 0;
+        uint32_t bufferBinds = 0;    // 顶点/索引缓冲绑定（缓冲变化时一次，MeshArena里的网格共用）
+        uint32_t draws = 0;          // vkCmdDrawIndexed次数（实例化绘制算一次）
+        uint32_t instancedDraws = 0;
+        uint32_t instances = 0;      // 实例化绘制画出的物体总数
+
+        void add(const Stats& other) {
+            pipelineBinds += other.pipelineBinds;
+            materialBinds += other.materialBinds;
+            bufferBinds += other.bufferBinds;
+            draws += other.draws;
+            instancedDraws += other.instancedDraws;
+            instances += other.instances;
+        }
+    };
+
+    static constexpr uint32_t PASS_BITS = 4;
+    static constexpr uint32_t PIPELINE_BITS = 10;
+    static constexpr uint32_t MATERIAL_BITS = 14;
+    static constexpr uint32_t MESH_BITS = 16;
+    static constexpr uint32_t DEPTH_BITS = 20;
+
+    void clear();
+
+    // depth：到相机的距离（>= 0），越小越先画
+    void add(uint32_t pass, Material* material, Mesh* mesh, float depth, uint32_t index);
+
+    void sort();
+
+    // 按排序后的顺序录制；beforeDraw(cmd, command)在每个绘制之前调用
+    template<typename Func>
+    void record(VkCommandBuffer cmd, Func&& beforeDraw);
+
+    // 同上，但相同材质+网格的连续绘制（至少minInstances个，且材质有instanced pipeline）
+    // 合并成一次实例化绘制：
+    // - writeInstances(begin, end) 把排序后第[begin, end)个绘制的实例数据写入实例缓冲，
+    //   返回firstInstance；返回UINT32_MAX（缓冲满了）时这一段退回逐个绘制
+    // - beforeInstances(cmd, command) 在实例化绘制之前调用（比如设置ViewProjection）
+    template<typename DrawFunc, typename WriteFunc, typename InstanceFunc>
+    void recordInstanced(VkCommandBuffer cmd, uint32_t minInstances,
+                         DrawFunc&& beforeDraw, WriteFunc&& writeInstances, InstanceFunc&& beforeInstances);
+
+    // 同上，但只录制排序后第[rangeBegin, rangeEnd)个绘制，统计累加到stats。
+    // 不修改DrawList，不同的段可以在不同线程上同时录制（回调也要是线程安全的）。
+    // 实例化的段不会跨过rangeEnd：段边界上的连续绘制被拆成两次
+    template<typename DrawFunc, typename WriteFunc, typename InstanceFunc>
+    void recordRange(VkCommandBuffer cmd, size_t rangeBegin, size_t rangeEnd, uint32_t minInstances,
+                     DrawFunc&& beforeDraw, WriteFunc&& writeInstances, InstanceFunc&& beforeInstances,
+                     Stats& stats) const;
+
+    // 排序后从第position个开始、相同材质+网格且在同一个pass里的连续绘制的结尾（不超过rangeEnd）。
+    // recordRange()把这样的一段合并成一次实例化绘制
+    size_t findRunEnd(size_t position, size_t rangeEnd) const;
+
+    size_t size() const { return m_commands.size(); }
+    // 排序后第position个绘制
+    const Command& getSortedCommand(size_t position) const { return m_commands[m_entries[position].command]; }
+    const Stats& getStats() const { return m_stats; }
+
+    static uint64_t makeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t command;
+    };
+
+    // 录制时当前绑定的状态
+    struct BindState {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        Material* material = nullptr;
+        bool instanced = false;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;   // MeshArena里的网格共用缓冲，换网格不用重新绑定
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+    };
+
+    static uint32_t idOf(std::unordered_map<const void*, uint32_t>& ids, const void* pointer);
+
+    // 只绑定和state不同的部分
+    static void bind(VkCommandBuffer cmd, BindState& state, const Command& command, bool instanced, Stats& stats);
+
+    std::vector<Command> m_commands;
+    std::vector<SortEntry> m_entries;
+    std::vector<SortEntry> m_scratch;     // 基数排序的另一半缓冲
+
+    std::unordered_map<const void*, uint32_t> m_pipelineIDs;
+    std::unordered_map<const void*, uint32_t> m_materialIDs;
+    std::unordered_map<const void*, uint32_t> m_meshIDs;
+
+    Stats m_stats;
+};
+
+template<typename Func>
+void DrawList::record(VkCommandBuffer cmd, Func&& beforeDraw) {
+    recordInstanced(cmd, UINT32_MAX, std::forward<Func>(beforeDraw),
+        [](size_t, size_t) { return UINT32_MAX; },
+        [](VkCommandBuffer, const Command&) {});
+}
+
+template<typename DrawFunc, typename WriteFunc, typename InstanceFunc>
+void DrawList::recordInstanced(VkCommandBuffer cmd, uint32_t minInstances,
+                               DrawFunc&& beforeDraw, WriteFunc&& writeInstances, InstanceFunc&& beforeInstances) {
+    m_stats = Stats();
+    recordRange(cmd, 0, m_entries.size(), minInstances, std::forward<DrawFunc>(beforeDraw),
+                std::forward<WriteFunc>(writeInstances), std::forward<InstanceFunc>(beforeInstances), m_stats);
+}
+
+template<typename DrawFunc, typename WriteFunc, typename InstanceFunc>
+void DrawList::recordRange(VkCommandBuffer cmd, size_t rangeBegin, size_t rangeEnd, uint32_t minInstances,
+                           DrawFunc&& beforeDraw, WriteFunc&& writeInstances, InstanceFunc&& beforeInstances,
+                           Stats& stats) const {
+    BindState state;
+
+    size_t begin = rangeBegin;
+    while (begin < rangeEnd) {
+        const Command& first = m_commands[m_entries[begin].command];
+        size_t end = findRunEnd(begin, rangeEnd);
+        uint32_t runLength = static_cast<uint32_t>(end - begin);
+
+        if (runLength >= minInstances && first.material->getInstancedPipeline() != VK_NULL_HANDLE) {
+            uint32_t firstInstance = writeInstances(begin, end);
+            if (firstInstance != UINT32_MAX) {
+                bind(cmd, state, first, true, stats);
+                beforeInstances(cmd, first);
+                first.mesh->drawIndexed(cmd, runLength, firstInstance);
+                stats.draws++;
+                stats.instancedDraws++;
+                stats.instances += runLength;
+                begin = end;
+                continue;
+            }
+        }
+
+        // 太短、材质不支持实例化或者实例缓冲满了：逐个绘制
+        for (; begin < end; ++begin) {
+            const Command& command = m_commands[m_entries[begin].command];
+            bind(cmd, state, command, false, stats);
+            beforeDraw(cmd, command);
+            command.mesh->drawIndexed(cmd);
+            stats.draws++;
+        }
+    }
+}
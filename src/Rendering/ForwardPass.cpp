@@ -2,8 +2,16 @@
 #include "ECS/ECS.h"
 #include "ECS/Components.h"
 #include "Framework/Camera.h"
+#include "Framework/TransformBatch.h"
+#include "Framework/JobSystem.h"
+#include "Rendering/FrustumCulling.h"
 #include "Rendering/Mesh.h"
 #include "Rendering/SimpleMaterial.h"
+#include "Rendering/ThreadCommandPools.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
 
 ForwardPass::~ForwardPass() {
     cleanup();
@@ -12,50 +20,265 @@ ForwardPass::~ForwardPass() {
 void ForwardPass::initialize(
     VkDevice device,
     VkRenderPass renderPass,
-    VkExtent2D extent
+    VkExtent2D extent,
+    VmaAllocator allocator,
+    VkPipelineCache pipelineCache,
+    bool gpuDrivenSupported
 ) {
     m_device = device;
-    // Phase 1: ForwardPass不需要额外初始化
+    m_renderPass = renderPass;
+    m_extent = extent;
+    m_allocator = allocator;
+    m_pipelineCache = pipelineCache;
+    m_gpuDrivenSupported = gpuDrivenSupported;
     // Later: 可能需要创建descriptor sets等
 }
 
+void ForwardPass::setGPUDriven(bool enabled) {
+    if (enabled == isGPUDriven()) return;
+
+    if (!enabled) {
+        m_indirect.reset();
+        return;
+    }
+    if (m_allocator == VK_NULL_HANDLE) {
+        throw std::runtime_error("GPU driven rendering requires a VMA allocator!");
+    }
+    if (!m_gpuDrivenSupported) {
+        throw std::runtime_error("GPU driven rendering requires drawIndirectCount and drawIndirectFirstInstance!");
+    }
+    m_indirect = std::make_unique<IndirectRenderer>();
+    m_indirect->initialize(m_allocator, m_device, m_renderPass, m_extent, m_pipelineCache);
+    m_indirect->beginFrame(m_frameIndex);
+}
+
+void ForwardPass::setParallelRecording(JobSystem* jobs, ThreadCommandPools* commandPools) {
+    if ((jobs == nullptr) != (commandPools == nullptr)) {
+        throw std::runtime_error("Parallel recording needs both a job system and thread command pools!");
+    }
+    m_jobs = jobs;
+    m_commandPools = commandPools;
+}
+
+void ForwardPass::beginFrame(uint32_t frameIndex) {
+    m_frameIndex = frameIndex;
+    if (m_indirect) {
+        m_indirect->beginFrame(frameIndex);
+    }
+}
+
+void ForwardPass::executeOffscreen(VkCommandBuffer cmd, ECS& ecs) {
+    // 计算着色器和缓冲复制不能在RenderPass里录制
+    if (!m_indirect || !m_camera) return;
+    m_indirect->cull(cmd, ecs, m_camera->getViewProjectionMatrix());
+}
+
+size_t ForwardPass::cullBounded(ECS& ecs, const glm::mat4& vp) {
+    // 1. 收集有包围盒的实体，转换到世界空间（直接遍历archetype chunk，无逐实体查找）
+    m_candidates.clear();
+    m_candidateModels.clear();
+    m_boundsCenters.clear();
+    m_boundsExtents.clear();
+    ecs.view<MeshComponent, MaterialComponent, TransformComponent, AABBComponent>().each(
+        [&](Entity, MeshComponent& meshComp, MaterialComponent& materialComp,
+            TransformComponent& transformComp, AABBComponent& aabbComp) {
+            if (!meshComp.mesh || !materialComp.material) return;
+
+            AABBComponent worldBounds = aabbComp.transformed(transformComp.transform);
+
+            m_candidates.push_back({ meshComp.mesh, materialComp.material });
+            m_candidateModels.push_back(transformComp.transform);
+            m_boundsCenters.push_back(worldBounds.getCenter());
+            m_boundsExtents.push_back(worldBounds.getExtents());
+        });
+
+    // 2. 视锥剔除（SIMD批量测试），只有可见的实体进入绘制列表
+    Frustum frustum = Frustum::fromViewProjection(vp);
+    m_visibleIndices.resize(m_candidates.size());
+    size_t visibleCount = FrustumCuller::cull(
+        frustum, m_boundsCenters.data(), m_boundsExtents.data(), m_candidates.size(), m_visibleIndices.data());
+
+    for (size_t i = 0; i < visibleCount; ++i) {
+        uint32_t index = m_visibleIndices[i];
+        m_drawItems.push_back(m_candidates[index]);
+        m_modelMatrices.push_back(m_candidateModels[index]);
+    }
+    return visibleCount;
+}
+
 void ForwardPass::execute(VkCommandBuffer cmd, ECS& ecs) {
     if (!m_camera) return;
 
-    // 获取相机的View和Projection矩阵
-    glm::mat4 view = m_camera->getViewMatrix();
-    glm::mat4 proj = m_camera->getProjectionMatrix();
-    glm::mat4 vp = proj * view;
+    glm::mat4 vp = m_camera->getViewProjectionMatrix();
+
+    m_drawItems.clear();
+    m_modelMatrices.clear();
+    m_candidates.clear();
+    size_t visibleCount = 0;
+
+    // GPU驱动时有包围盒的实体已经在executeOffscreen()里剔除，最后一次间接绘制画完
+    if (!m_indirect) {
+        visibleCount = cullBounded(ecs, vp);
+    }
+
+    // 没有包围盒的实体无法剔除，总是绘制
+    size_t unboundedCount = 0;
+    ecs.view<MeshComponent, MaterialComponent, TransformComponent>().exclude<AABBComponent>().each(
+        [&](Entity, MeshComponent& meshComp, MaterialComponent& materialComp, TransformComponent& transformComp) {
+            if (!meshComp.mesh || !materialComp.material) return;
+
+            m_drawItems.push_back({ meshComp.mesh, materialComp.material });
+            m_modelMatrices.push_back(transformComp.transform);
+            unboundedCount++;
+        });
+
+    m_cullingStats.tested = m_indirect ? m_indirect->getStats().objects : static_cast<uint32_t>(m_candidates.size());
+    m_cullingStats.visible = static_cast<uint32_t>(visibleCount);
+    m_cullingStats.culled = static_cast<uint32_t>(m_candidates.size() - visibleCount);
+    m_cullingStats.unbounded = static_cast<uint32_t>(unboundedCount);
+
+    // 3. 一次批量算出所有MVP矩阵（SIMD）
+    m_mvpMatrices.resize(m_modelMatrices.size());
+    TransformBatch::multiply(vp, m_modelMatrices.data(), m_mvpMatrices.data(), m_modelMatrices.size());
+
+    // 4. 按排序键排序（pipeline -> 材质 -> 网格 -> 深度），录制时只在状态变化时绑定
+    m_drawList.clear();
+    m_recordStats.pendingDraws = 0;
+    Material* fallback = (m_fallbackMaterial && m_fallbackMaterial->isReady()) ? m_fallbackMaterial : nullptr;
+    for (size_t i = 0; i < m_drawItems.size(); ++i) {
+        Material* material = m_drawItems[i].material;
+        if (!material->isReady()) {
+            // pipeline还在后台编译：不等它
+            m_recordStats.pendingDraws++;
+            if (!fallback) continue;
+            material = fallback;
+        }
+        // 裁剪空间w = 物体原点到相机的距离
+        float depth = m_mvpMatrices[i][3][3];
+        m_drawList.add(0, material, m_drawItems[i].mesh, depth, static_cast<uint32_t>(i));
+    }
+    m_drawList.sort();
+
+    // 5. 录制。相同网格+材质的连续段写进实例缓冲，一次实例化绘制
+    FrameAllocator::Allocation instances;
+    if (m_frameAllocator && !m_drawItems.empty()) {
+        // 按最坏情况（全部实例化）预留；每个绘制的实例数据放在它排序后的位置，
+        // 所以各块可以并行写，录制中途也不会满。Renderer提交前统一flush
+        m_frameAllocator->allocateArray<InstanceData>(m_drawItems.size(), instances);
+    }
+
+    auto recordStart = std::chrono::steady_clock::now();
+    m_drawStats = DrawList::Stats();
+
+    if (m_commandPools) {
+        recordParallel(cmd, vp, instances);
+    } else {
+        recordDraws(cmd, 0, m_drawList.size(), vp, instances, m_drawStats);
+        if (m_indirect) {
+            m_indirect->draw(cmd, vp);
+        }
+        m_recordStats.secondaryBuffers = 0;
+        m_recordStats.threads = 1;
+    }
+
+    m_recordStats.draws = static_cast<uint32_t>(m_drawList.size());
+    m_recordStats.milliseconds = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - recordStart).count();
+}
 
-    // 遍历所有有Mesh和Material的实体
-    auto entities = ecs.entitiesWith<MeshComponent, MaterialComponent, TransformComponent>();
+void ForwardPass::recordDraws(VkCommandBuffer cmd, size_t begin, size_t end, const glm::mat4& vp,
+                              const FrameAllocator::Allocation& instances, DrawList::Stats& stats) const {
+    if (begin >= end) return;
 
-    for (Entity entity : entities) {
-        auto* meshComp = ecs.getComponent<MeshComponent>(entity);
-        auto* materialComp = ecs.getComponent<MaterialComponent>(entity);
-        auto* transformComp = ecs.getComponent<TransformComponent>(entity);
+    InstanceData* instanceData = static_cast<InstanceData*>(instances.mapped);
+    if (instanceData) {
+        vkCmdBindVertexBuffers(cmd, 1, 1, &instances.buffer, &instances.offset);   // binding 1，整块不变
+    }
 
-        if (!meshComp->mesh || !materialComp->material) continue;
+    m_drawList.recordRange(cmd, begin, end, instanceData ? MIN_INSTANCES : UINT32_MAX,
+        [&](VkCommandBuffer cmd, const DrawList::Command& command) {
+            // 设置MVP（通过push constants）
+            // ASSUMPTION: 材质支持setMVP（SimpleMaterial有此方法）
+            auto* simpleMaterial = dynamic_cast<SimpleMaterial*>(command.material);
+            if (simpleMaterial) {
+                simpleMaterial->setMVP(cmd, m_mvpMatrices[command.index]);
+            }
+        },
+        [&](size_t runBegin, size_t runEnd) {
+            for (size_t i = runBegin; i < runEnd; ++i) {
+                instanceData[i].model = m_modelMatrices[m_drawList.getSortedCommand(i).index];
+            }
+            return static_cast<uint32_t>(runBegin);
+        },
+        [&](VkCommandBuffer cmd, const DrawList::Command& command) {
+            auto* simpleMaterial = dynamic_cast<SimpleMaterial*>(command.material);
+            if (simpleMaterial) {
+                simpleMaterial->setViewProjection(cmd, vp);
+            }
+        },
+        stats);
+}
 
-        // 计算MVP矩阵
-        glm::mat4 model = transformComp->transform;
-        glm::mat4 mvp = vp * model;
+void ForwardPass::recordParallel(VkCommandBuffer cmd, const glm::mat4& vp, const FrameAllocator::Allocation& instances) {
+    size_t drawCount = m_drawList.size();
+    uint32_t threadCount = m_commandPools->getThreadCount();
+    uint32_t chunkCount = getChunkCount(drawCount, threadCount);
 
-        // 绑定材质
-        materialComp->material->bind(cmd);
+    m_secondaries.assign(chunkCount, VK_NULL_HANDLE);
+    m_chunkStats.assign(chunkCount, DrawList::Stats());
+    m_chunkThreads.assign(chunkCount, 0);
+    m_chunkErrors.assign(chunkCount, nullptr);
 
-        // 设置MVP（通过push constants）
-        // ASSUMPTION: 材质支持setMVP（SimpleMaterial有此方法）
-        auto* simpleMaterial = dynamic_cast<SimpleMaterial*>(materialComp->material);
-        if (simpleMaterial) {
-            simpleMaterial->setMVP(cmd, mvp);
+    // 每块只写自己的secondary/stats，命令池按线程分开，不需要锁
+    m_jobs->parallelFor(0, chunkCount, 1, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+        uint32_t threadIndex = m_jobs->getCurrentThreadIndex();
+        for (uint32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk) {
+            // 作业不能抛异常：记下来，录制完再抛
+            try {
+                size_t begin = 0;
+                size_t end = 0;
+                getChunkRange(drawCount, chunkCount, chunk, begin, end);
+                VkCommandBuffer secondary = m_commandPools->beginSecondary(threadIndex, m_renderPass, 0);
+                recordDraws(secondary, begin, end, vp, instances, m_chunkStats[chunk]);
+                vkEndCommandBuffer(secondary);
+                m_secondaries[chunk] = secondary;
+                m_chunkThreads[chunk] = threadIndex;
+            } catch (...) {
+                m_chunkErrors[chunk] = std::current_exception();
+            }
         }
+    });
+
+    for (const std::exception_ptr& error : m_chunkErrors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    // 间接绘制只有几次调用，在当前线程上录制
+    if (m_indirect) {
+        VkCommandBuffer secondary = m_commandPools->beginSecondary(m_jobs->getCurrentThreadIndex(), m_renderPass, 0);
+        m_indirect->draw(secondary, vp);
+        vkEndCommandBuffer(secondary);
+        m_secondaries.push_back(secondary);
+    }
 
-        // 绘制网格
-        meshComp->mesh->draw(cmd);
+    // 按块的顺序执行，保持排序后的绘制顺序
+    if (!m_secondaries.empty()) {
+        vkCmdExecuteCommands(cmd, static_cast<uint32_t>(m_secondaries.size()), m_secondaries.data());
+    }
+
+    m_threadUsed.assign(threadCount, 0);
+    uint32_t threadsUsed = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        m_drawStats.add(m_chunkStats[chunk]);
+        if (!m_threadUsed[m_chunkThreads[chunk]]) {
+            m_threadUsed[m_chunkThreads[chunk]] = 1;
+            threadsUsed++;
+        }
     }
+    m_recordStats.secondaryBuffers = static_cast<uint32_t>(m_secondaries.size());
+    m_recordStats.threads = std::max(threadsUsed, 1u);
 }
 
 void ForwardPass::cleanup() {
-    // Phase 1: 无需清理
+    m_indirect.reset();
 }
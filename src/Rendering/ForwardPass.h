@@ -1,15 +1,39 @@
 #pragma once
 
 #include "Rendering/RenderPass.h"
+#include "Rendering/DrawList.h"
+#include "Rendering/FrameAllocator.h"
+#include "Rendering/IndirectRenderer.h"
 #include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
 
 class Camera;
+class Mesh;
+class Material;
+class JobSystem;
+class ThreadCommandPools;
 
 /**
  * @brief 前向渲染Pass - 第一个具体Pass实现
  *
  * 功能：
  * - 渲染所有不透明物体
+ * - 有AABBComponent的实体先做视锥剔除，只有可见的才录制绘制命令
+ * - 绘制按排序键排序（DrawList），相同的pipeline/网格只绑定一次
+ * - 相同网格+材质连续MIN_INSTANCES个以上时合并成一次实例化绘制，
+ *   model矩阵写入Renderer的FrameAllocator（需要setFrameAllocator）
+ * - setGPUDriven(true)之后有包围盒的实体交给IndirectRenderer：
+ *   剔除和绘制命令在GPU上生成，execute()不再逐个处理它们
+ * - setParallelRecording()之后排序好的绘制列表切成几块，在JobSystem的线程上
+ *   各自录制进secondary command buffer，再在primary里按顺序vkCmdExecuteCommands
+ *   （主RenderPass要用VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS开始）
+ * - pipeline还在后台编译的材质（Material::isReady()为false）用替代材质绘制，
+ *   没有替代材质时跳过，录制从不等待编译
  * - 使用SimpleMaterial
  * - Phase 1的主要渲染Pass
  *
@@ -17,22 +41,142 @@ class Camera;
  */
 class ForwardPass : public IRenderPass {
 public:
+    // 上一帧的剔除统计
+    struct CullingStats {
+        uint32_t tested = 0;     // 有包围盒、参与剔除的实体
+        uint32_t visible = 0;    // 通过剔除（GPU剔除时CPU不知道，为0）
+        uint32_t culled = 0;     // 被剔除（同上）
+        uint32_t unbounded = 0;  // 没有包围盒、总是绘制的实体
+    };
+
+    // 上一帧的录制统计（CPU录制耗时，可以用来比较不同线程数）
+    struct RecordStats {
+        float milliseconds = 0.0f;      // 从排序完成到录制完成
+        uint32_t draws = 0;             // 绘制列表里的绘制数
+        uint32_t secondaryBuffers = 0;  // 0 = 直接录制在primary里
+        uint32_t threads = 1;           // 实际参与录制的线程数
+        uint32_t pendingDraws = 0;      // 材质还没准备好（用替代材质绘制或跳过）
+    };
+
     ForwardPass() = default;
     ~ForwardPass() override;
 
+    // 更短的段逐个绘制：写实例缓冲不如直接push constant划算
+    static constexpr uint32_t MIN_INSTANCES = 4;
+
+    // 多线程录制的分块：块太小时调度和每块重新绑定状态的开销超过并行的收益
+    static constexpr uint32_t MIN_DRAWS_PER_CHUNK = 1024;
+    static constexpr uint32_t CHUNKS_PER_THREAD = 2;    // 留一些余量给work stealing平衡负载
+
+    // drawCount个绘制切成几块：最多每线程CHUNKS_PER_THREAD块，每块至少MIN_DRAWS_PER_CHUNK个
+    // （不到MIN_DRAWS_PER_CHUNK个时一块，没有绘制时0块）
+    static uint32_t getChunkCount(size_t drawCount, uint32_t threadCount) {
+        if (drawCount == 0) return 0;
+        size_t chunks = std::min<size_t>(size_t(threadCount) * CHUNKS_PER_THREAD, drawCount / MIN_DRAWS_PER_CHUNK);
+        return static_cast<uint32_t>(std::max<size_t>(chunks, 1));
+    }
+    // 第chunk块在排序后的绘制里的[begin, end)：按顺序首尾相接，大小最多差1
+    static void getChunkRange(size_t drawCount, uint32_t chunkCount, uint32_t chunk, size_t& begin, size_t& end) {
+        begin = drawCount * chunk / chunkCount;
+        end = drawCount * (chunk + 1) / chunkCount;
+    }
+
+    // allocator：GPU驱动绘制（IndirectRenderer）用
+    // gpuDrivenSupported：设备启用了drawIndirectCount和drawIndirectFirstInstance
+    // （VulkanContext::isGPUDrivenSupported()）
     void initialize(
         VkDevice device,
         VkRenderPass renderPass,
-        VkExtent2D extent
+        VkExtent2D extent,
+        VmaAllocator allocator = VK_NULL_HANDLE,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE,
+        bool gpuDrivenSupported = false
     );
 
+    void beginFrame(uint32_t frameIndex) override;
     void execute(VkCommandBuffer cmd, ECS& ecs) override;
+    void executeOffscreen(VkCommandBuffer cmd, ECS& ecs) override;
     void cleanup() override;
 
+    // 有包围盒的实体改用GPU剔除 + 间接绘制（需要initialize时传入allocator，
+    // 并且设备支持，见isGPUDrivenSupported()）
+    // 切换时GPU必须不再使用这个Pass的资源
+    void setGPUDriven(bool enabled);
+    bool isGPUDriven() const { return m_indirect != nullptr; }
+    bool isGPUDrivenSupported() const { return m_gpuDrivenSupported && m_allocator != VK_NULL_HANDLE; }
+    // GPU驱动时的上传统计；没有启用时返回nullptr
+    const IndirectRenderer* getIndirectRenderer() const { return m_indirect.get(); }
+
+    // 实例数据从这里分配；为空时不做实例化
+    void setFrameAllocator(FrameAllocator* frameAllocator) { m_frameAllocator = frameAllocator; }
+
+    // 多线程录制（两个都为空时恢复直接录制在primary里）。
+    // 调用方负责让主RenderPass的subpass contents和这里一致
+    void setParallelRecording(JobSystem* jobs, ThreadCommandPools* commandPools);
+    bool isParallelRecording() const { return m_commandPools != nullptr; }
+
+    // pipeline还在编译的材质改用这个材质绘制（为空时跳过这些绘制）。
+    // 替代材质要同步初始化，push constant布局和SimpleMaterial相同
+    void setFallbackMaterial(Material* material) { m_fallbackMaterial = material; }
+
     // 设置相机（用于MVP计算）
     void setCamera(Camera* camera) { m_camera = camera; }
 
+    const CullingStats& getCullingStats() const { return m_cullingStats; }
+    // 上一帧的pipeline绑定、缓冲绑定和绘制次数
+    const DrawList::Stats& getDrawStats() const { return m_drawStats; }
+    const RecordStats& getRecordStats() const { return m_recordStats; }
+
 private:
+    struct DrawItem {
+        Mesh* mesh;
+        Material* material;
+    };
+
+    // CPU视锥剔除有包围盒的实体，可见的追加到m_drawItems，返回可见数量
+    size_t cullBounded(ECS& ecs, const glm::mat4& vp);
+
+    // 录制排序后第[begin, end)个绘制；instances.mapped为空时不实例化。线程安全
+    void recordDraws(VkCommandBuffer cmd, size_t begin, size_t end, const glm::mat4& vp,
+                     const FrameAllocator::Allocation& instances, DrawList::Stats& stats) const;
+    // 分块并行录制进secondary，再在cmd里执行
+    void recordParallel(VkCommandBuffer cmd, const glm::mat4& vp, const FrameAllocator::Allocation& instances);
+
     VkDevice m_device = VK_NULL_HANDLE;
+    VkRenderPass m_renderPass = VK_NULL_HANDLE;
+    VkExtent2D m_extent = { 0, 0 };
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    bool m_gpuDrivenSupported = false;
     Camera* m_camera = nullptr;
+    Material* m_fallbackMaterial = nullptr;
+    FrameAllocator* m_frameAllocator = nullptr;
+    JobSystem* m_jobs = nullptr;
+    ThreadCommandPools* m_commandPools = nullptr;
+
+    std::unique_ptr<IndirectRenderer> m_indirect;
+    uint32_t m_frameIndex = 0;
+
+    // 每帧复用的缓冲：剔除候选（世界空间包围盒）
+    std::vector<DrawItem> m_candidates;
+    std::vector<glm::mat4> m_candidateModels;
+    std::vector<glm::vec3> m_boundsCenters;
+    std::vector<glm::vec3> m_boundsExtents;
+    std::vector<uint32_t> m_visibleIndices;
+    CullingStats m_cullingStats;
+
+    // 每帧复用的缓冲：先收集所有model矩阵，再批量算MVP
+    std::vector<DrawItem> m_drawItems;
+    std::vector<glm::mat4> m_modelMatrices;
+    std::vector<glm::mat4> m_mvpMatrices;
+    DrawList m_drawList;
+    DrawList::Stats m_drawStats;
+
+    // 每帧复用的缓冲：多线程录制的每块结果
+    std::vector<VkCommandBuffer> m_secondaries;
+    std::vector<DrawList::Stats> m_chunkStats;
+    std::vector<uint32_t> m_chunkThreads;
+    std::vector<std::exception_ptr> m_chunkErrors;   // 作业里抛出的异常，录制完在当前线程上重新抛出
+    std::vector<uint8_t> m_threadUsed;               // 线程下标 -> 这一帧录制过至少一块
+    RecordStats m_recordStats;
 };
@@ -0,0 +1,165 @@
+#include "Rendering/FrameAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+FrameAllocator::~FrameAllocator() {
+    cleanup();
+}
+
+void FrameAllocator::initialize(
+    VmaAllocator allocator,
+    VkDeviceSize uniformAlignment,
+    VkDeviceSize storageAlignment,
+    VkDeviceSize segmentSize,
+    VkBufferUsageFlags usage
+) {
+    m_allocator = allocator;
+    m_usage = usage;
+    m_uniformAlignment = std::max(uniformAlignment, DEFAULT_ALIGNMENT);
+    m_storageAlignment = std::max(storageAlignment, DEFAULT_ALIGNMENT);
+
+    createBuffer(alignUp(segmentSize, 256));
+    beginFrame(0);
+}
+
+void FrameAllocator::cleanup() {
+    destroyBuffer(m_buffer);
+    m_mapped = nullptr;
+
+    for (auto& overflow : m_overflow) {
+        for (OverflowBuffer& buffer : overflow) {
+            destroyBuffer(buffer.buffer);
+        }
+        overflow.clear();
+    }
+    for (RetiredBuffer& retired : m_retiredBuffers) {
+        destroyBuffer(retired.buffer);
+    }
+    m_retiredBuffers.clear();
+}
+
+void FrameAllocator::createBuffer(VkDeviceSize segmentSize) {
+    m_segmentSize = segmentSize;
+    m_buffer = std::make_unique<VulkanBuffer>();
+    m_buffer->create(m_allocator, segmentSize * IRenderPass::MAX_FRAMES_IN_FLIGHT, m_usage,
+                     VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+    m_mapped = static_cast<uint8_t*>(m_buffer->map());
+    m_generation++;
+}
+
+void FrameAllocator::destroyBuffer(std::unique_ptr<VulkanBuffer>& buffer) {
+    if (!buffer) return;
+    buffer->unmap();
+    buffer->cleanup();
+    buffer.reset();
+}
+
+void FrameAllocator::beginFrame(uint32_t frameIndex) {
+    // 上次用这一段的帧已经执行完：它的溢出缓冲可以释放
+    for (OverflowBuffer& overflow : m_overflow[frameIndex]) {
+        destroyBuffer(overflow.buffer);
+    }
+    m_overflow[frameIndex].clear();
+
+    for (auto it = m_retiredBuffers.begin(); it != m_retiredBuffers.end();) {
+        if (--it->framesLeft == 0) {
+            destroyBuffer(it->buffer);
+            it = m_retiredBuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 上次这一帧溢出了：换一个段更大的缓冲。
+    // 其他帧可能还在读旧缓冲，延迟销毁
+    VkDeviceSize segmentSize = grownSegmentSize(m_segmentSize, m_peakUsed[frameIndex]);
+    if (segmentSize != m_segmentSize) {
+        m_buffer->unmap();
+        m_retiredBuffers.push_back({ std::move(m_buffer), IRenderPass::MAX_FRAMES_IN_FLIGHT });
+        createBuffer(segmentSize);
+        m_stats.grows++;
+    }
+
+    m_frameIndex = frameIndex;
+    m_cursor = FrameCursor();
+    m_peakUsed[frameIndex] = 0;
+
+    m_stats.segmentSize = m_segmentSize;
+    m_stats.used = 0;
+    m_stats.allocations = 0;
+    m_stats.overflowBuffers = 0;
+}
+
+FrameAllocator::Allocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    m_stats.allocations++;
+
+    VkDeviceSize offset = 0;
+    bool fits = m_cursor.allocate(size, alignment, m_segmentSize, offset);
+    m_peakUsed[m_frameIndex] = m_cursor.used;
+    m_stats.used = m_cursor.used;
+
+    if (fits) {
+        VkDeviceSize bufferOffset = VkDeviceSize(m_frameIndex) * m_segmentSize + offset;
+        return { m_buffer->getHandle(), bufferOffset, m_mapped + bufferOffset };
+    }
+
+    return allocateOverflow(size, alignment);
+}
+
+FrameAllocator::Allocation FrameAllocator::allocateOverflow(VkDeviceSize size, VkDeviceSize alignment) {
+    std::vector<OverflowBuffer>& overflow = m_overflow[m_frameIndex];
+
+    if (overflow.empty() || alignUp(overflow.back().head, alignment) + size > overflow.back().size) {
+        OverflowBuffer buffer;
+        buffer.size = alignUp(std::max(size, m_segmentSize), 256);
+        buffer.buffer = std::make_unique<VulkanBuffer>();
+        buffer.buffer->create(m_allocator, buffer.size, m_usage, VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+        buffer.mapped = static_cast<uint8_t*>(buffer.buffer->map());
+        overflow.push_back(std::move(buffer));
+        m_stats.overflowBuffers++;
+    }
+
+    OverflowBuffer& buffer = overflow.back();
+    VkDeviceSize offset = alignUp(buffer.head, alignment);
+    buffer.head = offset + size;
+
+    return { buffer.buffer->getHandle(), offset, buffer.mapped + offset };
+}
+
+bool FrameAllocator::FrameCursor::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize segmentSize,
+                                           VkDeviceSize& offset) {
+    VkDeviceSize aligned = alignUp(head, alignment);
+    bool fits = aligned <= segmentSize && size <= segmentSize - aligned;
+    overflowed |= !fits;
+
+    // 第一次溢出之前段里的位置和扩大后的段一样，用量是实际的；之后的分配在扩大后的段里
+    // 位置不同，按最坏的对齐填充算，下次的段一定放得下整帧
+    used += overflowed ? size + alignment - 1 : aligned + size - head;
+    if (!fits) return false;
+
+    offset = aligned;
+    head = aligned + size;
+    return true;
+}
+
+VkDeviceSize FrameAllocator::grownSegmentSize(VkDeviceSize segmentSize, VkDeviceSize peakUsed) {
+    if (peakUsed <= segmentSize) return segmentSize;
+    return alignUp(std::max(peakUsed, segmentSize * 2), 256);
+}
+
+void FrameAllocator::flush() {
+    if (m_cursor.head > 0) {
+        m_buffer->flush(VkDeviceSize(m_frameIndex) * m_segmentSize, m_cursor.head);
+    }
+    for (OverflowBuffer& overflow : m_overflow[m_frameIndex]) {
+        if (overflow.head > 0) overflow.buffer->flush(0, overflow.head);
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Rendering/RenderPass.h"
+#include "Core/VulkanBuffer.h"
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 每帧的临时数据分配器 - 常驻映射的环形缓冲，按帧分段，指针递增分配
+ *
+ * 每帧变化的小块数据（uniform、实例数据、调试线段……）如果各自创建缓冲、
+ * 每次用的时候map/unmap，就是大量的小分配和映射调用。这里改成：
+ *
+ * - 一个CPU_TO_GPU缓冲，创建后一直映射
+ * - 分成MAX_FRAMES_IN_FLIGHT段，每帧用自己的一段
+ * - allocate()只是把这一段的指针往后挪（按要求对齐）
+ * - Renderer等到这一帧的m_inFlightFences之后调用beginFrame()，
+ *   这一段上次的数据GPU已经读完，指针直接回到段的开头
+ *
+ * 所有帧共用一个VkBuffer，所以dynamic uniform/storage buffer的
+ * descriptor set只需要写一次，每次绘制传不同的dynamic offset。
+ *
+ * 一帧用的超过了段的大小：这一帧剩下的分配放进临时的溢出缓冲，
+ * 下次轮到这一帧时段扩大到峰值用量（旧缓冲延迟MAX_FRAMES_IN_FLIGHT帧销毁）。
+ * 扩大后getBuffer()变了，用它写descriptor的代码要比较getGeneration()。
+ *
+ * 使用方法：
+ *   // Renderer::render()里，等待fence之后
+ *   frameAllocator.beginFrame(frameIndex);
+ *   ...
+ *   FrameAllocator::Allocation ubo = frameAllocator.allocateUniform(sizeof(CameraData));
+ *   std::memcpy(ubo.mapped, &cameraData, sizeof(CameraData));
+ *   uint32_t dynamicOffset = static_cast<uint32_t>(ubo.offset);
+ *   vkCmdBindDescriptorSets(..., 1, &dynamicOffset);   // 或者直接用ubo.buffer/ubo.offset
+ *   ...
+ *   frameAllocator.flush();    // 提交之前
+ */
+class FrameAllocator {
+public:
+    struct Allocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        void* mapped = nullptr;
+
+        explicit operator bool() const { return mapped != nullptr; }
+    };
+
+    struct Stats {
+        VkDeviceSize segmentSize = 0;   // 每帧一段的大小
+        VkDeviceSize used = 0;          // 当前帧已经分配的字节（包括对齐和溢出）
+        uint32_t allocations = 0;       // 当前帧的分配次数
+        uint32_t overflowBuffers = 0;   // 当前帧的溢出缓冲
+        uint32_t grows = 0;
+    };
+
+    static constexpr VkDeviceSize DEFAULT_SEGMENT_SIZE = 4ull << 20;
+    static constexpr VkDeviceSize DEFAULT_ALIGNMENT = 16;
+
+    // 顶点/索引/uniform/storage/间接命令都可以放
+    static constexpr VkBufferUsageFlags DEFAULT_USAGE =
+        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+
+    FrameAllocator() = default;
+    ~FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @param uniformAlignment VkPhysicalDeviceLimits::minUniformBufferOffsetAlignment
+     * @param storageAlignment VkPhysicalDeviceLimits::minStorageBufferOffsetAlignment
+     */
+    void initialize(
+        VmaAllocator allocator,
+        VkDeviceSize uniformAlignment,
+        VkDeviceSize storageAlignment,
+        VkDeviceSize segmentSize = DEFAULT_SEGMENT_SIZE,
+        VkBufferUsageFlags usage = DEFAULT_USAGE
+    );
+
+    void cleanup();
+
+    // 这一帧的fence等待过之后调用：回收这一段，释放这一帧上次的溢出缓冲
+    void beginFrame(uint32_t frameIndex);
+
+    // alignment必须是2的幂
+    Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = DEFAULT_ALIGNMENT);
+    Allocation allocateUniform(VkDeviceSize size) { return allocate(size, m_uniformAlignment); }
+    Allocation allocateStorage(VkDeviceSize size) { return allocate(size, m_storageAlignment); }
+
+    // 类型化的数组；allocation返回缓冲和偏移（绑定用）
+    template<typename T>
+    T* allocateArray(size_t count, Allocation& allocation) {
+        allocation = allocate(sizeof(T) * count, alignof(T) > DEFAULT_ALIGNMENT ? alignof(T) : DEFAULT_ALIGNMENT);
+        return static_cast<T*>(allocation.mapped);
+    }
+
+    // 提交这一帧之前调用（CPU_TO_GPU的内存可能不是HOST_COHERENT）
+    void flush();
+
+    // 所有帧共用的缓冲（不包括溢出缓冲）；扩大时会变
+    VkBuffer getBuffer() const { return m_buffer ? m_buffer->getHandle() : VK_NULL_HANDLE; }
+    uint64_t getGeneration() const { return m_generation; }
+    const Stats& getStats() const { return m_stats; }
+
+    // ---- 段的算法（只有整数运算，没有设备也能测试） ----
+
+    // 一帧在自己那一段里的分配位置和用量
+    struct FrameCursor {
+        VkDeviceSize head = 0;      // 段内偏移
+        VkDeviceSize used = 0;      // 包括对齐和溢出，决定下次的段大小
+        bool overflowed = false;    // 这一帧已经有放不下的分配
+
+        // 段内放得下返回true和对齐后的段内偏移；放不下返回false（调用方改用溢出缓冲），
+        // 两种情况都计入用量
+        bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize segmentSize, VkDeviceSize& offset);
+    };
+
+    // 上一帧用量超过段大小时的新段大小（至少翻倍，256对齐）；没超过返回segmentSize
+    static VkDeviceSize grownSegmentSize(VkDeviceSize segmentSize, VkDeviceSize peakUsed);
+
+private:
+    struct OverflowBuffer {
+        std::unique_ptr<VulkanBuffer> buffer;
+        uint8_t* mapped = nullptr;
+        VkDeviceSize size = 0;
+        VkDeviceSize head = 0;
+    };
+
+    struct RetiredBuffer {
+        std::unique_ptr<VulkanBuffer> buffer;
+        uint32_t framesLeft;
+    };
+
+    void createBuffer(VkDeviceSize segmentSize);
+    void destroyBuffer(std::unique_ptr<VulkanBuffer>& buffer);
+    Allocation allocateOverflow(VkDeviceSize size, VkDeviceSize alignment);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkBufferUsageFlags m_usage = 0;
+    VkDeviceSize m_uniformAlignment = DEFAULT_ALIGNMENT;
+    VkDeviceSize m_storageAlignment = DEFAULT_ALIGNMENT;
+
+    std::unique_ptr<VulkanBuffer> m_buffer;
+    uint8_t* m_mapped = nullptr;
+    VkDeviceSize m_segmentSize = 0;
+    uint64_t m_generation = 0;
+
+    uint32_t m_frameIndex = 0;
+    FrameCursor m_cursor;
+    VkDeviceSize m_peakUsed[IRenderPass::MAX_FRAMES_IN_FLIGHT] = {};
+
+    std::vector<OverflowBuffer> m_overflow[IRenderPass::MAX_FRAMES_IN_FLIGHT];
+    std::vector<RetiredBuffer> m_retiredBuffers;
+
+    Stats m_stats;
+};
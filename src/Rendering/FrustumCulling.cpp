@@ -0,0 +1,135 @@
+#include "Rendering/FrustumCulling.h"
+#include <cmath>
+
+#if defined(__AVX2__)
+    #define FRUSTUM_CULLING_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define FRUSTUM_CULLING_SSE 1
+#endif
+
+#if defined(FRUSTUM_CULLING_AVX2)
+    #include <immintrin.h>
+#elif defined(FRUSTUM_CULLING_SSE)
+    #include <xmmintrin.h>
+#endif
+
+Frustum Frustum::fromViewProjection(const glm::mat4& m) {
+    // glm是列主序：m[列][行]，第i行 = (m[0][i], m[1][i], m[2][i], m[3][i])
+    auto row = [&m](int i) { return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]); };
+    glm::vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    auto combine = [](const glm::vec4& a, const glm::vec4& b, float sign) {
+        return glm::vec4(a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w);
+    };
+
+    Frustum frustum;
+    frustum.planes[0] = combine(r3, r0, 1.0f);   // 左
+    frustum.planes[1] = combine(r3, r0, -1.0f);  // 右
+    frustum.planes[2] = combine(r3, r1, 1.0f);   // 下
+    frustum.planes[3] = combine(r3, r1, -1.0f);  // 上
+    // 近平面按OpenGL深度范围[-w, w]提取；如果投影是Vulkan的[0, w]，
+    // 这个平面稍微靠后一点，只会多留几个物体，不会误剔除
+    frustum.planes[4] = combine(r3, r2, 1.0f);   // 近
+    frustum.planes[5] = combine(r3, r2, -1.0f);  // 远
+
+    // 归一化，让dist是真实距离（方便调试，也让不同平面的误差一致）
+    for (glm::vec4& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = glm::vec4(plane.x / length, plane.y / length, plane.z / length, plane.w / length);
+        }
+    }
+    return frustum;
+}
+
+size_t FrustumCuller::cull(
+    const Frustum& frustum,
+    const glm::vec3* centers,
+    const glm::vec3* extents,
+    size_t count,
+    uint32_t* visibleIndices
+) {
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+#if defined(FRUSTUM_CULLING_AVX2)
+    for (; i + 8 <= count; i += 8) {
+        const glm::vec3* c = centers + i;
+        const glm::vec3* e = extents + i;
+        __m256 cx = _mm256_setr_ps(c[0].x, c[1].x, c[2].x, c[3].x, c[4].x, c[5].x, c[6].x, c[7].x);
+        __m256 cy = _mm256_setr_ps(c[0].y, c[1].y, c[2].y, c[3].y, c[4].y, c[5].y, c[6].y, c[7].y);
+        __m256 cz = _mm256_setr_ps(c[0].z, c[1].z, c[2].z, c[3].z, c[4].z, c[5].z, c[6].z, c[7].z);
+        __m256 ex = _mm256_setr_ps(e[0].x, e[1].x, e[2].x, e[3].x, e[4].x, e[5].x, e[6].x, e[7].x);
+        __m256 ey = _mm256_setr_ps(e[0].y, e[1].y, e[2].y, e[3].y, e[4].y, e[5].y, e[6].y, e[7].y);
+        __m256 ez = _mm256_setr_ps(e[0].z, e[1].z, e[2].z, e[3].z, e[4].z, e[5].z, e[6].z, e[7].z);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const glm::vec4& plane : frustum.planes) {
+            __m256 dist = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), cx), _mm256_mul_ps(_mm256_set1_ps(plane.y), cy)),
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), cz), _mm256_set1_ps(plane.w)));
+            __m256 radius = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(std::fabs(plane.x)), ex), _mm256_mul_ps(_mm256_set1_ps(std::fabs(plane.y)), ey)),
+                _mm256_mul_ps(_mm256_set1_ps(std::fabs(plane.z)), ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(dist, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        for (uint32_t lane = 0; lane < 8; ++lane) {
+            if (mask & (1 << lane)) {
+                visibleIndices[visibleCount++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+    }
+#endif
+
+#if defined(FRUSTUM_CULLING_SSE)
+    for (; i + 4 <= count; i += 4) {
+        const glm::vec3* c = centers + i;
+        const glm::vec3* e = extents + i;
+        __m128 cx = _mm_setr_ps(c[0].x, c[1].x, c[2].x, c[3].x);
+        __m128 cy = _mm_setr_ps(c[0].y, c[1].y, c[2].y, c[3].y);
+        __m128 cz = _mm_setr_ps(c[0].z, c[1].z, c[2].z, c[3].z);
+        __m128 ex = _mm_setr_ps(e[0].x, e[1].x, e[2].x, e[3].x);
+        __m128 ey = _mm_setr_ps(e[0].y, e[1].y, e[2].y, e[3].y);
+        __m128 ez = _mm_setr_ps(e[0].z, e[1].z, e[2].z, e[3].z);
+
+        __m128 inside = _mm_cmpeq_ps(_mm_setzero_ps(), _mm_setzero_ps());
+        for (const glm::vec4& plane : frustum.planes) {
+            __m128 dist = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+            __m128 radius = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::fabs(plane.x)), ex), _mm_mul_ps(_mm_set1_ps(std::fabs(plane.y)), ey)),
+                _mm_mul_ps(_mm_set1_ps(std::fabs(plane.z)), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, radius), _mm_setzero_ps()));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (uint32_t lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane)) {
+                visibleIndices[visibleCount++] = static_cast<uint32_t>(i + lane);
+            }
+        }
+    }
+#endif
+
+    // 剩下的零头（以及没有SIMD的平台）
+    for (; i < count; ++i) {
+        bool inside = true;
+        for (const glm::vec4& plane : frustum.planes) {
+            float dist = plane.x * centers[i].x + plane.y * centers[i].y + plane.z * centers[i].z + plane.w;
+            float radius = std::fabs(plane.x) * extents[i].x + std::fabs(plane.y) * extents[i].y + std::fabs(plane.z) * extents[i].z;
+            if (dist + radius < 0.0f) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            visibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    return visibleCount;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 视锥体 - 6个平面（左、右、下、上、近、远）
+ *
+ * 每个平面是 (normal, d)，法线指向视锥体内部：
+ * 点p在平面内侧 <=> dot(normal, p) + d >= 0
+ *
+ * 平面从ViewProjection矩阵直接提取（Gribb/Hartmann方法），
+ * 和相机使用什么投影参数无关。
+ */
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+};
+
+/**
+ * @brief 视锥剔除 - 批量测试包围盒是否在视锥体内
+ *
+ * 输入是世界空间的AABB，用中心点 + 半边长表示（SoA：两个数组），
+ * 可以用 AABBComponent::transformed() 从局部包围盒得到。
+ * 对每个平面只需要测一次：
+ *   dist   = dot(normal, center) + d
+ *   radius = dot(abs(normal), extents)
+ *   dist + radius < 0  =>  整个盒子在平面外侧，剔除
+ *
+ * 实现（编译期选择）：
+ * - AVX2：一次测8个盒子
+ * - SSE：一次测4个盒子
+ * - 其他平台：标量
+ *
+ * 测试是保守的：跨越平面交线的盒子可能被判为可见，但可见的盒子不会被剔除。
+ *
+ * 使用方法：
+ *   Frustum frustum = Frustum::fromViewProjection(camera.getViewProjectionMatrix());
+ *   size_t visibleCount = FrustumCuller::cull(frustum, centers, extents, count, visibleIndices);
+ */
+class FrustumCuller {
+public:
+    // 把可见盒子的下标按顺序写入visibleIndices（容量至少count），返回可见数量
+    static size_t cull(
+        const Frustum& frustum,
+        const glm::vec3* centers,
+        const glm::vec3* extents,
+        size_t count,
+        uint32_t* visibleIndices
+    );
+};
@@ -0,0 +1,570 @@
+#include "Rendering/IndirectRenderer.h"
+#include "Core/VulkanPipeline.h"
+#include "ECS/ECS.h"
+#include "Rendering/FrustumCulling.h"
+#include "Rendering/Mesh.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+    // 第一次分配的最小容量，避免场景慢慢变大时频繁换缓冲
+    constexpr VkDeviceSize MIN_BUFFER_SIZE = 64 * 1024;
+
+    constexpr VkDeviceSize COMMAND_STRIDE = sizeof(VkDrawIndexedIndirectCommand);
+}
+
+IndirectRenderer::~IndirectRenderer() {
+    cleanup();
+}
+
+void IndirectRenderer::initialize(
+    VmaAllocator allocator,
+    VkDevice device,
+    VkRenderPass renderPass,
+    VkExtent2D extent,
+    VkPipelineCache pipelineCache
+) {
+    m_allocator = allocator;
+    m_device = device;
+    m_pipelineCache = pipelineCache;
+    m_renderPass = renderPass;
+    m_extent = extent;
+
+    createDescriptors();
+    createPipelines();
+}
+
+void IndirectRenderer::createDescriptors() {
+    // 0: 物体（剔除读，顶点着色器读model）  1: 网格表  2: 间接命令  3: 每个网格的绘制数量
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[0].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create indirect descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size()) * IRenderPass::MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = IRenderPass::MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create indirect descriptor pool!");
+    }
+
+    std::array<VkDescriptorSetLayout, IRenderPass::MAX_FRAMES_IN_FLIGHT> layouts;
+    layouts.fill(m_setLayout);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate indirect descriptor sets!");
+    }
+
+    // 先分配最小的缓冲，descriptor set总是指向有效的缓冲
+    reserve(m_objectBuffer, MIN_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    reserve(m_meshBuffer, MIN_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    reserve(m_commandBuffer, MIN_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    reserve(m_countBuffer, MIN_BUFFER_SIZE,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+}
+
+void IndirectRenderer::createPipelines() {
+    // 剔除：push constants是视锥平面 + 物体数量
+    VkPushConstantRange cullRange{};
+    cullRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    cullRange.offset = 0;
+    cullRange.size = sizeof(CullPushConstants);
+
+    VkPipelineLayoutCreateInfo cullLayoutInfo{};
+    cullLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    cullLayoutInfo.setLayoutCount = 1;
+    cullLayoutInfo.pSetLayouts = &m_setLayout;
+    cullLayoutInfo.pushConstantRangeCount = 1;
+    cullLayoutInfo.pPushConstantRanges = &cullRange;
+
+    if (vkCreatePipelineLayout(m_device, &cullLayoutInfo, nullptr, &m_cullLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create cull pipeline layout!");
+    }
+
+    VulkanComputePipelineBuilder computeBuilder(m_device);
+    m_cullPipeline = computeBuilder
+        .setShader("shaders/compiled/gpu_cull.comp.spv")
+        .setLayout(m_cullLayout)
+        .setPipelineCache(m_pipelineCache)
+        .build();
+
+    // 绘制：push constants是ViewProjection，model矩阵从物体缓冲读
+    VkPushConstantRange drawRange{};
+    drawRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    drawRange.offset = 0;
+    drawRange.size = sizeof(glm::mat4);
+
+    VkPipelineLayoutCreateInfo drawLayoutInfo{};
+    drawLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    drawLayoutInfo.setLayoutCount = 1;
+    drawLayoutInfo.pSetLayouts = &m_setLayout;
+    drawLayoutInfo.pushConstantRangeCount = 1;
+    drawLayoutInfo.pPushConstantRanges = &drawRange;
+
+    if (vkCreatePipelineLayout(m_device, &drawLayoutInfo, nullptr, &m_drawLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create indirect draw pipeline layout!");
+    }
+
+    VulkanPipelineBuilder builder(m_device);
+
+    auto bindings = Vertex::getBindingDescription();
+    auto attributes = Vertex::getAttributeDescriptions();
+
+    m_drawPipeline = builder
+        .setShaders("shaders/compiled/gpu_driven.vert.spv", "shaders/compiled/simple.frag.spv")
+        .setVertexInput({bindings}, attributes)
+        .setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+        .setViewport(m_extent)
+        .setRasterizer(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE)
+        .setMultisampling(VK_SAMPLE_COUNT_1_BIT)
+        .setDepthStencil(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS)
+        .setColorBlending(VK_FALSE)
+        .setDescriptorSetLayout(m_setLayout)
+        .setPipelineLayout(m_drawLayout)
+        .setRenderPass(m_renderPass, 0)
+        .setPipelineCache(m_pipelineCache)
+        .build();
+}
+
+void IndirectRenderer::beginFrame(uint32_t frameIndex) {
+    m_frameIndex = frameIndex;
+
+    // 每次beginFrame都意味着又有一帧在GPU上执行完了
+    for (size_t i = 0; i < m_retiredBuffers.size();) {
+        if (--m_retiredBuffers[i].framesLeft == 0) {
+            m_retiredBuffers[i].buffer->cleanup();
+            m_retiredBuffers[i] = std::move(m_retiredBuffers.back());
+            m_retiredBuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+// ============================================================================
+// 场景同步
+// ============================================================================
+
+IndirectRenderer::GPUObject IndirectRenderer::makeObject(const Entry& entry) const {
+    GPUObject object{};
+    object.model = entry.transform->transform;
+    object.boundsCenter = glm::vec4(entry.localBounds.getCenter(), 0.0f);
+    object.boundsExtents = glm::vec4(entry.localBounds.getExtents(), 0.0f);
+    object.meshIndex = entry.meshIndex;
+    return object;
+}
+
+void IndirectRenderer::queueObject(uint32_t objectIndex, const GPUObject& object) {
+    VkDeviceSize srcOffset = m_pendingObjects.size() * sizeof(GPUObject);
+    VkDeviceSize dstOffset = objectIndex * sizeof(GPUObject);
+    m_pendingObjects.push_back(object);
+
+    // 相邻的物体合并成一个复制区域
+    if (!m_objectCopies.empty()) {
+        VkBufferCopy& last = m_objectCopies.back();
+        if (last.dstOffset + last.size == dstOffset && last.srcOffset + last.size == srcOffset) {
+            last.size += sizeof(GPUObject);
+            return;
+        }
+    }
+    m_objectCopies.push_back({ srcOffset, dstOffset, sizeof(GPUObject) });
+}
+
+void IndirectRenderer::rebuild(ECS& ecs) {
+    m_entries.clear();
+    m_meshes.clear();
+    m_gpuMeshes.clear();
+    m_groups.clear();
+    m_pendingObjects.clear();
+    m_objectCopies.clear();
+
+    // 没有网格的实体也记下来（meshIndex = NO_MESH），之后设置了网格能被发现
+    std::unordered_map<Mesh*, uint32_t> meshIndices;
+    std::vector<uint32_t> meshDraws;
+
+    ecs.view<MeshComponent, MaterialComponent, TransformComponent, AABBComponent>().each(
+        [&](Entity, MeshComponent& meshComp, MaterialComponent&,
+            TransformComponent& transformComp, AABBComponent& aabbComp) {
+            Entry entry;
+            entry.transform = &transformComp;
+            entry.bounds = &aabbComp;
+            entry.meshComponent = &meshComp;
+            entry.mesh = meshComp.mesh;
+            entry.transformVersion = transformComp.version;
+            entry.localBounds = aabbComp;
+
+            if (meshComp.mesh) {
+                auto result = meshIndices.emplace(meshComp.mesh, static_cast<uint32_t>(m_meshes.size()));
+                if (result.second) {
+                    m_meshes.push_back(meshComp.mesh);
+                    meshDraws.push_back(0);
+                }
+                entry.meshIndex = result.first->second;
+                meshDraws[entry.meshIndex]++;
+            }
+            m_entries.push_back(entry);
+        });
+
+    // 按缓冲分组：最坏情况下组里的物体全部可见，组的命令区要放得下
+    for (uint32_t i = 0; i < m_meshes.size(); ++i) {
+        Mesh* mesh = m_meshes[i];
+        VkBuffer vertexBuffer = mesh->getVertexBuffer();
+        VkBuffer indexBuffer = mesh->getIndexBuffer();
+
+        auto group = std::find_if(m_groups.begin(), m_groups.end(), [&](const DrawGroup& candidate) {
+            return candidate.vertexBuffer == vertexBuffer && candidate.indexBuffer == indexBuffer;
+        });
+        if (group == m_groups.end()) {
+            m_groups.push_back({ mesh, vertexBuffer, indexBuffer, 0, 0 });
+            group = m_groups.end() - 1;
+        }
+        group->maxDraws += meshDraws[i];
+
+        GPUMesh gpuMesh{};
+        gpuMesh.indexCount = mesh->getIndexCount();
+        gpuMesh.firstIndex = mesh->getFirstIndex();
+        gpuMesh.vertexOffset = mesh->getVertexOffset();
+        gpuMesh.drawGroup = static_cast<uint32_t>(group - m_groups.begin());
+        m_gpuMeshes.push_back(gpuMesh);
+    }
+
+    uint32_t firstCommand = 0;
+    for (DrawGroup& group : m_groups) {
+        group.firstCommand = firstCommand;
+        firstCommand += group.maxDraws;
+    }
+    for (GPUMesh& gpuMesh : m_gpuMeshes) {
+        gpuMesh.firstCommand = m_groups[gpuMesh.drawGroup].firstCommand;
+    }
+
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        queueObject(static_cast<uint32_t>(i), makeObject(m_entries[i]));
+    }
+    m_meshesDirty = true;
+
+    // 容量只在这里增长；所有内容都会重新上传，所以换缓冲不需要保留旧数据
+    reserve(m_objectBuffer, m_entries.size() * sizeof(GPUObject),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    reserve(m_meshBuffer, m_gpuMeshes.size() * sizeof(GPUMesh),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    reserve(m_commandBuffer, firstCommand * COMMAND_STRIDE,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    reserve(m_countBuffer, m_groups.size() * sizeof(uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+    m_structureVersion = ecs.getStructureVersion();
+    m_stats.rebuilt = true;
+}
+
+bool IndirectRenderer::collectChanges() {
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        Entry& entry = m_entries[i];
+        if (entry.meshComponent->mesh != entry.mesh) return false;
+
+        if (entry.transform->version == entry.transformVersion
+            && entry.bounds->min == entry.localBounds.min
+            && entry.bounds->max == entry.localBounds.max) {
+            continue;
+        }
+
+        // 网格没变，所以上传过的meshIndex仍然有效
+        entry.transformVersion = entry.transform->version;
+        entry.localBounds = *entry.bounds;
+        queueObject(static_cast<uint32_t>(i), makeObject(entry));
+    }
+    return true;
+}
+
+bool IndirectRenderer::refreshMeshes() {
+    for (size_t i = 0; i < m_meshes.size(); ++i) {
+        const Mesh* mesh = m_meshes[i];
+        GPUMesh& gpuMesh = m_gpuMeshes[i];
+
+        const DrawGroup& group = m_groups[gpuMesh.drawGroup];
+        if (mesh->getVertexBuffer() != group.vertexBuffer || mesh->getIndexBuffer() != group.indexBuffer) {
+            return false;
+        }
+
+        uint32_t firstIndex = mesh->getFirstIndex();
+        int32_t vertexOffset = mesh->getVertexOffset();
+        if (firstIndex != gpuMesh.firstIndex || vertexOffset != gpuMesh.vertexOffset
+            || mesh->getIndexCount() != gpuMesh.indexCount) {
+            gpuMesh.firstIndex = firstIndex;
+            gpuMesh.vertexOffset = vertexOffset;
+            gpuMesh.indexCount = mesh->getIndexCount();
+            m_meshesDirty = true;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// 缓冲管理
+// ============================================================================
+
+bool IndirectRenderer::reserve(GPUBuffer& target, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (target.buffer && size <= target.capacity) return false;
+
+    VkDeviceSize capacity = std::max(MIN_BUFFER_SIZE, target.capacity);
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    if (target.buffer) {
+        retire(std::move(target.buffer));
+    }
+    target.buffer = std::make_unique<VulkanBuffer>();
+    target.buffer->create(m_allocator, capacity, usage, VulkanBuffer::MemoryLocation::GPU_ONLY);
+    target.capacity = capacity;
+
+    m_bufferGeneration++;
+    return true;
+}
+
+void IndirectRenderer::retire(std::unique_ptr<VulkanBuffer> buffer) {
+    // 正在GPU上执行的帧可能还在用它
+    m_retiredBuffers.push_back({ std::move(buffer), IRenderPass::MAX_FRAMES_IN_FLIGHT });
+}
+
+IndirectRenderer::StagingBuffer& IndirectRenderer::reserveStaging(VkDeviceSize size) {
+    StagingBuffer& staging = m_stagingBuffers[m_frameIndex];
+    if (staging.buffer && size <= staging.capacity) return staging;
+
+    // 这一帧的旧staging缓冲GPU已经用完（beginFrame保证），可以直接销毁
+    VkDeviceSize capacity = std::max(MIN_BUFFER_SIZE, staging.capacity);
+    while (capacity < size) {
+        capacity *= 2;
+    }
+
+    if (staging.buffer) {
+        staging.buffer->unmap();
+        staging.buffer->cleanup();
+    }
+    staging.buffer = std::make_unique<VulkanBuffer>();
+    staging.buffer->create(m_allocator, capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+    staging.mapped = static_cast<uint8_t*>(staging.buffer->map());
+    staging.capacity = capacity;
+    return staging;
+}
+
+void IndirectRenderer::updateDescriptorSet(uint32_t frameIndex) {
+    if (m_setGenerations[frameIndex] == m_bufferGeneration) return;
+
+    // 这个set上一次被使用的帧已经执行完（beginFrame保证），可以更新
+    std::array<VkDescriptorBufferInfo, 4> bufferInfos = {{
+        { m_objectBuffer.buffer->getHandle(), 0, VK_WHOLE_SIZE },
+        { m_meshBuffer.buffer->getHandle(), 0, VK_WHOLE_SIZE },
+        { m_commandBuffer.buffer->getHandle(), 0, VK_WHOLE_SIZE },
+        { m_countBuffer.buffer->getHandle(), 0, VK_WHOLE_SIZE },
+    }};
+
+    std::array<VkWriteDescriptorSet, 4> writes{};
+    for (uint32_t i = 0; i < writes.size(); ++i) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = m_descriptorSets[frameIndex];
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+
+    m_setGenerations[frameIndex] = m_bufferGeneration;
+}
+
+void IndirectRenderer::recordUploads(VkCommandBuffer cmd) {
+    VkDeviceSize objectBytes = m_pendingObjects.size() * sizeof(GPUObject);
+    VkDeviceSize meshBytes = m_meshesDirty ? m_gpuMeshes.size() * sizeof(GPUMesh) : 0;
+    if (objectBytes + meshBytes == 0) return;
+
+    // staging布局：[物体...][网格表]
+    StagingBuffer& staging = reserveStaging(objectBytes + meshBytes);
+    if (objectBytes > 0) {
+        std::memcpy(staging.mapped, m_pendingObjects.data(), objectBytes);
+        vkCmdCopyBuffer(cmd, staging.buffer->getHandle(), m_objectBuffer.buffer->getHandle(),
+                        static_cast<uint32_t>(m_objectCopies.size()), m_objectCopies.data());
+    }
+    if (meshBytes > 0) {
+        std::memcpy(staging.mapped + objectBytes, m_gpuMeshes.data(), meshBytes);
+        VkBufferCopy region{ objectBytes, 0, meshBytes };
+        vkCmdCopyBuffer(cmd, staging.buffer->getHandle(), m_meshBuffer.buffer->getHandle(), 1, &region);
+    }
+    staging.buffer->flush(0, objectBytes + meshBytes);
+}
+
+// ============================================================================
+// 录制
+// ============================================================================
+
+void IndirectRenderer::cull(VkCommandBuffer cmd, ECS& ecs, const glm::mat4& viewProjection) {
+    m_stats = Stats();
+    m_pendingObjects.clear();
+    m_objectCopies.clear();
+    m_meshesDirty = false;
+
+    // 组件指针只在结构不变时有效；MeshArena扩容后网格换了缓冲，分组要重新算
+    if (ecs.getStructureVersion() != m_structureVersion || !collectChanges() || !refreshMeshes()) {
+        rebuild(ecs);
+    }
+
+    m_stats.objects = static_cast<uint32_t>(m_entries.size());
+    m_stats.meshes = static_cast<uint32_t>(m_meshes.size());
+    m_stats.drawGroups = static_cast<uint32_t>(m_groups.size());
+    m_stats.uploadedObjects = static_cast<uint32_t>(m_pendingObjects.size());
+    m_stats.copyRegions = static_cast<uint32_t>(m_objectCopies.size());
+
+    if (m_groups.empty()) return;
+
+    updateDescriptorSet(m_frameIndex);
+
+    // 1. 上一帧的间接绘制、顶点着色器、剔除都结束之后才能覆盖共用的缓冲（WAR，只需要执行依赖）
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+    // 2. 上传变化的物体，计数清零
+    recordUploads(cmd);
+    vkCmdFillBuffer(cmd, m_countBuffer.buffer->getHandle(), 0, m_groups.size() * sizeof(uint32_t), 0);
+
+    VkMemoryBarrier uploadBarrier{};
+    uploadBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    uploadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    uploadBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+        0, 1, &uploadBarrier, 0, nullptr, 0, nullptr);
+
+    // 3. 剔除，每个线程一个物体
+    CullPushConstants push{};
+    Frustum frustum = Frustum::fromViewProjection(viewProjection);
+    std::copy(std::begin(frustum.planes), std::end(frustum.planes), push.planes);
+    push.objectCount = m_stats.objects;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullLayout, 0, 1,
+                            &m_descriptorSets[m_frameIndex], 0, nullptr);
+    vkCmdPushConstants(cmd, m_cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullPushConstants), &push);
+    vkCmdDispatch(cmd, (m_stats.objects + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+    // 4. 命令和计数写完才能被间接绘制读取
+    VkMemoryBarrier cullBarrier{};
+    cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(cmd,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+        0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void IndirectRenderer::draw(VkCommandBuffer cmd, const glm::mat4& viewProjection) {
+    if (m_groups.empty()) return;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_drawPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_drawLayout, 0, 1,
+                            &m_descriptorSets[m_frameIndex], 0, nullptr);
+    vkCmdPushConstants(cmd, m_drawLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &viewProjection);
+
+    // 每个绘制组一次：GPU从计数缓冲读取绘制数量（最多maxDraws）
+    VkBuffer commands = m_commandBuffer.buffer->getHandle();
+    VkBuffer counts = m_countBuffer.buffer->getHandle();
+    for (uint32_t i = 0; i < m_groups.size(); ++i) {
+        const DrawGroup& group = m_groups[i];
+        group.bindMesh->bind(cmd);
+        vkCmdDrawIndexedIndirectCount(cmd,
+            commands, group.firstCommand * COMMAND_STRIDE,
+            counts, i * sizeof(uint32_t),
+            group.maxDraws, static_cast<uint32_t>(COMMAND_STRIDE));
+    }
+}
+
+void IndirectRenderer::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    for (RetiredBuffer& retired : m_retiredBuffers) {
+        retired.buffer->cleanup();
+    }
+    m_retiredBuffers.clear();
+
+    for (GPUBuffer* target : { &m_objectBuffer, &m_meshBuffer, &m_commandBuffer, &m_countBuffer }) {
+        if (target->buffer) {
+            target->buffer->cleanup();
+            target->buffer.reset();
+        }
+        target->capacity = 0;
+    }
+
+    for (StagingBuffer& staging : m_stagingBuffers) {
+        if (staging.buffer) {
+            staging.buffer->unmap();
+            staging.buffer->cleanup();
+            staging.buffer.reset();
+        }
+        staging.mapped = nullptr;
+        staging.capacity = 0;
+    }
+
+    if (m_drawPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_drawPipeline, nullptr);
+        m_drawPipeline = VK_NULL_HANDLE;
+    }
+    if (m_drawLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_drawLayout, nullptr);
+        m_drawLayout = VK_NULL_HANDLE;
+    }
+    if (m_cullPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_cullPipeline, nullptr);
+        m_cullPipeline = VK_NULL_HANDLE;
+    }
+    if (m_cullLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_cullLayout, nullptr);
+        m_cullLayout = VK_NULL_HANDLE;
+    }
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);   // 同时释放descriptor sets
+        m_descriptorPool = VK_NULL_HANDLE;
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+        m_setLayout = VK_NULL_HANDLE;
+    }
+
+    m_entries.clear();
+    m_meshes.clear();
+    m_gpuMeshes.clear();
+    m_groups.clear();
+    m_structureVersion = UINT64_MAX;
+    m_device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Rendering/RenderPass.h"
+#include "Core/VulkanBuffer.h"
+#include "ECS/Components.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ECS;
+class Mesh;
+
+/**
+ * @brief GPU驱动的绘制 - 剔除和绘制命令生成都在GPU上
+ *
+ * ForwardPass的CPU路径每帧要遍历所有实体、剔除、排序、逐个录制。
+ * 物体很多（几十万）时这些CPU工作本身就是瓶颈。这里改成：
+ *
+ * 1. 所有物体的model矩阵和局部包围盒放在一个GPU_ONLY的存储缓冲里，
+ *    只在场景结构变化时整体上传，之后每帧只上传变化了的物体
+ *    （TransformComponent::version变了，或者包围盒被修改）
+ * 2. 使用同一对顶点/索引缓冲的网格是一个绘制组（MeshArena里的网格全在一个组）。
+ *    计算着色器（gpu_cull.comp）每个线程测试一个物体，可见的写一条
+ *    VkDrawIndexedIndirectCommand（带网格的firstIndex/vertexOffset）到它绘制组的命令区，
+ *    并原子递增这个组的计数
+ * 3. 每个绘制组录制一次vkCmdDrawIndexedIndirectCount：
+ *    绘制数量由GPU从计数缓冲读取，CPU不知道也不需要知道有多少可见
+ *
+ * CPU每帧的工作只和网格种类数、变化的物体数有关，和物体总数无关
+ * （除了检查version的一次线性扫描）。整个场景都在MeshArena里时只有一次间接绘制。
+ *
+ * 限制：
+ * - 没有放进MeshArena的网格各自是一个绘制组
+ * - 所有物体用同一个pipeline着色（顶点颜色，和SimpleMaterial相同），忽略材质
+ * - 需要Vulkan 1.2的drawIndirectCount和drawIndirectFirstInstance特性
+ *   （VulkanContext::isGPUDrivenSupported()，ForwardPass不支持时拒绝启用）
+ * - 剔除结果在GPU上，CPU拿不到可见数量
+ *
+ * 同步：
+ * - 物体/命令/计数缓冲所有帧共用。每帧开头的屏障等上一帧的间接绘制和
+ *   顶点着色器读完才覆盖（屏障的第一个作用域包含队列上之前提交的所有命令）
+ * - 上传用的staging缓冲和descriptor set每帧一份
+ * - 换掉的旧缓冲延迟MAX_FRAMES_IN_FLIGHT帧再销毁
+ *
+ * 使用方法（ForwardPass::setGPUDriven(true)时由ForwardPass调用）：
+ *   indirect.beginFrame(frameIndex);
+ *   indirect.cull(cmd, ecs, viewProjection);   // RenderPass之外
+ *   ...vkCmdBeginRenderPass...
+ *   indirect.draw(cmd, viewProjection);
+ */
+class IndirectRenderer {
+public:
+    // 上一帧的统计
+    struct Stats {
+        uint32_t objects = 0;           // GPU上的物体（参与剔除）
+        uint32_t meshes = 0;            // 网格种类
+        uint32_t drawGroups = 0;        // 间接绘制次数
+        uint32_t uploadedObjects = 0;   // 这一帧上传的物体
+        uint32_t copyRegions = 0;       // 上传合并成的复制区域
+        bool rebuilt = false;           // 场景结构变化，整体重新上传
+    };
+
+    static constexpr uint32_t CULL_GROUP_SIZE = 64;      // 和gpu_cull.comp的local_size_x一致
+    static constexpr uint32_t NO_MESH = 0xFFFFFFFFu;
+
+    IndirectRenderer() = default;
+    ~IndirectRenderer();
+
+    void initialize(
+        VmaAllocator allocator,
+        VkDevice device,
+        VkRenderPass renderPass,
+        VkExtent2D extent,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
+    );
+
+    void beginFrame(uint32_t frameIndex);
+
+    // RenderPass之外录制：上传变化的物体、清零计数、剔除并生成间接命令
+    void cull(VkCommandBuffer cmd, ECS& ecs, const glm::mat4& viewProjection);
+
+    // 主RenderPass之内录制：每个绘制组一次vkCmdDrawIndexedIndirectCount
+    void draw(VkCommandBuffer cmd, const glm::mat4& viewProjection);
+
+    void cleanup();
+
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    // 和gpu_cull.comp / gpu_driven.vert的std430布局一致
+    struct GPUObject {
+        glm::mat4 model;
+        glm::vec4 boundsCenter;
+        glm::vec4 boundsExtents;
+        uint32_t meshIndex;
+        uint32_t padding[3];
+    };
+    static_assert(sizeof(GPUObject) == 112, "GPUObject must match the std430 layout");
+
+    struct GPUMesh {
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        uint32_t drawGroup;
+        uint32_t firstCommand;              // 绘制组的命令区起点
+        uint32_t padding[3];
+    };
+
+    struct CullPushConstants {
+        glm::vec4 planes[6];
+        uint32_t objectCount;
+    };
+
+    struct Entry {
+        const TransformComponent* transform = nullptr;
+        const AABBComponent* bounds = nullptr;
+        const MeshComponent* meshComponent = nullptr;
+        Mesh* mesh = nullptr;               // 上传时的网格，变了就需要重建网格表
+        uint32_t meshIndex = NO_MESH;
+        uint32_t transformVersion = 0;
+        AABBComponent localBounds;          // 副本，用来发现组件被修改
+    };
+
+    // 使用同一对顶点/索引缓冲的网格
+    struct DrawGroup {
+        Mesh* bindMesh;                     // 组里任意一个网格，用来绑定缓冲
+        VkBuffer vertexBuffer;
+        VkBuffer indexBuffer;
+        uint32_t firstCommand;
+        uint32_t maxDraws;                  // 使用这个组里网格的物体数
+    };
+
+    struct GPUBuffer {
+        std::unique_ptr<VulkanBuffer> buffer;
+        VkDeviceSize capacity = 0;
+    };
+
+    struct StagingBuffer {
+        std::unique_ptr<VulkanBuffer> buffer;
+        uint8_t* mapped = nullptr;
+        VkDeviceSize capacity = 0;
+    };
+
+    struct RetiredBuffer {
+        std::unique_ptr<VulkanBuffer> buffer;
+        uint32_t framesLeft;
+    };
+
+    void createDescriptors();
+    void createPipelines();
+
+    // 场景结构或者某个实体的网格变了：重新收集所有物体，整体上传
+    void rebuild(ECS& ecs);
+    // 只收集version/包围盒变化的物体；发现网格变化时返回false（需要rebuild）
+    bool collectChanges();
+    // 网格在缓冲里的位置变了（MeshArena整理）就更新网格表；缓冲换了返回false（需要rebuild）
+    bool refreshMeshes();
+    void queueObject(uint32_t objectIndex, const GPUObject& object);
+
+    GPUObject makeObject(const Entry& entry) const;
+
+    // 容量不够时换一个更大的缓冲（旧的延迟销毁），返回是否换了
+    bool reserve(GPUBuffer& target, VkDeviceSize size, VkBufferUsageFlags usage);
+    void retire(std::unique_ptr<VulkanBuffer> buffer);
+    StagingBuffer& reserveStaging(VkDeviceSize size);
+
+    void updateDescriptorSet(uint32_t frameIndex);
+    void recordUploads(VkCommandBuffer cmd);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    VkRenderPass m_renderPass = VK_NULL_HANDLE;
+    VkExtent2D m_extent = { 0, 0 };
+
+    VkDescriptorSetLayout m_setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet m_descriptorSets[IRenderPass::MAX_FRAMES_IN_FLIGHT] = {};
+    uint64_t m_setGenerations[IRenderPass::MAX_FRAMES_IN_FLIGHT] = {};
+    uint64_t m_bufferGeneration = 1;    // 任何一个缓冲被换掉时递增
+
+    VkPipelineLayout m_cullLayout = VK_NULL_HANDLE;
+    VkPipeline m_cullPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout m_drawLayout = VK_NULL_HANDLE;
+    VkPipeline m_drawPipeline = VK_NULL_HANDLE;
+
+    GPUBuffer m_objectBuffer;     // GPUObject[]
+    GPUBuffer m_meshBuffer;       // GPUMesh[]
+    GPUBuffer m_commandBuffer;    // VkDrawIndexedIndirectCommand[]，每个绘制组一段
+    GPUBuffer m_countBuffer;      // uint32_t[]，每个绘制组一个
+    StagingBuffer m_stagingBuffers[IRenderPass::MAX_FRAMES_IN_FLIGHT];
+    std::vector<RetiredBuffer> m_retiredBuffers;
+    uint32_t m_frameIndex = 0;
+
+    std::vector<Entry> m_entries;
+    std::vector<Mesh*> m_meshes;            // meshIndex -> 网格
+    std::vector<GPUMesh> m_gpuMeshes;
+    std::vector<DrawGroup> m_groups;
+    uint64_t m_structureVersion = UINT64_MAX;
+
+    // 这一帧要上传的物体，和它们合并成的复制区域（srcOffset相对staging里物体段的起点）
+    std::vector<GPUObject> m_pendingObjects;
+    std::vector<VkBufferCopy> m_objectCopies;
+    bool m_meshesDirty = false;
+
+    Stats m_stats;
+};
@@ -40,6 +40,35 @@ public:
      */
     virtual void bind(VkCommandBuffer commandBuffer) = 0;
 
+    /**
+     * @brief 材质使用的pipeline（用于按pipeline排序和去掉重复绑定）
+     *
+     * 返回VK_NULL_HANDLE表示不公开pipeline，这时DrawList每次换材质都调用bind()
+     */
+    virtual VkPipeline getPipeline() const { return VK_NULL_HANDLE; }
+
+    /**
+     * @brief 实例化绘制用的pipeline（顶点输入多一个InstanceData的binding 1）
+     *
+     * 返回VK_NULL_HANDLE表示材质不支持实例化，它的绘制总是逐个录制
+     */
+    virtual VkPipeline getInstancedPipeline() const { return VK_NULL_HANDLE; }
+
+    /**
+     * @brief 只绑定材质自己的资源（descriptor sets等），不绑定pipeline
+     *
+     * 和getPipeline()配合使用：pipeline相同的材质之间切换时只调用这个
+     */
+    virtual void bindResources(VkCommandBuffer) {}
+
+    /**
+     * @brief pipeline是否已经可以使用
+     *
+     * 后台编译pipeline的材质在编译完成之前返回false，
+     * 这时ForwardPass用替代材质绘制（或者跳过），不会等待编译
+     */
+    virtual bool isReady() const { return true; }
+
     /**
      * @brief 渲染ImGui控件（材质参数编辑）
      *
@@ -1,6 +1,9 @@
 #include "Rendering/Mesh.h"
+#include "Rendering/MeshBVH.h"
+#include "Framework/JobSystem.h"
 #include <cstring>
 #include <cmath>
+#include <utility>
 
 // ============================================================================
 // Vertex描述
@@ -44,14 +47,65 @@ std::vector<VkVertexInputAttributeDescription> Vertex::getAttributeDescriptions(
     return attributeDescriptions;
 }
 
+VkVertexInputBindingDescription Vertex::getInstanceBindingDescription() {
+    VkVertexInputBindingDescription bindingDescription{};
+    bindingDescription.binding = 1;
+    bindingDescription.stride = sizeof(InstanceData);
+    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    return bindingDescription;
+}
+
+std::vector<VkVertexInputAttributeDescription> Vertex::getInstanceAttributeDescriptions() {
+    // mat4占4个location，每列一个vec4
+    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(4);
+
+    // Location 4-7: model矩阵
+    for (uint32_t column = 0; column < 4; ++column) {
+        attributeDescriptions[column].binding = 1;
+        attributeDescriptions[column].location = 4 + column;
+        attributeDescriptions[column].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[column].offset = offsetof(InstanceData, model) + sizeof(glm::vec4) * column;
+    }
+
+    return attributeDescriptions;
+}
+
 // ============================================================================
 // Mesh实现
 // ============================================================================
 
+Mesh::Mesh() = default;
+
 Mesh::~Mesh() {
     cleanup();
 }
 
+Mesh::Mesh(Mesh&& other) noexcept
+    : m_vertices(std::move(other.m_vertices))
+    , m_indices(std::move(other.m_indices))
+    , m_vertexBuffer(std::move(other.m_vertexBuffer))
+    , m_indexBuffer(std::move(other.m_indexBuffer))
+    , m_arena(std::exchange(other.m_arena, nullptr))
+    , m_arenaHandle(std::exchange(other.m_arenaHandle, MeshArena::INVALID_HANDLE))
+    , m_device(std::exchange(other.m_device, VK_NULL_HANDLE))
+    , m_bvh(std::move(other.m_bvh)) {
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        cleanup();
+        m_vertices = std::move(other.m_vertices);
+        m_indices = std::move(other.m_indices);
+        m_vertexBuffer = std::move(other.m_vertexBuffer);
+        m_indexBuffer = std::move(other.m_indexBuffer);
+        m_arena = std::exchange(other.m_arena, nullptr);
+        m_arenaHandle = std::exchange(other.m_arenaHandle, MeshArena::INVALID_HANDLE);
+        m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+        m_bvh = std::move(other.m_bvh);
+    }
+    return *this;
+}
+
 void Mesh::create(
     VmaAllocator allocator,
     VkDevice device,
@@ -60,9 +114,12 @@ void Mesh::create(
     const std::vector<Vertex>& vertices,
     const std::vector<uint32_t>& indices
 ) {
+    cleanup();
+
     m_device = device;
     m_vertices = vertices;
     m_indices = indices;
+    m_bvh.reset();
 
     // 创建顶点缓冲
     VkDeviceSize vertexBufferSize = sizeof(Vertex) * vertices.size();
@@ -89,88 +146,242 @@ void Mesh::create(
     );
 }
 
+void Mesh::create(
+    MeshArena& arena,
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices
+) {
+    cleanup();
+
+    m_vertices = vertices;
+    m_indices = indices;
+    m_bvh.reset();
+
+    m_arena = &arena;
+    m_arenaHandle = arena.upload(vertices, indices);
+}
+
 void Mesh::cleanup() {
     m_vertexBuffer.cleanup();
     m_indexBuffer.cleanup();
+
+    if (m_arena) {
+        m_arena->free(m_arenaHandle);
+        m_arena = nullptr;
+        m_arenaHandle = MeshArena::INVALID_HANDLE;
+    }
+}
+
+uint32_t Mesh::getFirstIndex() const {
+    return m_arena ? m_arena->get(m_arenaHandle).firstIndex : 0;
+}
+
+int32_t Mesh::getVertexOffset() const {
+    return m_arena ? static_cast<int32_t>(m_arena->get(m_arenaHandle).vertexOffset) : 0;
+}
+
+VkBuffer Mesh::getVertexBuffer() const {
+    return m_arena ? m_arena->getVertexBuffer() : m_vertexBuffer.getHandle();
+}
+
+VkBuffer Mesh::getIndexBuffer() const {
+    return m_arena ? m_arena->getIndexBuffer() : m_indexBuffer.getHandle();
+}
+
+const MeshBVH& Mesh::getBVH() const {
+    // 直接从m_vertices/m_indices构建，不复制几何数据
+    if (!m_bvh) {
+        m_bvh = std::make_unique<const MeshBVH>(m_vertices, m_indices);
+    }
+    return *m_bvh;
 }
 
 void Mesh::draw(VkCommandBuffer commandBuffer) const {
+    bind(commandBuffer);
+    drawIndexed(commandBuffer);
+}
+
+void Mesh::bind(VkCommandBuffer commandBuffer) const {
     // 绑定顶点缓冲
-    VkBuffer vertexBuffers[] = { m_vertexBuffer.getHandle() };
+    VkBuffer vertexBuffers[] = { getVertexBuffer() };
     VkDeviceSize offsets[] = { 0 };
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
 
     // 绑定索引缓冲
-    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer.getHandle(), 0, VK_INDEX_TYPE_UINT32);
+    vkCmdBindIndexBuffer(commandBuffer, getIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+}
 
-    // 绘制
-    vkCmdDrawIndexed(commandBuffer, getIndexCount(), 1, 0, 0, 0);
+void Mesh::drawIndexed(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance) const {
+    // 放在MeshArena里时缓冲是共享的，用firstIndex/vertexOffset定位这个网格
+    vkCmdDrawIndexed(commandBuffer, getIndexCount(), instanceCount, getFirstIndex(), getVertexOffset(), firstInstance);
 }
 
 // ============================================================================
 // 基础几何体创建
 // ============================================================================
 
+// 几何数据生成和上传方式（独立缓冲 / MeshArena）无关
+namespace {
+    void generateCube(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+        // 立方体顶点（每个面不同颜色）
+        vertices = {
+            // Front face (红色)
+            {{-0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+            {{ 0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+            {{ 0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+            {{-0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+
+            // Back face (绿色)
+            {{ 0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f}},
+            {{-0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f}},
+            {{-0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 1.0f}},
+            {{ 0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f}},
+
+            // Top face (蓝色)
+            {{-0.5f,  0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+            {{ 0.5f,  0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+            {{ 0.5f,  0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+            {{-0.5f,  0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
+
+            // Bottom face (黄色)
+            {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f}},
+            {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {1.0f, 0.0f}},
+            {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {1.0f, 1.0f}},
+            {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 1.0f}},
+
+            // Right face (品红)
+            {{ 0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+            {{ 0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+            {{ 0.5f,  0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}},
+            {{ 0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}},
+
+            // Left face (青色)
+            {{-0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
+            {{-0.5f, -0.5f,  0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
+            {{-0.5f,  0.5f,  0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}},
+            {{-0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}},
+        };
+
+        // 索引（每个面2个三角形）
+        indices = {
+            0,  1,  2,  2,  3,  0,   // Front
+            4,  5,  6,  6,  7,  4,   // Back
+            8,  9,  10, 10, 11, 8,   // Top
+            12, 13, 14, 14, 15, 12,  // Bottom
+            16, 17, 18, 18, 19, 16,  // Right
+            20, 21, 22, 22, 23, 20   // Left
+        };
+    }
+
+    void generatePlane(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, float size) {
+        float halfSize = size * 0.5f;
+
+        vertices = {
+            {{-halfSize, 0.0f, -halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+            {{ halfSize, 0.0f, -halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
+            {{ halfSize, 0.0f,  halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+            {{-halfSize, 0.0f,  halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
+        };
+
+        indices = {
+            0, 1, 2,
+            2, 3, 0
+        };
+    }
+
+    void generateSphere(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                        float radius, uint32_t segments, JobSystem* jobSystem) {
+        const float PI = 3.14159265359f;
+        const uint32_t rowVertices = segments + 1;
+
+        // 预先分配好大小，每一行只写自己的区间，可以安全并行
+        vertices.resize(static_cast<size_t>(rowVertices) * rowVertices);
+        indices.resize(static_cast<size_t>(segments) * segments * 6);
+
+        // 生成顶点（每个纬度一行）
+        auto generateVertexRows = [&](uint32_t latBegin, uint32_t latEnd) {
+            for (uint32_t lat = latBegin; lat < latEnd; ++lat) {
+                float theta = lat * PI / segments;
+                float sinTheta = std::sin(theta);
+                float cosTheta = std::cos(theta);
+
+                for (uint32_t lon = 0; lon <= segments; ++lon) {
+                    float phi = lon * 2.0f * PI / segments;
+                    float sinPhi = std::sin(phi);
+                    float cosPhi = std::cos(phi);
+
+                    glm::vec3 position(
+                        radius * sinTheta * cosPhi,
+                        radius * cosTheta,
+                        radius * sinTheta * sinPhi
+                    );
+
+                    glm::vec3 normal = glm::normalize(position);
+                    glm::vec3 color(0.8f, 0.8f, 0.8f);
+                    glm::vec2 texCoord(
+                        static_cast<float>(lon) / segments,
+                        static_cast<float>(lat) / segments
+                    );
+
+                    vertices[lat * rowVertices + lon] = {position, color, normal, texCoord};
+                }
+            }
+        };
+
+        // 生成索引（每个纬度带6 * segments个）
+        auto generateIndexRows = [&](uint32_t latBegin, uint32_t latEnd) {
+            for (uint32_t lat = latBegin; lat < latEnd; ++lat) {
+                size_t out = static_cast<size_t>(lat) * segments * 6;
+                for (uint32_t lon = 0; lon < segments; ++lon) {
+                    uint32_t first = lat * rowVertices + lon;
+                    uint32_t second = first + segments + 1;
+
+                    indices[out++] = first;
+                    indices[out++] = second;
+                    indices[out++] = first + 1;
+
+                    indices[out++] = second;
+                    indices[out++] = second + 1;
+                    indices[out++] = first + 1;
+                }
+            }
+        };
+
+        if (jobSystem) {
+            jobSystem->parallelFor(0, rowVertices, 0, generateVertexRows);
+            jobSystem->parallelFor(0, segments, 0, generateIndexRows);
+        } else {
+            generateVertexRows(0, rowVertices);
+            generateIndexRows(0, segments);
+        }
+    }
+}
+
 Mesh Mesh::createCube(
     VmaAllocator allocator,
     VkDevice device,
     VkQueue queue,
     VkCommandPool commandPool
 ) {
-    // 立方体顶点（每个面不同颜色）
-    std::vector<Vertex> vertices = {
-        // Front face (红色)
-        {{-0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
-        {{ 0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
-        {{ 0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
-        {{-0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
-
-        // Back face (绿色)
-        {{ 0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 0.0f}},
-        {{-0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 0.0f}},
-        {{-0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 1.0f}},
-        {{ 0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f}},
-
-        // Top face (蓝色)
-        {{-0.5f,  0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
-        {{ 0.5f,  0.5f,  0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
-        {{ 0.5f,  0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
-        {{-0.5f,  0.5f, -0.5f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
-
-        // Bottom face (黄色)
-        {{-0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 0.0f}},
-        {{ 0.5f, -0.5f, -0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {1.0f, 0.0f}},
-        {{ 0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {1.0f, 1.0f}},
-        {{-0.5f, -0.5f,  0.5f}, {1.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {0.0f, 1.0f}},
-
-        // Right face (品红)
-        {{ 0.5f, -0.5f,  0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
-        {{ 0.5f, -0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
-        {{ 0.5f,  0.5f, -0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}},
-        {{ 0.5f,  0.5f,  0.5f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}},
-
-        // Left face (青色)
-        {{-0.5f, -0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f}},
-        {{-0.5f, -0.5f,  0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}},
-        {{-0.5f,  0.5f,  0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {1.0f, 1.0f}},
-        {{-0.5f,  0.5f, -0.5f}, {0.0f, 1.0f, 1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f}},
-    };
-
-    // 索引（每个面2个三角形）
-    std::vector<uint32_t> indices = {
-        0,  1,  2,  2,  3,  0,   // Front
-        4,  5,  6,  6,  7,  4,   // Back
-        8,  9,  10, 10, 11, 8,   // Top
-        12, 13, 14, 14, 15, 12,  // Bottom
-        16, 17, 18, 18, 19, 16,  // Right
-        20, 21, 22, 22, 23, 20   // Left
-    };
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    generateCube(vertices, indices);
 
     Mesh mesh;
     mesh.create(allocator, device, queue, commandPool, vertices, indices);
     return mesh;
 }
 
+Mesh Mesh::createCube(MeshArena& arena) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    generateCube(vertices, indices);
+
+    Mesh mesh;
+    mesh.create(arena, vertices, indices);
+    return mesh;
+}
+
 Mesh Mesh::createPlane(
     VmaAllocator allocator,
     VkDevice device,
@@ -178,22 +389,22 @@ Mesh Mesh::createPlane(
     VkCommandPool commandPool,
     float size
 ) {
-    float halfSize = size * 0.5f;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    generatePlane(vertices, indices, size);
 
-    std::vector<Vertex> vertices = {
-        {{-halfSize, 0.0f, -halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
-        {{ halfSize, 0.0f, -halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f}},
-        {{ halfSize, 0.0f,  halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
-        {{-halfSize, 0.0f,  halfSize}, {1.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}},
-    };
+    Mesh mesh;
+    mesh.create(allocator, device, queue, commandPool, vertices, indices);
+    return mesh;
+}
 
-    std::vector<uint32_t> indices = {
-        0, 1, 2,
-        2, 3, 0
-    };
+Mesh Mesh::createPlane(MeshArena& arena, float size) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    generatePlane(vertices, indices, size);
 
     Mesh mesh;
-    mesh.create(allocator, device, queue, commandPool, vertices, indices);
+    mesh.create(arena, vertices, indices);
     return mesh;
 }
 
@@ -203,58 +414,24 @@ Mesh Mesh::createSphere(
     VkQueue queue,
     VkCommandPool commandPool,
     float radius,
-    uint32_t segments
+    uint32_t segments,
+    JobSystem* jobSystem
 ) {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
+    generateSphere(vertices, indices, radius, segments, jobSystem);
 
-    const float PI = 3.14159265359f;
-
-    // 生成顶点
-    for (uint32_t lat = 0; lat <= segments; ++lat) {
-        float theta = lat * PI / segments;
-        float sinTheta = std::sin(theta);
-        float cosTheta = std::cos(theta);
-
-        for (uint32_t lon = 0; lon <= segments; ++lon) {
-            float phi = lon * 2.0f * PI / segments;
-            float sinPhi = std::sin(phi);
-            float cosPhi = std::cos(phi);
-
-            glm::vec3 position(
-                radius * sinTheta * cosPhi,
-                radius * cosTheta,
-                radius * sinTheta * sinPhi
-            );
-
-            glm::vec3 normal = glm::normalize(position);
-            glm::vec3 color(0.8f, 0.8f, 0.8f);
-            glm::vec2 texCoord(
-                static_cast<float>(lon) / segments,
-                static_cast<float>(lat) / segments
-            );
-
-            vertices.push_back({position, color, normal, texCoord});
-        }
-    }
-
-    // 生成索引
-    for (uint32_t lat = 0; lat < segments; ++lat) {
-        for (uint32_t lon = 0; lon < segments; ++lon) {
-            uint32_t first = lat * (segments + 1) + lon;
-            uint32_t second = first + segments + 1;
-
-            indices.push_back(first);
-            indices.push_back(second);
-            indices.push_back(first + 1);
+    Mesh mesh;
+    mesh.create(allocator, device, queue, commandPool, vertices, indices);
+    return mesh;
+}
 
-            indices.push_back(second);
-            indices.push_back(second + 1);
-            indices.push_back(first + 1);
-        }
-    }
+Mesh Mesh::createSphere(MeshArena& arena, float radius, uint32_t segments, JobSystem* jobSystem) {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    generateSphere(vertices, indices, radius, segments, jobSystem);
 
     Mesh mesh;
-    mesh.create(allocator, device, queue, commandPool, vertices, indices);
+    mesh.create(arena, vertices, indices);
     return mesh;
 }
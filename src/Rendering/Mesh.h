@@ -1,9 +1,14 @@
 #pragma once
 
 #include "Core/VulkanBuffer.h"
+#include "Rendering/MeshArena.h"
 #include <glm/glm.hpp>
+#include <memory>
 #include <vector>
 
+class JobSystem;
+class MeshBVH;
+
 /**
  * @brief 顶点数据结构
  *
@@ -19,6 +24,17 @@ struct Vertex {
     // Vulkan顶点输入描述
     static VkVertexInputBindingDescription getBindingDescription();
     static std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions();
+
+    // 实例化绘制的第二个binding（binding 1，每实例一个InstanceData，location 4-7）
+    static VkVertexInputBindingDescription getInstanceBindingDescription();
+    static std::vector<VkVertexInputAttributeDescription> getInstanceAttributeDescriptions();
+};
+
+/**
+ * @brief 每实例数据（实例化绘制时从binding 1读取）
+ */
+struct InstanceData {
+    glm::mat4 model;
 };
 
 /**
@@ -31,9 +47,15 @@ struct Vertex {
  */
 class Mesh {
 public:
-    Mesh() = default;
+    Mesh();     // 在Mesh.cpp里定义：m_bvh的MeshBVH在这里只有前向声明
     ~Mesh();
 
+    // 拥有GPU缓冲（或MeshArena里的一段），只能移动
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
     // 创建网格（上传到GPU）
     void create(
         VmaAllocator allocator,
@@ -44,17 +66,40 @@ public:
         const std::vector<uint32_t>& indices
     );
 
+    // 创建网格（放进共享的MeshArena，不单独分配缓冲）
+    // arena的生命周期必须长于这个网格
+    void create(
+        MeshArena& arena,
+        const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& indices
+    );
+
     void cleanup();
 
     // 渲染（绑定并绘制）
     void draw(VkCommandBuffer commandBuffer) const;
 
+    // 分开的绑定和绘制：连续绘制同一个网格时只需要绑定一次（见DrawList）
+    void bind(VkCommandBuffer commandBuffer) const;
+    void drawIndexed(VkCommandBuffer commandBuffer, uint32_t instanceCount = 1, uint32_t firstInstance = 0) const;
+
     // Getters
     const std::vector<Vertex>& getVertices() const { return m_vertices; }
     const std::vector<uint32_t>& getIndices() const { return m_indices; }
     uint32_t getVertexCount() const { return static_cast<uint32_t>(m_vertices.size()); }
     uint32_t getIndexCount() const { return static_cast<uint32_t>(m_indices.size()); }
 
+    // 在绑定的缓冲里的位置（独立缓冲时都是0）
+    uint32_t getFirstIndex() const;
+    int32_t getVertexOffset() const;
+    // bind()绑定的缓冲：两个网格返回相同的缓冲时切换网格不需要重新绑定
+    VkBuffer getVertexBuffer() const;
+    VkBuffer getIndexBuffer() const;
+
+    // 三角形BVH（射线拾取用）：第一次调用时从顶点/索引构建，之后缓存。
+    // 从没被拾取过的网格不花构建时间，也不多占内存。不是线程安全的
+    const MeshBVH& getBVH() const;
+
     // 辅助函数：创建基础几何体
     static Mesh createCube(
         VmaAllocator allocator,
@@ -62,6 +107,7 @@ public:
         VkQueue queue,
         VkCommandPool commandPool
     );
+    static Mesh createCube(MeshArena& arena);
 
     static Mesh createPlane(
         VmaAllocator allocator,
@@ -70,6 +116,7 @@ public:
         VkCommandPool commandPool,
         float size = 1.0f
     );
+    static Mesh createPlane(MeshArena& arena, float size = 1.0f);
 
     static Mesh createSphere(
         VmaAllocator allocator,
@@ -77,7 +124,14 @@ public:
         VkQueue queue,
         VkCommandPool commandPool,
         float radius = 0.5f,
-        uint32_t segments = 32
+        uint32_t segments = 32,
+        JobSystem* jobSystem = nullptr   // 不为空时按纬度行并行生成
+    );
+    static Mesh createSphere(
+        MeshArena& arena,
+        float radius = 0.5f,
+        uint32_t segments = 32,
+        JobSystem* jobSystem = nullptr
     );
 
 private:
@@ -87,5 +141,12 @@ private:
     VulkanBuffer m_vertexBuffer;
     VulkanBuffer m_indexBuffer;
 
+    // 放在MeshArena里时不使用上面两个缓冲
+    MeshArena* m_arena = nullptr;
+    MeshArena::Handle m_arenaHandle = MeshArena::INVALID_HANDLE;
+
     VkDevice m_device = VK_NULL_HANDLE;
+
+    // getBVH()第一次调用时构建；移动时跟着走
+    mutable std::unique_ptr<const MeshBVH> m_bvh;
 };
@@ -0,0 +1,385 @@
+#include "Rendering/MeshArena.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/RenderPass.h"
+#include "Core/VulkanUploader.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+// ============================================================================
+// RangeAllocator
+// ============================================================================
+
+void RangeAllocator::reset(uint32_t capacity) {
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+    m_capacity = capacity;
+    m_used = 0;
+    if (capacity > 0) {
+        insertFree(0, capacity);
+    }
+}
+
+void RangeAllocator::grow(uint32_t newCapacity) {
+    if (newCapacity <= m_capacity) return;
+    uint32_t oldCapacity = m_capacity;
+    m_capacity = newCapacity;
+    release(oldCapacity, newCapacity - oldCapacity);
+}
+
+uint32_t RangeAllocator::allocate(uint32_t size) {
+    if (size == 0) return 0;
+
+    // best-fit：最小的够用的空闲区间
+    auto it = m_freeBySize.lower_bound(size);
+    if (it == m_freeBySize.end()) return INVALID_OFFSET;
+
+    uint32_t offset = it->second;
+    uint32_t rangeSize = it->first;
+    m_freeBySize.erase(it);
+    m_freeByOffset.erase(offset);
+
+    if (rangeSize > size) {
+        insertFree(offset + size, rangeSize - size);
+    }
+    m_used += size;
+    return offset;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t size) {
+    if (size == 0) return;
+    m_used -= size;
+    release(offset, size);
+}
+
+uint32_t RangeAllocator::getLargestFreeRange() const {
+    return m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first;
+}
+
+void RangeAllocator::release(uint32_t offset, uint32_t size) {
+    auto next = m_freeByOffset.lower_bound(offset);
+
+    // 和前一个空闲区间相接
+    if (next != m_freeByOffset.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFree(previous);
+        }
+    }
+
+    // 和后一个空闲区间相接
+    if (next != m_freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        eraseFree(next);
+    }
+
+    insertFree(offset, size);
+}
+
+void RangeAllocator::insertFree(uint32_t offset, uint32_t size) {
+    m_freeByOffset.emplace(offset, size);
+    m_freeBySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFree(std::map<uint32_t, uint32_t>::iterator it) {
+    auto range = m_freeBySize.equal_range(it->second);
+    for (auto sizeIt = range.first; sizeIt != range.second; ++sizeIt) {
+        if (sizeIt->second == it->first) {
+            m_freeBySize.erase(sizeIt);
+            break;
+        }
+    }
+    m_freeByOffset.erase(it);
+}
+
+// ============================================================================
+// MeshArena
+// ============================================================================
+
+MeshArena::~MeshArena() {
+    cleanup();
+}
+
+void MeshArena::initialize(
+    VmaAllocator allocator,
+    VkDevice device,
+    VkQueue queue,
+    VkCommandPool commandPool,
+    uint32_t vertexCapacity,
+    uint32_t indexCapacity
+) {
+    m_allocator = allocator;
+    m_device = device;
+    m_queue = queue;
+    m_commandPool = commandPool;
+
+    createBuffers(vertexCapacity, indexCapacity, m_vertexBuffer, m_indexBuffer);
+    m_vertexRanges.reset(vertexCapacity);
+    m_indexRanges.reset(indexCapacity);
+}
+
+void MeshArena::cleanup() {
+    if (m_uploader && m_vertexBuffer) {
+        // 还在排队/传输的上传引用着这两个缓冲
+        m_uploader->finish(m_queue, m_commandPool);
+    }
+    if (m_vertexBuffer) {
+        m_vertexBuffer->cleanup();
+        m_vertexBuffer.reset();
+    }
+    if (m_indexBuffer) {
+        m_indexBuffer->cleanup();
+        m_indexBuffer.reset();
+    }
+    m_vertexRanges.reset(0);
+    m_indexRanges.reset(0);
+    m_allocations.clear();
+    m_alive.clear();
+    m_freeHandles.clear();
+    m_retired.clear();
+    m_retiredVertices = 0;
+    m_retiredIndices = 0;
+}
+
+void MeshArena::createBuffers(uint32_t vertexCapacity, uint32_t indexCapacity,
+                              std::unique_ptr<VulkanBuffer>& vertexBuffer,
+                              std::unique_ptr<VulkanBuffer>& indexBuffer) const {
+    // TRANSFER_SRC：扩容/整理时要从旧缓冲复制出去
+    vertexBuffer = std::make_unique<VulkanBuffer>();
+    vertexBuffer->create(m_allocator, VkDeviceSize(vertexCapacity) * sizeof(Vertex),
+                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                         VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                         VulkanBuffer::MemoryLocation::GPU_ONLY);
+
+    indexBuffer = std::make_unique<VulkanBuffer>();
+    indexBuffer->create(m_allocator, VkDeviceSize(indexCapacity) * sizeof(uint32_t),
+                        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                        VulkanBuffer::MemoryLocation::GPU_ONLY);
+}
+
+bool MeshArena::tryAllocate(uint32_t vertexCount, uint32_t indexCount, Allocation& allocation) {
+    uint32_t vertexOffset = m_vertexRanges.allocate(vertexCount);
+    if (vertexOffset == RangeAllocator::INVALID_OFFSET) return false;
+
+    uint32_t firstIndex = m_indexRanges.allocate(indexCount);
+    if (firstIndex == RangeAllocator::INVALID_OFFSET) {
+        m_vertexRanges.free(vertexOffset, vertexCount);
+        return false;
+    }
+
+    allocation = { vertexOffset, vertexCount, firstIndex, indexCount };
+    return true;
+}
+
+MeshArena::Handle MeshArena::upload(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    uint32_t indexCount = static_cast<uint32_t>(indices.size());
+
+    Allocation allocation;
+    if (!tryAllocate(vertexCount, indexCount, allocation)) {
+        // 退役的区间在整理（等待队列）之后也是空闲的
+        uint32_t freeVertices = m_vertexRanges.getCapacity() - m_vertexRanges.getUsed() + m_retiredVertices;
+        uint32_t freeIndices = m_indexRanges.getCapacity() - m_indexRanges.getUsed() + m_retiredIndices;
+
+        if (vertexCount <= freeVertices && indexCount <= freeIndices) {
+            // 空间够，只是碎片化了：整理后空闲空间是连续的一整段
+            defragment();
+        } else {
+            // 容量翻倍（至少放得下这个网格），复制时顺便整理
+            uint32_t vertexCapacity = std::max(m_vertexRanges.getCapacity() * 2, m_vertexRanges.getUsed() + vertexCount);
+            uint32_t indexCapacity = std::max(m_indexRanges.getCapacity() * 2, m_indexRanges.getUsed() + indexCount);
+            relocate(vertexCapacity, indexCapacity);
+            m_growCount++;
+        }
+
+        if (!tryAllocate(vertexCount, indexCount, allocation)) {
+            throw std::runtime_error("Mesh arena allocation failed!");
+        }
+    }
+
+    VkDeviceSize vertexBytes = VkDeviceSize(vertexCount) * sizeof(Vertex);
+    VkDeviceSize indexBytes = VkDeviceSize(indexCount) * sizeof(uint32_t);
+    if (m_uploader) {
+        // 异步：排进uploader的批次，Renderer提交的下一帧会等待它完成
+        m_uploader->upload(*m_vertexBuffer, VkDeviceSize(allocation.vertexOffset) * sizeof(Vertex),
+                           vertices.data(), vertexBytes);
+        m_uploader->upload(*m_indexBuffer, VkDeviceSize(allocation.firstIndex) * sizeof(uint32_t),
+                           indices.data(), indexBytes);
+    } else if (vertexBytes + indexBytes > 0) {
+        // 同步：一个staging缓冲放顶点和索引，分别复制到各自的区间
+        VulkanBuffer stagingBuffer;
+        stagingBuffer.create(m_allocator, vertexBytes + indexBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                             VulkanBuffer::MemoryLocation::CPU_TO_GPU);
+
+        uint8_t* mapped = static_cast<uint8_t*>(stagingBuffer.map());
+        std::memcpy(mapped, vertices.data(), vertexBytes);
+        std::memcpy(mapped + vertexBytes, indices.data(), indexBytes);
+        stagingBuffer.unmap();
+
+        VkBufferCopy vertexRegion{ 0, VkDeviceSize(allocation.vertexOffset) * sizeof(Vertex), vertexBytes };
+        VkBufferCopy indexRegion{ vertexBytes, VkDeviceSize(allocation.firstIndex) * sizeof(uint32_t), indexBytes };
+        m_vertexBuffer->copyRegionsFrom(m_device, m_queue, m_commandPool, stagingBuffer, &vertexRegion,
+                                        vertexBytes > 0 ? 1 : 0);
+        m_indexBuffer->copyRegionsFrom(m_device, m_queue, m_commandPool, stagingBuffer, &indexRegion,
+                                       indexBytes > 0 ? 1 : 0);
+
+        stagingBuffer.cleanup();
+    }
+
+    Handle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+        m_allocations[handle] = allocation;
+        m_alive[handle] = true;
+    } else {
+        handle = static_cast<Handle>(m_allocations.size());
+        m_allocations.push_back(allocation);
+        m_alive.push_back(true);
+    }
+    return handle;
+}
+
+void MeshArena::free(Handle handle) {
+    if (handle >= m_allocations.size() || !m_alive[handle]) return;
+
+    // 正在GPU上执行的帧可能还在画它：区间过MAX_FRAMES_IN_FLIGHT帧再回收，
+    // 否则新上传的网格会覆盖还在被读的顶点
+    const Allocation& allocation = m_allocations[handle];
+    m_retired.push_back({ allocation, IRenderPass::MAX_FRAMES_IN_FLIGHT });
+    m_retiredVertices += allocation.vertexCount;
+    m_retiredIndices += allocation.indexCount;
+
+    m_allocations[handle] = Allocation();
+    m_alive[handle] = false;
+    m_freeHandles.push_back(handle);
+}
+
+void MeshArena::beginFrame() {
+    // 每次beginFrame都意味着又有一帧在GPU上执行完了
+    for (size_t i = 0; i < m_retired.size();) {
+        if (--m_retired[i].framesLeft == 0) {
+            const Allocation& allocation = m_retired[i].allocation;
+            m_vertexRanges.free(allocation.vertexOffset, allocation.vertexCount);
+            m_indexRanges.free(allocation.firstIndex, allocation.indexCount);
+            m_retiredVertices -= allocation.vertexCount;
+            m_retiredIndices -= allocation.indexCount;
+
+            m_retired[i] = m_retired.back();
+            m_retired.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void MeshArena::defragment() {
+    relocate(m_vertexRanges.getCapacity(), m_indexRanges.getCapacity());
+    m_defragmentCount++;
+}
+
+void MeshArena::relocate(uint32_t vertexCapacity, uint32_t indexCapacity) {
+    if (m_uploader) {
+        // 旧缓冲里可能还有没完成（或者还归传输队列所有）的上传
+        m_uploader->finish(m_queue, m_commandPool);
+    }
+
+    std::unique_ptr<VulkanBuffer> vertexBuffer;
+    std::unique_ptr<VulkanBuffer> indexBuffer;
+    createBuffers(vertexCapacity, indexCapacity, vertexBuffer, indexBuffer);
+
+    // 按原来的位置顺序紧密排列：相邻的网格复制区域可以合并
+    std::vector<Handle> order;
+    for (Handle handle = 0; handle < m_allocations.size(); ++handle) {
+        if (m_alive[handle]) order.push_back(handle);
+    }
+    std::sort(order.begin(), order.end(), [&](Handle a, Handle b) {
+        return m_allocations[a].vertexOffset < m_allocations[b].vertexOffset;
+    });
+
+    std::vector<VkBufferCopy> vertexRegions;
+    std::vector<VkBufferCopy> indexRegions;
+    auto addRegion = [](std::vector<VkBufferCopy>& regions, VkDeviceSize src, VkDeviceSize dst, VkDeviceSize size) {
+        if (size == 0) return;
+        if (!regions.empty()) {
+            VkBufferCopy& last = regions.back();
+            if (last.srcOffset + last.size == src && last.dstOffset + last.size == dst) {
+                last.size += size;
+                return;
+            }
+        }
+        regions.push_back({ src, dst, size });
+    };
+
+    RangeAllocator vertexRanges;
+    RangeAllocator indexRanges;
+    vertexRanges.reset(vertexCapacity);
+    indexRanges.reset(indexCapacity);
+
+    for (Handle handle : order) {
+        Allocation& allocation = m_allocations[handle];
+
+        // 新的分配器是空的，按顺序分配就是紧密排列
+        uint32_t vertexOffset = vertexRanges.allocate(allocation.vertexCount);
+        uint32_t firstIndex = indexRanges.allocate(allocation.indexCount);
+
+        addRegion(vertexRegions, VkDeviceSize(allocation.vertexOffset) * sizeof(Vertex),
+                  VkDeviceSize(vertexOffset) * sizeof(Vertex), VkDeviceSize(allocation.vertexCount) * sizeof(Vertex));
+        addRegion(indexRegions, VkDeviceSize(allocation.firstIndex) * sizeof(uint32_t),
+                  VkDeviceSize(firstIndex) * sizeof(uint32_t), VkDeviceSize(allocation.indexCount) * sizeof(uint32_t));
+
+        allocation.vertexOffset = vertexOffset;
+        allocation.firstIndex = firstIndex;
+    }
+
+    // 同步复制：返回时GPU已经不再使用旧缓冲
+    vertexBuffer->copyRegionsFrom(m_device, m_queue, m_commandPool, *m_vertexBuffer,
+                                  vertexRegions.data(), static_cast<uint32_t>(vertexRegions.size()));
+    indexBuffer->copyRegionsFrom(m_device, m_queue, m_commandPool, *m_indexBuffer,
+                                 indexRegions.data(), static_cast<uint32_t>(indexRegions.size()));
+
+    m_vertexBuffer->cleanup();
+    m_indexBuffer->cleanup();
+    m_vertexBuffer = std::move(vertexBuffer);
+    m_indexBuffer = std::move(indexBuffer);
+    m_vertexRanges = std::move(vertexRanges);
+    m_indexRanges = std::move(indexRanges);
+
+    // 复制等待过队列，之前的帧都执行完了；退役的区间没有复制，新分配器里本来就是空闲的
+    m_retired.clear();
+    m_retiredVertices = 0;
+    m_retiredIndices = 0;
+}
+
+float MeshArena::getFragmentation() const {
+    auto fragmentation = [](const RangeAllocator& ranges) {
+        uint32_t freeSpace = ranges.getCapacity() - ranges.getUsed();
+        if (freeSpace == 0) return 0.0f;
+        return 1.0f - static_cast<float>(ranges.getLargestFreeRange()) / static_cast<float>(freeSpace);
+    };
+    return std::max(fragmentation(m_vertexRanges), fragmentation(m_indexRanges));
+}
+
+void MeshArena::bind(VkCommandBuffer cmd) const {
+    VkBuffer vertexBuffers[] = { m_vertexBuffer->getHandle() };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(cmd, 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(cmd, m_indexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+}
+
+MeshArena::Stats MeshArena::getStats() const {
+    Stats stats;
+    stats.meshes = static_cast<uint32_t>(m_allocations.size() - m_freeHandles.size());
+    stats.vertexCapacity = m_vertexRanges.getCapacity();
+    stats.verticesUsed = m_vertexRanges.getUsed();
+    stats.indexCapacity = m_indexRanges.getCapacity();
+    stats.indicesUsed = m_indexRanges.getUsed();
+    stats.grows = m_growCount;
+    stats.defragmentations = m_defragmentCount;
+    stats.retiredMeshes = static_cast<uint32_t>(m_retired.size());
+    return stats;
+}
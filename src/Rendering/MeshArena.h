@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Core/VulkanBuffer.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+struct Vertex;
+class VulkanUploader;
+
+/**
+ * @brief 区间分配器 - 在[0, capacity)里分配连续区间（只记账，不碰内存）
+ *
+ * 空闲区间同时按起点和按大小索引：
+ * - allocate()：best-fit，找最小的够用的空闲区间，从它的开头切
+ * - free()：和前后相邻的空闲区间合并
+ * 两个操作都是O(log n)，n = 空闲区间数量。
+ *
+ * 单位由调用者决定（MeshArena里是顶点个数和索引个数）。
+ */
+class RangeAllocator {
+public:
+    static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+    // 清空，整个[0, capacity)都空闲
+    void reset(uint32_t capacity);
+    // 在末尾追加[capacity, newCapacity)的空闲空间
+    void grow(uint32_t newCapacity);
+
+    // 没有够大的空闲区间时返回INVALID_OFFSET
+    uint32_t allocate(uint32_t size);
+    void free(uint32_t offset, uint32_t size);
+
+    uint32_t getCapacity() const { return m_capacity; }
+    uint32_t getUsed() const { return m_used; }
+    uint32_t getLargestFreeRange() const;
+    size_t getFreeRangeCount() const { return m_freeByOffset.size(); }
+
+private:
+    // 把区间放回空闲集合，和相邻的空闲区间合并
+    void release(uint32_t offset, uint32_t size);
+    void insertFree(uint32_t offset, uint32_t size);
+    void eraseFree(std::map<uint32_t, uint32_t>::iterator it);
+
+    uint32_t m_capacity = 0;
+    uint32_t m_used = 0;
+    std::map<uint32_t, uint32_t> m_freeByOffset;          // offset -> size
+    std::multimap<uint32_t, uint32_t> m_freeBySize;       // size -> offset
+};
+
+/**
+ * @brief 网格内存池 - 所有静态网格共用一个顶点缓冲和一个索引缓冲
+ *
+ * 每个Mesh自己create两个VulkanBuffer时，N个网格是2N次VMA分配，
+ * 绘制时每换一个网格都要重新绑定缓冲。放进内存池之后：
+ * - 只有两次分配（容量不够时换更大的缓冲）
+ * - 所有网格绑定的是同一对缓冲，换网格只是换firstIndex/vertexOffset，
+ *   DrawList/IndirectRenderer不再需要重新绑定
+ * - 同一对缓冲里的网格可以合并进一次间接绘制
+ *
+ * 顶点和索引各用一个RangeAllocator分配。分配失败时：
+ * - 空闲总量够、只是碎片化了：defragment()把所有网格挤到缓冲开头
+ * - 否则容量翻倍
+ * 两种情况都是把数据复制到一个新缓冲（vkCmdCopyBuffer的源和目标区域不能重叠），
+ * 网格通过Handle访问，所以偏移变化对它们透明。
+ *
+ * 扩容、碎片整理是同步的（提交后vkQueueWaitIdle，和createBufferWithData一样），
+ * 所以不能在录制一帧的中间调用；等待返回时旧缓冲不再被任何帧使用，可以直接销毁。
+ * 上传默认也是同步的；setUploader()之后改为排进VulkanUploader的批次，不等待
+ * （扩容/整理之前先finish()，保证旧缓冲里的数据已经到位）。
+ *
+ * free()之后在飞的帧可能还在画这个网格：它的区间先放进退役列表，
+ * MAX_FRAMES_IN_FLIGHT次beginFrame()之后才还给分配器（和FrameAllocator的旧缓冲一样）。
+ * 扩容/整理等待过队列，退役的区间直接丢掉。
+ *
+ * 使用方法：
+ *   MeshArena arena;
+ *   arena.initialize(allocator, device, queue, commandPool);
+ *   arena.setUploader(renderer.getUploader());   // 可选：异步上传
+ *   Mesh cube = Mesh::createCube(arena);
+ *   ...
+ *   renderer.setMeshArena(&arena);               // 每帧等待fence之后调用arena.beginFrame()
+ *   cube.bind(cmd);          // 绑定arena的缓冲（和上一个网格相同时DrawList会跳过）
+ *   cube.drawIndexed(cmd);   // 用firstIndex/vertexOffset
+ */
+class MeshArena {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+    // 一个网格在缓冲里的位置（单位是顶点/索引个数，不是字节）
+    struct Allocation {
+        uint32_t vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+    };
+
+    struct Stats {
+        uint32_t meshes = 0;
+        uint32_t vertexCapacity = 0;
+        uint32_t verticesUsed = 0;
+        uint32_t indexCapacity = 0;
+        uint32_t indicesUsed = 0;
+        uint32_t grows = 0;
+        uint32_t defragmentations = 0;
+        uint32_t retiredMeshes = 0;     // free()过、区间还没回收的网格
+    };
+
+    MeshArena() = default;
+    ~MeshArena();
+
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    void initialize(
+        VmaAllocator allocator,
+        VkDevice device,
+        VkQueue queue,
+        VkCommandPool commandPool,
+        uint32_t vertexCapacity = 1u << 20,
+        uint32_t indexCapacity = 1u << 22
+    );
+
+    void cleanup();
+
+    // 设置后upload()走异步上传（uploader要比arena活得久）；nullptr恢复同步上传
+    void setUploader(VulkanUploader* uploader) { m_uploader = uploader; }
+
+    // 分配并上传一个网格，返回它的Handle
+    Handle upload(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+    // Handle马上可以重用；区间MAX_FRAMES_IN_FLIGHT帧之后才回收
+    void free(Handle handle);
+
+    // 一帧的fence等待之后调用（Renderer::setMeshArena之后由render()调用）：回收到期的区间
+    void beginFrame();
+
+    const Allocation& get(Handle handle) const { return m_allocations[handle]; }
+
+    // 把所有网格挤到缓冲开头，消除空洞
+    void defragment();
+    // 0 = 没有碎片（所有空闲空间连续），接近1 = 空闲空间全是小洞
+    float getFragmentation() const;
+
+    void bind(VkCommandBuffer cmd) const;
+    VkBuffer getVertexBuffer() const { return m_vertexBuffer->getHandle(); }
+    VkBuffer getIndexBuffer() const { return m_indexBuffer->getHandle(); }
+
+    Stats getStats() const;
+
+private:
+    struct RetiredRange {
+        Allocation allocation;
+        uint32_t framesLeft;
+    };
+
+    // 把存活的网格紧密排列地复制到新容量的缓冲里，替换旧缓冲
+    void relocate(uint32_t vertexCapacity, uint32_t indexCapacity);
+    void createBuffers(uint32_t vertexCapacity, uint32_t indexCapacity,
+                       std::unique_ptr<VulkanBuffer>& vertexBuffer, std::unique_ptr<VulkanBuffer>& indexBuffer) const;
+    bool tryAllocate(uint32_t vertexCount, uint32_t indexCount, Allocation& allocation);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkQueue m_queue = VK_NULL_HANDLE;
+    VkCommandPool m_commandPool = VK_NULL_HANDLE;
+    VulkanUploader* m_uploader = nullptr;
+
+    // unique_ptr：relocate()时整体替换（VulkanBuffer的拷贝是浅拷贝）
+    std::unique_ptr<VulkanBuffer> m_vertexBuffer;
+    std::unique_ptr<VulkanBuffer> m_indexBuffer;
+    RangeAllocator m_vertexRanges;
+    RangeAllocator m_indexRanges;
+
+    std::vector<Allocation> m_allocations;
+    std::vector<bool> m_alive;
+    std::vector<Handle> m_freeHandles;
+
+    // free()过的区间：在飞的帧还可能在读
+    std::vector<RetiredRange> m_retired;
+    uint32_t m_retiredVertices = 0;
+    uint32_t m_retiredIndices = 0;
+
+    uint32_t m_growCount = 0;
+    uint32_t m_defragmentCount = 0;
+};
@@ -0,0 +1,245 @@
+#include "Rendering/MeshBVH.h"
+#include "Rendering/Mesh.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace {
+    constexpr int BIN_COUNT = 16;
+
+    struct Bounds {
+        glm::vec3 min = glm::vec3(FLT_MAX);
+        glm::vec3 max = glm::vec3(-FLT_MAX);
+
+        void grow(const glm::vec3& point) {
+            min = glm::vec3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+            max = glm::vec3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+        }
+        void grow(const Bounds& other) {
+            grow(other.min);
+            grow(other.max);
+        }
+        float area() const {
+            if (min.x > max.x) return 0.0f;
+            glm::vec3 d(max.x - min.x, max.y - min.y, max.z - min.z);
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    struct BuildTask {
+        uint32_t node;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t depth;
+    };
+}
+
+MeshBVH::MeshBVH(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    // 每个三角形的包围盒和重心
+    std::vector<Bounds> triangleBounds(triangleCount);
+    std::vector<glm::vec3> centroids(triangleCount);
+    std::vector<uint32_t> order(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        const glm::vec3& a = vertices[indices[t * 3 + 0]].position;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+        triangleBounds[t].grow(a);
+        triangleBounds[t].grow(b);
+        triangleBounds[t].grow(c);
+        centroids[t] = glm::vec3((a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f);
+        order[t] = t;
+    }
+
+    // 节点数最多 2N-1
+    m_nodes.reserve(std::max(1u, triangleCount * 2));
+    m_nodes.push_back(Node{ glm::vec3(FLT_MAX), 0, glm::vec3(-FLT_MAX), 0 });
+    if (triangleCount == 0) return;
+
+    // 迭代构建，避免不平衡的划分把调用栈撑爆
+    std::vector<BuildTask> tasks;
+    tasks.push_back({ 0, 0, triangleCount, 1 });
+
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+        m_depth = std::max(m_depth, task.depth);
+
+        Bounds bounds, centroidBounds;
+        for (uint32_t i = task.begin; i < task.end; ++i) {
+            bounds.grow(triangleBounds[order[i]]);
+            centroidBounds.grow(centroids[order[i]]);
+        }
+        m_nodes[task.node].min = bounds.min;
+        m_nodes[task.node].max = bounds.max;
+
+        uint32_t count = task.end - task.begin;
+        auto makeLeaf = [&]() {
+            m_nodes[task.node].leftFirst = task.begin;
+            m_nodes[task.node].count = count;
+        };
+        if (count <= MAX_LEAF_SIZE) {
+            makeLeaf();
+            continue;
+        }
+
+        glm::vec3 spread(centroidBounds.max.x - centroidBounds.min.x,
+                         centroidBounds.max.y - centroidBounds.min.y,
+                         centroidBounds.max.z - centroidBounds.min.z);
+        int axis = 0;
+        if (spread.y > spread[axis]) axis = 1;
+        if (spread.z > spread[axis]) axis = 2;
+
+        uint32_t middle = task.begin;
+        if (spread[axis] > 0.0f) {
+            // 分箱SAH：cost = 左边数量 * 左边面积 + 右边数量 * 右边面积
+            float binScale = BIN_COUNT / spread[axis];
+            auto binOf = [&](uint32_t triangle) {
+                int bin = static_cast<int>((centroids[triangle][axis] - centroidBounds.min[axis]) * binScale);
+                return std::min(bin, BIN_COUNT - 1);
+            };
+
+            Bounds binBounds[BIN_COUNT];
+            uint32_t binCounts[BIN_COUNT] = {};
+            for (uint32_t i = task.begin; i < task.end; ++i) {
+                int bin = binOf(order[i]);
+                binCounts[bin]++;
+                binBounds[bin].grow(triangleBounds[order[i]]);
+            }
+
+            float rightAreas[BIN_COUNT];
+            uint32_t rightCounts[BIN_COUNT];
+            Bounds right;
+            uint32_t rightCount = 0;
+            for (int bin = BIN_COUNT - 1; bin > 0; --bin) {
+                right.grow(binBounds[bin]);
+                rightCount += binCounts[bin];
+                rightAreas[bin] = right.area();
+                rightCounts[bin] = rightCount;
+            }
+
+            Bounds left;
+            uint32_t leftCount = 0;
+            float bestCost = FLT_MAX;
+            int bestSplit = 0;
+            for (int split = 1; split < BIN_COUNT; ++split) {
+                left.grow(binBounds[split - 1]);
+                leftCount += binCounts[split - 1];
+                if (leftCount == 0 || rightCounts[split] == 0) continue;
+
+                float cost = leftCount * left.area() + rightCounts[split] * rightAreas[split];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = split;
+                }
+            }
+
+            if (bestSplit > 0) {
+                middle = static_cast<uint32_t>(std::partition(order.begin() + task.begin, order.begin() + task.end,
+                    [&](uint32_t triangle) { return binOf(triangle) < bestSplit; }) - order.begin());
+            }
+        }
+
+        // 重心都挤在一起：按中位数切
+        if (middle == task.begin || middle == task.end) {
+            middle = task.begin + count / 2;
+            std::nth_element(order.begin() + task.begin, order.begin() + middle, order.begin() + task.end,
+                [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+        }
+
+        uint32_t leftChild = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(Node{});
+        m_nodes.push_back(Node{});
+        m_nodes[task.node].leftFirst = leftChild;
+        m_nodes[task.node].count = 0;
+
+        tasks.push_back({ leftChild, task.begin, middle, task.depth + 1 });
+        tasks.push_back({ leftChild + 1, middle, task.end, task.depth + 1 });
+    }
+
+    // 三角形顶点按叶子顺序排好，叶子内求交是顺序访问
+    m_positions.resize(static_cast<size_t>(triangleCount) * 3);
+    m_triangleIDs = std::move(order);
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        uint32_t t = m_triangleIDs[i];
+        m_positions[i * 3 + 0] = vertices[indices[t * 3 + 0]].position;
+        m_positions[i * 3 + 1] = vertices[indices[t * 3 + 1]].position;
+        m_positions[i * 3 + 2] = vertices[indices[t * 3 + 2]].position;
+    }
+}
+
+float MeshBVH::entryDistance(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance) {
+    float tx1 = (node.min.x - origin.x) * inverseDirection.x, tx2 = (node.max.x - origin.x) * inverseDirection.x;
+    float ty1 = (node.min.y - origin.y) * inverseDirection.y, ty2 = (node.max.y - origin.y) * inverseDirection.y;
+    float tz1 = (node.min.z - origin.z) * inverseDirection.z, tz2 = (node.max.z - origin.z) * inverseDirection.z;
+    float tNear = std::max({ std::min(tx1, tx2), std::min(ty1, ty2), std::min(tz1, tz2), 0.0f });
+    float tFar = std::min({ std::max(tx1, tx2), std::max(ty1, ty2), std::max(tz1, tz2), maxDistance });
+    return tNear <= tFar ? tNear : -1.0f;
+}
+
+bool MeshBVH::intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const {
+    if (m_triangleIDs.empty()) return false;
+
+    glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    if (entryDistance(m_nodes[0], origin, inverseDirection, maxDistance) < 0.0f) return false;
+
+    bool found = false;
+    std::vector<uint32_t> stack;
+    stack.reserve(m_depth + 1);
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (node.count > 0) {
+            // Möller–Trumbore
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+                const glm::vec3& a = m_positions[i * 3 + 0];
+                glm::vec3 edge1 = m_positions[i * 3 + 1] - a;
+                glm::vec3 edge2 = m_positions[i * 3 + 2] - a;
+
+                glm::vec3 p = glm::cross(direction, edge2);
+                float determinant = glm::dot(edge1, p);
+                if (std::abs(determinant) < 1e-12f) continue;   // 射线和三角形平行
+                float inverseDeterminant = 1.0f / determinant;
+
+                glm::vec3 toOrigin = origin - a;
+                float u = glm::dot(toOrigin, p) * inverseDeterminant;
+                if (u < 0.0f || u > 1.0f) continue;
+
+                glm::vec3 q = glm::cross(toOrigin, edge1);
+                float v = glm::dot(direction, q) * inverseDeterminant;
+                if (v < 0.0f || u + v > 1.0f) continue;
+
+                float distance = glm::dot(edge2, q) * inverseDeterminant;
+                if (distance < 0.0f || distance > maxDistance) continue;
+
+                maxDistance = distance;
+                hit.distance = distance;
+                hit.triangle = m_triangleIDs[i];
+                hit.u = u;
+                hit.v = v;
+                found = true;
+            }
+            continue;
+        }
+
+        // 近的子节点后入栈，先被访问；已经比当前命中远的子节点直接跳过
+        uint32_t child1 = node.leftFirst;
+        uint32_t child2 = node.leftFirst + 1;
+        float entry1 = entryDistance(m_nodes[child1], origin, inverseDirection, maxDistance);
+        float entry2 = entryDistance(m_nodes[child2], origin, inverseDirection, maxDistance);
+        if (entry1 >= 0.0f && entry2 >= 0.0f) {
+            stack.push_back(entry1 <= entry2 ? child2 : child1);
+            stack.push_back(entry1 <= entry2 ? child1 : child2);
+        } else if (entry1 >= 0.0f) {
+            stack.push_back(child1);
+        } else if (entry2 >= 0.0f) {
+            stack.push_back(child2);
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+/**
+ * @brief 三角形BVH - 网格的射线求交加速结构（静态，只读）
+ *
+ * 构建：自顶向下的分箱SAH（16个箱），叶子最多MAX_LEAF_SIZE个三角形。
+ * 布局：
+ * - 节点是32字节的扁平数组，两个子节点总是相邻（leftFirst, leftFirst+1）
+ * - 三角形顶点按叶子顺序重新排列，叶子里的三角形在内存里是连续的
+ *
+ * 求交：先进入近的子节点，找到命中后用命中距离裁剪射线，
+ * 百万三角形的网格也只需要访问几十个节点。
+ *
+ * 坐标都在网格的局部空间。构建后不会再修改，可以多线程同时查询。
+ */
+class MeshBVH {
+public:
+    static constexpr uint32_t MAX_LEAF_SIZE = 4;
+
+    struct Hit {
+        float distance = 0.0f;    // 以direction的长度为单位
+        uint32_t triangle = 0;    // 原网格里的三角形编号（索引数组里的第triangle*3个）
+        float u = 0.0f;           // 重心坐标
+        float v = 0.0f;
+    };
+
+    MeshBVH(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+
+    // 最近的命中（双面），没有命中或距离超过maxDistance返回false
+    bool intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Hit& hit) const;
+
+    const glm::vec3& getBoundsMin() const { return m_nodes[0].min; }
+    const glm::vec3& getBoundsMax() const { return m_nodes[0].max; }
+    size_t getTriangleCount() const { return m_triangleIDs.size(); }
+    size_t getNodeCount() const { return m_nodes.size(); }
+    uint32_t getDepth() const { return m_depth; }
+
+private:
+    struct Node {
+        glm::vec3 min;
+        uint32_t leftFirst;   // 内部节点：左子节点；叶子：第一个三角形
+        glm::vec3 max;
+        uint32_t count;       // 0 = 内部节点
+    };
+
+    // 射线进入节点包围盒的距离，不相交返回负数
+    static float entryDistance(const Node& node, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance);
+
+    std::vector<Node> m_nodes;
+    std::vector<glm::vec3> m_positions;     // 每个三角形3个顶点，按叶子顺序
+    std::vector<uint32_t> m_triangleIDs;    // 叶子顺序 -> 原三角形编号
+    uint32_t m_depth = 0;
+};
@@ -0,0 +1,40 @@
+#include "Rendering/PickRegion.h"
+#include <algorithm>
+
+PickRegion PickRegion::around(uint32_t x, uint32_t y, uint32_t radius, VkExtent2D attachment) {
+    PickRegion region;
+    if (attachment.width == 0 || attachment.height == 0) return region;
+
+    region.x = std::min(x, attachment.width - 1);
+    region.y = std::min(y, attachment.height - 1);
+
+    // 用减法裁剪左上角，radius很大时也不会回绕
+    uint32_t left = region.x > radius ? region.x - radius : 0;
+    uint32_t top = region.y > radius ? region.y - radius : 0;
+    uint32_t right = region.x + std::min(radius, attachment.width - 1 - region.x) + 1;
+    uint32_t bottom = region.y + std::min(radius, attachment.height - 1 - region.y) + 1;
+
+    region.offset = { static_cast<int32_t>(left), static_cast<int32_t>(top) };
+    region.extent = { right - left, bottom - top };
+    return region;
+}
+
+uint32_t PickRegion::findNearest(const uint32_t* pixels) const {
+    uint32_t nearest = 0;
+    uint64_t bestDistance = UINT64_MAX;
+    for (uint32_t row = 0; row < extent.height; ++row) {
+        for (uint32_t column = 0; column < extent.width; ++column) {
+            uint32_t pickID = pixels[row * extent.width + column];
+            if (pickID == 0) continue;
+
+            int64_t dx = static_cast<int64_t>(offset.x) + column - x;
+            int64_t dy = static_cast<int64_t>(offset.y) + row - y;
+            uint64_t distance = static_cast<uint64_t>(dx * dx + dy * dy);
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                nearest = pickID;
+            }
+        }
+    }
+    return nearest;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+/**
+ * @brief GPU拾取的回读区域 - 光标周围要复制的矩形，以及回读数据的解码
+ *
+ * PickingPass用它决定从ID缓冲复制哪一块、复制回来以后选哪个物体。
+ * 只有整数运算，不碰Vulkan对象，没有设备也能测试。
+ */
+struct PickRegion {
+    uint32_t x = 0;                     // 请求的像素（已夹到附件内）
+    uint32_t y = 0;
+    VkOffset2D offset = { 0, 0 };       // 复制的矩形（已裁剪到附件内）
+    VkExtent2D extent = { 0, 0 };
+
+    // (x, y)周围(2r+1)^2的矩形，裁剪到attachment内；附件为空时extent为0
+    static PickRegion around(uint32_t x, uint32_t y, uint32_t radius, VkExtent2D attachment);
+
+    // pixels是复制回来的矩形（按行紧密排列）：离(x, y)最近的非0 ID，距离相同时取先出现的；
+    // 全是0返回0
+    uint32_t findNearest(const uint32_t* pixels) const;
+};
@@ -0,0 +1,98 @@
+#include "Rendering/Picking.h"
+#include "ECS/ECS.h"
+#include "ECS/BVH.h"
+#include "ECS/Components.h"
+#include "Framework/Camera.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/MeshBVH.h"
+#include <algorithm>
+
+namespace {
+    // 射线和AABB的进入距离，不相交返回负数
+    float intersectAABB(const AABBComponent& box, const Ray& ray, float maxDistance) {
+        float tNear = 0.0f;
+        float tFar = maxDistance;
+        for (int i = 0; i < 3; ++i) {
+            float inverse = 1.0f / ray.direction[i];
+            float t1 = (box.min[i] - ray.origin[i]) * inverse;
+            float t2 = (box.max[i] - ray.origin[i]) * inverse;
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+        }
+        return tNear <= tFar ? tNear : -1.0f;
+    }
+
+    // 精测一个实体，命中比maxDistance近时写入hit并返回true
+    bool intersectEntity(ECS& ecs, Entity entity, const Ray& ray, float maxDistance, Picker::Hit& hit) {
+        const TransformComponent* transform = ecs.getComponent<TransformComponent>(entity);
+        if (!transform || !ecs.hasComponent<PickableComponent>(entity)) return false;
+
+        const MeshComponent* meshComponent = ecs.getComponent<MeshComponent>(entity);
+        if (meshComponent && meshComponent->mesh) {
+            // 变换到局部空间。方向不重新归一化，局部空间的t就是世界空间的距离
+            glm::mat4 inverseWorld = glm::inverse(transform->transform);
+            glm::vec4 localOrigin = inverseWorld * glm::vec4(ray.origin, 1.0f);
+            glm::vec4 localDirection = inverseWorld * glm::vec4(ray.direction, 0.0f);
+
+            MeshBVH::Hit meshHit;
+            if (!meshComponent->mesh->getBVH().intersect(
+                    glm::vec3(localOrigin), glm::vec3(localDirection), maxDistance, meshHit)) {
+                return false;
+            }
+            hit.distance = meshHit.distance;
+            hit.triangle = meshHit.triangle;
+        } else {
+            // 没有网格：按包围盒命中
+            const AABBComponent* bounds = ecs.getComponent<AABBComponent>(entity);
+            if (!bounds) return false;
+
+            float distance = intersectAABB(bounds->transformed(transform->transform), ray, maxDistance);
+            if (distance < 0.0f) return false;
+            hit.distance = distance;
+            hit.triangle = UINT32_MAX;
+        }
+
+        hit.entity = entity;
+        hit.position = ray.origin + ray.direction * hit.distance;
+        return true;
+    }
+}
+
+Ray Picker::screenPointToRay(const Camera& camera, float x, float y, float width, float height) {
+    // 像素 -> NDC。投影矩阵已经翻转了Y，所以屏幕的y向下正好对应NDC的y向下
+    float ndcX = 2.0f * x / width - 1.0f;
+    float ndcY = 2.0f * y / height - 1.0f;
+
+    // 反投影远平面上的点，射线从相机位置指向它
+    glm::mat4 inverseViewProjection = glm::inverse(camera.getViewProjectionMatrix());
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+
+    Ray ray;
+    ray.origin = camera.getPosition();
+    ray.direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - ray.origin);
+    return ray;
+}
+
+bool Picker::pick(ECS& ecs, const BVH& sceneBVH, const Ray& ray, Hit& hit, float maxDistance) {
+    bool found = false;
+
+    // 粗测：场景BVH按进入距离给出候选，精测命中后裁剪射线
+    sceneBVH.raycast(ray.origin, ray.direction, maxDistance, [&](Entity entity, float) {
+        if (intersectEntity(ecs, entity, ray, maxDistance, hit)) {
+            maxDistance = hit.distance;
+            found = true;
+        }
+        return maxDistance;
+    });
+
+    // 没有包围盒的实体不在场景BVH里
+    ecs.view<PickableComponent, TransformComponent, MeshComponent>().exclude<AABBComponent>().each(
+        [&](Entity entity, PickableComponent&, TransformComponent&, MeshComponent&) {
+            if (intersectEntity(ecs, entity, ray, maxDistance, hit)) {
+                maxDistance = hit.distance;
+                found = true;
+            }
+        });
+
+    return found;
+}
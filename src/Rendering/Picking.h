@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ECS/Entity.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+class Camera;
+class ECS;
+class BVH;
+
+/**
+ * @brief 射线（世界空间）
+ */
+struct Ray {
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);   // 单位向量
+};
+
+/**
+ * @brief CPU拾取 - 用射线找到光标下最近的可拾取物体
+ *
+ * 只考虑带PickableComponent的实体，分两个阶段：
+ * - 粗测：场景BVH（SceneBVHSystem）里射线和世界空间AABB求交，近的先测
+ * - 精测：射线变换到网格的局部空间，和网格的三角形BVH（Mesh::getBVH()）求交
+ *
+ * 找到命中后射线被裁剪到命中距离，更远的包围盒直接跳过，
+ * 所以即使场景里有百万三角形的网格，一次拾取通常也只测几十个三角形。
+ *
+ * 没有MeshComponent的实体按包围盒命中；没有AABBComponent的实体
+ * 不在场景BVH里，会被逐个精测（数量通常很少）。
+ *
+ * 使用方法：
+ *   Ray ray = Picker::screenPointToRay(camera, mouseX, mouseY, width, height);
+ *   Picker::Hit hit;
+ *   if (Picker::pick(ecs, sceneBVHSystem->getBVH(), ray, hit)) { ... hit.entity ... }
+ *
+ * 三角形BVH在网格第一次被精测时构建（之后缓存在Mesh里），所以每个网格的第一次拾取
+ * 要多花一次构建的时间（bench_picking分别测构建和拾取），之后的拾取不受影响。
+ * 需要在主线程、系统调度器不在运行时调用。
+ */
+class Picker {
+public:
+    struct Hit {
+        Entity entity = INVALID_ENTITY;
+        float distance = 0.0f;               // 世界空间距离
+        uint32_t triangle = UINT32_MAX;      // 网格的三角形编号，按包围盒命中时为UINT32_MAX
+        glm::vec3 position = glm::vec3(0.0f);
+    };
+
+    // 屏幕坐标（像素，左上角为原点）-> 从相机出发的世界空间射线
+    static Ray screenPointToRay(const Camera& camera, float x, float y, float width, float height);
+
+    // 最近的命中，没有命中返回false
+    static bool pick(ECS& ecs, const BVH& sceneBVH, const Ray& ray, Hit& hit, float maxDistance = 1000.0f);
+};
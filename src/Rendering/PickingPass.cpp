@@ -0,0 +1,373 @@
+#include "Rendering/PickingPass.h"
+#include "Core/VulkanPipeline.h"
+#include "ECS/ECS.h"
+#include "ECS/Components.h"
+#include "Framework/Camera.h"
+#include "Framework/TransformBatch.h"
+#include "Rendering/Mesh.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+PickingPass::~PickingPass() {
+    cleanup();
+}
+
+void PickingPass::initialize(
+    VmaAllocator allocator,
+    VkDevice device,
+    VkExtent2D extent,
+    VkPipelineCache pipelineCache
+) {
+    m_allocator = allocator;
+    m_device = device;
+    m_pipelineCache = pipelineCache;
+    m_extent = extent;
+
+    createRenderPass();
+    createPipelineLayout();
+    createPipeline();
+
+    // 回读缓冲一直映射着，每个都能放下最大的拾取矩形
+    VkDeviceSize slotSize = sizeof(uint32_t) * (2 * MAX_PICK_RADIUS + 1) * (2 * MAX_PICK_RADIUS + 1);
+    for (ReadbackSlot& slot : m_slots) {
+        slot.buffer.create(m_allocator, slotSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                           VulkanBuffer::MemoryLocation::GPU_TO_CPU);
+        slot.mapped = static_cast<const uint32_t*>(slot.buffer.map());
+    }
+}
+
+void PickingPass::resize(VkExtent2D extent) {
+    m_extent = extent;
+
+    // viewport/scissor是管线的静态状态，跟着大小一起重建（layout不变）；
+    // ID/深度图像的描述带着m_extent，图下一次compile()时重新分配
+    vkDestroyPipeline(m_device, m_pipeline, nullptr);
+    m_pipeline = VK_NULL_HANDLE;
+    createPipeline();
+}
+
+void PickingPass::beginFrame(uint32_t) {
+    // 每次beginFrame都意味着又有一帧在GPU上执行完了
+    for (size_t i = 0; i < m_retiredFramebuffers.size();) {
+        if (--m_retiredFramebuffers[i].framesLeft == 0) {
+            vkDestroyFramebuffer(m_device, m_retiredFramebuffers[i].framebuffer, nullptr);
+            m_retiredFramebuffers[i] = m_retiredFramebuffers.back();
+            m_retiredFramebuffers.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void PickingPass::createRenderPass() {
+    std::array<VkAttachmentDescription, 2> attachments{};
+
+    // 布局转换和前后的屏障由渲染图完成：附件的initialLayout/finalLayout都是附件布局
+    // 0: ID，之后由"PickingReadback"复制
+    attachments[0].format = VK_FORMAT_R32_UINT;
+    attachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachments[0].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    // 1: 深度，只在这个Pass里用
+    attachments[1].format = VK_FORMAT_D32_SFLOAT;
+    attachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    attachments[1].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference colorRef{ 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    VkAttachmentReference depthRef{ 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+    subpass.pDepthStencilAttachment = &depthRef;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    renderPassInfo.pAttachments = attachments.data();
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+
+    if (vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create picking render pass!");
+    }
+}
+
+void PickingPass::createPipelineLayout() {
+    // push constants：MVP + pickID
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PushConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create picking pipeline layout!");
+    }
+}
+
+void PickingPass::createPipeline() {
+    VulkanPipelineBuilder builder(m_device);
+
+    auto bindings = Vertex::getBindingDescription();
+    auto attributes = Vertex::getAttributeDescriptions();
+
+    // 整数附件不能混合；不剔除背面，和CPU拾取（双面）一致
+    m_pipeline = builder
+        .setShaders("shaders/compiled/picking.vert.spv", "shaders/compiled/picking.frag.spv")
+        .setVertexInput({bindings}, attributes)
+        .setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+        .setViewport(m_extent)
+        .setRasterizer(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE)
+        .setMultisampling(VK_SAMPLE_COUNT_1_BIT)
+        .setDepthStencil(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS)
+        .setColorBlending(VK_FALSE)
+        .setPipelineLayout(m_pipelineLayout)
+        .setRenderPass(m_renderPass, 0)
+        .setPipelineCache(m_pipelineCache)
+        .build();
+}
+
+VkFramebuffer PickingPass::getFramebuffer(const RenderGraph& graph, const RenderGraph::Resources& resources) {
+    VkImageView views[2] = { resources.getImageView(m_idImage), resources.getImageView(m_depthImage) };
+    uint32_t allocation = graph.getStats().reallocations;
+
+    if (m_framebuffer != VK_NULL_HANDLE && allocation == m_framebufferAllocation &&
+        views[0] == m_framebufferViews[0] && views[1] == m_framebufferViews[1]) {
+        return m_framebuffer;
+    }
+
+    // 在飞的帧可能还在用旧的（它的图像也由图延迟销毁）
+    if (m_framebuffer != VK_NULL_HANDLE) {
+        m_retiredFramebuffers.push_back({ m_framebuffer, MAX_FRAMES_IN_FLIGHT });
+        m_framebuffer = VK_NULL_HANDLE;
+    }
+
+    VkExtent2D extent = resources.getExtent(m_idImage);
+
+    VkFramebufferCreateInfo framebufferInfo{};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = m_renderPass;
+    framebufferInfo.attachmentCount = 2;
+    framebufferInfo.pAttachments = views;
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+
+    if (vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &m_framebuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create picking framebuffer!");
+    }
+    m_framebufferViews[0] = views[0];
+    m_framebufferViews[1] = views[1];
+    m_framebufferAllocation = allocation;
+    return m_framebuffer;
+}
+
+void PickingPass::setFrameFence(VkFence fence) {
+    // Renderer刚等待过这个栅栏，用它录制的回读已经写完
+    // （这里必须先处理：栅栏马上会被reset，之后再查询状态就是未signal）
+    for (uint32_t i = 0; i < READBACK_SLOTS; ++i) {
+        ReadbackSlot& slot = m_slots[(m_nextSlot + i) % READBACK_SLOTS];
+        if (slot.fence == fence) {
+            completeSlot(slot);
+        }
+    }
+    m_frameFence = fence;
+}
+
+void PickingPass::requestPick(uint32_t x, uint32_t y, uint32_t radius) {
+    if (m_extent.width == 0 || m_extent.height == 0) return;
+
+    m_request = PickRegion::around(x, y, std::min(radius, MAX_PICK_RADIUS), m_extent);
+    m_hasRequest = true;
+}
+
+bool PickingPass::pollResult(Result& result) {
+    // 从最老的槽开始，保证结果按请求顺序出来
+    for (uint32_t i = 0; i < READBACK_SLOTS; ++i) {
+        ReadbackSlot& slot = m_slots[(m_nextSlot + i) % READBACK_SLOTS];
+        if (slot.fence != VK_NULL_HANDLE && vkGetFenceStatus(m_device, slot.fence) == VK_SUCCESS) {
+            completeSlot(slot);
+        }
+    }
+
+    if (m_results.empty()) return false;
+    result = m_results.front();
+    m_results.pop_front();
+    return true;
+}
+
+void PickingPass::completeSlot(ReadbackSlot& slot) {
+    slot.buffer.invalidate();
+
+    Result result;
+    result.pickID = slot.request.findNearest(slot.mapped);
+    result.x = slot.request.x;
+    result.y = slot.request.y;
+
+    m_results.push_back(result);
+    slot.fence = VK_NULL_HANDLE;
+}
+
+void PickingPass::setupGraph(RenderGraph& graph, ECS& ecs) {
+    // 没有请求就什么都不声明；环满了（GPU落后太多）请求留到下一帧
+    if (!m_hasRequest || !m_camera || m_frameFence == VK_NULL_HANDLE) return;
+    ReadbackSlot& slot = m_slots[m_nextSlot];
+    if (slot.fence != VK_NULL_HANDLE) return;
+
+    // 1. 收集可拾取的实体，批量算MVP
+    m_drawItems.clear();
+    m_modelMatrices.clear();
+    ecs.view<PickableComponent, MeshComponent, TransformComponent>().each(
+        [&](Entity, PickableComponent& pickable, MeshComponent& meshComp, TransformComponent& transformComp) {
+            if (!meshComp.mesh || pickable.pickID == NO_PICK_ID) return;
+
+            m_drawItems.push_back({ meshComp.mesh, pickable.pickID });
+            m_modelMatrices.push_back(transformComp.transform);
+        });
+
+    m_mvpMatrices.resize(m_modelMatrices.size());
+    TransformBatch::multiply(m_camera->getViewProjectionMatrix(), m_modelMatrices.data(), m_mvpMatrices.data(),
+                             m_modelMatrices.size());
+
+    // 2. 渲染ID缓冲到瞬态图像
+    graph.addPass("PickingID",
+        [&](RenderGraph::PassBuilder& builder) {
+            m_idImage = builder.createImage("PickID", { VK_FORMAT_R32_UINT, m_extent });
+            m_depthImage = builder.createImage("PickDepth", { VK_FORMAT_D32_SFLOAT, m_extent });
+            builder.write(m_idImage, RenderGraph::Access::ColorAttachmentWrite);
+            builder.write(m_depthImage, RenderGraph::Access::DepthAttachmentWrite);
+        },
+        [this, &graph](VkCommandBuffer cmd, const RenderGraph::Resources& resources) {
+            recordIDPass(cmd, getFramebuffer(graph, resources));
+        });
+
+    // 3. 光标下的矩形复制到回读缓冲：结果在图之外（CPU读），不能被剔除
+    RenderGraph::BufferHandle readback = graph.importBuffer("PickReadback", slot.buffer.getHandle(),
+                                                            RenderGraph::Access::None, RenderGraph::Access::None);
+    graph.addPass("PickingReadback",
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.read(m_idImage, RenderGraph::Access::TransferRead);
+            builder.write(readback, RenderGraph::Access::TransferWrite);
+            builder.setSideEffect();
+        },
+        [this, &slot](VkCommandBuffer cmd, const RenderGraph::Resources& resources) {
+            recordReadback(cmd, resources.getImage(m_idImage), slot);
+        });
+
+    slot.request = m_request;
+    slot.fence = m_frameFence;
+    m_nextSlot = (m_nextSlot + 1) % READBACK_SLOTS;
+    m_hasRequest = false;
+}
+
+void PickingPass::recordIDPass(VkCommandBuffer cmd, VkFramebuffer framebuffer) {
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color.uint32[0] = NO_PICK_ID;
+    clearValues[1].depthStencil = { 1.0f, 0 };
+
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = m_renderPass;
+    renderPassInfo.framebuffer = framebuffer;
+    renderPassInfo.renderArea = { { 0, 0 }, m_extent };
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
+
+    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+
+    for (size_t i = 0; i < m_drawItems.size(); ++i) {
+        PushConstants constants{ m_mvpMatrices[i], m_drawItems[i].pickID };
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0, sizeof(PushConstants), &constants);
+        m_drawItems[i].mesh->draw(cmd);
+    }
+
+    vkCmdEndRenderPass(cmd);
+}
+
+void PickingPass::recordReadback(VkCommandBuffer cmd, VkImage idImage, const ReadbackSlot& slot) {
+    // 图已经把ID图像转换到TRANSFER_SRC_OPTIMAL，并等待了颜色写入
+    const PickRegion& request = slot.request;
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;     // 紧密排列
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = { request.offset.x, request.offset.y, 0 };
+    region.imageExtent = { request.extent.width, request.extent.height, 1 };
+
+    vkCmdCopyImageToBuffer(cmd, idImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           slot.buffer.getHandle(), 1, &region);
+
+    // 复制结果对CPU可见（栅栏signal之后）；图里没有主机访问，这个屏障自己录制
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = slot.buffer.getHandle();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0,
+                         0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void PickingPass::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    for (ReadbackSlot& slot : m_slots) {
+        slot.buffer.unmap();
+        slot.buffer.cleanup();
+        slot.mapped = nullptr;
+        slot.fence = VK_NULL_HANDLE;
+    }
+    m_results.clear();
+    m_hasRequest = false;
+
+    if (m_framebuffer != VK_NULL_HANDLE) {
+        vkDestroyFramebuffer(m_device, m_framebuffer, nullptr);
+        m_framebuffer = VK_NULL_HANDLE;
+    }
+    for (RetiredFramebuffer& retired : m_retiredFramebuffers) {
+        vkDestroyFramebuffer(m_device, retired.framebuffer, nullptr);
+    }
+    m_retiredFramebuffers.clear();
+
+    if (m_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+    }
+    if (m_pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        m_pipelineLayout = VK_NULL_HANDLE;
+    }
+    if (m_renderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+        m_renderPass = VK_NULL_HANDLE;
+    }
+    m_device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Rendering/RenderPass.h"
+#include "Rendering/RenderGraph.h"
+#include "Rendering/PickRegion.h"
+#include "Core/VulkanBuffer.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class Camera;
+class Mesh;
+
+/**
+ * @brief GPU拾取Pass - 把PickableComponent::pickID渲染到R32_UINT附件
+ *
+ * CPU拾取（Picker）的替代方案：不需要三角形BVH，结果和屏幕上看到的像素完全一致。
+ *
+ * 流程：
+ * 1. requestPick() 记下光标位置
+ * 2. 下一帧 setupGraph() 把两个Pass声明到渲染图：
+ *    "PickingID" 渲染ID缓冲（0 = 没有物体）到瞬态的ID/深度图像，
+ *    "PickingReadback" 只把光标下的小矩形复制到一个GPU_TO_CPU的回读缓冲（导入的缓冲）。
+ *    布局转换和两个Pass之间的屏障由图完成，瞬态图像的内存可以和其他Pass的共用
+ * 3. 帧的栅栏signal之后（一到两帧以后）pollResult() 读出pickID
+ *
+ * 回读缓冲是一个小环（READBACK_SLOTS个），每个槽记录录制它的那一帧的栅栏，
+ * 从不调用vkQueueWaitIdle/vkDeviceWaitIdle，拾取不会卡住帧。
+ * 没有请求的帧什么都不声明，ID缓冲也不占内存。
+ *
+ * 这个Pass不依赖交换链，所以也可以在无窗口的设备上（比如lavapipe）单独使用：
+ * graph.reset()、setupGraph()、graph.compile()、录制graph.execute()、提交、再pollResult()（见test_picking_pass）。
+ *
+ * 使用方法：
+ *   pickingPass->requestPick(mouseX, mouseY);
+ *   ...
+ *   PickingPass::Result result;
+ *   while (pickingPass->pollResult(result)) { ... result.pickID ... }
+ */
+class PickingPass : public IRenderPass {
+public:
+    static constexpr uint32_t READBACK_SLOTS = 3;
+    static constexpr uint32_t MAX_PICK_RADIUS = 8;
+    static constexpr uint32_t NO_PICK_ID = 0;
+
+    struct Result {
+        uint32_t pickID = NO_PICK_ID;   // NO_PICK_ID = 光标下没有可拾取物体
+        uint32_t x = 0;                 // 请求的像素坐标
+        uint32_t y = 0;
+    };
+
+    PickingPass() = default;
+    ~PickingPass() override;
+
+    void initialize(
+        VmaAllocator allocator,
+        VkDevice device,
+        VkExtent2D extent,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
+    );
+
+    // 窗口大小改变时重建管线（viewport是静态的）；ID缓冲由渲染图按新的大小重新分配
+    void resize(VkExtent2D extent);
+
+    void beginFrame(uint32_t frameIndex) override;
+    void execute(VkCommandBuffer, ECS&) override {}
+    void setupGraph(RenderGraph& graph, ECS& ecs) override;
+    void cleanup() override;
+
+    void setCamera(Camera* camera) { m_camera = camera; }
+
+    // 录制本帧之前由Renderer调用：这一帧提交时使用的栅栏（此时它刚被等待过）
+    void setFrameFence(VkFence fence);
+
+    // 拾取像素(x, y)；radius > 0时读取(2r+1)^2的矩形，取离中心最近的物体（方便点中细小物体）
+    // 多次请求在录制前只保留最后一次
+    void requestPick(uint32_t x, uint32_t y, uint32_t radius = 0);
+
+    // 取出一个已完成的结果（按请求顺序），没有返回false
+    bool pollResult(Result& result);
+
+private:
+    struct PushConstants {
+        glm::mat4 mvp;
+        uint32_t pickID;
+    };
+
+    struct ReadbackSlot {
+        VulkanBuffer buffer;
+        const uint32_t* mapped = nullptr;
+        VkFence fence = VK_NULL_HANDLE;   // 不为空 = GPU还可能在写
+        PickRegion request;
+    };
+
+    struct DrawItem {
+        Mesh* mesh;
+        uint32_t pickID;
+    };
+
+    struct RetiredFramebuffer {
+        VkFramebuffer framebuffer;
+        uint32_t framesLeft;
+    };
+
+    void createRenderPass();
+    void createPipelineLayout();
+    // 用m_pipelineLayout和当前的m_extent创建管线
+    void createPipeline();
+
+    // 图的瞬态图像重新分配过时重建framebuffer（旧的延迟MAX_FRAMES_IN_FLIGHT帧销毁）
+    VkFramebuffer getFramebuffer(const RenderGraph& graph, const RenderGraph::Resources& resources);
+
+    void recordIDPass(VkCommandBuffer cmd, VkFramebuffer framebuffer);
+    void recordReadback(VkCommandBuffer cmd, VkImage idImage, const ReadbackSlot& slot);
+
+    // 槽里的数据已经写完：解码到m_results并释放这个槽
+    void completeSlot(ReadbackSlot& slot);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkDevice m_device = VK_NULL_HANDLE;
+    VkPipelineCache m_pipelineCache = VK_NULL_HANDLE;
+    VkExtent2D m_extent = { 0, 0 };
+    Camera* m_camera = nullptr;
+
+    VkRenderPass m_renderPass = VK_NULL_HANDLE;
+    VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    // 这一帧图里的ID/深度图像（setupGraph()里声明，execute回调里取实际对象）
+    RenderGraph::ImageHandle m_idImage;         // R32_UINT
+    RenderGraph::ImageHandle m_depthImage;
+
+    // 用图分配的ID/深度图像创建；图重新分配过（视图可能是同一个句柄值）才重建
+    VkFramebuffer m_framebuffer = VK_NULL_HANDLE;
+    VkImageView m_framebufferViews[2] = { VK_NULL_HANDLE, VK_NULL_HANDLE };
+    uint32_t m_framebufferAllocation = 0;       // 创建时图的Stats::reallocations
+    std::vector<RetiredFramebuffer> m_retiredFramebuffers;
+
+    ReadbackSlot m_slots[READBACK_SLOTS];
+    uint32_t m_nextSlot = 0;
+    VkFence m_frameFence = VK_NULL_HANDLE;
+
+    bool m_hasRequest = false;
+    PickRegion m_request;
+    std::deque<Result> m_results;
+
+    // 每帧复用的缓冲
+    std::vector<DrawItem> m_drawItems;
+    std::vector<glm::mat4> m_modelMatrices;
+    std::vector<glm::mat4> m_mvpMatrices;
+};
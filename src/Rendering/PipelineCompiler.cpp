@@ -0,0 +1,117 @@
+#include "Rendering/PipelineCompiler.h"
+#include "Core/VulkanPipeline.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+AsyncPipeline::AsyncPipeline(VkDevice device, std::unique_ptr<VulkanPipelineBuilder> builder,
+                             std::shared_ptr<SharedPipelineLayout> layout)
+    : m_device(device), m_builder(std::move(builder)), m_layout(std::move(layout)) {
+}
+
+AsyncPipeline::~AsyncPipeline() {
+    if (m_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+    }
+}
+
+void AsyncPipeline::compile() {
+    try {
+        m_pipeline = m_builder->build();
+        m_state.store(State::Ready, std::memory_order_release);
+        return;
+    } catch (const std::exception& e) {
+        m_error = e.what();
+    } catch (...) {
+        m_error = "unknown error";
+    }
+
+    // 每个管线只编译一次，失败也只报告这一次（之后材质一直用替代材质绘制）
+    std::cerr << "Pipeline compilation failed: " << m_error << std::endl;
+    m_state.store(State::Failed, std::memory_order_release);
+}
+
+PipelineCompiler::~PipelineCompiler() {
+    cleanup();
+}
+
+void PipelineCompiler::initialize(VkDevice device, JobSystem* jobs) {
+    m_device = device;
+    m_jobs = jobs;
+    m_maxConcurrent = jobs ? std::max(1u, jobs->getThreadCount() / MAX_CONCURRENT_DIVISOR) : 1;
+    m_stats = Stats{};
+}
+
+void PipelineCompiler::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    waitIdle();
+    m_jobs = nullptr;
+    m_device = VK_NULL_HANDLE;
+}
+
+std::shared_ptr<AsyncPipeline> PipelineCompiler::compile(std::unique_ptr<VulkanPipelineBuilder> builder,
+                                                        std::shared_ptr<SharedPipelineLayout> layout) {
+    auto pipeline = std::make_shared<AsyncPipeline>(m_device, std::move(builder), std::move(layout));
+
+    if (!m_jobs) {
+        pipeline->compile();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.submitted++;
+        m_stats.completed++;
+        if (pipeline->getState() == AsyncPipeline::State::Failed) m_stats.failed++;
+        return pipeline;
+    }
+
+    bool startJob = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(pipeline);
+        m_stats.submitted++;
+        m_stats.pending++;
+        if (m_runningJobs < m_maxConcurrent) {
+            m_runningJobs++;
+            startJob = true;
+        }
+    }
+
+    if (startJob) {
+        // 后台作业：主线程每帧的wait()不会把它取走在帧线程上编译
+        m_jobs->runBackground([this]() { drainQueue(); }, &m_counter);
+    }
+    return pipeline;
+}
+
+void PipelineCompiler::drainQueue() {
+    for (;;) {
+        std::shared_ptr<AsyncPipeline> pipeline;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.empty()) {
+                // 和compile()在同一把锁下判断：不会有请求留在队列里没人处理
+                m_runningJobs--;
+                return;
+            }
+            pipeline = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        pipeline->compile();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.completed++;
+        m_stats.pending--;
+        if (pipeline->getState() == AsyncPipeline::State::Failed) m_stats.failed++;
+    }
+}
+
+void PipelineCompiler::waitIdle() {
+    if (m_jobs) {
+        m_jobs->wait(m_counter);
+    }
+}
+
+PipelineCompiler::Stats PipelineCompiler::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
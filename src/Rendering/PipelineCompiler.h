@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Framework/JobSystem.h"
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class SharedPipelineLayout;
+class VulkanPipelineBuilder;
+
+/**
+ * @brief 后台编译中的图形管线
+ *
+ * 由PipelineCompiler::compile()返回，材质持有shared_ptr。
+ * 编译完成之前get()返回VK_NULL_HANDLE，调用方用替代材质或者跳过绘制。
+ * 状态是原子的：渲染线程每帧查询，不需要加锁。
+ *
+ * 最后一个引用释放时销毁pipeline，所以和其他Vulkan对象一样
+ * 要在GPU不再使用它之后（比如vkDeviceWaitIdle之后）释放。
+ * 编译中途释放没有问题：编译作业自己也持有一个引用。
+ * builder用的共用layout（setPipelineLayout）也由它持有：材质在编译中途释放layout时，
+ * layout活到编译结束、pipeline销毁之后。
+ */
+class AsyncPipeline {
+public:
+    enum class State : uint32_t {
+        Pending,   // 排队或正在编译
+        Ready,
+        Failed     // getError()是build()抛出的信息
+    };
+
+    AsyncPipeline(VkDevice device, std::unique_ptr<VulkanPipelineBuilder> builder,
+                  std::shared_ptr<SharedPipelineLayout> layout = nullptr);
+    ~AsyncPipeline();
+
+    AsyncPipeline(const AsyncPipeline&) = delete;
+    AsyncPipeline& operator=(const AsyncPipeline&) = delete;
+
+    State getState() const { return m_state.load(std::memory_order_acquire); }
+    bool isReady() const { return getState() == State::Ready; }
+
+    // Ready之前返回VK_NULL_HANDLE
+    VkPipeline get() const { return isReady() ? m_pipeline : VK_NULL_HANDLE; }
+
+    // 只在Failed之后有效
+    const std::string& getError() const { return m_error; }
+
+    // 创建它的配置（build()不修改配置，编译中也可以读）
+    const VulkanPipelineBuilder& getBuilder() const { return *m_builder; }
+
+private:
+    friend class PipelineCompiler;
+
+    // 在工作线程上执行，不抛异常
+    void compile();
+
+    VkDevice m_device;
+    std::unique_ptr<VulkanPipelineBuilder> m_builder;   // build()之后还持有它创建的layout
+    std::shared_ptr<SharedPipelineLayout> m_layout;     // builder的外部layout，析构时在pipeline之后释放
+    VkPipeline m_pipeline = VK_NULL_HANDLE;
+    std::string m_error;
+    std::atomic<State> m_state{State::Pending};
+};
+
+/**
+ * @brief 在JobSystem的工作线程上编译图形管线
+ *
+ * vkCreateGraphicsPipelines可能要几十到几百毫秒（缓存没命中时驱动编译着色器），
+ * 放在主线程上材质创建和启动都会卡住一帧或几秒。这里把配置好的builder交给工作线程：
+ *
+ *   auto builder = std::make_unique<VulkanPipelineBuilder>(device);
+ *   builder->setShaders(...)...setPipelineCache(cache);
+ *   std::shared_ptr<AsyncPipeline> pipeline = compiler.compile(std::move(builder));
+ *   ...
+ *   if (VkPipeline handle = pipeline->get()) { ... }   // 编译完成之前是VK_NULL_HANDLE
+ *
+ * 编译作业用runBackground()提交：只由空闲的工作线程执行，主线程在SystemScheduler、
+ * 并行录制里的wait()不会取到它，帧线程上不会出现几百毫秒的编译。
+ * 编译失败时在std::cerr上报告一次。
+ *
+ * 同时编译的作业最多MAX_CONCURRENT_DIVISOR分之一的线程：编译作业很长，
+ * 不能占满所有线程，否则同一帧的parallelFor（并行录制、剔除）只剩主线程在做。
+ * 其余的排队，由正在运行的编译作业做完手上的再取。
+ *
+ * 多个线程同时用同一个VkPipelineCache创建管线是安全的（驱动内部同步）。
+ * jobs为空时compile()直接在调用线程上编译（返回时已经Ready或Failed）。
+ */
+class PipelineCompiler {
+public:
+    struct Stats {
+        uint32_t submitted = 0;
+        uint32_t completed = 0;   // 包括失败的
+        uint32_t failed = 0;
+        uint32_t pending = 0;     // 排队+正在编译
+    };
+
+    static constexpr uint32_t MAX_CONCURRENT_DIVISOR = 2;
+
+    PipelineCompiler() = default;
+    ~PipelineCompiler();
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    void initialize(VkDevice device, JobSystem* jobs);
+
+    // 等待所有编译完成（之后才能销毁设备）
+    void cleanup();
+
+    // builder必须已经配置好；返回时编译可能还没开始。
+    // layout：builder的setPipelineLayout()来自共用layout时传入，管线持有它
+    std::shared_ptr<AsyncPipeline> compile(std::unique_ptr<VulkanPipelineBuilder> builder,
+                                           std::shared_ptr<SharedPipelineLayout> layout = nullptr);
+
+    // 等待已提交的编译全部完成（等待期间当前线程执行普通作业，编译由工作线程完成）
+    void waitIdle();
+
+    bool isAsync() const { return m_jobs != nullptr; }
+    Stats getStats() const;
+
+private:
+    // 编译作业：一直取队列里的请求，直到队列为空
+    void drainQueue();
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    JobSystem* m_jobs = nullptr;
+    uint32_t m_maxConcurrent = 1;
+
+    mutable std::mutex m_mutex;
+    std::deque<std::shared_ptr<AsyncPipeline>> m_queue;
+    uint32_t m_runningJobs = 0;
+    Stats m_stats;
+
+    JobCounter m_counter;
+};
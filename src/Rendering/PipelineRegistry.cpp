@@ -0,0 +1,133 @@
+#include "Rendering/PipelineRegistry.h"
+#include "Core/VulkanPipeline.h"
+#include "Rendering/PipelineCompiler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+bool samePushConstants(const std::vector<VkPushConstantRange>& a, const std::vector<VkPushConstantRange>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].stageFlags != b[i].stageFlags || a[i].offset != b[i].offset || a[i].size != b[i].size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+SharedPipelineLayout::~SharedPipelineLayout() {
+    vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    cleanup();
+}
+
+void PipelineRegistry::initialize(VkDevice device, PipelineCompiler* compiler, ShaderLibrary* shaderLibrary) {
+    m_device = device;
+    m_compiler = compiler;
+    m_shaderLibrary = shaderLibrary;
+    m_stats = Stats{};
+}
+
+void PipelineRegistry::cleanup() {
+    // 只忘记条目：管线和layout属于还持有它们的材质
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pipelines.clear();
+    m_layouts.clear();
+    m_compiler = nullptr;
+    m_shaderLibrary = nullptr;
+    m_device = VK_NULL_HANDLE;
+}
+
+std::shared_ptr<AsyncPipeline> PipelineRegistry::acquire(std::unique_ptr<VulkanPipelineBuilder> builder,
+                                                        std::shared_ptr<SharedPipelineLayout> layout) {
+    size_t key = builder->hashState();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.requests++;
+
+    auto range = m_pipelines.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        std::shared_ptr<AsyncPipeline> pipeline = it->second.lock();
+        if (pipeline && pipeline->getBuilder().hasSameState(*builder)) {
+            m_stats.hits++;
+            return pipeline;
+        }
+    }
+
+    if (!m_compiler) {
+        throw std::runtime_error("PipelineRegistry used before initialize()!");
+    }
+
+    // 在锁里提交：同时请求相同配置的两个线程不会各编译一次
+    std::shared_ptr<AsyncPipeline> pipeline = m_compiler->compile(std::move(builder), std::move(layout));
+    m_pipelines.emplace(key, pipeline);
+    if (m_pipelines.size() >= m_pruneThreshold) {
+        pruneExpired();
+    }
+    return pipeline;
+}
+
+std::shared_ptr<SharedPipelineLayout> PipelineRegistry::acquireLayout(
+    const std::vector<VkDescriptorSetLayout>& setLayouts,
+    const std::vector<VkPushConstantRange>& pushConstants
+) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.layoutRequests++;
+
+    for (const LayoutEntry& entry : m_layouts) {
+        if (entry.setLayouts != setLayouts || !samePushConstants(entry.pushConstants, pushConstants)) continue;
+        if (std::shared_ptr<SharedPipelineLayout> layout = entry.layout.lock()) {
+            m_stats.layoutHits++;
+            return layout;
+        }
+    }
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    layoutInfo.pSetLayouts = setLayouts.empty() ? nullptr : setLayouts.data();
+    layoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstants.size());
+    layoutInfo.pPushConstantRanges = pushConstants.empty() ? nullptr : pushConstants.data();
+
+    VkPipelineLayout handle;
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &handle) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+
+    auto layout = std::make_shared<SharedPipelineLayout>(m_device, handle);
+    m_layouts.erase(std::remove_if(m_layouts.begin(), m_layouts.end(),
+                                   [](const LayoutEntry& entry) { return entry.layout.expired(); }),
+                    m_layouts.end());
+    m_layouts.push_back({ setLayouts, pushConstants, layout });
+    return layout;
+}
+
+PipelineRegistry::Stats PipelineRegistry::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.pipelines = 0;
+    for (const auto& entry : m_pipelines) {
+        if (!entry.second.expired()) stats.pipelines++;
+    }
+    stats.layouts = 0;
+    for (const LayoutEntry& entry : m_layouts) {
+        if (!entry.layout.expired()) stats.layouts++;
+    }
+    return stats;
+}
+
+void PipelineRegistry::pruneExpired() {
+    for (auto it = m_pipelines.begin(); it != m_pipelines.end();) {
+        if (it->second.expired()) {
+            it = m_pipelines.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_pruneThreshold = std::max<size_t>(64, m_pipelines.size() * 2);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class AsyncPipeline;
+class PipelineCompiler;
+class ShaderLibrary;
+class VulkanPipelineBuilder;
+
+/**
+ * @brief 多个材质共用的VkPipelineLayout，最后一个引用释放时销毁
+ */
+class SharedPipelineLayout {
+public:
+    SharedPipelineLayout(VkDevice device, VkPipelineLayout layout) : m_device(device), m_layout(layout) {}
+    ~SharedPipelineLayout();
+
+    SharedPipelineLayout(const SharedPipelineLayout&) = delete;
+    SharedPipelineLayout& operator=(const SharedPipelineLayout&) = delete;
+
+    VkPipelineLayout get() const { return m_layout; }
+
+private:
+    VkDevice m_device;
+    VkPipelineLayout m_layout;
+};
+
+/**
+ * @brief 按配置去重的管线注册表
+ *
+ * 同一种材质的每个实例都用相同的builder配置（着色器、顶点输入、光栅化/深度/混合状态、RenderPass），
+ * 各自创建管线的话1000个实例就是1000个相同的VkPipeline（和1000次编译）。
+ * 这里用VulkanPipelineBuilder::hashState()查找，hasSameState()逐项比较确认
+ * （着色器按内容：着色器库里是同一个module；其余状态逐字段比较，所以哈希冲突时不会合并不同的管线）。
+ * 着色器在材质创建builder时（反射）已经加载，acquire()里只是查找：
+ *
+ *   std::shared_ptr<AsyncPipeline> pipeline = registry.acquire(std::move(builder));
+ *
+ * 已经有相同配置的管线（编译中的也算）时直接返回它，builder丢弃；否则交给PipelineCompiler编译。
+ * 注册表只持有weak_ptr：管线的生命周期由使用它的材质决定，最后一个材质释放时销毁。
+ *
+ * 共用的管线句柄相同，ForwardPass的DrawList按pipeline排序，
+ * 相同句柄的绘制排在一起，相邻两次只比较句柄就跳过重复绑定。
+ *
+ * acquireLayout()对pipeline layout做同样的事（按descriptor set layout和push constant范围比较）。
+ * 所有函数线程安全。
+ */
+class PipelineRegistry {
+public:
+    struct Stats {
+        uint32_t requests = 0;        // acquire()调用次数
+        uint32_t hits = 0;            // 返回了已有的管线
+        uint32_t pipelines = 0;       // 注册表里还活着的管线
+        uint32_t layoutRequests = 0;
+        uint32_t layoutHits = 0;
+        uint32_t layouts = 0;
+    };
+
+    PipelineRegistry() = default;
+    ~PipelineRegistry();
+
+    PipelineRegistry(const PipelineRegistry&) = delete;
+    PipelineRegistry& operator=(const PipelineRegistry&) = delete;
+
+    // 新管线交给compiler编译（同步还是后台由compiler决定）。
+    // shaderLibrary：给材质的builder用（setShaderLibrary），可以为空
+    void initialize(VkDevice device, PipelineCompiler* compiler, ShaderLibrary* shaderLibrary = nullptr);
+    void cleanup();
+
+    ShaderLibrary* getShaderLibrary() const { return m_shaderLibrary; }
+
+    // layout：builder的setPipelineLayout()来自acquireLayout()时传入，新编译的管线持有它
+    // （已有的管线配置相同，用的是同一个layout，它自己已经持有）
+    std::shared_ptr<AsyncPipeline> acquire(std::unique_ptr<VulkanPipelineBuilder> builder,
+                                           std::shared_ptr<SharedPipelineLayout> layout = nullptr);
+
+    std::shared_ptr<SharedPipelineLayout> acquireLayout(const std::vector<VkDescriptorSetLayout>& setLayouts,
+                                                        const std::vector<VkPushConstantRange>& pushConstants);
+
+    Stats getStats() const;
+
+private:
+    struct LayoutEntry {
+        std::vector<VkDescriptorSetLayout> setLayouts;
+        std::vector<VkPushConstantRange> pushConstants;
+        std::weak_ptr<SharedPipelineLayout> layout;
+    };
+
+    // 删除已经释放的条目（条目数翻倍时做一次）
+    void pruneExpired();
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    PipelineCompiler* m_compiler = nullptr;
+    ShaderLibrary* m_shaderLibrary = nullptr;
+
+    mutable std::mutex m_mutex;
+    std::unordered_multimap<size_t, std::weak_ptr<AsyncPipeline>> m_pipelines;
+    std::vector<LayoutEntry> m_layouts;   // 种类很少，线性查找
+    size_t m_pruneThreshold = 64;
+    Stats m_stats;
+};
@@ -0,0 +1,751 @@
+#include "Rendering/RenderGraph.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool overlaps(uint32_t firstA, uint32_t lastA, uint32_t firstB, uint32_t lastB) {
+    return firstA <= lastB && firstB <= lastA;
+}
+
+// 只有写需要make available，屏障的srcAccessMask里不放读
+VkAccessFlags writeAccessMask(VkAccessFlags access) {
+    return access & (VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                     VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT |
+                     VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+}
+
+} // namespace
+
+// ============================================================================
+// PassBuilder / Resources
+// ============================================================================
+
+RenderGraph::ImageHandle RenderGraph::PassBuilder::createImage(const std::string& name, const ImageDesc& desc) {
+    if (desc.format == VK_FORMAT_UNDEFINED || desc.extent.width == 0 || desc.extent.height == 0) {
+        throw std::runtime_error("RenderGraph: invalid transient image '" + name + "'");
+    }
+
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    return { m_graph.addResource(std::move(resource)) };
+}
+
+RenderGraph::ImageHandle RenderGraph::PassBuilder::read(ImageHandle image, Access access) {
+    m_graph.addUse(m_pass, image.index, access, false);
+    return image;
+}
+
+RenderGraph::ImageHandle RenderGraph::PassBuilder::write(ImageHandle image, Access access) {
+    m_graph.addUse(m_pass, image.index, access, true);
+    return image;
+}
+
+RenderGraph::BufferHandle RenderGraph::PassBuilder::read(BufferHandle buffer, Access access) {
+    m_graph.addUse(m_pass, buffer.index, access, false);
+    return buffer;
+}
+
+RenderGraph::BufferHandle RenderGraph::PassBuilder::write(BufferHandle buffer, Access access) {
+    m_graph.addUse(m_pass, buffer.index, access, true);
+    return buffer;
+}
+
+void RenderGraph::PassBuilder::setSideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+VkImage RenderGraph::Resources::getImage(ImageHandle image) const {
+    return m_graph.m_resources[image.index].image;
+}
+
+VkImageView RenderGraph::Resources::getImageView(ImageHandle image) const {
+    return m_graph.m_resources[image.index].view;
+}
+
+VkExtent2D RenderGraph::Resources::getExtent(ImageHandle image) const {
+    return m_graph.m_resources[image.index].desc.extent;
+}
+
+VkFormat RenderGraph::Resources::getFormat(ImageHandle image) const {
+    return m_graph.m_resources[image.index].desc.format;
+}
+
+VkBuffer RenderGraph::Resources::getBuffer(BufferHandle buffer) const {
+    return m_graph.m_resources[buffer.index].buffer;
+}
+
+// ============================================================================
+// RenderGraph
+// ============================================================================
+
+RenderGraph::~RenderGraph() {
+    cleanup();
+}
+
+void RenderGraph::initialize(VmaAllocator allocator, VkDevice device) {
+    m_allocator = allocator;
+    m_device = device;
+}
+
+void RenderGraph::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    destroyImages(m_physicalImages, m_heaps);
+    for (RetiredImages& retired : m_retired) {
+        destroyImages(retired.images, retired.heaps);
+    }
+    m_retired.clear();
+
+    m_resources.clear();
+    m_passes.clear();
+    m_order.clear();
+    m_compiled = false;
+    m_device = VK_NULL_HANDLE;
+}
+
+void RenderGraph::destroyImages(std::vector<PhysicalImage>& images, std::vector<Heap>& heaps) {
+    for (PhysicalImage& image : images) {
+        vkDestroyImageView(m_device, image.view, nullptr);
+        vkDestroyImage(m_device, image.image, nullptr);
+    }
+    for (Heap& heap : heaps) {
+        vmaFreeMemory(m_allocator, heap.allocation);
+    }
+    images.clear();
+    heaps.clear();
+}
+
+void RenderGraph::reset() {
+    // 这一帧的fence等待过：重新分配前的图像已经没有帧在用
+    for (auto it = m_retired.begin(); it != m_retired.end();) {
+        if (--it->framesLeft == 0) {
+            destroyImages(it->images, it->heaps);
+            it = m_retired.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_resources.clear();
+    m_passes.clear();
+    m_order.clear();
+    m_imageBarriers.clear();
+    m_bufferBarriers.clear();
+    m_finalBarriers = {};
+    m_compiled = false;
+}
+
+RenderGraph::ImageHandle RenderGraph::importImage(const std::string& name, VkImage image, VkImageView view,
+                                                  VkFormat format, VkExtent2D extent,
+                                                  Access initialAccess, Access finalAccess) {
+    if (image == VK_NULL_HANDLE) {
+        throw std::runtime_error("RenderGraph: imported image '" + name + "' is null");
+    }
+
+    Resource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.initialAccess = initialAccess;
+    resource.finalAccess = finalAccess;
+    resource.image = image;
+    resource.view = view;
+    resource.desc.format = format;
+    resource.desc.extent = extent;
+    return { addResource(std::move(resource)) };
+}
+
+RenderGraph::BufferHandle RenderGraph::importBuffer(const std::string& name, VkBuffer buffer,
+                                                    Access initialAccess, Access finalAccess) {
+    if (buffer == VK_NULL_HANDLE) {
+        throw std::runtime_error("RenderGraph: imported buffer '" + name + "' is null");
+    }
+
+    Resource resource;
+    resource.name = name;
+    resource.isImage = false;
+    resource.imported = true;
+    resource.initialAccess = initialAccess;
+    resource.finalAccess = finalAccess;
+    resource.buffer = buffer;
+    return { addResource(std::move(resource)) };
+}
+
+void RenderGraph::exportImage(ImageHandle image, Access finalAccess) {
+    if (!image || image.index >= m_resources.size() || !m_resources[image.index].isImage) {
+        throw std::runtime_error("RenderGraph: exportImage() with an invalid handle");
+    }
+    m_resources[image.index].finalAccess = finalAccess;
+    m_compiled = false;
+}
+
+void RenderGraph::addPass(const std::string& name, const SetupFunc& setup, ExecuteFunc execute) {
+    uint32_t index = static_cast<uint32_t>(m_passes.size());
+    m_passes.emplace_back();
+    m_passes.back().name = name;
+    m_passes.back().execute = std::move(execute);
+
+    PassBuilder builder(*this, index);
+    setup(builder);
+    m_compiled = false;
+}
+
+uint32_t RenderGraph::addResource(Resource resource) {
+    m_resources.push_back(std::move(resource));
+    return static_cast<uint32_t>(m_resources.size() - 1);
+}
+
+void RenderGraph::addUse(uint32_t pass, uint32_t resource, Access access, bool write) {
+    if (resource >= m_resources.size()) {
+        throw std::runtime_error("RenderGraph: pass '" + m_passes[pass].name + "' uses an invalid handle");
+    }
+
+    const Resource& res = m_resources[resource];
+    AccessInfo info = getAccessInfo(access);
+    bool bufferAccess = info.layout == VK_IMAGE_LAYOUT_UNDEFINED || info.layout == VK_IMAGE_LAYOUT_GENERAL ||
+                        access == Access::TransferRead || access == Access::TransferWrite;
+    bool imageAccess = info.layout != VK_IMAGE_LAYOUT_UNDEFINED;
+
+    if (access == Access::None || access == Access::Present || info.write != write ||
+        (res.isImage ? !imageAccess : !bufferAccess)) {
+        throw std::runtime_error("RenderGraph: pass '" + m_passes[pass].name + "' declares an invalid access to '" +
+                                 res.name + "'");
+    }
+
+    // 同一个Pass对同一个资源只能有一种用法（一次屏障只能转换到一个布局）
+    for (const ResourceUse& use : m_passes[pass].uses) {
+        if (use.resource != resource) continue;
+        if (use.access != access) {
+            throw std::runtime_error("RenderGraph: pass '" + m_passes[pass].name + "' uses '" + res.name +
+                                     "' in two different ways");
+        }
+        return;
+    }
+    m_passes[pass].uses.push_back({ resource, access });
+}
+
+void RenderGraph::compile() {
+    m_stats = Stats{ 0, 0, 0, 0, 0, 0, 0, 0, m_stats.reallocations };
+
+    cullPasses();
+    computeLifetimes();
+    allocateImages();
+    computeAliasBarriers();
+    buildBarriers();
+
+    m_compiled = true;
+}
+
+void RenderGraph::cullPasses() {
+    // 图结束之后还有人看的资源：导入的（图之外的对象）和导出的
+    std::vector<bool> needed(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); i++) {
+        needed[i] = m_resources[i].imported || m_resources[i].finalAccess != Access::None;
+    }
+
+    // 从后往前：写了之后还需要的资源的Pass要执行，它用到的资源也就需要了
+    for (size_t p = m_passes.size(); p-- > 0;) {
+        Pass& pass = m_passes[p];
+
+        bool keep = pass.sideEffect;
+        for (const ResourceUse& use : pass.uses) {
+            if (keep) break;
+            keep = getAccessInfo(use.access).write && needed[use.resource];
+        }
+
+        pass.culled = !keep;
+        if (pass.culled) {
+            m_stats.culledPasses++;
+            continue;
+        }
+        for (const ResourceUse& use : pass.uses) {
+            needed[use.resource] = true;
+        }
+    }
+
+    m_order.clear();
+    for (uint32_t p = 0; p < m_passes.size(); p++) {
+        if (!m_passes[p].culled) m_order.push_back(p);
+    }
+    m_stats.passes = static_cast<uint32_t>(m_order.size());
+}
+
+void RenderGraph::computeLifetimes() {
+    for (Resource& res : m_resources) {
+        res.usage = res.desc.extraUsage | getAccessInfo(res.finalAccess).imageUsage;
+        res.firstPass = UINT32_MAX;
+        res.lastPass = 0;
+        res.endStages = 0;
+        res.endAccess = 0;
+    }
+
+    for (uint32_t i = 0; i < m_order.size(); i++) {
+        for (const ResourceUse& use : m_passes[m_order[i]].uses) {
+            Resource& res = m_resources[use.resource];
+            AccessInfo info = getAccessInfo(use.access);
+
+            res.usage |= info.imageUsage;
+            res.firstPass = std::min(res.firstPass, i);
+            res.lastPass = i;
+            if (info.write) {
+                res.endStages = info.stages;
+                res.endAccess = writeAccessMask(info.access);
+            } else {
+                res.endStages |= info.stages;
+            }
+        }
+    }
+
+    // 导出的图像在图结束之后还要用：活到最后，不能和之后才开始的图像共用内存
+    uint32_t end = static_cast<uint32_t>(m_order.size());
+    for (Resource& res : m_resources) {
+        if (res.firstPass == UINT32_MAX || res.finalAccess == Access::None) continue;
+        res.lastPass = end;
+        res.endStages |= getAccessInfo(res.finalAccess).stages;
+    }
+}
+
+void RenderGraph::allocateImages() {
+    std::vector<uint32_t> transients;
+    for (uint32_t i = 0; i < m_resources.size(); i++) {
+        const Resource& res = m_resources[i];
+        if (res.isImage && !res.imported && res.firstPass != UINT32_MAX) {
+            transients.push_back(i);
+        }
+    }
+
+    // 和上一次同样的图像、同样的生命周期：别名关系不变，直接复用
+    bool reuse = transients.size() == m_physicalImages.size();
+    for (size_t i = 0; reuse && i < transients.size(); i++) {
+        const Resource& res = m_resources[transients[i]];
+        const PhysicalImage& image = m_physicalImages[i];
+        reuse = image.format == res.desc.format && image.extent.width == res.desc.extent.width &&
+                image.extent.height == res.desc.extent.height && image.usage == res.usage &&
+                image.firstPass == res.firstPass && image.lastPass == res.lastPass;
+    }
+
+    if (!reuse) {
+        if (!m_physicalImages.empty()) {
+            m_retired.push_back({ std::move(m_physicalImages), std::move(m_heaps), IRenderPass::MAX_FRAMES_IN_FLIGHT });
+            m_physicalImages.clear();
+            m_heaps.clear();
+        }
+        m_stats.reallocations++;
+
+        std::vector<VkMemoryRequirements> requirements(transients.size());
+        m_physicalImages.resize(transients.size());
+
+        for (size_t i = 0; i < transients.size(); i++) {
+            const Resource& res = m_resources[transients[i]];
+            PhysicalImage& image = m_physicalImages[i];
+            image.format = res.desc.format;
+            image.extent = res.desc.extent;
+            image.usage = res.usage;
+            image.firstPass = res.firstPass;
+            image.lastPass = res.lastPass;
+
+            VkImageCreateInfo imageInfo{};
+            imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            imageInfo.imageType = VK_IMAGE_TYPE_2D;
+            imageInfo.format = image.format;
+            imageInfo.extent = { image.extent.width, image.extent.height, 1 };
+            imageInfo.mipLevels = 1;
+            imageInfo.arrayLayers = 1;
+            imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            imageInfo.usage = image.usage;
+            imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            if (vkCreateImage(m_device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to create transient image '" + res.name + "'");
+            }
+            vkGetImageMemoryRequirements(m_device, image.image, &requirements[i]);
+            image.size = requirements[i].size;
+        }
+
+        std::vector<AliasRequest> aliasRequests(transients.size());
+        for (size_t i = 0; i < transients.size(); i++) {
+            const PhysicalImage& image = m_physicalImages[i];
+            aliasRequests[i] = { image.size, requirements[i].alignment, requirements[i].memoryTypeBits,
+                                 image.firstPass, image.lastPass };
+        }
+
+        std::vector<AliasPlacement> placements;
+        std::vector<AliasHeap> aliasHeaps;
+        planAliasing(aliasRequests, placements, aliasHeaps);
+
+        for (size_t i = 0; i < transients.size(); i++) {
+            m_physicalImages[i].heap = placements[i].heap;
+            m_physicalImages[i].offset = placements[i].offset;
+        }
+        m_heaps.resize(aliasHeaps.size());
+        for (size_t i = 0; i < aliasHeaps.size(); i++) {
+            m_heaps[i].size = aliasHeaps[i].size;
+            m_heaps[i].alignment = aliasHeaps[i].alignment;
+            m_heaps[i].memoryTypeBits = aliasHeaps[i].memoryTypeBits;
+        }
+
+        for (Heap& heap : m_heaps) {
+            VkMemoryRequirements req{ heap.size, heap.alignment, heap.memoryTypeBits };
+
+            VmaAllocationCreateInfo allocInfo{};
+            allocInfo.usage = VMA_MEMORY_USAGE_UNKNOWN;
+            allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+            if (vmaAllocateMemory(m_allocator, &req, &allocInfo, &heap.allocation, nullptr) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to allocate transient image memory!");
+            }
+        }
+
+        for (size_t i = 0; i < transients.size(); i++) {
+            PhysicalImage& image = m_physicalImages[i];
+            if (vmaBindImageMemory2(m_allocator, m_heaps[image.heap].allocation, image.offset, image.image, nullptr)
+                != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to bind transient image memory!");
+            }
+
+            VkImageViewCreateInfo viewInfo{};
+            viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            viewInfo.image = image.image;
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewInfo.format = image.format;
+            viewInfo.subresourceRange = { getAspectMask(image.format), 0, 1, 0, 1 };
+
+            if (vkCreateImageView(m_device, &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+                throw std::runtime_error("RenderGraph: failed to create transient image view!");
+            }
+        }
+    }
+
+    for (size_t i = 0; i < transients.size(); i++) {
+        Resource& res = m_resources[transients[i]];
+        res.physical = static_cast<uint32_t>(i);
+        res.image = m_physicalImages[i].image;
+        res.view = m_physicalImages[i].view;
+
+        m_stats.transientBytes += m_physicalImages[i].size;
+    }
+    for (const Heap& heap : m_heaps) {
+        m_stats.allocatedBytes += heap.size;
+    }
+    m_stats.transientImages = static_cast<uint32_t>(transients.size());
+}
+
+void RenderGraph::planAliasing(const std::vector<AliasRequest>& requests, std::vector<AliasPlacement>& placements,
+                               std::vector<AliasHeap>& heaps) {
+    placements.assign(requests.size(), AliasPlacement{});
+    heaps.clear();
+
+    // 从大到小放置：每个图像放在同一块内存里最低的、
+    // 不和生命周期重叠的图像冲突的偏移上
+    std::vector<size_t> bySize(requests.size());
+    for (size_t i = 0; i < bySize.size(); i++) bySize[i] = i;
+    std::stable_sort(bySize.begin(), bySize.end(), [&](size_t a, size_t b) {
+        return requests[a].size > requests[b].size;
+    });
+
+    std::vector<std::vector<size_t>> placed;   // 每块内存里已经放置的图像
+    for (size_t i : bySize) {
+        const AliasRequest& image = requests[i];
+        AliasPlacement& placement = placements[i];
+
+        uint32_t heapIndex = 0;
+        while (heapIndex < heaps.size() && (heaps[heapIndex].memoryTypeBits & image.memoryTypeBits) == 0) {
+            heapIndex++;
+        }
+        if (heapIndex == heaps.size()) {
+            heaps.emplace_back();
+            placed.emplace_back();
+        }
+        AliasHeap& heap = heaps[heapIndex];
+
+        std::vector<VkDeviceSize> candidates = { 0 };
+        for (size_t other : placed[heapIndex]) {
+            const AliasRequest& o = requests[other];
+            if (overlaps(image.firstPass, image.lastPass, o.firstPass, o.lastPass)) {
+                candidates.push_back(alignUp(placements[other].offset + o.size, image.alignment));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (VkDeviceSize offset : candidates) {
+            bool fits = true;
+            for (size_t other : placed[heapIndex]) {
+                const AliasRequest& o = requests[other];
+                VkDeviceSize otherOffset = placements[other].offset;
+                if (overlaps(image.firstPass, image.lastPass, o.firstPass, o.lastPass) &&
+                    offset < otherOffset + o.size && otherOffset < offset + image.size) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                placement.offset = offset;
+                break;
+            }
+        }
+
+        placement.heap = heapIndex;
+        heap.size = std::max(heap.size, placement.offset + image.size);
+        heap.alignment = std::max(heap.alignment, image.alignment);
+        heap.memoryTypeBits &= image.memoryTypeBits;
+        placed[heapIndex].push_back(i);
+    }
+}
+
+void RenderGraph::computeAliasBarriers() {
+    std::vector<uint32_t> resourceOf(m_physicalImages.size());
+    for (uint32_t i = 0; i < m_resources.size(); i++) {
+        if (m_resources[i].physical != UINT32_MAX && !m_resources[i].imported) {
+            resourceOf[m_resources[i].physical] = i;
+        }
+    }
+
+    // 第一次写之前要等共用内存的前一个图像用完。这一帧里没有前一个时，
+    // 等上一帧最后用这块内存的访问（同一个队列上，屏障的源范围包括之前提交的帧）
+    for (size_t i = 0; i < m_physicalImages.size(); i++) {
+        PhysicalImage& image = m_physicalImages[i];
+        VkPipelineStageFlags beforeStages = 0, allStages = 0;
+        VkAccessFlags beforeAccess = 0, allAccess = 0;
+
+        for (size_t j = 0; j < m_physicalImages.size(); j++) {
+            const PhysicalImage& other = m_physicalImages[j];
+            if (other.heap != image.heap ||
+                !(other.offset < image.offset + image.size && image.offset < other.offset + other.size)) {
+                continue;
+            }
+
+            const Resource& res = m_resources[resourceOf[j]];
+            allStages |= res.endStages;
+            allAccess |= res.endAccess;
+            if (j != i && other.lastPass < image.firstPass) {
+                beforeStages |= res.endStages;
+                beforeAccess |= res.endAccess;
+            }
+        }
+
+        image.aliasStages = beforeStages != 0 ? beforeStages : allStages;
+        image.aliasAccess = beforeStages != 0 ? beforeAccess : allAccess;
+    }
+}
+
+void RenderGraph::buildBarriers() {
+    m_imageBarriers.clear();
+    m_bufferBarriers.clear();
+
+    std::vector<ResourceState> states(m_resources.size());
+    for (size_t i = 0; i < m_resources.size(); i++) {
+        const Resource& res = m_resources[i];
+        ResourceState& state = states[i];
+
+        if (res.imported) {
+            AccessInfo info = getAccessInfo(res.initialAccess);
+            state.layout = info.layout;
+            if (info.write) {
+                state.writeStages = info.stages;
+                state.writeAccess = writeAccessMask(info.access);
+            } else {
+                state.readStages = info.stages;
+            }
+            state.visibleStages = info.stages;
+            state.visibleAccess = info.access;
+        } else if (res.physical != UINT32_MAX) {
+            // 内容不保留：从UNDEFINED转换，等待共用内存的前一个图像
+            state.writeStages = m_physicalImages[res.physical].aliasStages;
+            state.writeAccess = m_physicalImages[res.physical].aliasAccess;
+        }
+    }
+
+    for (uint32_t passIndex : m_order) {
+        Pass& pass = m_passes[passIndex];
+        pass.barriers = BarrierBatch{};
+        pass.barriers.firstImageBarrier = static_cast<uint32_t>(m_imageBarriers.size());
+        pass.barriers.firstBufferBarrier = static_cast<uint32_t>(m_bufferBarriers.size());
+
+        for (const ResourceUse& use : pass.uses) {
+            transition(use.resource, states[use.resource], use.access, pass.barriers);
+        }
+    }
+
+    m_finalBarriers = BarrierBatch{};
+    m_finalBarriers.firstImageBarrier = static_cast<uint32_t>(m_imageBarriers.size());
+    m_finalBarriers.firstBufferBarrier = static_cast<uint32_t>(m_bufferBarriers.size());
+    for (uint32_t i = 0; i < m_resources.size(); i++) {
+        const Resource& res = m_resources[i];
+        if (res.finalAccess == Access::None) continue;
+        if (!res.imported && res.physical == UINT32_MAX) continue;   // 没有Pass写过，没有分配
+        transition(i, states[i], res.finalAccess, m_finalBarriers);
+    }
+}
+
+void RenderGraph::transition(uint32_t resource, ResourceState& state, Access access, BarrierBatch& batch) {
+    const Resource& res = m_resources[resource];
+    AccessInfo info = getAccessInfo(access);
+
+    VkImageLayout oldLayout = state.layout;
+    bool layoutChange = res.isImage && oldLayout != info.layout;
+    VkPipelineStageFlags srcStages = 0;
+    VkAccessFlags srcAccess = 0;
+    bool needBarrier = false;
+
+    if (info.write || layoutChange) {
+        // 写（或布局转换）：等之前的写（WAW）和之后的读（WAR）
+        srcStages = state.writeStages | state.readStages;
+        srcAccess = state.writeAccess;
+        needBarrier = layoutChange || srcStages != 0;
+
+        // 读的布局转换之后，其他阶段的读要等这次的读阶段（转换在它之前完成）
+        state.writeStages = info.stages;
+        state.writeAccess = info.write ? writeAccessMask(info.access) : 0;
+        state.readStages = info.write ? 0 : info.stages;
+        state.visibleStages = info.stages;
+        state.visibleAccess = info.access;
+        state.layout = info.layout;
+    } else {
+        // 同一布局下的读：最后的写对这个阶段还不可见时才需要屏障（RAW）
+        bool visible = (info.stages & ~state.visibleStages) == 0 && (info.access & ~state.visibleAccess) == 0;
+        if ((state.writeStages != 0 || state.writeAccess != 0) && !visible) {
+            srcStages = state.writeStages;
+            srcAccess = state.writeAccess;
+            needBarrier = true;
+            state.visibleStages |= info.stages;
+            state.visibleAccess |= info.access;
+        }
+        state.readStages |= info.stages;
+    }
+
+    if (!needBarrier) return;
+
+    if (res.isImage) {
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = info.access;
+        barrier.oldLayout = oldLayout;
+        barrier.newLayout = info.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = res.image;
+        barrier.subresourceRange = {
+            getAspectMask(res.desc.format), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS
+        };
+        m_imageBarriers.push_back(barrier);
+        batch.imageBarrierCount++;
+        m_stats.imageBarriers++;
+    } else {
+        VkBufferMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = info.access;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.buffer = res.buffer;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+        m_bufferBarriers.push_back(barrier);
+        batch.bufferBarrierCount++;
+        m_stats.bufferBarriers++;
+    }
+
+    if (batch.srcStages == 0 && batch.dstStages == 0) {
+        m_stats.barrierBatches++;
+    }
+    batch.srcStages |= srcStages != 0 ? srcStages : static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    batch.dstStages |= info.stages;
+}
+
+void RenderGraph::execute(VkCommandBuffer cmd) {
+    if (!m_compiled) {
+        throw std::runtime_error("RenderGraph: execute() before compile()");
+    }
+
+    auto recordBarriers = [&](const BarrierBatch& batch) {
+        if (batch.imageBarrierCount == 0 && batch.bufferBarrierCount == 0) return;
+        vkCmdPipelineBarrier(
+            cmd,
+            batch.srcStages,
+            batch.dstStages,
+            0,
+            0, nullptr,
+            batch.bufferBarrierCount, m_bufferBarriers.data() + batch.firstBufferBarrier,
+            batch.imageBarrierCount, m_imageBarriers.data() + batch.firstImageBarrier
+        );
+    };
+
+    Resources resources(*this);
+    for (uint32_t passIndex : m_order) {
+        const Pass& pass = m_passes[passIndex];
+        recordBarriers(pass.barriers);
+        if (pass.execute) {
+            pass.execute(cmd, resources);
+        }
+    }
+    recordBarriers(m_finalBarriers);
+}
+
+RenderGraph::AccessInfo RenderGraph::getAccessInfo(Access access) {
+    switch (access) {
+    case Access::ColorAttachmentWrite:
+        return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+    case Access::DepthAttachmentWrite:
+        return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+    case Access::DepthAttachmentRead:
+        return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, false, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+    case Access::FragmentSampled:
+        return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false, VK_IMAGE_USAGE_SAMPLED_BIT };
+    case Access::ComputeSampled:
+        return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false, VK_IMAGE_USAGE_SAMPLED_BIT };
+    case Access::ComputeStorageRead:
+        return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT,
+                 VK_IMAGE_LAYOUT_GENERAL, false, VK_IMAGE_USAGE_STORAGE_BIT };
+    case Access::ComputeStorageWrite:
+        return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_GENERAL, true, VK_IMAGE_USAGE_STORAGE_BIT };
+    case Access::TransferRead:
+        return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, false, VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+    case Access::TransferWrite:
+        return { VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true, VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+    case Access::IndirectRead:
+        return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                 VK_IMAGE_LAYOUT_UNDEFINED, false, 0 };
+    case Access::VertexRead:
+        return { VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT,
+                 VK_IMAGE_LAYOUT_UNDEFINED, false, 0 };
+    case Access::VertexShaderRead:
+        return { VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                 VK_IMAGE_LAYOUT_UNDEFINED, false, 0 };
+    case Access::Present:
+        return { VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, false, 0 };
+    case Access::None:
+    default:
+        return { 0, 0, VK_IMAGE_LAYOUT_UNDEFINED, false, 0 };
+    }
+}
+
+VkImageAspectFlags RenderGraph::getAspectMask(VkFormat format) {
+    switch (format) {
+    case VK_FORMAT_D32_SFLOAT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT;
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    default:
+        return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include "Rendering/RenderPass.h"
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 渲染图 - Pass声明读写的资源，由图决定顺序、屏障和瞬态图像的内存
+ *
+ * 每帧重新声明（Frostbite FrameGraph的思路）：
+ *   graph.reset();
+ *   graph.addPass("Shadow", setup, execute);   // setup里声明读写
+ *   ...
+ *   graph.compile();
+ *   graph.execute(cmd);                        // 主RenderPass之外
+ *
+ * compile()做的事情：
+ * 1. 剔除：从有副作用的Pass、写导入/导出资源的Pass往回找，
+ *    结果没有被任何人用到的Pass不执行（写被当作读-改-写：之前的写入者也保留）
+ * 2. 顺序：按声明顺序执行留下的Pass（读只能读到之前声明的写，声明顺序就是拓扑序）
+ * 3. 屏障：逐个资源跟踪最后的写和之后的读，只在RAW/WAR/WAW和布局转换时插入；
+ *    同一布局下已经可见的读不需要屏障。每个Pass之前的屏障合并成一次vkCmdPipelineBarrier
+ * 4. 别名：瞬态图像按生命周期（第一次到最后一次使用的Pass）分配，
+ *    生命周期不重叠的图像共用同一块VMA内存。声明的瞬态图像和生命周期不变时，
+ *    下一帧直接复用上次的图像；变了才重新分配（旧的延迟MAX_FRAMES_IN_FLIGHT帧销毁）
+ *
+ * 有附件的Pass自己开始VkRenderPass：它的附件initialLayout和finalLayout
+ * 都用Access对应的布局（COLOR_ATTACHMENT_OPTIMAL等），布局转换由图完成。
+ * 瞬态图像的VkImage/VkImageView只在重新分配时变化，用它们创建framebuffer的Pass比较句柄缓存。
+ *
+ * Example（阴影贴图给主RenderPass采样）：
+ *   RenderGraph::ImageHandle shadowMap;
+ *   graph.addPass("Shadow",
+ *       [&](RenderGraph::PassBuilder& builder) {
+ *           shadowMap = builder.createImage("ShadowMap", { VK_FORMAT_D32_SFLOAT, { 2048, 2048 } });
+ *           builder.write(shadowMap, RenderGraph::Access::DepthAttachmentWrite);
+ *       },
+ *       [&](VkCommandBuffer cmd, const RenderGraph::Resources& resources) {
+ *           VkImageView view = resources.getImageView(shadowMap);
+ *           ...
+ *       });
+ *   graph.exportImage(shadowMap, RenderGraph::Access::FragmentSampled);
+ */
+class RenderGraph {
+public:
+    /**
+     * @brief 资源的用法：决定管线阶段、访问类型、图像布局和是否是写
+     */
+    enum class Access {
+        None,                    // 导入时：内容不需要保留（UNDEFINED）
+        ColorAttachmentWrite,
+        DepthAttachmentWrite,
+        DepthAttachmentRead,     // 只读深度测试
+        FragmentSampled,
+        ComputeSampled,
+        ComputeStorageRead,
+        ComputeStorageWrite,     // 读写storage图像/缓冲
+        TransferRead,
+        TransferWrite,
+        IndirectRead,            // 间接命令、绘制数量
+        VertexRead,              // 顶点/索引缓冲
+        VertexShaderRead,        // 顶点着色器里的uniform/storage缓冲
+        Present
+    };
+
+    struct ImageHandle {
+        uint32_t index = UINT32_MAX;
+        explicit operator bool() const { return index != UINT32_MAX; }
+    };
+
+    struct BufferHandle {
+        uint32_t index = UINT32_MAX;
+        explicit operator bool() const { return index != UINT32_MAX; }
+    };
+
+    // 瞬态图像的描述；usage由声明的Access推导，extraUsage补充其他用途
+    struct ImageDesc {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = { 0, 0 };
+        VkImageUsageFlags extraUsage = 0;
+    };
+
+    class PassBuilder {
+    public:
+        // 创建瞬态图像（只在这一帧的图里存在，内存可能和其他瞬态图像共用）
+        ImageHandle createImage(const std::string& name, const ImageDesc& desc);
+
+        ImageHandle read(ImageHandle image, Access access);
+        ImageHandle write(ImageHandle image, Access access);
+        BufferHandle read(BufferHandle buffer, Access access);
+        BufferHandle write(BufferHandle buffer, Access access);
+
+        // 结果在图之外（回读、调试输出……）：不会被剔除
+        void setSideEffect();
+
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    // execute回调里取实际的Vulkan对象
+    class Resources {
+    public:
+        VkImage getImage(ImageHandle image) const;
+        VkImageView getImageView(ImageHandle image) const;
+        VkExtent2D getExtent(ImageHandle image) const;
+        VkFormat getFormat(ImageHandle image) const;
+        VkBuffer getBuffer(BufferHandle buffer) const;
+
+    private:
+        friend class RenderGraph;
+        explicit Resources(const RenderGraph& graph) : m_graph(graph) {}
+
+        const RenderGraph& m_graph;
+    };
+
+    using SetupFunc = std::function<void(PassBuilder&)>;
+    using ExecuteFunc = std::function<void(VkCommandBuffer, const Resources&)>;
+
+    struct Stats {
+        uint32_t passes = 0;            // 执行的Pass
+        uint32_t culledPasses = 0;
+        uint32_t barrierBatches = 0;    // vkCmdPipelineBarrier调用次数
+        uint32_t imageBarriers = 0;
+        uint32_t bufferBarriers = 0;
+        uint32_t transientImages = 0;
+        VkDeviceSize transientBytes = 0;   // 不共用内存时需要的大小
+        VkDeviceSize allocatedBytes = 0;   // 别名之后实际分配的大小
+        uint32_t reallocations = 0;
+    };
+
+    /**
+     * @brief 瞬态图像在共用内存里的放置（compile()的别名步骤）
+     *
+     * 从大到小放置：每个图像放进第一块memoryTypeBits兼容的内存，偏移取最低的、
+     * 不和生命周期重叠的图像冲突的位置。只有整数运算，不碰Vulkan对象，没有设备也能测试
+     */
+    struct AliasRequest {
+        VkDeviceSize size = 0;
+        VkDeviceSize alignment = 1;
+        uint32_t memoryTypeBits = ~0u;
+        uint32_t firstPass = 0;            // 生命周期（执行顺序里的位置，包含两端）
+        uint32_t lastPass = 0;
+    };
+
+    struct AliasPlacement {
+        uint32_t heap = 0;
+        VkDeviceSize offset = 0;
+    };
+
+    struct AliasHeap {
+        VkDeviceSize size = 0;
+        VkDeviceSize alignment = 1;
+        uint32_t memoryTypeBits = ~0u;     // 放进来的所有图像都兼容的内存类型
+    };
+
+    static void planAliasing(const std::vector<AliasRequest>& requests, std::vector<AliasPlacement>& placements,
+                             std::vector<AliasHeap>& heaps);
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    void initialize(VmaAllocator allocator, VkDevice device);
+    void cleanup();
+
+    // 开始声明新的一帧（每帧一次，fence等待之后）
+    void reset();
+
+    /**
+     * @brief 导入图之外的图像（交换链图像、跨帧保留的贴图……）
+     *
+     * initialAccess是图开始时图像的状态，finalAccess是图结束后要转换到的状态
+     * （Access::None = 不需要转换）。写导入资源的Pass不会被剔除。
+     */
+    ImageHandle importImage(const std::string& name, VkImage image, VkImageView view, VkFormat format,
+                            VkExtent2D extent, Access initialAccess, Access finalAccess);
+    BufferHandle importBuffer(const std::string& name, VkBuffer buffer, Access initialAccess, Access finalAccess);
+
+    // 瞬态图像在图之后还要用（比如主RenderPass采样）：图结束时转换到finalAccess，写它的Pass不会被剔除
+    void exportImage(ImageHandle image, Access finalAccess);
+
+    void addPass(const std::string& name, const SetupFunc& setup, ExecuteFunc execute);
+
+    // 剔除、计算屏障、分配瞬态图像
+    void compile();
+
+    // 录制所有Pass（不在任何RenderPass内）
+    void execute(VkCommandBuffer cmd);
+
+    const Stats& getStats() const { return m_stats; }
+
+private:
+    struct AccessInfo {
+        VkPipelineStageFlags stages;
+        VkAccessFlags access;
+        VkImageLayout layout;
+        bool write;
+        VkImageUsageFlags imageUsage;
+    };
+
+    struct Resource {
+        std::string name;
+        bool isImage = true;
+        bool imported = false;
+        Access initialAccess = Access::None;
+        Access finalAccess = Access::None;
+
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        ImageDesc desc;
+
+        // compile()
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = UINT32_MAX;   // 执行顺序里的位置
+        uint32_t lastPass = 0;
+        VkPipelineStageFlags endStages = 0;   // 最后一次写和之后的读（别名的下一个图像要等它们）
+        VkAccessFlags endAccess = 0;
+        uint32_t physical = UINT32_MAX;       // m_physicalImages的下标
+    };
+
+    struct ResourceUse {
+        uint32_t resource;
+        Access access;
+    };
+
+    struct BarrierBatch {
+        VkPipelineStageFlags srcStages = 0;
+        VkPipelineStageFlags dstStages = 0;
+        uint32_t firstImageBarrier = 0;
+        uint32_t imageBarrierCount = 0;
+        uint32_t firstBufferBarrier = 0;
+        uint32_t bufferBarrierCount = 0;
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<ResourceUse> uses;
+        ExecuteFunc execute;
+        bool sideEffect = false;
+        bool culled = false;
+        BarrierBatch barriers;
+    };
+
+    // 瞬态图像的实际对象；签名相同时跨帧复用
+    struct PhysicalImage {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent = { 0, 0 };
+        VkImageUsageFlags usage = 0;
+        uint32_t firstPass = 0;
+        uint32_t lastPass = 0;
+
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t heap = 0;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+
+        // 第一次使用之前要等待的：共用内存的前一个图像（或上一帧）的最后访问
+        VkPipelineStageFlags aliasStages = 0;
+        VkAccessFlags aliasAccess = 0;
+    };
+
+    struct Heap {
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        VkDeviceSize alignment = 1;
+        uint32_t memoryTypeBits = ~0u;
+    };
+
+    // 重新分配后旧的图像还可能被在飞的帧使用
+    struct RetiredImages {
+        std::vector<PhysicalImage> images;
+        std::vector<Heap> heaps;
+        uint32_t framesLeft;
+    };
+
+    struct ResourceState {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags writeStages = 0;   // 最后一次写
+        VkAccessFlags writeAccess = 0;
+        VkPipelineStageFlags readStages = 0;    // 最后一次写之后的读
+        VkPipelineStageFlags visibleStages = 0; // 最后一次写已经对这些阶段/访问可见
+        VkAccessFlags visibleAccess = 0;
+    };
+
+    static AccessInfo getAccessInfo(Access access);
+    static VkImageAspectFlags getAspectMask(VkFormat format);
+
+    uint32_t addResource(Resource resource);
+    void addUse(uint32_t pass, uint32_t resource, Access access, bool write);
+
+    void cullPasses();
+    void computeLifetimes();
+    void allocateImages();
+    void computeAliasBarriers();
+    void buildBarriers();
+    void transition(uint32_t resource, ResourceState& state, Access access, BarrierBatch& batch);
+
+    void destroyImages(std::vector<PhysicalImage>& images, std::vector<Heap>& heaps);
+
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
+    VkDevice m_device = VK_NULL_HANDLE;
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<uint32_t> m_order;   // 执行的Pass（m_passes的下标）
+    bool m_compiled = false;
+
+    std::vector<VkImageMemoryBarrier> m_imageBarriers;
+    std::vector<VkBufferMemoryBarrier> m_bufferBarriers;
+    BarrierBatch m_finalBarriers;    // 图结束时导入/导出资源的转换
+
+    std::vector<PhysicalImage> m_physicalImages;
+    std::vector<Heap> m_heaps;
+    std::vector<RetiredImages> m_retired;
+
+    Stats m_stats;
+};
@@ -3,6 +3,7 @@
 #include <vulkan/vulkan.h>
 
 class ECS;
+class RenderGraph;
 
 /**
  * @brief 渲染Pass接口
@@ -23,6 +24,8 @@ class ECS;
  * 1. 创建新的Pass类，继承IRenderPass
  * 2. 实现execute()方法
  * 3. 在Renderer中注册Pass
+ * 4. 有中间结果（阴影贴图、SSAO、后处理的中间图像）的Pass在setupGraph()里
+ *    声明读写，顺序、屏障和瞬态图像的内存由RenderGraph决定
  *
  * Example:
  *   class ShadowPass : public IRenderPass {
@@ -36,8 +39,20 @@ class ECS;
  */
 class IRenderPass {
 public:
+    // 同时在GPU上执行的帧数（每帧资源需要这么多份）
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
     virtual ~IRenderPass() = default;
 
+    /**
+     * @brief 开始新的一帧（可选）
+     *
+     * Renderer在录制之前调用。frameIndex在[0, MAX_FRAMES_IN_FLIGHT)之间，
+     * 调用时上一次使用同一个frameIndex的帧已经在GPU上执行完，
+     * 它的每帧资源（实例缓冲、uniform等）可以安全地覆盖。
+     */
+    virtual void beginFrame(uint32_t) {}
+
     /**
      * @brief 执行渲染Pass
      *
@@ -46,6 +61,29 @@ public:
      */
     virtual void execute(VkCommandBuffer cmd, ECS& ecs) = 0;
 
+    /**
+     * @brief 录制离屏工作（可选）
+     *
+     * 在主RenderPass开始之前调用。不经过渲染图的离屏工作（比如GPU剔除）在这里录制；
+     * 有自己附件的Pass在这里开始/结束自己的VkRenderPass，因为RenderPass不能嵌套。
+     *
+     * @param cmd Vulkan命令缓冲区（不在任何RenderPass内）
+     * @param ecs ECS实例
+     */
+    virtual void executeOffscreen(VkCommandBuffer, ECS&) {}
+
+    /**
+     * @brief 把离屏工作声明到渲染图（可选）
+     *
+     * Renderer每帧reset()渲染图之后调用；addPass()的execute回调
+     * 在主RenderPass开始之前、executeOffscreen()之前录制。
+     * 结果给主RenderPass用的瞬态图像要exportImage()，否则会被剔除。
+     *
+     * @param graph 这一帧的渲染图
+     * @param ecs ECS实例
+     */
+    virtual void setupGraph(RenderGraph&, ECS&) {}
+
     /**
      * @brief 清理资源
      */
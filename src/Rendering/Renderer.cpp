@@ -1,8 +1,18 @@
 #include "Rendering/Renderer.h"
 #include "Rendering/ForwardPass.h"
+#include "Rendering/FrameAllocator.h"
+#include "Rendering/MeshArena.h"
+#include "Rendering/PickingPass.h"
+#include "Rendering/PipelineCompiler.h"
+#include "Rendering/PipelineRegistry.h"
+#include "Rendering/RenderGraph.h"
+#include "Rendering/ThreadCommandPools.h"
+#include "Core/ShaderLibrary.h"
 #include "Core/VulkanContext.h"
 #include "Core/VulkanSwapchain.h"
+#include "Core/VulkanUploader.h"
 #include "Framework/Camera.h"
+#include "Framework/JobSystem.h"
 #include "ECS/ECS.h"
 #include <stdexcept>
 #include <array>
@@ -11,9 +21,10 @@ Renderer::~Renderer() {
     cleanup();
 }
 
-void Renderer::initialize(VulkanContext* context, Camera* camera) {
+void Renderer::initialize(VulkanContext* context, Camera* camera, VmaAllocator allocator) {
     m_context = context;
     m_camera = camera;
+    m_allocator = allocator;
 
     // TODO: 实现这些初始化函数
     createRenderPass();
@@ -22,6 +33,18 @@ void Renderer::initialize(VulkanContext* context, Camera* camera) {
     createCommandPool();
     createCommandBuffers();
     createSyncObjects();
+    createUploader();
+    createFrameAllocator();
+
+    m_renderGraph = std::make_unique<RenderGraph>();
+    m_renderGraph->initialize(m_allocator, m_context->getDevice());
+
+    m_shaderLibrary = std::make_unique<ShaderLibrary>();
+    m_shaderLibrary->initialize(m_context->getDevice());
+    m_pipelineCompiler = std::make_unique<PipelineCompiler>();
+    m_pipelineCompiler->initialize(m_context->getDevice(), nullptr);
+    m_pipelineRegistry = std::make_unique<PipelineRegistry>();
+    m_pipelineRegistry->initialize(m_context->getDevice(), m_pipelineCompiler.get(), m_shaderLibrary.get());
 
     // 初始化渲染Pass
     initializeRenderPasses();
@@ -33,11 +56,50 @@ void Renderer::cleanup() {
     // 等待设备空闲
     vkDeviceWaitIdle(device);
 
-    // 清理渲染Pass
+    // 先清理渲染Pass：它们的管线和材质不能比下面的着色器库、编译器活得久
     for (auto& pass : m_renderPasses) {
         pass->cleanup();
     }
     m_renderPasses.clear();
+    m_pickingPass = nullptr;
+    m_forwardPass = nullptr;
+
+    // 还在编译的pipeline：编译作业结束后才能销毁设备
+    if (m_pipelineRegistry) {
+        m_pipelineRegistry->cleanup();
+        m_pipelineRegistry.reset();
+    }
+    if (m_pipelineCompiler) {
+        m_pipelineCompiler->cleanup();
+        m_pipelineCompiler.reset();
+    }
+    // 编译都结束了，module不再需要
+    if (m_shaderLibrary) {
+        m_shaderLibrary->cleanup();
+        m_shaderLibrary.reset();
+    }
+
+    // 瞬态图像（包括等待延迟销毁的）
+    if (m_renderGraph) {
+        m_renderGraph->cleanup();
+        m_renderGraph.reset();
+    }
+
+    if (m_frameAllocator) {
+        m_frameAllocator->cleanup();
+        m_frameAllocator.reset();
+    }
+
+    if (m_threadCommandPools) {
+        m_threadCommandPools->cleanup();
+        m_threadCommandPools.reset();
+    }
+
+    // 等待已提交的上传，销毁staging环形缓冲
+    if (m_uploader) {
+        m_uploader->cleanup();
+        m_uploader.reset();
+    }
 
     // 清理同步对象
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
@@ -97,25 +159,70 @@ void Renderer::render(ECS& ecs) {
         throw std::runtime_error("Failed to acquire swap chain image!");
     }
 
+    // 这一帧的fence刚等待过：用它录制的拾取回读已经完成（必须在reset之前）
+    if (m_pickingPass) {
+        m_pickingPass->setFrameFence(m_inFlightFences[m_currentFrame]);
+    }
+
+    // 同上：这一帧在FrameAllocator里的一段GPU已经读完
+    m_frameAllocator->beginFrame(m_currentFrame);
+    if (m_meshArena) {
+        m_meshArena->beginFrame();
+    }
+    if (m_threadCommandPools) {
+        m_threadCommandPools->beginFrame(m_currentFrame);
+    }
+
+    for (auto& pass : m_renderPasses) {
+        pass->beginFrame(m_currentFrame);
+    }
+
+    // 离屏工作声明到渲染图：剔除没用的Pass，计算屏障，分配瞬态图像
+    m_renderGraph->reset();
+    for (auto& pass : m_renderPasses) {
+        pass->setupGraph(*m_renderGraph, ecs);
+    }
+    m_renderGraph->compile();
+
     // 重置fence（等待新的帧）
     vkResetFences(device, 1, &m_inFlightFences[m_currentFrame]);
 
+    // 提交这一帧之前排队的上传（不等待，GPU上由信号量同步）
+    VkCommandBuffer acquireCmd = VK_NULL_HANDLE;
+    uint64_t uploadValue = prepareUploads(acquireCmd);
+
     // 重置并记录命令缓冲区
     VkCommandBuffer cmd = m_commandBuffers[m_currentFrame];
     vkResetCommandBuffer(cmd, 0);
     recordCommandBuffer(cmd, imageIndex, ecs);
+    m_frameAllocator->flush();
 
-    // 提交命令缓冲区
+    // 提交命令缓冲区（获取屏障在前）
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkSemaphore waitSemaphores[] = { m_imageAvailableSemaphores[m_currentFrame] };
-    VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    submitInfo.waitSemaphoreCount = 1;
+    VkSemaphore waitSemaphores[2] = { m_imageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE };
+    VkPipelineStageFlags waitStages[2] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0 };
+    uint64_t waitValues[2] = { 0, uploadValue };   // 二值信号量的值被忽略
+    uint32_t waitCount = 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    if (uploadValue > 0) {
+        waitSemaphores[1] = m_uploader->getSemaphore();
+        waitStages[1] = VulkanUploader::CONSUMER_STAGES;
+        waitCount = 2;
+        timelineInfo.waitSemaphoreValueCount = waitCount;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        submitInfo.pNext = &timelineInfo;
+    }
+
+    VkCommandBuffer commandBuffers[2] = { acquireCmd, cmd };
+    submitInfo.waitSemaphoreCount = waitCount;
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.commandBufferCount = acquireCmd != VK_NULL_HANDLE ? 2 : 1;
+    submitInfo.pCommandBuffers = acquireCmd != VK_NULL_HANDLE ? commandBuffers : &cmd;
 
     VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
     submitInfo.signalSemaphoreCount = 1;
@@ -162,6 +269,111 @@ void Renderer::recreateFramebuffers() {
 
     // 重建
     createFramebuffers();
+
+    if (m_pickingPass) {
+        m_pickingPass->resize(m_context->getSwapchain()->getExtent());
+    }
+}
+
+void Renderer::enablePicking() {
+    if (m_pickingPass) return;
+
+    auto pickingPass = std::make_unique<PickingPass>();
+    pickingPass->initialize(m_allocator, m_context->getDevice(), m_context->getSwapchain()->getExtent(),
+                            m_context->getPipelineCache());
+    pickingPass->setCamera(m_camera);
+    m_pickingPass = pickingPass.get();
+    m_renderPasses.push_back(std::move(pickingPass));
+}
+
+void Renderer::createUploader() {
+    const auto families = m_context->getQueueFamilies();
+    uint32_t graphicsFamily = families.graphicsFamily.value_or(0);
+
+    m_uploader = std::make_unique<VulkanUploader>();
+    m_uploader->initialize(
+        m_allocator,
+        m_context->getDevice(),
+        m_context->getTransferQueue(),
+        m_context->getTransferQueueFamily(),
+        graphicsFamily
+    );
+
+    m_acquireCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = m_commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+
+    if (vkAllocateCommandBuffers(m_context->getDevice(), &allocInfo, m_acquireCommandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate upload acquire command buffers!");
+    }
+}
+
+void Renderer::createFrameAllocator() {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_context->getPhysicalDevice(), &properties);
+
+    m_frameAllocator = std::make_unique<FrameAllocator>();
+    m_frameAllocator->initialize(
+        m_allocator,
+        properties.limits.minUniformBufferOffsetAlignment,
+        properties.limits.minStorageBufferOffsetAlignment
+    );
+}
+
+uint64_t Renderer::prepareUploads(VkCommandBuffer& acquireCmd) {
+    acquireCmd = VK_NULL_HANDLE;
+    if (!m_uploader) return 0;
+
+    m_uploader->submit();
+
+    // 传输队列族和图形队列族不同：这一帧先获取新上传区间的所有权
+    if (m_uploader->hasPendingAcquires()) {
+        acquireCmd = m_acquireCommandBuffers[m_currentFrame];
+        vkResetCommandBuffer(acquireCmd, 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(acquireCmd, &beginInfo);
+        m_uploader->recordAcquires(acquireCmd);
+        vkEndCommandBuffer(acquireCmd);
+    }
+
+    return m_uploader->takeGraphicsWaitValue();
+}
+
+void Renderer::enableParallelRecording(JobSystem* jobs) {
+    // 旧的命令池可能还被在飞的帧使用
+    vkDeviceWaitIdle(m_context->getDevice());
+
+    m_forwardPass->setParallelRecording(nullptr, nullptr);
+    if (m_threadCommandPools) {
+        m_threadCommandPools->cleanup();
+        m_threadCommandPools.reset();
+    }
+    m_subpassContents = VK_SUBPASS_CONTENTS_INLINE;
+    if (!jobs) return;
+
+    m_threadCommandPools = std::make_unique<ThreadCommandPools>();
+    m_threadCommandPools->initialize(
+        m_context->getDevice(),
+        m_context->getQueueFamilies().graphicsFamily.value_or(0),
+        jobs->getThreadCount()
+    );
+    m_threadCommandPools->beginFrame(m_currentFrame);
+
+    m_forwardPass->setParallelRecording(jobs, m_threadCommandPools.get());
+    m_subpassContents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+}
+
+void Renderer::enableAsyncPipelineCompilation(JobSystem* jobs) {
+    // 已经提交的编译先完成，它们的AsyncPipeline不受影响
+    m_pipelineCompiler->cleanup();
+    m_pipelineCompiler->initialize(m_context->getDevice(), jobs);
 }
 
 // ============================================================================
@@ -207,10 +419,12 @@ void Renderer::createSyncObjects() {
 void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, ECS& ecs) {
     // TODO: 记录命令缓冲区
     // 1. vkBeginCommandBuffer
-    // 2. vkCmdBeginRenderPass
-    // 3. 执行各个渲染Pass
-    // 4. vkCmdEndRenderPass
-    // 5. vkEndCommandBuffer
+    // 2. m_renderGraph->execute(commandBuffer)（Pass在setupGraph()里声明的离屏工作和屏障，比如PickingPass）
+    // 3. 各个渲染Pass的executeOffscreen()（不经过渲染图的离屏工作，比如ForwardPass的GPU剔除）
+    // 4. vkCmdBeginRenderPass（contents用m_subpassContents）
+    // 5. 执行各个渲染Pass（多线程录制时它们在primary里只调用vkCmdExecuteCommands）
+    // 6. vkCmdEndRenderPass
+    // 7. vkEndCommandBuffer
     //
     // 参考: https://vulkan-tutorial.com/Drawing_a_triangle/Drawing/Command_buffers
     throw std::runtime_error("recordCommandBuffer() not implemented yet!");
@@ -219,8 +433,11 @@ void Renderer::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t image
 void Renderer::initializeRenderPasses() {
     // 创建ForwardPass
     auto forwardPass = std::make_unique<ForwardPass>();
-    forwardPass->initialize(m_context->getDevice(), m_renderPass, m_context->getSwapchain()->getExtent());
+    forwardPass->initialize(m_context->getDevice(), m_renderPass, m_context->getSwapchain()->getExtent(), m_allocator,
+                            m_context->getPipelineCache(), m_context->isGPUDrivenSupported());
     forwardPass->setCamera(m_camera);
+    forwardPass->setFrameAllocator(m_frameAllocator.get());
+    m_forwardPass = forwardPass.get();
     m_renderPasses.push_back(std::move(forwardPass));
 
     // Later: 添加更多Pass
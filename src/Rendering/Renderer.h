@@ -1,13 +1,25 @@
 #pragma once
 
+#include "Rendering/RenderPass.h"
 #include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
 #include <memory>
 #include <vector>
 
 class VulkanContext;
 class ECS;
 class Camera;
-class IRenderPass;
+class PickingPass;
+class MeshArena;
+class ForwardPass;
+class VulkanUploader;
+class FrameAllocator;
+class JobSystem;
+class ThreadCommandPools;
+class RenderGraph;
+class PipelineCompiler;
+class PipelineRegistry;
+class ShaderLibrary;
 
 /**
  * @brief 渲染器 - 协调所有渲染操作
@@ -33,7 +45,8 @@ public:
     Renderer() = default;
     ~Renderer();
 
-    void initialize(VulkanContext* context, Camera* camera);
+    // allocator：Pass的每帧缓冲（实例缓冲、拾取回读等）用VMA分配
+    void initialize(VulkanContext* context, Camera* camera, VmaAllocator allocator);
     void cleanup();
 
     // 渲染主函数
@@ -42,6 +55,45 @@ public:
     // Framebuffer调整大小（窗口resize时调用）
     void recreateFramebuffers();
 
+    // 启用GPU拾取（在initialize之后调用）
+    void enablePicking();
+    PickingPass* getPickingPass() const { return m_pickingPass; }
+
+    // 多线程录制：ForwardPass把绘制列表分块，在jobs的线程上录制进secondary command buffer。
+    // 每个线程每帧一个命令池；主RenderPass改用VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS。
+    // 在initialize之后调用；jobs为空时恢复单线程录制
+    void enableParallelRecording(JobSystem* jobs);
+
+    // 后台编译pipeline：材质用SimpleMaterial::initializeAsync(..., *getPipelineRegistry())创建，
+    // 编译完成之前ForwardPass用替代材质（getForwardPass()->setFallbackMaterial）绘制。
+    // 在initialize之后调用；jobs为空时恢复在调用线程上同步编译
+    void enableAsyncPipelineCompilation(JobSystem* jobs);
+    PipelineCompiler* getPipelineCompiler() const { return m_pipelineCompiler.get(); }
+
+    // 相同配置的材质共用pipeline和layout（新的pipeline交给getPipelineCompiler()编译）。
+    // 用它创建的材质要在cleanup()之前cleanup()：管线的builder里记着着色器库
+    PipelineRegistry* getPipelineRegistry() const { return m_pipelineRegistry.get(); }
+
+    // SPIR-V文件只加载一次，shader module在管线之间共用（注册表给材质的builder用它）
+    ShaderLibrary* getShaderLibrary() const { return m_shaderLibrary.get(); }
+
+    // 主Pass（比如切换GPU驱动绘制：getForwardPass()->isGPUDrivenSupported()时setGPUDriven(true)）
+    ForwardPass* getForwardPass() const { return m_forwardPass; }
+
+    // 异步上传（MeshArena::setUploader、createBufferWithData的uploader版本）。
+    // render()每帧提交排队的上传，并让这一帧等待它们完成
+    VulkanUploader* getUploader() const { return m_uploader.get(); }
+
+    // 每帧的临时数据（uniform、实例数据……）。fence等待之后自动回收这一帧的一段
+    FrameAllocator* getFrameAllocator() const { return m_frameAllocator.get(); }
+
+    // render()每帧fence等待之后调用arena->beginFrame()，回收free()过的网格区间
+    // （arena要比Renderer活得久，或者销毁前设回nullptr）
+    void setMeshArena(MeshArena* arena) { m_meshArena = arena; }
+
+    // 离屏Pass的渲染图（Pass通过IRenderPass::setupGraph声明）；getStats()看剔除、屏障和别名的结果
+    RenderGraph* getRenderGraph() const { return m_renderGraph.get(); }
+
 private:
     // ========================================================================
     // [YOUR VULKAN LEARNING TASK] 实现这些函数
@@ -121,9 +173,19 @@ private:
     // 渲染Pass管理
     void initializeRenderPasses();
 
+    // 上传管理器，和每帧录制获取屏障的命令缓冲（在createCommandPool之后调用）
+    void createUploader();
+    // 提交排队的上传；需要获取所有权时把屏障录制进这一帧的acquire命令缓冲。
+    // 返回这一帧要等待的timeline值（0 = 不用等）
+    uint64_t prepareUploads(VkCommandBuffer& acquireCmd);
+
+    // 按设备的对齐要求创建FrameAllocator
+    void createFrameAllocator();
+
     // 外部引用
     VulkanContext* m_context = nullptr;
     Camera* m_camera = nullptr;
+    VmaAllocator m_allocator = VK_NULL_HANDLE;
 
     // Vulkan对象
     VkRenderPass m_renderPass = VK_NULL_HANDLE;
@@ -137,12 +199,34 @@ private:
     VkImageView m_depthImageView = VK_NULL_HANDLE;
 
     // 同步对象（每帧）
-    static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = IRenderPass::MAX_FRAMES_IN_FLIGHT;
     std::vector<VkSemaphore> m_imageAvailableSemaphores;
     std::vector<VkSemaphore> m_renderFinishedSemaphores;
     std::vector<VkFence> m_inFlightFences;
     uint32_t m_currentFrame = 0;
 
+    // 异步上传
+    std::unique_ptr<VulkanUploader> m_uploader;
+    std::vector<VkCommandBuffer> m_acquireCommandBuffers;   // 每帧一个，只放所有权获取屏障
+
+    std::unique_ptr<FrameAllocator> m_frameAllocator;
+    MeshArena* m_meshArena = nullptr;   // 不拥有
+
+    // 每帧重新声明、编译
+    std::unique_ptr<RenderGraph> m_renderGraph;
+
+    // 材质pipeline的后台编译（enableAsyncPipelineCompilation）
+    std::unique_ptr<ShaderLibrary> m_shaderLibrary;
+    std::unique_ptr<PipelineCompiler> m_pipelineCompiler;
+    std::unique_ptr<PipelineRegistry> m_pipelineRegistry;
+
+    // 多线程录制（enableParallelRecording）
+    std::unique_ptr<ThreadCommandPools> m_threadCommandPools;
+    // 主RenderPass的vkCmdBeginRenderPass用：多线程录制时Pass在里面只能vkCmdExecuteCommands
+    VkSubpassContents m_subpassContents = VK_SUBPASS_CONTENTS_INLINE;
+
     // 渲染Pass列表（可扩展）
     std::vector<std::unique_ptr<IRenderPass>> m_renderPasses;
+    PickingPass* m_pickingPass = nullptr;  // 属于m_renderPasses
+    ForwardPass* m_forwardPass = nullptr;  // 属于m_renderPasses
 };
@@ -1,9 +1,21 @@
 #include "Rendering/SimpleMaterial.h"
+#include "Core/ShaderLibrary.h"
 #include "Core/VulkanPipeline.h"
 #include "Rendering/Mesh.h"
+#include "Rendering/PipelineCompiler.h"
+#include "Rendering/PipelineRegistry.h"
 #include <imgui.h>
+#include <algorithm>
 #include <stdexcept>
 
+namespace {
+
+const char* const VERTEX_SHADER = "shaders/compiled/simple.vert.spv";
+const char* const INSTANCED_VERTEX_SHADER = "shaders/compiled/simple_instanced.vert.spv";
+const char* const FRAGMENT_SHADER = "shaders/compiled/simple.frag.spv";
+
+} // namespace
+
 SimpleMaterial::SimpleMaterial() {
 }
 
@@ -14,48 +26,127 @@ SimpleMaterial::~SimpleMaterial() {
 void SimpleMaterial::initialize(
     VkDevice device,
     VkRenderPass renderPass,
-    VkExtent2D extent
+    VkExtent2D extent,
+    VkPipelineCache pipelineCache
 ) {
     m_device = device;
+    m_pushConstants = getPushConstantRange(nullptr);
+    createPipelineLayout();
+
+    m_pipeline = createBuilder(false, renderPass, extent, pipelineCache, nullptr)->build();
+    m_instancedPipeline = createBuilder(true, renderPass, extent, pipelineCache, nullptr)->build();
+}
+
+void SimpleMaterial::initializeAsync(
+    VkDevice device,
+    VkRenderPass renderPass,
+    VkExtent2D extent,
+    PipelineRegistry& registry,
+    VkPipelineCache pipelineCache
+) {
+    m_device = device;
+    ShaderLibrary* shaderLibrary = registry.getShaderLibrary();
+
+    auto builder = createBuilder(false, renderPass, extent, pipelineCache, shaderLibrary);
+    auto instancedBuilder = createBuilder(true, renderPass, extent, pipelineCache, shaderLibrary);
+
+    // 两个版本的push constant在同一个位置（MVP / ViewProjection），共用simple.vert反射出的layout
+    m_pushConstants = getPushConstantRange(builder.get());
+    m_sharedLayout = registry.acquireLayout({}, { m_pushConstants });
+    m_pipelineLayout = m_sharedLayout->get();
+    builder->setPipelineLayout(m_pipelineLayout);
+    instancedBuilder->setPipelineLayout(m_pipelineLayout);
+
+    // 配置和已有的实例相同时直接共用；否则builder随请求一起交给工作线程。
+    // 管线也持有layout：cleanup()在编译中途释放m_sharedLayout时layout不会先被销毁
+    m_asyncPipeline = registry.acquire(std::move(builder), m_sharedLayout);
+    m_asyncInstancedPipeline = registry.acquire(std::move(instancedBuilder), m_sharedLayout);
+}
+
+VkPushConstantRange SimpleMaterial::getPushConstantRange(const VulkanPipelineBuilder* builder) {
+    // 从着色器反射；着色器读不了时（size = 0）用手写的范围，错误由后台编译报告
+    if (builder) {
+        VkPushConstantRange reflected = builder->getReflectedPushConstants();
+        if (reflected.size > 0) return reflected;
+    }
 
-    // 创建管线布局（使用push constants传递MVP）
     VkPushConstantRange pushConstantRange{};
     pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     pushConstantRange.offset = 0;
     pushConstantRange.size = sizeof(glm::mat4);  // MVP矩阵
+    return pushConstantRange;
+}
 
+void SimpleMaterial::createPipelineLayout() {
+    // 创建管线布局（使用push constants传递MVP）
     VkPipelineLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     layoutInfo.pushConstantRangeCount = 1;
-    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    layoutInfo.pPushConstantRanges = &m_pushConstants;
     layoutInfo.setLayoutCount = 0;  // Phase 1不使用descriptor sets
     layoutInfo.pSetLayouts = nullptr;
 
     if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
         throw std::runtime_error("Failed to create pipeline layout!");
     }
+}
 
-    // 创建图形管线
-    VulkanPipelineBuilder builder(m_device);
+std::unique_ptr<VulkanPipelineBuilder> SimpleMaterial::createBuilder(
+    bool instanced,
+    VkRenderPass renderPass,
+    VkExtent2D extent,
+    VkPipelineCache pipelineCache,
+    ShaderLibrary* shaderLibrary
+) const {
+    auto builder = std::make_unique<VulkanPipelineBuilder>(m_device);
 
-    auto bindings = Vertex::getBindingDescription();
+    std::vector<VkVertexInputBindingDescription> bindings = { Vertex::getBindingDescription() };
     auto attributes = Vertex::getAttributeDescriptions();
 
-    m_pipeline = builder
-        .setShaders("shaders/compiled/simple.vert.spv", "shaders/compiled/simple.frag.spv")
-        .setVertexInput({bindings}, attributes)
-        .setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+    if (instanced) {
+        // 实例化版本：多一个每实例的binding
+        auto perInstance = Vertex::getInstanceAttributeDescriptions();
+        attributes.insert(attributes.end(), perInstance.begin(), perInstance.end());
+        bindings.push_back(Vertex::getInstanceBindingDescription());
+        builder->setShaders(INSTANCED_VERTEX_SHADER, FRAGMENT_SHADER);
+    } else {
+        builder->setShaders(VERTEX_SHADER, FRAGMENT_SHADER);
+    }
+
+    // 有着色器库时去掉着色器不读的属性
+    builder->setVertexInput(bindings, attributes)
+        .setShaderLibrary(shaderLibrary);
+    if (shaderLibrary) {
+        builder->setVertexInput(bindings, builder->getActiveVertexAttributes());
+    }
+
+    builder->setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
         .setViewport(extent)
         .setRasterizer(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE)
         .setMultisampling(VK_SAMPLE_COUNT_1_BIT)
         .setDepthStencil(VK_TRUE, VK_TRUE, VK_COMPARE_OP_LESS)
         .setColorBlending(VK_FALSE)
+        .setPipelineLayout(m_pipelineLayout)
         .setRenderPass(renderPass, 0)
-        .build();
+        .setPipelineCache(pipelineCache);
+    return builder;
+}
+
+VkPipeline SimpleMaterial::getPipeline() const {
+    return m_asyncPipeline ? m_asyncPipeline->get() : m_pipeline;
+}
+
+VkPipeline SimpleMaterial::getInstancedPipeline() const {
+    // 实例化版本还没编译好时逐个绘制
+    return m_asyncInstancedPipeline ? m_asyncInstancedPipeline->get() : m_instancedPipeline;
+}
+
+bool SimpleMaterial::isReady() const {
+    return !m_asyncPipeline || m_asyncPipeline->isReady();
 }
 
 void SimpleMaterial::bind(VkCommandBuffer commandBuffer) {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, getPipeline());
 }
 
 void SimpleMaterial::renderUI() {
@@ -65,21 +156,37 @@ void SimpleMaterial::renderUI() {
 }
 
 void SimpleMaterial::setMVP(VkCommandBuffer commandBuffer, const glm::mat4& mvp) {
+    // stageFlags/offset和layout里的范围一致（反射出来的可能包括片段着色器）
     vkCmdPushConstants(
         commandBuffer,
         m_pipelineLayout,
-        VK_SHADER_STAGE_VERTEX_BIT,
-        0,
-        sizeof(glm::mat4),
+        m_pushConstants.stageFlags,
+        m_pushConstants.offset,
+        std::min<uint32_t>(m_pushConstants.size, sizeof(glm::mat4)),
         &mvp
     );
 }
 
+void SimpleMaterial::setViewProjection(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection) {
+    setMVP(commandBuffer, viewProjection);
+}
+
 void SimpleMaterial::cleanup() {
+    // 最后一个引用释放时销毁；还在编译的由编译作业释放
+    m_asyncPipeline.reset();
+    m_asyncInstancedPipeline.reset();
+    if (m_sharedLayout) {
+        m_sharedLayout.reset();
+        m_pipelineLayout = VK_NULL_HANDLE;
+    }
     if (m_pipeline != VK_NULL_HANDLE) {
         vkDestroyPipeline(m_device, m_pipeline, nullptr);
         m_pipeline = VK_NULL_HANDLE;
     }
+    if (m_instancedPipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_instancedPipeline, nullptr);
+        m_instancedPipeline = VK_NULL_HANDLE;
+    }
     if (m_pipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
         m_pipelineLayout = VK_NULL_HANDLE;
@@ -2,6 +2,13 @@
 
 #include "Rendering/Material.h"
 #include <glm/glm.hpp>
+#include <memory>
+
+class AsyncPipeline;
+class PipelineRegistry;
+class SharedPipelineLayout;
+class ShaderLibrary;
+class VulkanPipelineBuilder;
 
 /**
  * @brief 简单材质 - 第一个具体材质实现
@@ -10,6 +17,10 @@
  * - 纯色渲染（顶点颜色）
  * - 简单的MVP变换
  * - 用于Phase 1学习
+ * - initializeAsync()：pipeline和layout从PipelineRegistry取，相同配置的实例共用一份；
+ *   新的pipeline在后台编译，编译完成之前isReady()为false，getPipeline()返回VK_NULL_HANDLE
+ *   有着色器库时push constant范围从着色器反射（setMVP用反射出的stageFlags），
+ *   顶点属性去掉着色器不读的
  *
  * Later：添加PBRMaterial, WaterMaterial等
  */
@@ -21,7 +32,17 @@ public:
     void initialize(
         VkDevice device,
         VkRenderPass renderPass,
-        VkExtent2D extent
+        VkExtent2D extent,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
+    );
+
+    // 和initialize相同，但pipeline和layout由registry共享（需要编译时在后台编译），立即返回
+    void initializeAsync(
+        VkDevice device,
+        VkRenderPass renderPass,
+        VkExtent2D extent,
+        PipelineRegistry& registry,
+        VkPipelineCache pipelineCache = VK_NULL_HANDLE
     );
 
     void bind(VkCommandBuffer commandBuffer) override;
@@ -31,14 +52,34 @@ public:
 
     // 设置变换矩阵（通过push constants）
     void setMVP(VkCommandBuffer commandBuffer, const glm::mat4& mvp);
+    // 实例化pipeline：同一个push constant位置放ViewProjection，model矩阵来自实例缓冲
+    void setViewProjection(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection);
 
-    VkPipeline getPipeline() const { return m_pipeline; }
+    VkPipeline getPipeline() const override;
+    VkPipeline getInstancedPipeline() const override;
+    bool isReady() const override;
     VkPipelineLayout getPipelineLayout() const { return m_pipelineLayout; }
 
 private:
+    // builder有着色器库时从着色器反射；否则（或着色器读不了）是手写的mat4
+    static VkPushConstantRange getPushConstantRange(const VulkanPipelineBuilder* builder);
+    // 用m_pushConstants创建m_pipelineLayout
+    void createPipelineLayout();
+    // instanced = true：多一个每实例的binding。builder用m_pipelineLayout（可以之后再设置）
+    std::unique_ptr<VulkanPipelineBuilder> createBuilder(bool instanced, VkRenderPass renderPass, VkExtent2D extent,
+                                                         VkPipelineCache pipelineCache,
+                                                         ShaderLibrary* shaderLibrary) const;
+
     VkDevice m_device = VK_NULL_HANDLE;
     VkPipeline m_pipeline = VK_NULL_HANDLE;
+    VkPipeline m_instancedPipeline = VK_NULL_HANDLE;
     VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+    VkPushConstantRange m_pushConstants{};   // m_pipelineLayout里唯一的范围
+
+    // initializeAsync：和其他实例共用，编译完成后才有pipeline
+    std::shared_ptr<AsyncPipeline> m_asyncPipeline;
+    std::shared_ptr<AsyncPipeline> m_asyncInstancedPipeline;
+    std::shared_ptr<SharedPipelineLayout> m_sharedLayout;   // m_pipelineLayout属于它
 
     // 材质参数
     glm::vec3 m_color = glm::vec3(1.0f);
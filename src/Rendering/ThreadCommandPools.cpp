@@ -0,0 +1,83 @@
+#include "Rendering/ThreadCommandPools.h"
+#include <stdexcept>
+
+ThreadCommandPools::~ThreadCommandPools() {
+    cleanup();
+}
+
+void ThreadCommandPools::initialize(VkDevice device, uint32_t queueFamily, uint32_t threadCount) {
+    m_device = device;
+    m_threadCount = threadCount;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;   // 整个池一起重置，不需要RESET_COMMAND_BUFFER
+    poolInfo.queueFamilyIndex = queueFamily;
+
+    for (auto& framePools : m_pools) {
+        framePools = std::vector<ThreadPool>(threadCount);
+        for (ThreadPool& threadPool : framePools) {
+            if (vkCreateCommandPool(device, &poolInfo, nullptr, &threadPool.pool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create thread command pool!");
+            }
+        }
+    }
+}
+
+void ThreadCommandPools::cleanup() {
+    if (m_device == VK_NULL_HANDLE) return;
+
+    for (auto& framePools : m_pools) {
+        for (ThreadPool& threadPool : framePools) {
+            // 销毁池时它的命令缓冲一起释放
+            vkDestroyCommandPool(m_device, threadPool.pool, nullptr);
+        }
+        framePools.clear();
+    }
+    m_device = VK_NULL_HANDLE;
+}
+
+void ThreadCommandPools::beginFrame(uint32_t frameIndex) {
+    m_frameIndex = frameIndex;
+    for (ThreadPool& threadPool : m_pools[frameIndex]) {
+        if (threadPool.used == 0) continue;
+        vkResetCommandPool(m_device, threadPool.pool, 0);
+        threadPool.used = 0;
+    }
+}
+
+VkCommandBuffer ThreadCommandPools::beginSecondary(uint32_t threadIndex, VkRenderPass renderPass, uint32_t subpass,
+                                                   VkFramebuffer framebuffer) {
+    ThreadPool& threadPool = m_pools[m_frameIndex][threadIndex];
+
+    if (threadPool.used == threadPool.buffers.size()) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = threadPool.pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to allocate secondary command buffer!");
+        }
+        threadPool.buffers.push_back(commandBuffer);
+    }
+    VkCommandBuffer commandBuffer = threadPool.buffers[threadPool.used++];
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = renderPass;
+    inheritanceInfo.subpass = subpass;
+    inheritanceInfo.framebuffer = framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin secondary command buffer!");
+    }
+    return commandBuffer;
+}
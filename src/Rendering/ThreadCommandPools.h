@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Rendering/RenderPass.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 每线程、每帧的命令池 - 多线程录制secondary command buffer
+ *
+ * VkCommandPool不是线程安全的：从同一个池分配/录制的命令缓冲
+ * 不能同时在多个线程上使用。所以每个线程有自己的池，
+ * 每个池再按帧分开（MAX_FRAMES_IN_FLIGHT份）：
+ * - beginFrame()时这一帧的fence已经等待过，它的所有secondary都执行完了，
+ *   每个池一次vkResetCommandPool全部回收（比逐个vkResetCommandBuffer便宜）
+ * - 回收的命令缓冲下一帧按顺序复用，只有数量增加时才分配新的
+ *
+ * 线程编号来自JobSystem::getCurrentThreadIndex()（0 = 主线程）。
+ *
+ * 使用方法：
+ *   pools.beginFrame(frameIndex);                       // fence等待之后
+ *   jobs.parallelFor(0, chunkCount, 1, [&](uint32_t begin, uint32_t end) {
+ *       VkCommandBuffer secondary = pools.beginSecondary(jobs.getCurrentThreadIndex(), renderPass, 0);
+ *       ...录制...
+ *       vkEndCommandBuffer(secondary);
+ *   });
+ *   vkCmdExecuteCommands(primary, count, secondaries);
+ */
+class ThreadCommandPools {
+public:
+    ThreadCommandPools() = default;
+    ~ThreadCommandPools();
+
+    ThreadCommandPools(const ThreadCommandPools&) = delete;
+    ThreadCommandPools& operator=(const ThreadCommandPools&) = delete;
+
+    void initialize(VkDevice device, uint32_t queueFamily, uint32_t threadCount);
+    void cleanup();
+
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief 在threadIndex线程的池里开始一个secondary command buffer
+     *
+     * 用RENDER_PASS_CONTINUE开始，继承renderPass的subpass；
+     * framebuffer可以为空（驱动不知道具体的framebuffer时优化少一点）。
+     * 只能在编号为threadIndex的线程上调用。
+     */
+    VkCommandBuffer beginSecondary(uint32_t threadIndex, VkRenderPass renderPass, uint32_t subpass,
+                                   VkFramebuffer framebuffer = VK_NULL_HANDLE);
+
+    uint32_t getThreadCount() const { return m_threadCount; }
+
+private:
+    // 每个线程只写自己的那一个，按缓存行对齐避免伪共享
+    struct alignas(64) ThreadPool {
+        VkCommandPool pool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> buffers;
+        size_t used = 0;
+    };
+
+    VkDevice m_device = VK_NULL_HANDLE;
+    uint32_t m_threadCount = 0;
+    uint32_t m_frameIndex = 0;
+    std::vector<ThreadPool> m_pools[IRenderPass::MAX_FRAMES_IN_FLIGHT];   // [帧][线程]
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdio>
+
+/**
+ * @brief 单元测试的最小工具（test_*共用，只有头文件，不依赖测试框架）
+ *
+ * CHECK()失败时打印文件、行号和表达式，然后继续执行，
+ * 一次运行能看到所有失败。main()最后 return test::finish("test_xxx");
+ * 有失败时返回1，ctest据此判定失败。
+ *
+ *   CHECK(allocator.getUsed() == 0);
+ *   CHECK_EQ(offset, 64u);
+ *
+ * 需要Vulkan设备的测试在没有设备（或用到的学习任务还没实现）时
+ * return test::skip("test_xxx", "原因"); ctest按SKIP_RETURN_CODE记为跳过。
+ */
+namespace test {
+
+inline int& failureCount() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* expression) {
+    std::printf("  FAILED %s:%d: %s\n", file, line, expression);
+    failureCount()++;
+}
+
+inline int finish(const char* name) {
+    if (failureCount() == 0) {
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+    std::printf("%s: %d check(s) failed\n", name, failureCount());
+    return 1;
+}
+
+constexpr int SKIP_RETURN_CODE = 77;
+
+inline int skip(const char* name, const char* reason) {
+    std::printf("%s: skipped (%s)\n", name, reason);
+    return SKIP_RETURN_CODE;
+}
+
+} // namespace test
+
+#define CHECK(expression) \
+    do { if (!(expression)) test::fail(__FILE__, __LINE__, #expression); } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { if (!((actual) == (expected))) test::fail(__FILE__, __LINE__, #actual " == " #expected); } while (0)
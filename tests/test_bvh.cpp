@@ -0,0 +1,272 @@
+#include "TestCommon.h"
+#include "ECS/BVH.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// BVH：查询结果和暴力遍历一致；增删改之后树的结构仍然正确
+// margin = 0，胖包围盒就是实体本身的盒子，结果可以精确比较
+
+namespace {
+
+struct Scene {
+    std::vector<Entity> entities;
+    std::vector<AABBComponent> bounds;
+};
+
+Scene makeScene(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    std::uniform_real_distribution<float> size(0.2f, 4.0f);
+
+    Scene scene;
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        glm::vec3 half(size(rng) * 0.5f, size(rng) * 0.5f, size(rng) * 0.5f);
+        AABBComponent box;
+        box.min = center - half;
+        box.max = center + half;
+        scene.entities.push_back(makeEntity(i, 1));
+        scene.bounds.push_back(box);
+    }
+    return scene;
+}
+
+bool overlaps(const AABBComponent& a, const AABBComponent& b) {
+    return a.max.x >= b.min.x && a.min.x <= b.max.x &&
+           a.max.y >= b.min.y && a.min.y <= b.max.y &&
+           a.max.z >= b.min.z && a.min.z <= b.max.z;
+}
+
+// 父子索引一致、内部节点包住两个子节点、高度正确、叶子数 == size()
+void checkStructure(const BVH& bvh) {
+    const auto& nodes = bvh.getNodes();
+    if (bvh.getRoot() == BVH::NULL_NODE) {
+        CHECK_EQ(bvh.size(), 0u);
+        return;
+    }
+    CHECK_EQ(nodes[bvh.getRoot()].parent, BVH::NULL_NODE);
+
+    size_t leaves = 0;
+    bool linksValid = true, boundsValid = true, heightsValid = true;
+    std::vector<int32_t> stack{ bvh.getRoot() };
+    while (!stack.empty()) {
+        int32_t index = stack.back();
+        stack.pop_back();
+        const BVH::Node& node = nodes[index];
+        if (node.isLeaf()) {
+            leaves++;
+            heightsValid &= node.height == 0;
+            continue;
+        }
+
+        for (int32_t child : { node.child1, node.child2 }) {
+            const BVH::Node& c = nodes[child];
+            linksValid &= c.parent == index;
+            boundsValid &= node.min.x <= c.min.x && node.min.y <= c.min.y && node.min.z <= c.min.z &&
+                           c.max.x <= node.max.x && c.max.y <= node.max.y && c.max.z <= node.max.z;
+            stack.push_back(child);
+        }
+        heightsValid &= node.height == 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+    }
+
+    CHECK(linksValid);
+    CHECK(boundsValid);
+    CHECK(heightsValid);
+    CHECK_EQ(leaves, bvh.size());
+}
+
+// 对每个查询盒比较BVH结果和暴力结果（present[i] = 实体i当前在树里）
+void checkQueries(const BVH& bvh, const Scene& scene, const std::vector<bool>& present, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-5.0f, 105.0f);
+    std::uniform_real_distribution<float> size(0.0f, 30.0f);
+
+    bool allMatch = true;
+    for (int q = 0; q < 200; ++q) {
+        glm::vec3 corner(position(rng), position(rng), position(rng));
+        AABBComponent query;
+        query.min = corner;
+        query.max = corner + glm::vec3(size(rng), size(rng), size(rng));
+
+        std::vector<Entity> found;
+        bvh.queryAABB(query, [&](Entity e) { found.push_back(e); });
+
+        std::vector<Entity> expected;
+        for (size_t i = 0; i < scene.entities.size(); ++i) {
+            if (present[i] && overlaps(scene.bounds[i], query)) expected.push_back(scene.entities[i]);
+        }
+
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        allMatch &= found == expected;
+    }
+    CHECK(allMatch);
+}
+
+void testEmpty() {
+    BVH bvh(0.0f);
+    int calls = 0;
+    AABBComponent box;
+    bvh.queryAABB(box, [&](Entity) { calls++; });
+    bvh.raycast(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 100.0f, [&](Entity, float) { calls++; return 100.0f; });
+    CHECK_EQ(calls, 0);
+    CHECK_EQ(bvh.getHeight(), 0);
+
+    bvh.build({}, {});
+    CHECK_EQ(bvh.size(), 0u);
+    checkStructure(bvh);
+}
+
+void testBuildMatchesBruteForce() {
+    Scene scene = makeScene(2000, 1);
+    BVH bvh(0.0f);
+    bvh.build(scene.entities, scene.bounds);
+
+    CHECK_EQ(bvh.size(), scene.entities.size());
+    CHECK(bvh.contains(scene.entities[0]));
+    checkStructure(bvh);
+    checkQueries(bvh, scene, std::vector<bool>(scene.entities.size(), true), 2);
+
+    // 2000个叶子的SAH树不该退化成链表
+    CHECK(bvh.getHeight() < 40);
+}
+
+void testInsertRemoveUpdate() {
+    Scene scene = makeScene(1000, 3);
+    std::vector<bool> present(scene.entities.size(), false);
+    BVH bvh(0.0f);
+
+    for (size_t i = 0; i < scene.entities.size(); ++i) {
+        bvh.insert(scene.entities[i], scene.bounds[i]);
+        present[i] = true;
+    }
+    checkStructure(bvh);
+    checkQueries(bvh, scene, present, 4);
+
+    // 删掉每三个中的一个
+    for (size_t i = 0; i < scene.entities.size(); i += 3) {
+        bvh.remove(scene.entities[i]);
+        present[i] = false;
+    }
+    CHECK(!bvh.contains(scene.entities[0]));
+    bvh.remove(scene.entities[0]);  // 重复删除什么都不做
+    checkStructure(bvh);
+    checkQueries(bvh, scene, present, 5);
+
+    // 移动剩下的一半实体
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> offset(-20.0f, 20.0f);
+    for (size_t i = 1; i < scene.entities.size(); i += 2) {
+        if (!present[i]) continue;
+        glm::vec3 delta(offset(rng), offset(rng), offset(rng));
+        scene.bounds[i].min = scene.bounds[i].min + delta;
+        scene.bounds[i].max = scene.bounds[i].max + delta;
+        bvh.update(scene.entities[i], scene.bounds[i]);
+    }
+    checkStructure(bvh);
+    checkQueries(bvh, scene, present, 7);
+
+    // 删掉的节点会被复用，节点数组不会无限增长
+    size_t nodeCount = bvh.getNodes().size();
+    for (size_t i = 0; i < scene.entities.size(); i += 3) {
+        bvh.insert(scene.entities[i], scene.bounds[i]);
+        present[i] = true;
+    }
+    CHECK(bvh.getNodes().size() <= nodeCount + 2);
+    checkStructure(bvh);
+    checkQueries(bvh, scene, present, 8);
+}
+
+void testFatBounds() {
+    AABBComponent box;
+    BVH bvh(0.5f);
+    bvh.insert(makeEntity(1, 1), box);
+
+    // 在胖包围盒里移动不需要重新插入
+    AABBComponent moved = box;
+    moved.min.x += 0.4f;
+    moved.max.x += 0.4f;
+    CHECK(!bvh.update(makeEntity(1, 1), moved));
+
+    moved.min.x += 0.2f;
+    moved.max.x += 0.2f;
+    CHECK(bvh.update(makeEntity(1, 1), moved));
+
+    // 更新一个不在树里的实体等于插入
+    CHECK(bvh.update(makeEntity(2, 1), box));
+    CHECK_EQ(bvh.size(), 2u);
+    checkStructure(bvh);
+}
+
+void testRaycastClosestHit() {
+    Scene scene = makeScene(2000, 9);
+    BVH bvh(0.0f);
+    bvh.build(scene.entities, scene.bounds);
+
+    std::mt19937 rng(10);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+
+    bool allMatch = true;
+    for (int r = 0; r < 200; ++r) {
+        glm::vec3 origin(position(rng), position(rng), -10.0f);
+        glm::vec3 direction = glm::normalize(glm::vec3(position(rng), position(rng), 110.0f) - origin);
+        const float maxDistance = 200.0f;
+
+        // 和BVH::raycast同样的slab测试，暴力求最近的进入距离
+        float expected = -1.0f;
+        for (const auto& box : scene.bounds) {
+            float t1x = (box.min.x - origin.x) / direction.x, t2x = (box.max.x - origin.x) / direction.x;
+            float t1y = (box.min.y - origin.y) / direction.y, t2y = (box.max.y - origin.y) / direction.y;
+            float t1z = (box.min.z - origin.z) / direction.z, t2z = (box.max.z - origin.z) / direction.z;
+            float tNear = std::max({ std::min(t1x, t2x), std::min(t1y, t2y), std::min(t1z, t2z), 0.0f });
+            float tFar = std::min({ std::max(t1x, t2x), std::max(t1y, t2y), std::max(t1z, t2z), maxDistance });
+            if (tNear <= tFar && (expected < 0.0f || tNear < expected)) expected = tNear;
+        }
+
+        float closest = -1.0f;
+        bvh.raycast(origin, direction, maxDistance, [&](Entity, float entry) {
+            if (closest < 0.0f || entry < closest) closest = entry;
+            return entry;
+        });
+
+        allMatch &= (expected < 0.0f) ? closest < 0.0f : std::abs(closest - expected) < 1e-3f;
+    }
+    CHECK(allMatch);
+}
+
+void testFrustumContainsAABBResults() {
+    Scene scene = makeScene(1000, 11);
+    BVH bvh(0.0f);
+    bvh.build(scene.entities, scene.bounds);
+
+    // 轴对齐的"视锥"（6个朝内的平面围成一个盒子）结果应该和同一个盒子的AABB查询一致
+    AABBComponent box;
+    box.min = glm::vec3(20.0f, 30.0f, 10.0f);
+    box.max = glm::vec3(60.0f, 50.0f, 70.0f);
+    glm::vec4 planes[6] = {
+        glm::vec4( 1.0f, 0.0f, 0.0f, -box.min.x), glm::vec4(-1.0f, 0.0f, 0.0f, box.max.x),
+        glm::vec4( 0.0f, 1.0f, 0.0f, -box.min.y), glm::vec4( 0.0f, -1.0f, 0.0f, box.max.y),
+        glm::vec4( 0.0f, 0.0f, 1.0f, -box.min.z), glm::vec4( 0.0f, 0.0f, -1.0f, box.max.z),
+    };
+
+    std::vector<Entity> byFrustum, byBox;
+    bvh.queryFrustum(planes, [&](Entity e) { byFrustum.push_back(e); });
+    bvh.queryAABB(box, [&](Entity e) { byBox.push_back(e); });
+    std::sort(byFrustum.begin(), byFrustum.end());
+    std::sort(byBox.begin(), byBox.end());
+    CHECK(!byBox.empty());
+    CHECK(byFrustum == byBox);
+}
+
+} // namespace
+
+int main() {
+    testEmpty();
+    testBuildMatchesBruteForce();
+    testInsertRemoveUpdate();
+    testFatBounds();
+    testRaycastClosestHit();
+    testFrustumContainsAABBResults();
+    return test::finish("test_bvh");
+}
@@ -0,0 +1,229 @@
+#include "TestCommon.h"
+#include "Rendering/DrawList.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// DrawList的排序键、基数排序和实例化合并的分段：只测CPU部分（add/sort/findRunEnd），不录制命令
+
+namespace {
+
+// 只提供一个假的pipeline句柄，DrawList用它给绘制分组
+class TestMaterial : public Material {
+public:
+    explicit TestMaterial(uintptr_t pipeline) : m_pipeline(reinterpret_cast<VkPipeline>(pipeline)) {}
+
+    void bind(VkCommandBuffer) override {}
+    VkPipeline getPipeline() const override { return m_pipeline; }
+    void renderUI() override {}
+    void cleanup() override {}
+    const char* getName() const override { return "Test"; }
+
+private:
+    VkPipeline m_pipeline;
+};
+
+struct Draw {
+    uint32_t pass;
+    Material* material;
+    Mesh* mesh;
+    float depth;
+};
+
+// 期望的顺序：和DrawList一样按第一次出现分配编号，然后按键稳定排序
+std::vector<uint32_t> expectedOrder(const std::vector<Draw>& draws) {
+    std::unordered_map<const void*, uint32_t> pipelines, materials, meshes;
+    auto idOf = [](std::unordered_map<const void*, uint32_t>& ids, const void* pointer) {
+        return ids.emplace(pointer, static_cast<uint32_t>(ids.size())).first->second;
+    };
+
+    std::vector<uint64_t> keys;
+    for (const Draw& draw : draws) {
+        uint32_t pipeline = idOf(pipelines, draw.material->getPipeline());
+        uint32_t material = idOf(materials, draw.material);
+        uint32_t mesh = idOf(meshes, draw.mesh);
+        keys.push_back(DrawList::makeKey(draw.pass, pipeline, material, mesh, draw.depth));
+    }
+
+    std::vector<uint32_t> order(draws.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+std::vector<uint32_t> sortedOrder(DrawList& drawList, const std::vector<Draw>& draws) {
+    drawList.clear();
+    for (uint32_t i = 0; i < draws.size(); ++i) {
+        drawList.add(draws[i].pass, draws[i].material, draws[i].mesh, draws[i].depth, i);
+    }
+    drawList.sort();
+
+    std::vector<uint32_t> order;
+    for (size_t i = 0; i < drawList.size(); ++i) order.push_back(drawList.getSortedCommand(i).index);
+    return order;
+}
+
+void testKeyLayout() {
+    // 高位字段优先于所有低位字段
+    CHECK(DrawList::makeKey(1, 0, 0, 0, 0.0f) > DrawList::makeKey(0, 1023, 16383, 65535, 1e30f));
+    CHECK(DrawList::makeKey(0, 1, 0, 0, 0.0f) > DrawList::makeKey(0, 0, 16383, 65535, 1e30f));
+    CHECK(DrawList::makeKey(0, 0, 1, 0, 0.0f) > DrawList::makeKey(0, 0, 0, 65535, 1e30f));
+    CHECK(DrawList::makeKey(0, 0, 0, 1, 0.0f) > DrawList::makeKey(0, 0, 0, 0, 1e30f));
+
+    // 深度：近的在前，0和负数都排在最前
+    CHECK(DrawList::makeKey(0, 0, 0, 0, 1.0f) < DrawList::makeKey(0, 0, 0, 0, 2.0f));
+    CHECK(DrawList::makeKey(0, 0, 0, 0, 0.5f) < DrawList::makeKey(0, 0, 0, 0, 100.0f));
+    CHECK_EQ(DrawList::makeKey(0, 0, 0, 0, 0.0f), DrawList::makeKey(0, 0, 0, 0, -3.0f));
+
+    // 编号超过位数时回绕，不会写进相邻字段
+    CHECK_EQ(DrawList::makeKey(0, 0, 0, 1u << DrawList::MESH_BITS, 0.0f), DrawList::makeKey(0, 0, 0, 0, 0.0f));
+    CHECK_EQ(DrawList::makeKey(1u << DrawList::PASS_BITS, 0, 0, 0, 0.0f), DrawList::makeKey(0, 0, 0, 0, 0.0f));
+}
+
+void testSmallLists() {
+    TestMaterial material(1);
+    Mesh mesh;
+    DrawList drawList;
+
+    CHECK(sortedOrder(drawList, {}).empty());
+    CHECK(sortedOrder(drawList, { { 0, &material, &mesh, 1.0f } }) == std::vector<uint32_t>{ 0 });
+    CHECK(sortedOrder(drawList, { { 0, &material, &mesh, 2.0f }, { 0, &material, &mesh, 1.0f } }) ==
+          (std::vector<uint32_t>{ 1, 0 }));
+}
+
+void testRandomMatchesStableSort() {
+    std::vector<std::unique_ptr<TestMaterial>> materials;
+    for (uint32_t i = 0; i < 12; ++i) materials.push_back(std::make_unique<TestMaterial>(1 + i % 4));   // 4个pipeline
+    std::vector<Mesh> meshes(20);
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint32_t> pass(0, 2), material(0, 11), mesh(0, 19);
+    std::uniform_real_distribution<float> depth(0.0f, 500.0f);
+
+    DrawList drawList;
+    for (uint32_t count : { 7u, 300u, 20000u }) {
+        std::vector<Draw> draws;
+        for (uint32_t i = 0; i < count; ++i) {
+            draws.push_back({ pass(rng), materials[material(rng)].get(), &meshes[mesh(rng)], depth(rng) });
+        }
+        CHECK(sortedOrder(drawList, draws) == expectedOrder(draws));
+    }
+}
+
+void testStableForEqualKeys() {
+    // 所有键都相同：每个字节都被跳过，顺序保持添加顺序
+    TestMaterial material(1);
+    Mesh mesh;
+    std::vector<Draw> draws(100, Draw{ 0, &material, &mesh, 5.0f });
+
+    DrawList drawList;
+    std::vector<uint32_t> order = sortedOrder(drawList, draws);
+    bool inOrder = true;
+    for (uint32_t i = 0; i < order.size(); ++i) inOrder &= order[i] == i;
+    CHECK(inOrder);
+
+    // 深度相同的绘制交错在两个网格之间：按网格分组，组内保持添加顺序
+    Mesh other;
+    draws.clear();
+    for (uint32_t i = 0; i < 10; ++i) draws.push_back({ 0, &material, (i % 2) ? &other : &mesh, 5.0f });
+    CHECK(sortedOrder(drawList, draws) == (std::vector<uint32_t>{ 0, 2, 4, 6, 8, 1, 3, 5, 7, 9 }));
+}
+
+void testGrouping() {
+    // 排序后同一pipeline、同一材质、同一网格的绘制是连续的
+    std::vector<std::unique_ptr<TestMaterial>> materials;
+    for (uint32_t i = 0; i < 6; ++i) materials.push_back(std::make_unique<TestMaterial>(1 + i % 3));
+    std::vector<Mesh> meshes(5);
+
+    std::mt19937 rng(2);
+    DrawList drawList;
+    for (uint32_t i = 0; i < 2000; ++i) {
+        drawList.add(0, materials[rng() % 6].get(), &meshes[rng() % 5], float(rng() % 1000), i);
+    }
+    drawList.sort();
+
+    uint32_t materialChanges = 0, pipelineChanges = 0;
+    for (size_t i = 1; i < drawList.size(); ++i) {
+        const auto& previous = drawList.getSortedCommand(i - 1);
+        const auto& current = drawList.getSortedCommand(i);
+        if (previous.material != current.material) materialChanges++;
+        if (previous.material->getPipeline() != current.material->getPipeline()) pipelineChanges++;
+    }
+    CHECK_EQ(pipelineChanges, 2u);
+    CHECK_EQ(materialChanges, 5u);
+}
+
+// 实例化合并的分段：每段是同一pass、同一材质+网格的最长连续绘制，段数等于出现过的组合数
+void testInstancingRuns() {
+    std::vector<std::unique_ptr<TestMaterial>> materials;
+    for (uint32_t i = 0; i < 3; ++i) materials.push_back(std::make_unique<TestMaterial>(1 + i % 2));
+    std::vector<Mesh> meshes(3);
+
+    std::mt19937 rng(3);
+    bool runsValid = true;
+    bool runCountMatches = true;
+    bool rangesClipped = true;
+    DrawList drawList;
+    for (uint32_t count : { 1u, 2u, 9u, 500u, 5000u }) {
+        std::vector<Draw> draws;
+        std::set<std::tuple<uint32_t, Material*, Mesh*>> groups;
+        for (uint32_t i = 0; i < count; ++i) {
+            Draw draw{ static_cast<uint32_t>(rng() % 3), materials[rng() % 3].get(), &meshes[rng() % 3], float(rng() % 100) };
+            draws.push_back(draw);
+            groups.emplace(draw.pass, draw.material, draw.mesh);
+        }
+        sortedOrder(drawList, draws);
+
+        auto sameGroup = [&](size_t a, size_t b) {
+            const Draw& first = draws[drawList.getSortedCommand(a).index];
+            const Draw& second = draws[drawList.getSortedCommand(b).index];
+            return first.pass == second.pass && first.material == second.material && first.mesh == second.mesh;
+        };
+
+        size_t runs = 0;
+        for (size_t begin = 0; begin < drawList.size(); ++runs) {
+            size_t end = drawList.findRunEnd(begin, drawList.size());
+            runsValid &= end > begin && end <= drawList.size();
+            for (size_t i = begin + 1; i < end; ++i) runsValid &= sameGroup(begin, i);
+            if (end < drawList.size()) runsValid &= !sameGroup(begin, end);   // 最长：下一个属于别的组
+            begin = end;
+        }
+        runCountMatches &= runs == groups.size();
+
+        // 段不超过rangeEnd（多线程录制时每个线程一段）
+        for (int round = 0; round < 50; ++round) {
+            size_t begin = rng() % drawList.size();
+            size_t rangeEnd = begin + 1 + rng() % (drawList.size() - begin);
+            size_t end = drawList.findRunEnd(begin, rangeEnd);
+            rangesClipped &= end > begin && end <= rangeEnd;
+            rangesClipped &= end == rangeEnd || end == drawList.findRunEnd(begin, drawList.size());
+        }
+    }
+    CHECK(runsValid);
+    CHECK(runCountMatches);
+    CHECK(rangesClipped);
+
+    // 同一材质+网格但在不同pass：不合并
+    TestMaterial material(1);
+    Mesh mesh;
+    sortedOrder(drawList, { { 0, &material, &mesh, 1.0f }, { 0, &material, &mesh, 2.0f }, { 1, &material, &mesh, 1.0f } });
+    CHECK_EQ(drawList.findRunEnd(0, drawList.size()), 2u);
+    CHECK_EQ(drawList.findRunEnd(2, drawList.size()), 3u);
+}
+
+} // namespace
+
+int main() {
+    testKeyLayout();
+    testSmallLists();
+    testRandomMatchesStableSort();
+    testStableForEqualKeys();
+    testGrouping();
+    testInstancingRuns();
+    return test::finish("test_drawlist");
+}
@@ -0,0 +1,455 @@
+#include "TestCommon.h"
+#include "ECS/ECS.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// ECS：随机增删实体/组件，和一个简单的模型（每个实体记下有哪些组件、值是多少）对比
+
+namespace {
+
+// 四种组件，大小不同；Big一个chunk只放得下几十行，能测到跨chunk的行
+struct CompA { int value; };
+struct CompB { int value; double padding; };
+struct CompC { int value; };
+struct Big { int value; char padding[500]; };
+
+constexpr int TYPE_COUNT = 4;
+
+struct ModelEntity {
+    bool has[TYPE_COUNT] = {};
+    int value[TYPE_COUNT] = {};
+};
+
+using Model = std::map<Entity, ModelEntity>;
+
+template<int I> struct TypeAt;
+template<> struct TypeAt<0> { using type = CompA; };
+template<> struct TypeAt<1> { using type = CompB; };
+template<> struct TypeAt<2> { using type = CompC; };
+template<> struct TypeAt<3> { using type = Big; };
+
+ComponentTypeID typeIDAt(int type) {
+    switch (type) {
+        case 0: return componentTypeID<CompA>();
+        case 1: return componentTypeID<CompB>();
+        case 2: return componentTypeID<CompC>();
+        default: return componentTypeID<Big>();
+    }
+}
+
+template<int I>
+void addAt(ECS& ecs, Entity entity, int value) {
+    typename TypeAt<I>::type component{};
+    component.value = value;
+    ecs.addComponent(entity, component);
+}
+
+void addComponent(ECS& ecs, Entity entity, int type, int value) {
+    switch (type) {
+        case 0: addAt<0>(ecs, entity, value); break;
+        case 1: addAt<1>(ecs, entity, value); break;
+        case 2: addAt<2>(ecs, entity, value); break;
+        default: addAt<3>(ecs, entity, value); break;
+    }
+}
+
+void removeComponent(ECS& ecs, Entity entity, int type) {
+    switch (type) {
+        case 0: ecs.removeComponent<CompA>(entity); break;
+        case 1: ecs.removeComponent<CompB>(entity); break;
+        case 2: ecs.removeComponent<CompC>(entity); break;
+        default: ecs.removeComponent<Big>(entity); break;
+    }
+}
+
+// 没有这个组件时返回false
+template<int I>
+bool valueAt(const ECS& ecs, Entity entity, int& value) {
+    const auto* component = ecs.getComponent<typename TypeAt<I>::type>(entity);
+    if (component) value = component->value;
+    return component != nullptr;
+}
+
+bool componentValue(const ECS& ecs, Entity entity, int type, int& value) {
+    switch (type) {
+        case 0: return valueAt<0>(ecs, entity, value);
+        case 1: return valueAt<1>(ecs, entity, value);
+        case 2: return valueAt<2>(ecs, entity, value);
+        default: return valueAt<3>(ecs, entity, value);
+    }
+}
+
+bool hasComponent(const ECS& ecs, Entity entity, int type) {
+    switch (type) {
+        case 0: return ecs.hasComponent<CompA>(entity);
+        case 1: return ecs.hasComponent<CompB>(entity);
+        case 2: return ecs.hasComponent<CompC>(entity);
+        default: return ecs.hasComponent<Big>(entity);
+    }
+}
+
+// 实体、组件值、archetype划分都要和模型一致
+bool matchesModel(const ECS& ecs, const Model& model) {
+    if (ecs.getEntityCount() != model.size()) return false;
+
+    std::set<Entity> listed(ecs.getAllEntities().begin(), ecs.getAllEntities().end());
+    if (listed.size() != model.size()) return false;
+
+    for (const auto& [entity, expected] : model) {
+        if (!listed.count(entity) || !ecs.isEntityValid(entity)) return false;
+
+        for (int type = 0; type < TYPE_COUNT; ++type) {
+            int value = 0;
+            bool has = componentValue(ecs, entity, type, value);
+            if (has != expected.has[type] || hasComponent(ecs, entity, type) != has) return false;
+            if (has && value != expected.value[type]) return false;
+        }
+    }
+
+    // 每个实体恰好在一个archetype里，且archetype的组件集合就是实体的组件集合
+    size_t rows = 0;
+    std::set<std::vector<ComponentTypeID>> typeSets;
+    for (const auto& archetype : ecs.getArchetypes()) {
+        std::vector<ComponentTypeID> types = archetype->getTypes();
+        std::sort(types.begin(), types.end());
+        if (!typeSets.insert(types).second) return false;
+
+        for (Entity entity : archetype->getEntities()) {
+            auto it = model.find(entity);
+            if (it == model.end()) return false;
+
+            std::vector<ComponentTypeID> expectedTypes;
+            for (int type = 0; type < TYPE_COUNT; ++type) {
+                if (it->second.has[type]) expectedTypes.push_back(typeIDAt(type));
+            }
+            std::sort(expectedTypes.begin(), expectedTypes.end());
+            if (types != expectedTypes) return false;
+        }
+        rows += archetype->size();
+    }
+    return rows == model.size();
+}
+
+void testBasicMoves() {
+    ECS ecs;
+    Entity entity = ecs.createEntity();
+    CHECK(ecs.isEntityValid(entity));
+    CHECK(!ecs.hasComponent<CompA>(entity));
+
+    addComponent(ecs, entity, 0, 1);
+    addComponent(ecs, entity, 1, 2);
+    CHECK_EQ(ecs.getComponent<CompA>(entity)->value, 1);
+    CHECK_EQ(ecs.getComponent<CompB>(entity)->value, 2);
+
+    // 已有的组件只覆盖值，不换archetype
+    uint64_t version = ecs.getStructureVersion();
+    addComponent(ecs, entity, 0, 10);
+    CHECK_EQ(ecs.getComponent<CompA>(entity)->value, 10);
+    CHECK_EQ(ecs.getStructureVersion(), version);
+
+    ecs.removeComponent<CompA>(entity);
+    CHECK(ecs.getComponent<CompA>(entity) == nullptr);
+    CHECK_EQ(ecs.getComponent<CompB>(entity)->value, 2);
+    CHECK(ecs.getStructureVersion() != version);
+
+    // 删除没有的组件什么都不做
+    version = ecs.getStructureVersion();
+    ecs.removeComponent<CompC>(entity);
+    CHECK_EQ(ecs.getStructureVersion(), version);
+
+    CHECK_EQ(ecs.entitiesWith<CompB>().size(), 1u);
+    CHECK(ecs.entitiesWith<CompA>().empty());
+}
+
+void testRandomAgainstModel() {
+    ECS ecs;
+    Model model;
+    std::vector<Entity> alive;
+    std::mt19937 rng(1234);
+
+    auto pick = [&]() { return alive[std::uniform_int_distribution<size_t>(0, alive.size() - 1)(rng)]; };
+
+    bool consistent = true;
+    for (int step = 0; step < 20000 && consistent; ++step) {
+        int op = std::uniform_int_distribution<int>(0, 9)(rng);
+        int type = std::uniform_int_distribution<int>(0, TYPE_COUNT - 1)(rng);
+
+        if (alive.empty() || op < 3) {
+            Entity entity = ecs.createEntity();
+            alive.push_back(entity);
+            model[entity] = ModelEntity();
+        } else if (op < 4) {
+            Entity entity = pick();
+            ecs.destroyEntity(entity);
+            model.erase(entity);
+            alive.erase(std::find(alive.begin(), alive.end(), entity));
+        } else if (op < 8) {
+            Entity entity = pick();
+            int value = static_cast<int>(rng() % 100000);
+            addComponent(ecs, entity, type, value);
+            model[entity].has[type] = true;
+            model[entity].value[type] = value;
+        } else {
+            Entity entity = pick();
+            removeComponent(ecs, entity, type);
+            model[entity].has[type] = false;
+        }
+
+        if (step % 500 == 0) consistent = matchesModel(ecs, model);
+    }
+
+    CHECK(consistent);
+    CHECK(matchesModel(ecs, model));
+
+    // 删光之后所有archetype都是空的
+    for (Entity entity : alive) ecs.destroyEntity(entity);
+    model.clear();
+    CHECK(matchesModel(ecs, model));
+    CHECK_EQ(ecs.getEntityCount(), 0u);
+}
+
+// view().each()/count()/exclude()和对模型的暴力筛选一致，each()拿到的是组件本身的引用
+void testViewAgainstModel() {
+    ECS ecs;
+    Model model;
+    std::mt19937 rng(99);
+
+    for (int i = 0; i < 3000; ++i) {
+        Entity entity = ecs.createEntity();
+        ModelEntity& expected = model[entity];
+        for (int type = 0; type < TYPE_COUNT; ++type) {
+            if (rng() % 2) {
+                int value = static_cast<int>(rng() % 1000);
+                addComponent(ecs, entity, type, value);
+                expected.has[type] = true;
+                expected.value[type] = value;
+            }
+        }
+    }
+
+    auto expectedEntities = [&](std::initializer_list<int> required, std::initializer_list<int> excluded) {
+        std::set<Entity> result;
+        for (const auto& [entity, expected] : model) {
+            bool match = true;
+            for (int type : required) match &= expected.has[type];
+            for (int type : excluded) match &= !expected.has[type];
+            if (match) result.insert(entity);
+        }
+        return result;
+    };
+
+    std::set<Entity> visited;
+    bool valuesMatch = true;
+    ecs.view<CompA, Big>().each([&](Entity entity, CompA& a, Big& big) {
+        valuesMatch &= visited.insert(entity).second;
+        valuesMatch &= a.value == model[entity].value[0] && big.value == model[entity].value[3];
+    });
+    CHECK(valuesMatch);
+    CHECK(visited == expectedEntities({0, 3}, {}));
+    size_t count = ecs.view<CompA, Big>().count();
+    CHECK_EQ(count, visited.size());
+
+    visited.clear();
+    ecs.view<CompB>().exclude<CompA, CompC>().each([&](Entity entity, CompB&) {
+        visited.insert(entity);
+    });
+    CHECK(visited == expectedEntities({1}, {0, 2}));
+    count = ecs.view<CompB>().exclude<CompA, CompC>().count();
+    CHECK_EQ(count, visited.size());
+
+    // exclude()返回新的View，原来的不受影响
+    auto view = ecs.view<CompC>();
+    auto excluding = view.exclude<Big>();
+    CHECK_EQ(view.count(), expectedEntities({2}, {}).size());
+    CHECK_EQ(excluding.count(), expectedEntities({2}, {3}).size());
+
+    // 通过引用写回
+    ecs.each<CompC>([](Entity, CompC& c) { c.value += 1; });
+    bool written = true;
+    for (const auto& [entity, expected] : model) {
+        if (expected.has[2]) written &= ecs.getComponent<CompC>(entity)->value == expected.value[2] + 1;
+    }
+    CHECK(written);
+
+    // entitiesWith()是同一个查询的分配版
+    std::vector<Entity> with = ecs.entitiesWith<CompA, Big>();
+    CHECK(std::set<Entity>(with.begin(), with.end()) == expectedEntities({0, 3}, {}));
+
+    // 删掉实体后的空archetype不会被访问到
+    for (const auto& entry : model) ecs.destroyEntity(entry.first);
+    int calls = 0;
+    ecs.view<CompA>().each([&](Entity, CompA&) { ++calls; });
+    CHECK_EQ(calls, 0);
+    CHECK_EQ(ecs.view<CompA>().count(), 0u);
+}
+
+// 销毁后的句柄失效；槽位被复用时换代，旧句柄不会误操作新实体
+void testGenerationalHandles() {
+    ECS ecs;
+    CHECK(!ecs.isEntityValid(INVALID_ENTITY));
+    CHECK(!ecs.isEntityValid(makeEntity(12345, 1)));
+
+    Entity first = ecs.createEntity();
+    CHECK(first != INVALID_ENTITY);
+    CHECK_EQ(entityGeneration(first), 1u);
+    addComponent(ecs, first, 0, 7);
+
+    ecs.destroyEntity(first);
+    CHECK(!ecs.isEntityValid(first));
+    CHECK(ecs.getComponent<CompA>(first) == nullptr);
+
+    // 同一个槽位，新的代数
+    Entity second = ecs.createEntity();
+    CHECK_EQ(entityIndex(second), entityIndex(first));
+    CHECK_EQ(entityGeneration(second), entityGeneration(first) + 1);
+    CHECK(ecs.isEntityValid(second));
+    CHECK(!ecs.hasComponent<CompA>(second));
+
+    // 旧句柄上的所有操作都被忽略
+    uint64_t version = ecs.getStructureVersion();
+    addComponent(ecs, first, 0, 99);
+    ecs.removeComponent<CompA>(first);
+    ecs.destroyEntity(first);
+    CHECK(ecs.isEntityValid(second));
+    CHECK(!ecs.hasComponent<CompA>(second));
+    CHECK_EQ(ecs.getStructureVersion(), version);
+    CHECK_EQ(ecs.getEntityCount(), 1u);
+
+    // 重复销毁也是no-op
+    ecs.destroyEntity(second);
+    ecs.destroyEntity(second);
+    CHECK_EQ(ecs.getEntityCount(), 0u);
+
+    // 空闲槽位用完之前不会开新槽位；旧句柄一个都不复活
+    std::vector<Entity> batch;
+    for (int i = 0; i < 100; ++i) batch.push_back(ecs.createEntity());
+    std::vector<Entity> stale = batch;
+    for (Entity entity : batch) ecs.destroyEntity(entity);
+
+    std::set<uint32_t> freeIndices;
+    for (Entity entity : batch) freeIndices.insert(entityIndex(entity));
+
+    bool reused = true;
+    bool staleRejected = true;
+    for (int i = 0; i < 100; ++i) {
+        Entity entity = ecs.createEntity();
+        reused &= freeIndices.erase(entityIndex(entity)) == 1;
+    }
+    for (Entity entity : stale) staleRejected &= !ecs.isEntityValid(entity);
+    CHECK(reused);
+    CHECK(staleRejected);
+    CHECK_EQ(ecs.getEntityCount(), 100u);
+}
+
+// 数自己活着的实例个数；shared_ptr用来确认在archetype之间搬动时值没丢
+struct Counted {
+    static int& alive() {
+        static int count = 0;
+        return count;
+    }
+
+    std::shared_ptr<int> payload;
+
+    explicit Counted(std::shared_ptr<int> value = nullptr) : payload(std::move(value)) { alive()++; }
+    Counted(const Counted& other) : payload(other.payload) { alive()++; }
+    Counted(Counted&& other) noexcept : payload(std::move(other.payload)) { alive()++; }
+    Counted& operator=(const Counted&) = default;
+    ~Counted() { alive()--; }
+};
+
+// removeComponent()、destroyEntity()、ECS析构都会调用析构函数；池统计跟着变
+void testComponentPools() {
+    auto payload = std::make_shared<int>(42);
+    {
+        ECS ecs;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 200; ++i) {
+            Entity entity = ecs.createEntity();
+            ecs.addComponent(entity, Counted(payload));
+            entities.push_back(entity);
+        }
+        CHECK_EQ(Counted::alive(), 200);
+        CHECK_EQ(payload.use_count(), 201);
+
+        ComponentPool::Stats stats = ecs.getPoolStats<Counted>();
+        CHECK_EQ(stats.liveCount, 200u);
+        CHECK_EQ(stats.usedBytes, 200 * sizeof(Counted));
+        CHECK(stats.reservedBytes >= stats.usedBytes);
+        CHECK(stats.peakReservedBytes >= stats.reservedBytes);
+        CHECK(ecs.getAllocatedChunkBytes() >= stats.reservedBytes);
+
+        // 搬到别的archetype：组件被移动，不复制也不泄漏
+        for (int i = 0; i < 100; ++i) addComponent(ecs, entities[i], 0, i);
+        CHECK_EQ(Counted::alive(), 200);
+        CHECK_EQ(payload.use_count(), 201);
+        CHECK(ecs.getComponent<Counted>(entities[0])->payload == payload);
+
+        // 覆盖已有的组件是赋值，个数不变
+        ecs.addComponent(entities[0], Counted(std::make_shared<int>(1)));
+        CHECK_EQ(Counted::alive(), 200);
+        CHECK_EQ(payload.use_count(), 200);
+
+        for (int i = 0; i < 50; ++i) ecs.removeComponent<Counted>(entities[i]);
+        for (int i = 50; i < 100; ++i) ecs.destroyEntity(entities[i]);
+        CHECK_EQ(Counted::alive(), 100);
+        CHECK_EQ(ecs.getPoolStats<Counted>().liveCount, 100u);
+        CHECK_EQ(payload.use_count(), 101);
+
+        // 没用过的类型也有名字，计数为0
+        struct Unused { int value; };
+        CHECK_EQ(ecs.getPoolStats<Unused>().liveCount, 0u);
+        CHECK(ecs.getPoolStats<Unused>().name != nullptr);
+
+        bool listed = false;
+        for (const ComponentPool::Stats& entry : ecs.getPoolStats()) {
+            listed |= entry.liveCount == 100 && entry.usedBytes == 100 * sizeof(Counted);
+        }
+        CHECK(listed);
+    }
+
+    // ECS析构时剩下的组件也被销毁
+    CHECK_EQ(Counted::alive(), 0);
+    CHECK_EQ(payload.use_count(), 1);
+}
+
+// 删光实体后chunk被释放（每个archetype最多留一个备用chunk）
+void testChunkRelease() {
+    ECS ecs;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 2000; ++i) {
+        Entity entity = ecs.createEntity();
+        addComponent(ecs, entity, 3, i);
+        entities.push_back(entity);
+    }
+
+    ComponentPool::Stats full = ecs.getPoolStats<Big>();
+    CHECK_EQ(full.liveCount, 2000u);
+    CHECK(full.reservedBytes >= full.usedBytes);
+
+    for (Entity entity : entities) ecs.destroyEntity(entity);
+    ComponentPool::Stats empty = ecs.getPoolStats<Big>();
+    CHECK_EQ(empty.liveCount, 0u);
+    CHECK_EQ(empty.usedBytes, 0u);
+    CHECK(empty.reservedBytes < full.reservedBytes);
+    CHECK_EQ(empty.peakReservedBytes, full.peakReservedBytes);
+
+    size_t spare = 0;
+    for (const auto& archetype : ecs.getArchetypes()) spare = std::max(spare, archetype->getAllocatedChunkCount());
+    CHECK(spare <= 1);
+}
+
+} // namespace
+
+int main() {
+    testBasicMoves();
+    testRandomAgainstModel();
+    testViewAgainstModel();
+    testGenerationalHandles();
+    testComponentPools();
+    testChunkRelease();
+    return test::finish("test_ecs");
+}
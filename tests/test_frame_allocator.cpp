@@ -0,0 +1,108 @@
+#include "TestCommon.h"
+#include "Rendering/FrameAllocator.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// FrameAllocator的段算法（FrameCursor）：段内分配对齐、不越过段尾、互不重叠；
+// 一帧溢出之后，扩大的段放得下同样的整帧分配（不再溢出），没溢出的帧不扩大
+// 缓冲的创建和映射需要设备（VulkanBuffer::create/map还是学习任务），这里不测
+
+namespace {
+
+struct Request {
+    VkDeviceSize size;
+    VkDeviceSize alignment;
+};
+
+// 用FrameCursor回放一帧，返回用量；overflows是放不下的分配数
+VkDeviceSize replayFrame(const std::vector<Request>& requests, VkDeviceSize segmentSize,
+                         uint32_t& overflows, bool& valid) {
+    FrameAllocator::FrameCursor cursor;
+    overflows = 0;
+    for (const Request& request : requests) {
+        VkDeviceSize head = cursor.head;
+        VkDeviceSize offset = 0;
+        if (cursor.allocate(request.size, request.alignment, segmentSize, offset)) {
+            valid &= offset % request.alignment == 0;
+            valid &= offset >= head;                              // 不和前面的分配重叠
+            valid &= offset + request.size <= segmentSize;
+            valid &= cursor.head == offset + request.size;
+        } else {
+            valid &= cursor.head == head;
+            overflows++;
+        }
+    }
+    valid &= cursor.overflowed == (overflows > 0);
+    return cursor.used;
+}
+
+void testCursorKnown() {
+    FrameAllocator::FrameCursor cursor;
+    VkDeviceSize offset = 0;
+    CHECK(cursor.allocate(20, 16, 256, offset));
+    CHECK_EQ(offset, 0u);
+    CHECK(cursor.allocate(16, 16, 256, offset));
+    CHECK_EQ(offset, 32u);
+    CHECK_EQ(cursor.used, 48u);                         // 实际的对齐填充
+    CHECK(cursor.allocate(0, 256, 256, offset));        // 正好在段尾
+    CHECK_EQ(offset, 256u);
+    CHECK(!cursor.allocate(1, 16, 256, offset));
+    CHECK(cursor.overflowed);
+    CHECK_EQ(cursor.used, 256u + 16u);                  // 溢出按最坏填充：1 + 15
+
+    // 很大的size不能因为回绕而"放得下"
+    FrameAllocator::FrameCursor huge;
+    huge.head = 16;
+    CHECK(!huge.allocate(UINT64_MAX - 8, 16, 256, offset));
+}
+
+void testGrownSegmentSize() {
+    CHECK_EQ(FrameAllocator::grownSegmentSize(1024, 0), 1024u);
+    CHECK_EQ(FrameAllocator::grownSegmentSize(1024, 1024), 1024u);
+    CHECK_EQ(FrameAllocator::grownSegmentSize(1024, 1025), 2048u);     // 至少翻倍
+    CHECK_EQ(FrameAllocator::grownSegmentSize(1024, 5000), 5120u);     // 峰值，256对齐
+}
+
+// 随机的帧（混合uniform/storage/实例数据的对齐）：溢出之后扩大的段放得下整帧
+void testGrowthHoldsFrame() {
+    std::mt19937 rng(23);
+    const VkDeviceSize alignments[] = { 16, 64, 256 };
+    bool valid = true;
+    bool fitsAfterGrowth = true;
+    bool grew = false;
+
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<Request> requests(1 + rng() % 64);
+        for (Request& request : requests) {
+            request.size = 1 + rng() % 512;
+            request.alignment = alignments[rng() % 3];
+        }
+        VkDeviceSize segmentSize = 256 * (1 + rng() % 16);
+
+        uint32_t overflows = 0;
+        VkDeviceSize used = replayFrame(requests, segmentSize, overflows, valid);
+        VkDeviceSize grown = FrameAllocator::grownSegmentSize(segmentSize, used);
+        if (overflows == 0) {
+            valid &= grown == segmentSize;
+            continue;
+        }
+
+        grew = true;
+        valid &= grown > segmentSize && grown % 256 == 0;
+        replayFrame(requests, grown, overflows, valid);
+        fitsAfterGrowth &= overflows == 0;
+    }
+    CHECK(grew);
+    CHECK(valid);
+    CHECK(fitsAfterGrowth);
+}
+
+} // namespace
+
+int main() {
+    testCursorKnown();
+    testGrownSegmentSize();
+    testGrowthHoldsFrame();
+    return test::finish("test_frame_allocator");
+}
@@ -0,0 +1,111 @@
+#include "TestCommon.h"
+#include "Rendering/FrustumCulling.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// FrustumCuller：SIMD版本（SSE，ENABLE_AVX2时是AVX2）和标量的逐平面测试结果一致，
+// 包括凑不满一组的零头；下标按升序输出
+
+namespace {
+
+// 标量参考：double精度算 dist + radius；离0太近的盒子两种结果都算对（舍入顺序不同）
+enum class Expected { Visible, Culled, Either };
+
+Expected referenceTest(const Frustum& frustum, const glm::vec3& center, const glm::vec3& extents) {
+    bool ambiguous = false;
+    for (const glm::vec4& plane : frustum.planes) {
+        double dist = double(plane.x) * center.x + double(plane.y) * center.y + double(plane.z) * center.z + plane.w;
+        double radius = std::fabs(double(plane.x)) * extents.x + std::fabs(double(plane.y)) * extents.y +
+                        std::fabs(double(plane.z)) * extents.z;
+        double value = dist + radius;
+        if (value < -1e-3) return Expected::Culled;
+        if (value < 1e-3) ambiguous = true;
+    }
+    return ambiguous ? Expected::Either : Expected::Visible;
+}
+
+Frustum makeFrustum() {
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(3.0f, 4.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum::fromViewProjection(projection * view);
+}
+
+// 返回结果是否和参考一致，且下标严格递增
+bool cullMatchesReference(const Frustum& frustum, const std::vector<glm::vec3>& centers,
+                          const std::vector<glm::vec3>& extents) {
+    size_t count = centers.size();
+    std::vector<uint32_t> visible(count + 1, UINT32_MAX);
+    size_t visibleCount = FrustumCuller::cull(frustum, centers.data(), extents.data(), count, visible.data());
+    if (visibleCount > count || visible[count] != UINT32_MAX) return false;
+
+    std::vector<bool> reported(count, false);
+    for (size_t k = 0; k < visibleCount; ++k) {
+        if (visible[k] >= count || (k > 0 && visible[k] <= visible[k - 1])) return false;
+        reported[visible[k]] = true;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Expected expected = referenceTest(frustum, centers[i], extents[i]);
+        if (expected == Expected::Visible && !reported[i]) return false;
+        if (expected == Expected::Culled && reported[i]) return false;
+    }
+    return true;
+}
+
+void testAgainstScalarReference() {
+    Frustum frustum = makeFrustum();
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+    // 0..34覆盖8个一组、4个一组和所有零头；再加一个大批量
+    bool match = true;
+    for (size_t count = 0; count <= 34; ++count) {
+        for (int round = 0; round < 20; ++round) {
+            std::vector<glm::vec3> centers(count), extents(count);
+            for (size_t i = 0; i < count; ++i) {
+                centers[i] = glm::vec3(position(rng), position(rng), position(rng));
+                extents[i] = glm::vec3(size(rng), size(rng), size(rng));
+            }
+            match &= cullMatchesReference(frustum, centers, extents);
+        }
+    }
+    CHECK(match);
+
+    std::vector<glm::vec3> centers(10000), extents(10000);
+    for (size_t i = 0; i < centers.size(); ++i) {
+        centers[i] = glm::vec3(position(rng), position(rng), position(rng));
+        extents[i] = glm::vec3(size(rng), size(rng), size(rng));
+    }
+    CHECK(cullMatchesReference(frustum, centers, extents));
+}
+
+void testKnownBoxes() {
+    Frustum frustum = makeFrustum();
+
+    // 相机在(3, 4, 10)看着原点：原点附近可见；相机背后的、远平面之外的剔除；包住整个视锥体的盒子可见
+    std::vector<glm::vec3> centers = {
+        glm::vec3(0.0f), glm::vec3(6.0f, 8.0f, 20.0f),
+        glm::vec3(-60.0f, -80.0f, -200.0f), glm::vec3(0.0f), glm::vec3(1.0f, 0.5f, 0.0f)
+    };
+    std::vector<glm::vec3> extents = {
+        glm::vec3(0.0f), glm::vec3(0.5f), glm::vec3(1.0f), glm::vec3(1000.0f), glm::vec3(0.1f)
+    };
+
+    std::vector<uint32_t> visible(centers.size());
+    size_t visibleCount = FrustumCuller::cull(frustum, centers.data(), extents.data(), centers.size(), visible.data());
+    CHECK_EQ(visibleCount, 3u);
+    CHECK_EQ(visible[0], 0u);
+    CHECK_EQ(visible[1], 3u);
+    CHECK_EQ(visible[2], 4u);
+}
+
+} // namespace
+
+int main() {
+    testAgainstScalarReference();
+    testKnownBoxes();
+    return test::finish("test_frustum_culling");
+}
@@ -0,0 +1,150 @@
+#include "TestCommon.h"
+#include "Framework/JobSystem.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// JobSystem：parallelFor每个下标恰好执行一次、块不越界；计数器、依赖、嵌套和后台作业
+
+namespace {
+
+// [begin, end)里每个下标被访问的次数都是1，且每块不超过grainSize
+bool coversExactlyOnce(JobSystem& jobs, uint32_t begin, uint32_t end, uint32_t grainSize) {
+    uint32_t count = end > begin ? end - begin : 0;
+    std::unique_ptr<std::atomic<uint32_t>[]> hits(new std::atomic<uint32_t>[count + 1]);
+    for (uint32_t i = 0; i <= count; ++i) hits[i] = 0;
+
+    std::atomic<bool> chunksValid{true};
+    jobs.parallelFor(begin, end, grainSize, [&](uint32_t chunkBegin, uint32_t chunkEnd) {
+        if (chunkBegin >= chunkEnd || chunkBegin < begin || chunkEnd > end ||
+            (grainSize != 0 && chunkEnd - chunkBegin > grainSize)) {
+            chunksValid = false;
+            return;
+        }
+        for (uint32_t i = chunkBegin; i < chunkEnd; ++i) hits[i - begin]++;
+    });
+
+    bool exact = chunksValid.load();
+    for (uint32_t i = 0; i < count; ++i) exact &= hits[i].load() == 1;
+    return exact;
+}
+
+void testParallelForCoverage() {
+    JobSystem jobs(3);
+
+    const uint32_t counts[] = { 0, 1, 2, 7, 64, 1000, 4097, 100000 };
+    const uint32_t grains[] = { 0, 1, 3, 64, 1000, 200000 };
+    bool covered = true;
+    for (uint32_t count : counts) {
+        for (uint32_t grain : grains) {
+            covered &= coversExactlyOnce(jobs, 0, count, grain);
+            covered &= coversExactlyOnce(jobs, 12345, 12345 + count, grain);
+        }
+    }
+    CHECK(covered);
+
+    // 区间贴着UINT32_MAX：块尾不能回绕
+    CHECK(coversExactlyOnce(jobs, UINT32_MAX - 10, UINT32_MAX, 4));
+    CHECK(coversExactlyOnce(jobs, UINT32_MAX - 1000, UINT32_MAX, 0));
+
+    // begin >= end 什么都不做
+    int calls = 0;
+    jobs.parallelFor(10, 5, 1, [&](uint32_t, uint32_t) { ++calls; });
+    CHECK_EQ(calls, 0);
+}
+
+// 作业里再调用parallelFor：等待的线程会帮忙执行，不会死锁
+void testNestedParallelFor() {
+    JobSystem jobs(2);
+    std::atomic<uint64_t> sum{0};
+    jobs.parallelFor(0, 16, 1, [&](uint32_t outerBegin, uint32_t outerEnd) {
+        for (uint32_t outer = outerBegin; outer < outerEnd; ++outer) {
+            jobs.parallelFor(0, 1000, 50, [&](uint32_t begin, uint32_t end) {
+                uint64_t local = 0;
+                for (uint32_t i = begin; i < end; ++i) local += i;
+                sum += local;
+            });
+        }
+    });
+    CHECK_EQ(sum.load(), 16ull * (999ull * 1000ull / 2));
+}
+
+void testCountersAndDependencies() {
+    JobSystem jobs(2);
+
+    JobCounter first;
+    std::atomic<int> firstDone{0};
+    for (int i = 0; i < 100; ++i) {
+        jobs.run([&]() { firstDone++; }, &first);
+    }
+
+    // 依赖first的作业只能看到first全部完成
+    JobCounter second;
+    std::atomic<bool> orderHeld{true};
+    for (int i = 0; i < 20; ++i) {
+        jobs.run([&]() { orderHeld = orderHeld && firstDone.load() == 100; }, &second, &first);
+    }
+
+    jobs.wait(second);
+    CHECK(first.isDone());
+    CHECK(second.isDone());
+    CHECK_EQ(firstDone.load(), 100);
+    CHECK(orderHeld.load());
+
+    // 依赖已经完成时直接执行
+    JobCounter third;
+    bool ran = false;
+    jobs.run([&]() { ran = true; }, &third, &first);
+    jobs.wait(third);
+    CHECK(ran);
+}
+
+void testThreadIndices() {
+    JobSystem jobs(3);
+    CHECK_EQ(jobs.getThreadCount(), 4u);
+    CHECK_EQ(jobs.getCurrentThreadIndex(), 0u);
+
+    std::atomic<bool> inRange{true};
+    jobs.parallelFor(0, 10000, 16, [&](uint32_t, uint32_t) {
+        inRange = inRange && jobs.getCurrentThreadIndex() < jobs.getThreadCount();
+    });
+    CHECK(inRange.load());
+
+    // 别的JobSystem的工作线程在这里算外部线程
+    JobSystem other(1);
+    JobCounter counter;
+    uint32_t indexSeenByOther = 99;
+    other.runBackground([&]() { indexSeenByOther = jobs.getCurrentThreadIndex(); }, &counter);
+    other.wait(counter);
+    CHECK_EQ(indexSeenByOther, 0u);
+}
+
+// 后台作业由空闲的工作线程执行；wait()期间主线程只跑普通作业
+void testBackgroundJobs() {
+    JobSystem jobs(1);
+    JobCounter background;
+    std::atomic<uint32_t> ranOn{UINT32_MAX};
+    jobs.runBackground([&]() { ranOn = jobs.getCurrentThreadIndex(); }, &background);
+
+    JobCounter normal;
+    std::atomic<int> normalRuns{0};
+    for (int i = 0; i < 50; ++i) jobs.run([&]() { normalRuns++; }, &normal);
+    jobs.wait(normal);
+    jobs.wait(background);
+
+    CHECK_EQ(normalRuns.load(), 50);
+    CHECK(ranOn.load() != 0u);
+    CHECK(ranOn.load() < jobs.getThreadCount());
+}
+
+} // namespace
+
+int main() {
+    testParallelForCoverage();
+    testNestedParallelFor();
+    testCountersAndDependencies();
+    testThreadIndices();
+    testBackgroundJobs();
+    return test::finish("test_job_system");
+}
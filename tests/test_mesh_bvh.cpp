@@ -0,0 +1,233 @@
+#include "TestCommon.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/MeshBVH.h"
+#include <cmath>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// MeshBVH：最近命中和逐个三角形暴力求交一致（随机三角形汤、规则网格、轴对齐射线），
+// maxDistance裁剪正确，空网格不命中；Mesh缓存的BVH跟着移动走
+
+namespace {
+
+struct Geometry {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    void addVertex(const glm::vec3& position) {
+        Vertex vertex{};
+        vertex.position = position;
+        vertices.push_back(vertex);
+    }
+};
+
+// 和MeshBVH::intersect相同的Möller–Trumbore，逐个三角形算，返回最近的距离（没有命中返回负数）
+float bruteForce(const Geometry& geometry, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+    float best = -1.0f;
+    for (size_t t = 0; t + 2 < geometry.indices.size(); t += 3) {
+        const glm::vec3& a = geometry.vertices[geometry.indices[t + 0]].position;
+        glm::vec3 edge1 = geometry.vertices[geometry.indices[t + 1]].position - a;
+        glm::vec3 edge2 = geometry.vertices[geometry.indices[t + 2]].position - a;
+
+        glm::vec3 p = glm::cross(direction, edge2);
+        float determinant = glm::dot(edge1, p);
+        if (std::abs(determinant) < 1e-12f) continue;
+        float inverseDeterminant = 1.0f / determinant;
+
+        glm::vec3 toOrigin = origin - a;
+        float u = glm::dot(toOrigin, p) * inverseDeterminant;
+        if (u < 0.0f || u > 1.0f) continue;
+
+        glm::vec3 q = glm::cross(toOrigin, edge1);
+        float v = glm::dot(direction, q) * inverseDeterminant;
+        if (v < 0.0f || u + v > 1.0f) continue;
+
+        float distance = glm::dot(edge2, q) * inverseDeterminant;
+        if (distance < 0.0f || distance > maxDistance) continue;
+        if (best < 0.0f || distance < best) best = distance;
+    }
+    return best;
+}
+
+// 命中点确实落在报告的三角形上，重心坐标对得上（掠射时距离的误差会放大，容差随射线长度放大）
+bool hitIsConsistent(const Geometry& geometry, const glm::vec3& origin, const glm::vec3& direction,
+                     const MeshBVH::Hit& hit) {
+    if (hit.triangle * 3 + 2 >= geometry.indices.size()) return false;
+    const glm::vec3& a = geometry.vertices[geometry.indices[hit.triangle * 3 + 0]].position;
+    const glm::vec3& b = geometry.vertices[geometry.indices[hit.triangle * 3 + 1]].position;
+    const glm::vec3& c = geometry.vertices[geometry.indices[hit.triangle * 3 + 2]].position;
+    glm::vec3 onTriangle = a * (1.0f - hit.u - hit.v) + b * hit.u + c * hit.v;
+    glm::vec3 onRay = origin + direction * hit.distance;
+    glm::vec3 difference = onTriangle - onRay;
+    float tolerance = 1e-3f * (1.0f + glm::length(direction) * hit.distance);
+    return glm::dot(difference, difference) < tolerance * tolerance;
+}
+
+// BVH和暴力结果是否一致；两者都按同样的浮点公式算，距离应该完全相同
+bool matchesBruteForce(const Geometry& geometry, const MeshBVH& bvh, const glm::vec3& origin,
+                       const glm::vec3& direction, float maxDistance) {
+    float expected = bruteForce(geometry, origin, direction, maxDistance);
+    MeshBVH::Hit hit;
+    bool found = bvh.intersect(origin, direction, maxDistance, hit);
+    if (expected < 0.0f) return !found;
+    return found && hit.distance == expected && hitIsConsistent(geometry, origin, direction, hit);
+}
+
+Geometry randomSoup(uint32_t triangleCount, std::mt19937& rng) {
+    std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> offset(-1.5f, 1.5f);
+    Geometry geometry;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        glm::vec3 center(position(rng), position(rng), position(rng));
+        for (int k = 0; k < 3; ++k) {
+            geometry.addVertex(center + glm::vec3(offset(rng), offset(rng), offset(rng)));
+            geometry.indices.push_back(t * 3 + k);
+        }
+    }
+    return geometry;
+}
+
+// y = 0平面上的n x n网格，共享顶点；所有三角形都在包围盒的一个面上（包围盒厚度为0）
+Geometry flatGrid(uint32_t n) {
+    Geometry geometry;
+    for (uint32_t z = 0; z <= n; ++z) {
+        for (uint32_t x = 0; x <= n; ++x) {
+            geometry.addVertex(glm::vec3(float(x), 0.0f, float(z)));
+        }
+    }
+    for (uint32_t z = 0; z < n; ++z) {
+        for (uint32_t x = 0; x < n; ++x) {
+            uint32_t corner = z * (n + 1) + x;
+            geometry.indices.insert(geometry.indices.end(),
+                { corner, corner + n + 1, corner + 1, corner + 1, corner + n + 1, corner + n + 2 });
+        }
+    }
+    return geometry;
+}
+
+void testRandomSoupAgainstBruteForce() {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+
+    // 三角形数从0到叶子大小附近再到几千，覆盖只有一个叶子的树
+    const uint32_t counts[] = { 0, 1, 3, 4, 5, 17, 200, 3000 };
+    bool match = true;
+    size_t hits = 0;
+    for (uint32_t count : counts) {
+        Geometry geometry = randomSoup(count, rng);
+        MeshBVH bvh(geometry.vertices, geometry.indices);
+        match &= bvh.getTriangleCount() == count;
+
+        for (int r = 0; r < 300; ++r) {
+            glm::vec3 origin(position(rng), position(rng), position(rng));
+            // 一半射线瞄准某个三角形的重心，保证有足够多的命中
+            glm::vec3 target(position(rng), position(rng), position(rng));
+            if (count > 0 && r % 2 == 0) {
+                uint32_t t = rng() % count;
+                target = (geometry.vertices[t * 3].position + geometry.vertices[t * 3 + 1].position +
+                          geometry.vertices[t * 3 + 2].position) / 3.0f;
+            }
+            glm::vec3 direction = target - origin;
+            if (glm::dot(direction, direction) < 1e-6f) continue;
+
+            match &= matchesBruteForce(geometry, bvh, origin, direction, 1e30f);
+            hits += bruteForce(geometry, origin, direction, 1e30f) >= 0.0f;
+        }
+    }
+    CHECK(match);
+    CHECK(hits > 1000);
+}
+
+// 方向分量为0（inverseDirection是无穷大）和零厚度的包围盒
+void testAxisAlignedRays() {
+    Geometry geometry = flatGrid(64);
+    MeshBVH bvh(geometry.vertices, geometry.indices);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordinate(-4.0f, 68.0f);
+
+    bool match = true;
+    for (int r = 0; r < 2000; ++r) {
+        glm::vec3 origin(coordinate(rng), r % 2 == 0 ? 10.0f : -10.0f, coordinate(rng));
+        glm::vec3 direction(0.0f, r % 2 == 0 ? -1.0f : 1.0f, 0.0f);
+        match &= matchesBruteForce(geometry, bvh, origin, direction, 1e30f);
+
+        // 斜着打，方向只有一个分量为0
+        glm::vec3 slanted(0.0f, -1.0f, r % 3 == 0 ? 0.5f : -0.5f);
+        match &= matchesBruteForce(geometry, bvh, glm::vec3(origin.x, 10.0f, origin.z), slanted, 1e30f);
+    }
+    CHECK(match);
+
+    // 网格内部竖直向下必中，距离就是高度
+    MeshBVH::Hit hit;
+    CHECK(bvh.intersect(glm::vec3(10.3f, 7.0f, 20.6f), glm::vec3(0.0f, -1.0f, 0.0f), 1e30f, hit));
+    CHECK(std::fabs(hit.distance - 7.0f) < 1e-5f);
+    CHECK(!bvh.intersect(glm::vec3(-1.0f, 7.0f, 20.6f), glm::vec3(0.0f, -1.0f, 0.0f), 1e30f, hit));
+}
+
+void testMaxDistance() {
+    std::mt19937 rng(23);
+    Geometry geometry = randomSoup(1000, rng);
+    MeshBVH bvh(geometry.vertices, geometry.indices);
+    std::uniform_real_distribution<float> position(-15.0f, 15.0f);
+    std::uniform_real_distribution<float> limit(0.0f, 1.5f);
+
+    // 距离以direction的长度为单位：direction是origin到目标点，maxDistance = 1表示到目标点为止
+    bool match = true;
+    for (int r = 0; r < 1000; ++r) {
+        glm::vec3 origin(position(rng), position(rng), position(rng));
+        glm::vec3 target = geometry.vertices[rng() % geometry.vertices.size()].position;
+        match &= matchesBruteForce(geometry, bvh, origin, target - origin, limit(rng));
+    }
+    CHECK(match);
+
+    // 同一条射线：限制在第一个命中之前就没有命中
+    glm::vec3 origin(0.0f, 0.0f, -50.0f);
+    glm::vec3 direction(0.05f, 0.02f, 1.0f);
+    MeshBVH::Hit first;
+    if (bvh.intersect(origin, direction, 1e30f, first)) {
+        MeshBVH::Hit clipped;
+        CHECK(!bvh.intersect(origin, direction, first.distance * 0.99f, clipped));
+        CHECK(bvh.intersect(origin, direction, first.distance, clipped));
+    }
+}
+
+void testEmptyMesh() {
+    Geometry empty;
+    MeshBVH bvh(empty.vertices, empty.indices);
+    MeshBVH::Hit hit;
+    CHECK_EQ(bvh.getTriangleCount(), 0u);
+    CHECK(!bvh.intersect(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), 1e30f, hit));
+}
+
+static_assert(!std::is_copy_constructible<Mesh>::value && !std::is_copy_assignable<Mesh>::value,
+              "Mesh owns GPU buffers and must not be copied");
+static_assert(std::is_nothrow_move_constructible<Mesh>::value && std::is_nothrow_move_assignable<Mesh>::value,
+              "Mesh must be movable (createCube etc. return by value)");
+
+// 没有create()过的网格也能构建（空的）BVH，不需要设备
+void testMeshMoveKeepsBVH() {
+    Mesh original;
+    const MeshBVH* bvh = &original.getBVH();
+
+    Mesh moved(std::move(original));
+    CHECK(&moved.getBVH() == bvh);
+
+    Mesh assigned;
+    assigned.getBVH();
+    assigned = std::move(moved);
+    CHECK(&assigned.getBVH() == bvh);
+    CHECK_EQ(assigned.getBVH().getTriangleCount(), 0u);
+}
+
+} // namespace
+
+int main() {
+    testRandomSoupAgainstBruteForce();
+    testAxisAlignedRays();
+    testMaxDistance();
+    testEmptyMesh();
+    testMeshMoveKeepsBVH();
+    return test::finish("test_mesh_bvh");
+}
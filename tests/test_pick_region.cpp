@@ -0,0 +1,151 @@
+#include "TestCommon.h"
+#include "Rendering/PickRegion.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// PickRegion：光标周围的矩形和逐个像素判断的结果一致（边角、超出附件、半径很大），
+// 解码出离光标最近的非0 ID，距离相同时取先出现的
+
+namespace {
+
+// 像素(px, py)是否应该被复制：在附件内，且和夹到附件内的光标在每个方向上相差不超过radius
+bool inRegion(uint32_t px, uint32_t py, uint32_t x, uint32_t y, uint32_t radius, VkExtent2D attachment) {
+    uint64_t cx = std::min(x, attachment.width - 1);
+    uint64_t cy = std::min(y, attachment.height - 1);
+    uint64_t dx = px > cx ? px - cx : cx - px;
+    uint64_t dy = py > cy ? py - cy : cy - py;
+    return dx <= radius && dy <= radius;
+}
+
+bool regionMatchesBruteForce(uint32_t x, uint32_t y, uint32_t radius, VkExtent2D attachment) {
+    PickRegion region = PickRegion::around(x, y, radius, attachment);
+    if (region.x != std::min(x, attachment.width - 1) || region.y != std::min(y, attachment.height - 1)) {
+        return false;
+    }
+    if (region.offset.x < 0 || region.offset.y < 0) return false;
+
+    for (uint32_t py = 0; py < attachment.height; ++py) {
+        for (uint32_t px = 0; px < attachment.width; ++px) {
+            bool copied = px >= uint32_t(region.offset.x) && px < region.offset.x + region.extent.width &&
+                          py >= uint32_t(region.offset.y) && py < region.offset.y + region.extent.height;
+            if (copied != inRegion(px, py, x, y, radius, attachment)) return false;
+        }
+    }
+    return true;
+}
+
+void testRegionAgainstBruteForce() {
+    std::mt19937 rng(12);
+    bool match = true;
+    for (int round = 0; round < 2000; ++round) {
+        VkExtent2D attachment = { uint32_t(1 + rng() % 24), uint32_t(1 + rng() % 24) };
+        // 光标偶尔在附件外（窗口缩小后还没有resize）
+        uint32_t x = rng() % (attachment.width + 4);
+        uint32_t y = rng() % (attachment.height + 4);
+        uint32_t radius = rng() % 10;
+        match &= regionMatchesBruteForce(x, y, radius, attachment);
+    }
+    CHECK(match);
+}
+
+void testRegionEdges() {
+    VkExtent2D attachment = { 1280, 720 };
+
+    PickRegion center = PickRegion::around(640, 360, 2, attachment);
+    CHECK_EQ(center.offset.x, 638);
+    CHECK_EQ(center.offset.y, 358);
+    CHECK_EQ(center.extent.width, 5u);
+    CHECK_EQ(center.extent.height, 5u);
+
+    PickRegion corner = PickRegion::around(0, 0, 3, attachment);
+    CHECK_EQ(corner.offset.x, 0);
+    CHECK_EQ(corner.extent.width, 4u);
+    CHECK_EQ(corner.extent.height, 4u);
+
+    PickRegion outside = PickRegion::around(5000, 5000, 1, attachment);
+    CHECK_EQ(outside.x, 1279u);
+    CHECK_EQ(outside.y, 719u);
+    CHECK_EQ(outside.offset.x, 1278);
+    CHECK_EQ(outside.extent.width, 2u);
+
+    // 半径大到x + radius会回绕：整个附件
+    PickRegion huge = PickRegion::around(10, 10, UINT32_MAX, attachment);
+    CHECK_EQ(huge.offset.x, 0);
+    CHECK_EQ(huge.offset.y, 0);
+    CHECK_EQ(huge.extent.width, 1280u);
+    CHECK_EQ(huge.extent.height, 720u);
+
+    PickRegion empty = PickRegion::around(3, 3, 2, VkExtent2D{ 0, 0 });
+    CHECK_EQ(empty.extent.width, 0u);
+    CHECK_EQ(empty.extent.height, 0u);
+}
+
+// 暴力：逐个像素算到光标的距离，严格更近才替换
+uint32_t bruteForceNearest(const PickRegion& region, const std::vector<uint32_t>& pixels) {
+    uint32_t nearest = 0;
+    int64_t bestDistance = INT64_MAX;
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        if (pixels[i] == 0) continue;
+        int64_t px = region.offset.x + static_cast<int64_t>(i % region.extent.width);
+        int64_t py = region.offset.y + static_cast<int64_t>(i / region.extent.width);
+        int64_t distance = (px - region.x) * (px - region.x) + (py - region.y) * (py - region.y);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            nearest = pixels[i];
+        }
+    }
+    return nearest;
+}
+
+void testFindNearestAgainstBruteForce() {
+    std::mt19937 rng(34);
+    bool match = true;
+    for (int round = 0; round < 2000; ++round) {
+        VkExtent2D attachment = { uint32_t(1 + rng() % 40), uint32_t(1 + rng() % 40) };
+        PickRegion region = PickRegion::around(rng() % attachment.width, rng() % attachment.height, rng() % 9, attachment);
+
+        // 大部分像素是背景（0），ID很少，方便出现距离相同的情况
+        std::vector<uint32_t> pixels(region.extent.width * region.extent.height);
+        for (uint32_t& pixel : pixels) pixel = rng() % 4 == 0 ? 1 + rng() % 3 : 0;
+
+        match &= region.findNearest(pixels.data()) == bruteForceNearest(region, pixels);
+    }
+    CHECK(match);
+}
+
+void testFindNearestKnown() {
+    PickRegion region = PickRegion::around(5, 5, 1, VkExtent2D{ 10, 10 });
+
+    // 光标下有物体：就是它
+    std::vector<uint32_t> pixels = { 7, 7, 7,
+                                     7, 9, 7,
+                                     7, 7, 7 };
+    CHECK_EQ(region.findNearest(pixels.data()), 9u);
+
+    // 光标下是背景：上下左右比对角更近
+    pixels = { 3, 0, 0,
+               0, 0, 0,
+               0, 4, 0 };
+    CHECK_EQ(region.findNearest(pixels.data()), 4u);
+
+    // 距离相同：按行优先先出现的
+    pixels = { 0, 0, 0,
+               6, 0, 8,
+               0, 0, 0 };
+    CHECK_EQ(region.findNearest(pixels.data()), 6u);
+
+    pixels.assign(9, 0);
+    CHECK_EQ(region.findNearest(pixels.data()), 0u);
+}
+
+} // namespace
+
+int main() {
+    testRegionAgainstBruteForce();
+    testRegionEdges();
+    testFindNearestAgainstBruteForce();
+    testFindNearestKnown();
+    return test::finish("test_pick_region");
+}
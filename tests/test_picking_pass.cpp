@@ -0,0 +1,269 @@
+#include "TestCommon.h"
+#include "ECS/ECS.h"
+#include "ECS/Components.h"
+#include "Framework/Camera.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/PickingPass.h"
+#include "Rendering/RenderGraph.h"
+#include <vulkan/vulkan.h>
+#include <vma/vk_mem_alloc.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// PickingPass在无窗口的设备上（比如lavapipe）：ID缓冲渲染出来的物体和它们在屏幕上的位置一致，
+// 结果在栅栏signal之后才出来，按请求顺序，不需要等队列空闲。
+// 没有Vulkan设备，或者用到的学习任务（VulkanBuffer、VulkanPipelineBuilder……）还没实现时跳过。
+// 从仓库根目录运行（着色器在shaders/compiled）。
+
+namespace {
+
+constexpr VkExtent2D EXTENT = { 64, 64 };
+constexpr uint32_t LEFT_ID = 11;
+constexpr uint32_t RIGHT_ID = 22;
+
+// 学习任务还没实现时抛出的异常
+bool isLearnerTodo(const std::exception& e) {
+    return std::strstr(e.what(), "TODO NOT IMPLEMENTED") != nullptr;
+}
+
+void check(VkResult result, const char* what) {
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error(std::string("test_picking_pass: ") + what + " failed");
+    }
+}
+
+// 测试需要的最少Vulkan对象，不经过VulkanContext（它要窗口和交换链）
+struct Device {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    uint32_t queueFamily = 0;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VmaAllocator allocator = VK_NULL_HANDLE;
+
+    // 没有可用的设备返回false
+    bool create();
+    void destroy();
+};
+
+bool Device::create() {
+    VkApplicationInfo appInfo{};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "test_picking_pass";
+    appInfo.apiVersion = VK_API_VERSION_1_2;
+
+    VkInstanceCreateInfo instanceInfo{};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+    instanceInfo.pApplicationInfo = &appInfo;
+    if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS) {
+        instance = VK_NULL_HANDLE;
+        return false;
+    }
+
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
+    std::vector<VkPhysicalDevice> devices(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+
+    for (VkPhysicalDevice candidate : devices) {
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(candidate, &familyCount, families.data());
+        for (uint32_t i = 0; i < familyCount; ++i) {
+            if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+                physicalDevice = candidate;
+                queueFamily = i;
+                break;
+            }
+        }
+        if (physicalDevice != VK_NULL_HANDLE) break;
+    }
+    if (physicalDevice == VK_NULL_HANDLE) return false;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    std::printf("test_picking_pass: %s\n", properties.deviceName);
+
+    float priority = 1.0f;
+    VkDeviceQueueCreateInfo queueInfo{};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = queueFamily;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo deviceInfo{};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+    check(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device), "vkCreateDevice");
+    vkGetDeviceQueue(device, queueFamily, 0, &queue);
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+    check(vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool), "vkCreateCommandPool");
+
+    VmaAllocatorCreateInfo allocatorInfo{};
+    allocatorInfo.physicalDevice = physicalDevice;
+    allocatorInfo.device = device;
+    allocatorInfo.instance = instance;
+    allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_2;
+    check(vmaCreateAllocator(&allocatorInfo, &allocator), "vmaCreateAllocator");
+    return true;
+}
+
+void Device::destroy() {
+    if (device != VK_NULL_HANDLE) {
+        vkDeviceWaitIdle(device);
+        if (allocator != VK_NULL_HANDLE) vmaDestroyAllocator(allocator);
+        if (commandPool != VK_NULL_HANDLE) vkDestroyCommandPool(device, commandPool, nullptr);
+        vkDestroyDevice(device, nullptr);
+    }
+    if (instance != VK_NULL_HANDLE) vkDestroyInstance(instance, nullptr);
+}
+
+// 和Renderer::render()相同的顺序，只有一帧在飞：等栅栏、交给拾取Pass、声明、编译、录制、提交
+struct Frame {
+    Device& device;
+    RenderGraph& graph;
+    PickingPass& pass;
+    ECS& ecs;
+    VkFence fence = VK_NULL_HANDLE;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+
+    void render() {
+        vkWaitForFences(device.device, 1, &fence, VK_TRUE, UINT64_MAX);
+        pass.setFrameFence(fence);
+        pass.beginFrame(0);
+
+        graph.reset();
+        pass.setupGraph(graph, ecs);
+        graph.compile();
+
+        vkResetFences(device.device, 1, &fence);
+        vkResetCommandBuffer(cmd, 0);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        check(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer");
+        graph.execute(cmd);
+        check(vkEndCommandBuffer(cmd), "vkEndCommandBuffer");
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+        check(vkQueueSubmit(device.queue, 1, &submitInfo, fence), "vkQueueSubmit");
+    }
+};
+
+Entity spawnCube(ECS& ecs, Mesh& cube, glm::vec3 position, uint32_t pickID) {
+    TransformComponent transform;
+    transform.position = position;
+    transform.scale = glm::vec3(0.5f);
+    transform.transform = transform.getLocalMatrix();
+
+    Entity entity = ecs.createEntity();
+    ecs.addComponent(entity, transform);
+    ecs.addComponent(entity, MeshComponent{ &cube });
+    ecs.addComponent(entity, PickableComponent{ pickID, false });
+    return entity;
+}
+
+void testPicking(Device& device) {
+    RenderGraph graph;
+    graph.initialize(device.allocator, device.device);
+
+    PickingPass pass;
+    pass.initialize(device.allocator, device.device, EXTENT);
+
+    // 相机在(0, 0, 3)看向-Z：左边的立方体在屏幕左半边，右边的在右半边，中间是背景
+    Camera camera;
+    camera.setPerspective(45.0f, 1.0f, 0.1f, 100.0f);
+    pass.setCamera(&camera);
+
+    Mesh cube = Mesh::createCube(device.allocator, device.device, device.queue, device.commandPool);
+    ECS ecs;
+    spawnCube(ecs, cube, glm::vec3(-0.6f, 0.0f, 0.0f), LEFT_ID);
+    spawnCube(ecs, cube, glm::vec3(0.6f, 0.0f, 0.0f), RIGHT_ID);
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = device.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+
+    Frame frame{ device, graph, pass, ecs };
+    check(vkCreateFence(device.device, &fenceInfo, nullptr, &frame.fence), "vkCreateFence");
+    check(vkAllocateCommandBuffers(device.device, &allocInfo, &frame.cmd), "vkAllocateCommandBuffers");
+
+    // 没有请求的帧什么都不声明
+    frame.render();
+    CHECK_EQ(graph.getStats().passes, 0u);
+
+    // 请求的帧：ID和回读两个Pass；结果要等栅栏
+    pass.requestPick(48, 32);
+    frame.render();
+    CHECK_EQ(graph.getStats().passes, 2u);
+
+    // 栅栏signal之后pollResult()自己查询到（不经过setFrameFence）
+    vkWaitForFences(device.device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+    PickingPass::Result result;
+    CHECK(pass.pollResult(result));
+    CHECK_EQ(result.pickID, RIGHT_ID);
+    CHECK_EQ(result.x, 48u);
+    CHECK(!pass.pollResult(result));
+
+    // 连续几帧的请求：下一帧开头setFrameFence()收回上一帧的结果，按请求顺序出来
+    const uint32_t xs[] = { 16, 32, 38 };
+    const uint32_t radii[] = { 0, 0, 8 };
+    const uint32_t expected[] = { LEFT_ID, PickingPass::NO_PICK_ID, RIGHT_ID };   // 38附近8像素内有右边的立方体
+    for (int i = 0; i < 3; ++i) {
+        pass.requestPick(xs[i], 32, radii[i]);
+        frame.render();
+    }
+    frame.render();
+    vkWaitForFences(device.device, 1, &frame.fence, VK_TRUE, UINT64_MAX);
+
+    bool inOrder = true;
+    for (int i = 0; i < 3; ++i) {
+        inOrder &= pass.pollResult(result) && result.x == xs[i] && result.pickID == expected[i];
+    }
+    CHECK(inOrder);
+
+    vkDeviceWaitIdle(device.device);
+    vkDestroyFence(device.device, frame.fence, nullptr);
+    cube.cleanup();
+    pass.cleanup();
+    graph.cleanup();
+}
+
+} // namespace
+
+int main() {
+    Device device;
+    try {
+        if (!device.create()) {
+            device.destroy();
+            return test::skip("test_picking_pass", "no Vulkan device with a graphics queue");
+        }
+        testPicking(device);
+    } catch (const std::exception& e) {
+        device.destroy();
+        if (isLearnerTodo(e)) {
+            return test::skip("test_picking_pass", "needs the VulkanBuffer and VulkanPipelineBuilder learner tasks");
+        }
+        std::printf("  FAILED: %s\n", e.what());
+        return 1;
+    }
+    device.destroy();
+    return test::finish("test_picking_pass");
+}
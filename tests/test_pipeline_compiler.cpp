@@ -0,0 +1,174 @@
+#include "TestCommon.h"
+#include "Core/ShaderLibrary.h"
+#include "Core/VulkanPipeline.h"
+#include "Framework/JobSystem.h"
+#include "Rendering/PipelineCompiler.h"
+#include "Rendering/PipelineRegistry.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// PipelineCompiler的调度：同步和后台编译的每个请求都恰好完成一次、状态和统计一致，
+// 在工作线程上提交也不会丢请求，编译中途释放结果、释放共用layout都没有问题。
+// builder的键：着色器读不了（或没有着色器库）时按路径比较，哈希和比较一致。
+// 按内容合并需要着色器库创建module（要设备），这里不测。
+// 没有设备：builder不设置render pass，build()在碰Vulkan之前就抛异常，编译结果都是Failed
+// （每个失败会在std::cerr上报告一次）。真正创建管线需要设备，Application还不创建Renderer
+// （VulkanContext、Renderer的学习任务），这里不测
+
+namespace {
+
+constexpr uint32_t WORKER_COUNT = 3;
+
+// 假的设备句柄：只有编译成功的管线才会用它销毁，这里不会。
+// 不能是VK_NULL_HANDLE，否则cleanup()当作没有初始化，不等待编译作业
+VkDevice fakeDevice() {
+    return reinterpret_cast<VkDevice>(uintptr_t(1));
+}
+
+std::unique_ptr<VulkanPipelineBuilder> makeBuilder(uint32_t index) {
+    auto builder = std::make_unique<VulkanPipelineBuilder>(fakeDevice());
+    builder->setShaders("test_" + std::to_string(index) + ".vert.spv", "test.frag.spv");
+    return builder;
+}
+
+bool failedWithoutRenderPass(const AsyncPipeline& pipeline) {
+    return pipeline.getState() == AsyncPipeline::State::Failed && pipeline.get() == VK_NULL_HANDLE &&
+           pipeline.getError().find("render pass") != std::string::npos;
+}
+
+// 没有JobSystem：compile()返回时已经编译完
+void testSynchronous() {
+    PipelineCompiler compiler;
+    compiler.initialize(fakeDevice(), nullptr);
+    CHECK(!compiler.isAsync());
+
+    std::shared_ptr<AsyncPipeline> pipeline = compiler.compile(makeBuilder(0));
+    CHECK(failedWithoutRenderPass(*pipeline));
+    CHECK(pipeline->getBuilder().hasSameState(*makeBuilder(0)));
+
+    PipelineCompiler::Stats stats = compiler.getStats();
+    CHECK_EQ(stats.submitted, 1u);
+    CHECK_EQ(stats.completed, 1u);
+    CHECK_EQ(stats.failed, 1u);
+    CHECK_EQ(stats.pending, 0u);
+    compiler.cleanup();
+}
+
+void testBackground() {
+    JobSystem jobs(WORKER_COUNT);
+    PipelineCompiler compiler;
+    compiler.initialize(fakeDevice(), &jobs);
+    CHECK(compiler.isAsync());
+
+    const uint32_t count = 24;
+    std::vector<std::shared_ptr<AsyncPipeline>> pipelines;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::shared_ptr<AsyncPipeline> pipeline = compiler.compile(makeBuilder(i));
+        // 一半的结果马上释放：编译作业自己持有引用
+        if (i % 2 == 0) pipelines.push_back(std::move(pipeline));
+    }
+    compiler.waitIdle();
+
+    bool allFailed = true;
+    for (const std::shared_ptr<AsyncPipeline>& pipeline : pipelines) {
+        allFailed &= failedWithoutRenderPass(*pipeline);
+    }
+    CHECK(allFailed);
+
+    PipelineCompiler::Stats stats = compiler.getStats();
+    CHECK_EQ(stats.submitted, count);
+    CHECK_EQ(stats.completed, count);
+    CHECK_EQ(stats.failed, count);
+    CHECK_EQ(stats.pending, 0u);
+    compiler.cleanup();
+}
+
+// 工作线程上同时提交（材质在作业里创建）：队列和正在运行的作业数不会丢请求
+void testConcurrentSubmit() {
+    JobSystem jobs(WORKER_COUNT);
+    PipelineCompiler compiler;
+    compiler.initialize(fakeDevice(), &jobs);
+
+    const uint32_t count = 32;
+    std::vector<std::shared_ptr<AsyncPipeline>> pipelines(count);
+    jobs.parallelFor(0, count, 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) pipelines[i] = compiler.compile(makeBuilder(i));
+    });
+    compiler.waitIdle();
+
+    bool allFailed = true;
+    for (const std::shared_ptr<AsyncPipeline>& pipeline : pipelines) {
+        allFailed &= pipeline && failedWithoutRenderPass(*pipeline);
+    }
+    CHECK(allFailed);
+
+    PipelineCompiler::Stats stats = compiler.getStats();
+    CHECK_EQ(stats.submitted, count);
+    CHECK_EQ(stats.completed, count);
+    CHECK_EQ(stats.pending, 0u);
+
+    // waitIdle()之后还能继续提交（作业数归零后重新启动），cleanup()等它完成
+    std::shared_ptr<AsyncPipeline> late = compiler.compile(makeBuilder(count));
+    compiler.cleanup();
+    CHECK(failedWithoutRenderPass(*late));
+}
+
+// 材质在编译中途cleanup()：共用layout由管线持有，活到管线释放
+void testPipelineKeepsLayout() {
+    JobSystem jobs(WORKER_COUNT);
+    PipelineCompiler compiler;
+    compiler.initialize(fakeDevice(), &jobs);
+
+    // 释放时不调用析构函数：SharedPipelineLayout的析构会在假设备上调用vkDestroyPipelineLayout
+    bool released = false;
+    std::shared_ptr<SharedPipelineLayout> layout(new SharedPipelineLayout(fakeDevice(), VK_NULL_HANDLE),
+                                                 [&](SharedPipelineLayout* object) {
+                                                     released = true;
+                                                     ::operator delete(object);
+                                                 });
+
+    std::shared_ptr<AsyncPipeline> pipeline = compiler.compile(makeBuilder(0), layout);
+    layout.reset();
+    compiler.waitIdle();
+    CHECK(!released);
+
+    pipeline.reset();
+    CHECK(released);
+    compiler.cleanup();
+}
+
+// 着色器库里找不到文件：键退回到路径，其他配置不同的不合并
+void testBuilderKeyFallsBackToPath() {
+    ShaderLibrary library;
+    library.initialize(fakeDevice());
+
+    auto a = makeBuilder(1);
+    auto samePath = makeBuilder(1);
+    auto otherPath = makeBuilder(2);
+    auto otherState = makeBuilder(1);
+    otherState->setDepthStencil(VK_TRUE, VK_FALSE);
+    auto withLibrary = makeBuilder(1);
+    withLibrary->setShaderLibrary(&library);
+
+    CHECK_EQ(library.getContentHash("test_1.vert.spv"), 0u);
+    CHECK(a->hasSameState(*samePath));
+    CHECK_EQ(a->hashState(), samePath->hashState());
+    CHECK(!a->hasSameState(*otherPath));
+    CHECK(!a->hasSameState(*otherState));
+    CHECK(a->hasSameState(*withLibrary));
+    CHECK_EQ(a->hashState(), withLibrary->hashState());
+    library.cleanup();
+}
+
+} // namespace
+
+int main() {
+    testSynchronous();
+    testBackground();
+    testConcurrentSubmit();
+    testPipelineKeepsLayout();
+    testBuilderKeyFallsBackToPath();
+    return test::finish("test_pipeline_compiler");
+}
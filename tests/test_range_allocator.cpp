@@ -0,0 +1,177 @@
+#include "TestCommon.h"
+#include "Rendering/MeshArena.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// RangeAllocator：best-fit、相邻空闲区间合并、grow()，以及和位图模型的随机对比
+
+namespace {
+
+void testAllocateUntilFull() {
+    RangeAllocator allocator;
+    allocator.reset(100);
+    CHECK_EQ(allocator.getCapacity(), 100u);
+    CHECK_EQ(allocator.getLargestFreeRange(), 100u);
+
+    CHECK_EQ(allocator.allocate(30), 0u);
+    CHECK_EQ(allocator.allocate(30), 30u);
+    CHECK_EQ(allocator.allocate(40), 60u);
+    CHECK_EQ(allocator.getUsed(), 100u);
+    CHECK_EQ(allocator.getFreeRangeCount(), 0u);
+    CHECK_EQ(allocator.allocate(1), RangeAllocator::INVALID_OFFSET);
+
+    // 大小为0的分配/释放什么都不做
+    CHECK_EQ(allocator.allocate(0), 0u);
+    allocator.free(0, 0);
+    CHECK_EQ(allocator.getUsed(), 100u);
+
+    allocator.reset(0);
+    CHECK_EQ(allocator.allocate(1), RangeAllocator::INVALID_OFFSET);
+    CHECK_EQ(allocator.getLargestFreeRange(), 0u);
+}
+
+void testBestFit() {
+    RangeAllocator allocator;
+    allocator.reset(100);
+
+    // 留下大小为8、3、5的空洞，中间隔着已分配的区间
+    uint32_t a = allocator.allocate(8);
+    allocator.allocate(1);
+    uint32_t b = allocator.allocate(3);
+    allocator.allocate(1);
+    uint32_t c = allocator.allocate(5);
+    allocator.allocate(1);
+    allocator.allocate(81);
+    allocator.free(a, 8);
+    allocator.free(b, 3);
+    allocator.free(c, 5);
+    CHECK_EQ(allocator.getFreeRangeCount(), 3u);
+
+    // 每次取最小的够用的空洞
+    CHECK_EQ(allocator.allocate(3), b);
+    CHECK_EQ(allocator.allocate(4), c);
+    CHECK_EQ(allocator.allocate(6), a);
+    // c剩下1个，a剩下2个
+    CHECK_EQ(allocator.allocate(2), a + 6);
+    CHECK_EQ(allocator.allocate(1), c + 4);
+    CHECK_EQ(allocator.allocate(1), RangeAllocator::INVALID_OFFSET);
+}
+
+void testCoalesce() {
+    RangeAllocator allocator;
+    allocator.reset(40);
+    uint32_t offsets[4];
+    for (uint32_t& offset : offsets) offset = allocator.allocate(10);
+
+    // 先释放不相邻的两个，再释放中间的：前后都合并
+    allocator.free(offsets[0], 10);
+    allocator.free(offsets[2], 10);
+    CHECK_EQ(allocator.getFreeRangeCount(), 2u);
+    allocator.free(offsets[1], 10);
+    CHECK_EQ(allocator.getFreeRangeCount(), 1u);
+    CHECK_EQ(allocator.getLargestFreeRange(), 30u);
+
+    allocator.free(offsets[3], 10);
+    CHECK_EQ(allocator.getFreeRangeCount(), 1u);
+    CHECK_EQ(allocator.getLargestFreeRange(), 40u);
+    CHECK_EQ(allocator.getUsed(), 0u);
+    CHECK_EQ(allocator.allocate(40), 0u);
+}
+
+void testGrow() {
+    RangeAllocator allocator;
+    allocator.reset(10);
+    allocator.allocate(6);
+
+    // 新空间和末尾的空闲区间合并
+    allocator.grow(20);
+    CHECK_EQ(allocator.getCapacity(), 20u);
+    CHECK_EQ(allocator.getFreeRangeCount(), 1u);
+    CHECK_EQ(allocator.getLargestFreeRange(), 14u);
+    CHECK_EQ(allocator.allocate(14), 6u);
+
+    // 已经满了：新空间单独成一个区间
+    allocator.grow(25);
+    CHECK_EQ(allocator.getFreeRangeCount(), 1u);
+    CHECK_EQ(allocator.allocate(5), 20u);
+
+    // 不会缩小
+    allocator.grow(5);
+    CHECK_EQ(allocator.getCapacity(), 25u);
+    CHECK_EQ(allocator.getUsed(), 25u);
+}
+
+// 随机分配/释放，每一步都和逐格记录占用的位图对比
+void testRandomAgainstBitmap() {
+    const uint32_t capacity = 4096;
+    RangeAllocator allocator;
+    allocator.reset(capacity);
+
+    struct Allocation { uint32_t offset, size; };
+    std::vector<Allocation> live;
+    std::vector<bool> used(capacity, false);
+
+    std::mt19937 rng(1);
+    bool noOverlap = true, statsMatch = true, failuresJustified = true;
+
+    for (int step = 0; step < 20000; ++step) {
+        bool doAllocate = live.empty() || rng() % 100 < 55;
+        if (doAllocate) {
+            uint32_t size = 1 + rng() % 64;
+            uint32_t offset = allocator.allocate(size);
+            if (offset == RangeAllocator::INVALID_OFFSET) {
+                failuresJustified &= allocator.getLargestFreeRange() < size;
+                continue;
+            }
+            for (uint32_t i = offset; i < offset + size; ++i) {
+                noOverlap &= i < capacity && !used[i];
+                if (i < capacity) used[i] = true;
+            }
+            live.push_back({ offset, size });
+        } else {
+            size_t index = rng() % live.size();
+            Allocation allocation = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            allocator.free(allocation.offset, allocation.size);
+            for (uint32_t i = allocation.offset; i < allocation.offset + allocation.size; ++i) used[i] = false;
+        }
+
+        // 位图里的最大空闲段 = 合并后的空闲区间
+        uint32_t usedCount = 0, freeRuns = 0, largestRun = 0, run = 0;
+        for (uint32_t i = 0; i < capacity; ++i) {
+            if (used[i]) {
+                usedCount++;
+                run = 0;
+            } else {
+                if (run == 0) freeRuns++;
+                largestRun = std::max(largestRun, ++run);
+            }
+        }
+        statsMatch &= allocator.getUsed() == usedCount &&
+                      allocator.getFreeRangeCount() == freeRuns &&
+                      allocator.getLargestFreeRange() == largestRun;
+        if (!statsMatch) break;
+    }
+
+    CHECK(noOverlap);
+    CHECK(statsMatch);
+    CHECK(failuresJustified);
+
+    for (const Allocation& allocation : live) allocator.free(allocation.offset, allocation.size);
+    CHECK_EQ(allocator.getUsed(), 0u);
+    CHECK_EQ(allocator.getFreeRangeCount(), 1u);
+    CHECK_EQ(allocator.getLargestFreeRange(), capacity);
+}
+
+} // namespace
+
+int main() {
+    testAllocateUntilFull();
+    testBestFit();
+    testCoalesce();
+    testGrow();
+    testRandomAgainstBitmap();
+    return test::finish("test_range_allocator");
+}
@@ -0,0 +1,85 @@
+#include "TestCommon.h"
+#include "Rendering/ForwardPass.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+// ForwardPass多线程录制的分块（getChunkCount/getChunkRange）：各块按顺序首尾相接、
+// 覆盖所有绘制、大小最多差1；每块至少MIN_DRAWS_PER_CHUNK个（绘制够的话），
+// 最多每线程CHUNKS_PER_THREAD块，而且在这两个限制下块数最多
+// 录制本身需要设备和学习任务（Renderer、VulkanBuffer），这里不测
+
+namespace {
+
+bool chunksValid(size_t drawCount, uint32_t threadCount) {
+    const uint32_t chunkCount = ForwardPass::getChunkCount(drawCount, threadCount);
+    const size_t maxChunks = size_t(threadCount) * ForwardPass::CHUNKS_PER_THREAD;
+
+    if (drawCount == 0) return chunkCount == 0;
+    if (chunkCount == 0 || chunkCount > maxChunks) return false;
+    // 块数最多：再多一块就会有块小于MIN_DRAWS_PER_CHUNK
+    if (chunkCount < maxChunks && size_t(chunkCount + 1) * ForwardPass::MIN_DRAWS_PER_CHUNK <= drawCount) return false;
+
+    size_t expectedBegin = 0;
+    size_t smallest = SIZE_MAX;
+    size_t largest = 0;
+    for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+        size_t begin = 0;
+        size_t end = 0;
+        ForwardPass::getChunkRange(drawCount, chunkCount, chunk, begin, end);
+        if (begin != expectedBegin || end <= begin) return false;
+        expectedBegin = end;
+        smallest = std::min(smallest, end - begin);
+        largest = std::max(largest, end - begin);
+    }
+    if (expectedBegin != drawCount || largest - smallest > 1) return false;
+
+    // 绘制不到一块的量时就是一块；够的话每块都不小于MIN_DRAWS_PER_CHUNK
+    if (drawCount < ForwardPass::MIN_DRAWS_PER_CHUNK) return chunkCount == 1;
+    return smallest >= ForwardPass::MIN_DRAWS_PER_CHUNK;
+}
+
+void testKnownCounts() {
+    CHECK_EQ(ForwardPass::getChunkCount(0, 8), 0u);
+    CHECK_EQ(ForwardPass::getChunkCount(1, 8), 1u);
+    CHECK_EQ(ForwardPass::getChunkCount(1023, 8), 1u);
+    CHECK_EQ(ForwardPass::getChunkCount(1025, 8), 1u);      // 两块的话每块只有512个
+    CHECK_EQ(ForwardPass::getChunkCount(2048, 8), 2u);
+    CHECK_EQ(ForwardPass::getChunkCount(100000, 8), 16u);
+    CHECK_EQ(ForwardPass::getChunkCount(100000, 1), 2u);
+}
+
+void testBoundaries() {
+    bool valid = true;
+    const size_t minDraws = ForwardPass::MIN_DRAWS_PER_CHUNK;
+    for (uint32_t threads = 1; threads <= 16; ++threads) {
+        for (size_t multiple = 0; multiple <= 40; ++multiple) {
+            for (int delta = -1; delta <= 1; ++delta) {
+                size_t drawCount = multiple * minDraws;
+                if (delta < 0 && drawCount == 0) continue;
+                valid &= chunksValid(drawCount + delta, threads);
+            }
+        }
+    }
+    CHECK(valid);
+}
+
+void testRandom() {
+    std::mt19937_64 rng(31);
+    bool valid = true;
+    for (int round = 0; round < 5000; ++round) {
+        uint32_t threads = 1 + static_cast<uint32_t>(rng() % 64);
+        size_t drawCount = round % 2 == 0 ? rng() % 100000 : rng() % 50000000;
+        valid &= chunksValid(drawCount, threads);
+    }
+    CHECK(valid);
+}
+
+} // namespace
+
+int main() {
+    testKnownCounts();
+    testBoundaries();
+    testRandom();
+    return test::finish("test_record_chunks");
+}
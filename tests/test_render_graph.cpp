@@ -0,0 +1,320 @@
+#include "TestCommon.h"
+#include "Rendering/RenderGraph.h"
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// RenderGraph的CPU部分：
+// - 剔除：结果没人用的Pass（包括只被剔除的Pass读的瞬态图像的写入者）不执行
+// - 屏障：RAW/WAR/WAW和布局转换各一个屏障，同一布局下已经可见的读没有屏障，
+//   同一个Pass之前的屏障合并成一批，图结束时导入资源转换到finalAccess
+// - 别名（planAliasing）：生命周期重叠的图像在同一块内存里不重叠、偏移对齐、内存类型兼容
+// 导入的句柄是假的、不调用initialize()：compile()只有瞬态图像真的分配时才碰设备，
+// 所以这里不测有瞬态图像的图的分配和execute()（需要设备和学习任务）
+
+namespace {
+
+using Access = RenderGraph::Access;
+using AliasRequest = RenderGraph::AliasRequest;
+using AliasPlacement = RenderGraph::AliasPlacement;
+using AliasHeap = RenderGraph::AliasHeap;
+
+constexpr VkFormat COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+constexpr VkExtent2D EXTENT = { 64, 64 };
+
+VkImage fakeImage(uintptr_t value) {
+    return reinterpret_cast<VkImage>(value);
+}
+
+VkBuffer fakeBuffer(uintptr_t value) {
+    return reinterpret_cast<VkBuffer>(value);
+}
+
+RenderGraph::ImageHandle importColor(RenderGraph& graph, Access finalAccess) {
+    return graph.importImage("Color", fakeImage(1), VK_NULL_HANDLE, COLOR_FORMAT, EXTENT, Access::None, finalAccess);
+}
+
+// 只声明读写、没有execute的Pass
+void addPass(RenderGraph& graph, const char* name, const RenderGraph::SetupFunc& setup) {
+    graph.addPass(name, setup, nullptr);
+}
+
+void testImageBarriers() {
+    RenderGraph graph;
+    RenderGraph::ImageHandle color = importColor(graph, Access::None);
+
+    addPass(graph, "Draw", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(color, Access::ColorAttachmentWrite);        // UNDEFINED -> 附件：1
+    });
+    addPass(graph, "Blur", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(color, Access::FragmentSampled);              // RAW + 布局转换：2
+        builder.setSideEffect();
+    });
+    addPass(graph, "Tone", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(color, Access::FragmentSampled);              // 已经可见：没有屏障
+        builder.setSideEffect();
+    });
+    addPass(graph, "Histogram", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(color, Access::ComputeSampled);               // 同一布局，但计算阶段还看不到：3
+        builder.setSideEffect();
+    });
+    addPass(graph, "Overwrite", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(color, Access::ColorAttachmentWrite);        // WAR + 布局转换：4
+    });
+    graph.compile();
+
+    const RenderGraph::Stats& stats = graph.getStats();
+    CHECK_EQ(stats.passes, 5u);
+    CHECK_EQ(stats.culledPasses, 0u);
+    CHECK_EQ(stats.imageBarriers, 4u);
+    CHECK_EQ(stats.bufferBarriers, 0u);
+    CHECK_EQ(stats.barrierBatches, 4u);
+    CHECK_EQ(stats.transientImages, 0u);
+}
+
+void testBufferBarriers() {
+    RenderGraph graph;
+    RenderGraph::BufferHandle commands = graph.importBuffer("Commands", fakeBuffer(1), Access::None, Access::None);
+
+    addPass(graph, "Cull", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(commands, Access::ComputeStorageWrite);      // 之前没有访问：没有屏障
+    });
+    addPass(graph, "Compact", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(commands, Access::ComputeStorageWrite);      // WAW：1
+    });
+    addPass(graph, "Draw", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(commands, Access::IndirectRead);              // RAW：2
+        builder.setSideEffect();
+    });
+    addPass(graph, "DrawAgain", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(commands, Access::IndirectRead);              // 已经可见：没有屏障
+        builder.setSideEffect();
+    });
+    graph.compile();
+
+    const RenderGraph::Stats& stats = graph.getStats();
+    CHECK_EQ(stats.passes, 4u);
+    CHECK_EQ(stats.bufferBarriers, 2u);
+    CHECK_EQ(stats.imageBarriers, 0u);
+    CHECK_EQ(stats.barrierBatches, 2u);
+
+    // 上一帧（或图之前）写过的导入缓冲：第一次读也要等
+    graph.reset();
+    commands = graph.importBuffer("Commands", fakeBuffer(1), Access::TransferWrite, Access::None);
+    addPass(graph, "Draw", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(commands, Access::IndirectRead);
+        builder.setSideEffect();
+    });
+    graph.compile();
+    CHECK_EQ(graph.getStats().bufferBarriers, 1u);
+}
+
+// 同一个Pass之前的屏障合并成一次vkCmdPipelineBarrier；导入图像结束时转换到finalAccess
+void testBatchesAndFinalTransition() {
+    RenderGraph graph;
+    RenderGraph::ImageHandle color = importColor(graph, Access::Present);
+    RenderGraph::ImageHandle depth = graph.importImage("Depth", fakeImage(2), VK_NULL_HANDLE, VK_FORMAT_D32_SFLOAT,
+                                                       EXTENT, Access::None, Access::None);
+    RenderGraph::BufferHandle instances = graph.importBuffer("Instances", fakeBuffer(3),
+                                                             Access::TransferWrite, Access::None);
+
+    addPass(graph, "Forward", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(color, Access::ColorAttachmentWrite);
+        builder.write(depth, Access::DepthAttachmentWrite);
+        builder.read(instances, Access::VertexShaderRead);
+    });
+    graph.compile();
+
+    const RenderGraph::Stats& stats = graph.getStats();
+    CHECK_EQ(stats.imageBarriers, 3u);       // 颜色、深度、结束时颜色 -> PRESENT
+    CHECK_EQ(stats.bufferBarriers, 1u);
+    CHECK_EQ(stats.barrierBatches, 2u);      // Forward之前一批，结束时一批
+}
+
+void testCulling() {
+    RenderGraph graph;
+    RenderGraph::ImageHandle color = importColor(graph, Access::None);
+    RenderGraph::ImageHandle scratch;
+
+    // Debug写的瞬态图像只有Unused读，Unused的结果没人用：两个都剔除，瞬态图像也不分配
+    addPass(graph, "Debug", [&](RenderGraph::PassBuilder& builder) {
+        scratch = builder.createImage("Scratch", { COLOR_FORMAT, EXTENT });
+        builder.write(scratch, Access::ColorAttachmentWrite);
+    });
+    addPass(graph, "Unused", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(scratch, Access::FragmentSampled);
+    });
+    addPass(graph, "Forward", [&](RenderGraph::PassBuilder& builder) {
+        builder.write(color, Access::ColorAttachmentWrite);
+    });
+    addPass(graph, "ReadOnly", [&](RenderGraph::PassBuilder& builder) {
+        builder.read(color, Access::FragmentSampled);
+    });
+    graph.compile();
+
+    const RenderGraph::Stats& stats = graph.getStats();
+    CHECK_EQ(stats.passes, 1u);
+    CHECK_EQ(stats.culledPasses, 3u);
+    CHECK_EQ(stats.transientImages, 0u);
+    CHECK_EQ(stats.imageBarriers, 1u);       // 剔除的Pass不产生屏障
+}
+
+// 图里先导入一个缓冲（下标0），setup里声明的用法不合法时addPass()抛出异常
+bool throwsOnSetup(const RenderGraph::SetupFunc& setup) {
+    RenderGraph graph;
+    graph.importBuffer("Buffer", fakeBuffer(1), Access::None, Access::None);
+    try {
+        addPass(graph, "Invalid", setup);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void testInvalidAccess() {
+    const RenderGraph::BufferHandle buffer{ 0 };
+    bool readAsWrite = throwsOnSetup([](RenderGraph::PassBuilder& builder) {
+        RenderGraph::ImageHandle image = builder.createImage("Image", { COLOR_FORMAT, EXTENT });
+        builder.read(image, Access::ColorAttachmentWrite);
+    });
+    bool twoLayouts = throwsOnSetup([](RenderGraph::PassBuilder& builder) {
+        RenderGraph::ImageHandle image = builder.createImage("Image", { COLOR_FORMAT, EXTENT });
+        builder.write(image, Access::ColorAttachmentWrite);
+        builder.read(image, Access::FragmentSampled);
+    });
+    bool bufferAsAttachment = throwsOnSetup([&](RenderGraph::PassBuilder& builder) {
+        builder.write(buffer, Access::ColorAttachmentWrite);
+    });
+    bool valid = throwsOnSetup([&](RenderGraph::PassBuilder& builder) {
+        builder.write(buffer, Access::ComputeStorageWrite);
+    });
+    CHECK(readAsWrite);
+    CHECK(twoLayouts);
+    CHECK(bufferAsAttachment);
+    CHECK(!valid);
+}
+
+// 生命周期不重叠的图像共用内存，重叠的错开；内存类型不兼容的放进另一块
+void testAliasingKnown() {
+    std::vector<AliasPlacement> placements;
+    std::vector<AliasHeap> heaps;
+
+    std::vector<AliasRequest> chain = {
+        { 1000, 256, ~0u, 0, 0 },
+        { 1000, 256, ~0u, 1, 1 },
+        { 1000, 256, ~0u, 2, 2 },
+    };
+    RenderGraph::planAliasing(chain, placements, heaps);
+    CHECK_EQ(heaps.size(), 1u);
+    CHECK_EQ(heaps[0].size, 1000u);
+    CHECK_EQ(placements[1].offset, 0u);
+    CHECK_EQ(placements[2].offset, 0u);
+
+    // 0和1重叠，1和2重叠，0和2不重叠：2放回0的位置
+    std::vector<AliasRequest> overlapping = {
+        { 1000, 256, ~0u, 0, 1 },
+        { 1000, 256, ~0u, 1, 2 },
+        { 1000, 256, ~0u, 2, 3 },
+    };
+    RenderGraph::planAliasing(overlapping, placements, heaps);
+    CHECK_EQ(heaps.size(), 1u);
+    CHECK_EQ(placements[0].offset, 0u);
+    CHECK_EQ(placements[1].offset, 1024u);   // 对齐到256
+    CHECK_EQ(placements[2].offset, 0u);
+    CHECK_EQ(heaps[0].size, 2024u);
+
+    // 大的先放：小图像放不进大图像之前的空位
+    std::vector<AliasRequest> sizes = {
+        { 100, 16, ~0u, 0, 1 },
+        { 4000, 16, ~0u, 0, 1 },
+    };
+    RenderGraph::planAliasing(sizes, placements, heaps);
+    CHECK_EQ(placements[1].offset, 0u);
+    CHECK_EQ(placements[0].offset, 4000u);
+
+    std::vector<AliasRequest> types = {
+        { 1000, 256, 0x1, 0, 0 },
+        { 1000, 256, 0x2, 1, 1 },
+        { 1000, 256, 0x3, 2, 2 },
+    };
+    RenderGraph::planAliasing(types, placements, heaps);
+    CHECK_EQ(heaps.size(), 2u);
+    CHECK_EQ(placements[0].heap, 0u);
+    CHECK_EQ(placements[1].heap, 1u);
+    CHECK_EQ(placements[2].heap, 0u);
+    CHECK_EQ(heaps[0].memoryTypeBits, 0x1u);
+}
+
+void testAliasingRandom() {
+    std::mt19937 rng(41);
+    const VkDeviceSize alignments[] = { 1, 256, 4096, 65536 };
+    bool valid = true;
+    bool disjoint = true;
+    bool aliased = false;
+
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<AliasRequest> requests(1 + rng() % 12);
+        VkDeviceSize unaliased = 0;
+        for (AliasRequest& request : requests) {
+            request.size = 1 + rng() % 200000;
+            request.alignment = alignments[rng() % 4];
+            request.memoryTypeBits = 1 + rng() % 7;
+            request.firstPass = rng() % 8;
+            request.lastPass = request.firstPass + rng() % 4;
+            unaliased += request.size + request.alignment;
+        }
+
+        std::vector<AliasPlacement> placements;
+        std::vector<AliasHeap> heaps;
+        RenderGraph::planAliasing(requests, placements, heaps);
+        if (placements.size() != requests.size()) {
+            valid = false;
+            continue;
+        }
+
+        VkDeviceSize allocated = 0;
+        for (const AliasHeap& heap : heaps) allocated += heap.size;
+        valid &= allocated <= unaliased;
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+            const AliasRequest& a = requests[i];
+            const AliasPlacement& pa = placements[i];
+            if (pa.heap >= heaps.size()) {
+                valid = false;
+                continue;
+            }
+            const AliasHeap& heap = heaps[pa.heap];
+            valid &= pa.offset % a.alignment == 0;
+            valid &= pa.offset + a.size <= heap.size;
+            valid &= heap.alignment % a.alignment == 0;
+            valid &= heap.memoryTypeBits != 0 && (heap.memoryTypeBits & ~a.memoryTypeBits) == 0;
+
+            for (size_t j = i + 1; j < requests.size(); ++j) {
+                const AliasRequest& b = requests[j];
+                const AliasPlacement& pb = placements[j];
+                if (pa.heap != pb.heap) continue;
+                bool memoryOverlaps = pa.offset < pb.offset + b.size && pb.offset < pa.offset + a.size;
+                bool lifetimesOverlap = a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+                disjoint &= !(memoryOverlaps && lifetimesOverlap);
+                aliased |= memoryOverlaps;
+            }
+        }
+    }
+    CHECK(valid);
+    CHECK(disjoint);
+    CHECK(aliased);
+}
+
+} // namespace
+
+int main() {
+    testImageBarriers();
+    testBufferBarriers();
+    testBatchesAndFinalTransition();
+    testCulling();
+    testInvalidAccess();
+    testAliasingKnown();
+    testAliasingRandom();
+    return test::finish("test_render_graph");
+}
@@ -0,0 +1,322 @@
+#include "TestCommon.h"
+#include "Core/SpirvReflection.h"
+#include <initializer_list>
+#include <stdexcept>
+#include <vector>
+
+// ShaderReflection：手工拼出的SPIR-V模块（和glslc的输出结构相同，但只有反射用到的指令）
+
+namespace {
+
+// SPIR-V规范的数值
+enum : uint32_t {
+    OpMemoryModel = 14, OpEntryPoint = 15, OpCapability = 17, OpTypeVoid = 19,
+    OpTypeInt = 21, OpTypeFloat = 22, OpTypeVector = 23, OpTypeMatrix = 24, OpTypeImage = 25,
+    OpTypeSampledImage = 27, OpTypeArray = 28, OpTypeRuntimeArray = 29, OpTypeStruct = 30,
+    OpTypePointer = 32, OpTypeFunction = 33, OpConstant = 43, OpFunction = 54, OpFunctionEnd = 56,
+    OpVariable = 59, OpDecorate = 71, OpMemberDecorate = 72, OpLabel = 248, OpReturn = 253
+};
+enum : uint32_t {
+    DecorationBlock = 2, DecorationBufferBlock = 3, DecorationArrayStride = 6, DecorationMatrixStride = 7,
+    DecorationBuiltIn = 11, DecorationLocation = 30, DecorationBinding = 33, DecorationDescriptorSet = 34,
+    DecorationOffset = 35
+};
+enum : uint32_t {
+    StorageUniformConstant = 0, StorageInput = 1, StorageUniform = 2, StorageOutput = 3,
+    StoragePushConstant = 9, StorageStorageBuffer = 12
+};
+enum : uint32_t { ModelVertex = 0, ModelFragment = 4 };
+
+// 按顺序追加指令；头部的id上界在code()里填
+class SpirvBuilder {
+public:
+    uint32_t newId() { return m_nextId++; }
+
+    void add(uint32_t opcode, std::initializer_list<uint32_t> operands) {
+        m_words.push_back((uint32_t(operands.size() + 1) << 16) | opcode);
+        m_words.insert(m_words.end(), operands);
+    }
+
+    // 定义一个类型/常量/变量，分配并返回result id
+    // （hasResultType：OpConstant/OpVariable的result id在结果类型之后）
+    uint32_t define(uint32_t opcode, std::initializer_list<uint32_t> operandsAfterResult, bool hasResultType = false) {
+        uint32_t result = newId();
+        std::vector<uint32_t> operands(operandsAfterResult);
+        operands.insert(operands.begin() + (hasResultType ? 1 : 0), result);
+        m_words.push_back((uint32_t(operands.size() + 1) << 16) | opcode);
+        m_words.insert(m_words.end(), operands.begin(), operands.end());
+        return result;
+    }
+
+    void entryPoint(uint32_t model, uint32_t function, std::initializer_list<uint32_t> interface) {
+        std::vector<uint32_t> operands{ model, function, 0x6e69616d, 0 };   // "main\0"
+        operands.insert(operands.end(), interface);
+        m_words.push_back((uint32_t(operands.size() + 1) << 16) | OpEntryPoint);
+        m_words.insert(m_words.end(), operands.begin(), operands.end());
+    }
+
+    void decorate(uint32_t target, uint32_t decoration) { add(OpDecorate, { target, decoration }); }
+    void decorate(uint32_t target, uint32_t decoration, uint32_t value) { add(OpDecorate, { target, decoration, value }); }
+    void memberDecorate(uint32_t structId, uint32_t member, uint32_t decoration, uint32_t value) {
+        add(OpMemberDecorate, { structId, member, decoration, value });
+    }
+
+    std::vector<uint32_t> code() const {
+        std::vector<uint32_t> result{ 0x07230203, 0x00010000, 0, m_nextId, 0 };
+        result.insert(result.end(), m_words.begin(), m_words.end());
+        return result;
+    }
+
+    // 空的main函数（反射在第一个OpFunction处停止）
+    void function(uint32_t functionId, uint32_t voidType, uint32_t functionType) {
+        add(OpFunction, { voidType, functionId, 0, functionType });
+        add(OpLabel, { newId() });
+        add(OpReturn, {});
+        add(OpFunctionEnd, {});
+    }
+
+private:
+    uint32_t m_nextId = 1;
+    std::vector<uint32_t> m_words;
+};
+
+ShaderReflection reflect(const std::vector<uint32_t>& code) {
+    return ShaderReflection::reflect(code.data(), code.size());
+}
+
+// 相当于shaders/simple.vert，外加一个mat4实例输入（location 4-7）和gl_VertexIndex
+std::vector<uint32_t> buildVertexShader() {
+    SpirvBuilder b;
+    uint32_t main = b.newId();
+
+    // 先分配接口变量的id，入口点要引用它们
+    uint32_t inPosition = b.newId(), inColor = b.newId(), inNormal = b.newId(), inTexCoord = b.newId();
+    uint32_t inModel = b.newId(), vertexIndex = b.newId(), perVertex = b.newId();
+
+    b.add(OpCapability, { 1 });
+    b.add(OpMemoryModel, { 0, 1 });
+    b.entryPoint(ModelVertex, main, { inPosition, inColor, inNormal, inTexCoord, inModel, vertexIndex, perVertex });
+
+    uint32_t voidType = b.define(OpTypeVoid, {});
+    uint32_t functionType = b.define(OpTypeFunction, { voidType });
+    uint32_t floatType = b.define(OpTypeFloat, { 32 });
+    uint32_t intType = b.define(OpTypeInt, { 32, 1 });
+    uint32_t vec2 = b.define(OpTypeVector, { floatType, 2 });
+    uint32_t vec3 = b.define(OpTypeVector, { floatType, 3 });
+    uint32_t vec4 = b.define(OpTypeVector, { floatType, 4 });
+    uint32_t mat4 = b.define(OpTypeMatrix, { vec4, 4 });
+
+    uint32_t inVec2 = b.define(OpTypePointer, { StorageInput, vec2 });
+    uint32_t inVec3 = b.define(OpTypePointer, { StorageInput, vec3 });
+    uint32_t inMat4 = b.define(OpTypePointer, { StorageInput, mat4 });
+    uint32_t inInt = b.define(OpTypePointer, { StorageInput, intType });
+
+    b.add(OpVariable, { inVec3, inPosition, StorageInput });
+    b.add(OpVariable, { inVec3, inColor, StorageInput });
+    b.add(OpVariable, { inVec3, inNormal, StorageInput });
+    b.add(OpVariable, { inVec2, inTexCoord, StorageInput });
+    b.add(OpVariable, { inMat4, inModel, StorageInput });
+    b.add(OpVariable, { inInt, vertexIndex, StorageInput });
+    b.decorate(inPosition, DecorationLocation, 0);
+    b.decorate(inColor, DecorationLocation, 1);
+    b.decorate(inNormal, DecorationLocation, 2);
+    b.decorate(inTexCoord, DecorationLocation, 3);
+    b.decorate(inModel, DecorationLocation, 4);
+    b.decorate(vertexIndex, DecorationBuiltIn, 42);
+
+    // gl_PerVertex输出块
+    uint32_t perVertexType = b.define(OpTypeStruct, { vec4 });
+    b.memberDecorate(perVertexType, 0, DecorationBuiltIn, 0);
+    b.decorate(perVertexType, DecorationBlock);
+    uint32_t outPerVertex = b.define(OpTypePointer, { StorageOutput, perVertexType });
+    b.add(OpVariable, { outPerVertex, perVertex, StorageOutput });
+
+    // layout(push_constant) uniform { mat4 mvp; }
+    uint32_t pushType = b.define(OpTypeStruct, { mat4 });
+    b.memberDecorate(pushType, 0, DecorationOffset, 0);
+    b.memberDecorate(pushType, 0, DecorationMatrixStride, 16);
+    b.decorate(pushType, DecorationBlock);
+    uint32_t pushPointer = b.define(OpTypePointer, { StoragePushConstant, pushType });
+    b.define(OpVariable, { pushPointer, StoragePushConstant }, true);
+
+    b.function(main, voidType, functionType);
+    return b.code();
+}
+
+// 片段着色器：各种descriptor类型，以及从offset 64开始的push constant
+std::vector<uint32_t> buildFragmentShader() {
+    SpirvBuilder b;
+    uint32_t main = b.newId();
+
+    b.add(OpCapability, { 1 });
+    b.add(OpMemoryModel, { 0, 1 });
+    b.entryPoint(ModelFragment, main, {});
+
+    uint32_t voidType = b.define(OpTypeVoid, {});
+    uint32_t functionType = b.define(OpTypeFunction, { voidType });
+    uint32_t floatType = b.define(OpTypeFloat, { 32 });
+    uint32_t uintType = b.define(OpTypeInt, { 32, 0 });
+    uint32_t vec4 = b.define(OpTypeVector, { floatType, 4 });
+    uint32_t four = b.define(OpConstant, { uintType, 4 }, true);
+
+    // set 1, binding 0: uniform Material { vec4 color; float roughness; }
+    uint32_t uboType = b.define(OpTypeStruct, { vec4, floatType });
+    b.memberDecorate(uboType, 0, DecorationOffset, 0);
+    b.memberDecorate(uboType, 1, DecorationOffset, 16);
+    b.decorate(uboType, DecorationBlock);
+    uint32_t uboPointer = b.define(OpTypePointer, { StorageUniform, uboType });
+    uint32_t ubo = b.define(OpVariable, { uboPointer, StorageUniform }, true);
+    b.decorate(ubo, DecorationDescriptorSet, 1);
+    b.decorate(ubo, DecorationBinding, 0);
+
+    // set 0, binding 3: sampler2D textures[4]
+    uint32_t image2D = b.define(OpTypeImage, { floatType, 1, 0, 0, 0, 1, 0 });
+    uint32_t sampledImage = b.define(OpTypeSampledImage, { image2D });
+    uint32_t textureArray = b.define(OpTypeArray, { sampledImage, four });
+    uint32_t texturesPointer = b.define(OpTypePointer, { StorageUniformConstant, textureArray });
+    uint32_t textures = b.define(OpVariable, { texturesPointer, StorageUniformConstant }, true);
+    b.decorate(textures, DecorationDescriptorSet, 0);
+    b.decorate(textures, DecorationBinding, 3);
+
+    // set 0, binding 1: buffer Lights { vec4 lights[]; }（StorageBuffer存储类）
+    uint32_t runtimeArray = b.define(OpTypeRuntimeArray, { vec4 });
+    b.decorate(runtimeArray, DecorationArrayStride, 16);
+    uint32_t ssboType = b.define(OpTypeStruct, { runtimeArray });
+    b.memberDecorate(ssboType, 0, DecorationOffset, 0);
+    b.decorate(ssboType, DecorationBlock);
+    uint32_t ssboPointer = b.define(OpTypePointer, { StorageStorageBuffer, ssboType });
+    uint32_t ssbo = b.define(OpVariable, { ssboPointer, StorageStorageBuffer }, true);
+    b.decorate(ssbo, DecorationDescriptorSet, 0);
+    b.decorate(ssbo, DecorationBinding, 1);
+
+    // set 0, binding 0: 旧式的BufferBlock（Uniform存储类）也是storage buffer
+    uint32_t legacyType = b.define(OpTypeStruct, { vec4 });
+    b.memberDecorate(legacyType, 0, DecorationOffset, 0);
+    b.decorate(legacyType, DecorationBufferBlock);
+    uint32_t legacyPointer = b.define(OpTypePointer, { StorageUniform, legacyType });
+    uint32_t legacy = b.define(OpVariable, { legacyPointer, StorageUniform }, true);
+    b.decorate(legacy, DecorationDescriptorSet, 0);
+    b.decorate(legacy, DecorationBinding, 0);
+
+    // set 2, binding 0: image2D（sampled = 2，storage image）
+    uint32_t storageImageType = b.define(OpTypeImage, { floatType, 1, 0, 0, 0, 2, 1 });
+    uint32_t storageImagePointer = b.define(OpTypePointer, { StorageUniformConstant, storageImageType });
+    uint32_t storageImage = b.define(OpVariable, { storageImagePointer, StorageUniformConstant }, true);
+    b.decorate(storageImage, DecorationDescriptorSet, 2);
+    b.decorate(storageImage, DecorationBinding, 0);
+
+    // push constant：layout(offset = 64) vec4 tint; float exposure;
+    uint32_t pushType = b.define(OpTypeStruct, { vec4, floatType });
+    b.memberDecorate(pushType, 0, DecorationOffset, 64);
+    b.memberDecorate(pushType, 1, DecorationOffset, 80);
+    b.decorate(pushType, DecorationBlock);
+    uint32_t pushPointer = b.define(OpTypePointer, { StoragePushConstant, pushType });
+    b.define(OpVariable, { pushPointer, StoragePushConstant }, true);
+
+    b.function(main, voidType, functionType);
+    return b.code();
+}
+
+void testVertexShader() {
+    ShaderReflection reflection = reflect(buildVertexShader());
+    CHECK_EQ(reflection.stage, VK_SHADER_STAGE_VERTEX_BIT);
+    CHECK(reflection.bindings.empty());
+
+    CHECK_EQ(reflection.pushConstants.stageFlags, VkShaderStageFlags(VK_SHADER_STAGE_VERTEX_BIT));
+    CHECK_EQ(reflection.pushConstants.offset, 0u);
+    CHECK_EQ(reflection.pushConstants.size, 64u);
+
+    // 0-3来自Vertex，mat4展开成4-7；gl_VertexIndex不算
+    CHECK_EQ(reflection.vertexInputs.size(), 8u);
+    if (reflection.vertexInputs.size() == 8) {
+        CHECK_EQ(reflection.vertexInputs[0].format, VK_FORMAT_R32G32B32_SFLOAT);
+        CHECK_EQ(reflection.vertexInputs[2].format, VK_FORMAT_R32G32B32_SFLOAT);
+        CHECK_EQ(reflection.vertexInputs[3].format, VK_FORMAT_R32G32_SFLOAT);
+        for (uint32_t i = 0; i < 8; ++i) CHECK_EQ(reflection.vertexInputs[i].location, i);
+        for (uint32_t i = 4; i < 8; ++i) CHECK_EQ(reflection.vertexInputs[i].format, VK_FORMAT_R32G32B32A32_SFLOAT);
+    }
+    CHECK(reflection.hasVertexInput(7));
+    CHECK(!reflection.hasVertexInput(8));
+}
+
+void testFragmentShader() {
+    ShaderReflection reflection = reflect(buildFragmentShader());
+    CHECK_EQ(reflection.stage, VK_SHADER_STAGE_FRAGMENT_BIT);
+    CHECK(reflection.vertexInputs.empty());
+
+    // 按(set, binding)排序
+    CHECK_EQ(reflection.bindings.size(), 5u);
+    if (reflection.bindings.size() == 5) {
+        const auto& b = reflection.bindings;
+        CHECK(b[0].set == 0 && b[0].binding == 0 && b[0].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        CHECK(b[1].set == 0 && b[1].binding == 1 && b[1].type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+        CHECK(b[2].set == 0 && b[2].binding == 3 && b[2].type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        CHECK_EQ(b[2].count, 4u);
+        CHECK(b[3].set == 1 && b[3].binding == 0 && b[3].type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+        CHECK_EQ(b[3].count, 1u);
+        CHECK(b[4].set == 2 && b[4].binding == 0 && b[4].type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        CHECK_EQ(b[0].stages, VkShaderStageFlags(VK_SHADER_STAGE_FRAGMENT_BIT));
+    }
+
+    // 范围从第一个成员的offset开始，到最后一个成员的末尾
+    CHECK_EQ(reflection.pushConstants.offset, 64u);
+    CHECK_EQ(reflection.pushConstants.size, 20u);
+}
+
+void testNoPushConstants() {
+    SpirvBuilder b;
+    uint32_t main = b.newId();
+    b.entryPoint(ModelFragment, main, {});
+    uint32_t voidType = b.define(OpTypeVoid, {});
+    b.function(main, voidType, b.define(OpTypeFunction, { voidType }));
+
+    ShaderReflection reflection = reflect(b.code());
+    CHECK_EQ(reflection.pushConstants.size, 0u);
+    CHECK(reflection.bindings.empty());
+}
+
+bool throws(const std::vector<uint32_t>& code) {
+    try {
+        ShaderReflection::reflect(code.data(), code.size());
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+void testInvalidModules() {
+    std::vector<uint32_t> valid = buildVertexShader();
+    CHECK(!throws(valid));
+
+    CHECK(throws({}));
+    CHECK(throws({ 0x07230203, 0x00010000, 0 }));     // 头部不完整
+
+    std::vector<uint32_t> badMagic = valid;
+    badMagic[0] = 0x03022307;
+    CHECK(throws(badMagic));
+
+    // 最后一条指令被截断
+    std::vector<uint32_t> truncated(valid.begin(), valid.begin() + 12);
+    truncated.back() = (100u << 16) | OpTypeFloat;
+    CHECK(throws(truncated));
+
+    // id超过头部声明的上界
+    std::vector<uint32_t> badBound = valid;
+    badBound[3] = 3;
+    CHECK(throws(badBound));
+
+    // 没有入口点
+    SpirvBuilder b;
+    b.define(OpTypeVoid, {});
+    CHECK(throws(b.code()));
+}
+
+} // namespace
+
+int main() {
+    testVertexShader();
+    testFragmentShader();
+    testNoPushConstants();
+    testInvalidModules();
+    return test::finish("test_spirv_reflection");
+}
@@ -0,0 +1,198 @@
+#include "TestCommon.h"
+#include "ECS/ECS.h"
+#include "ECS/SystemScheduler.h"
+#include "Framework/JobSystem.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// SystemScheduler：冲突的系统按注册顺序执行，不冲突的可以同时执行，异常在update()里重新抛出
+
+namespace {
+
+struct CompA {};
+struct CompB {};
+struct CompC {};
+struct CompD {};
+
+// 全局递增的时钟，记录每个系统开始/结束的先后
+std::atomic<uint64_t> g_clock{0};
+
+struct Interval {
+    uint64_t start = 0;
+    uint64_t end = 0;
+    int runs = 0;
+};
+
+class RecordingSystem : public ISystem {
+public:
+    RecordingSystem(uint32_t readMask, uint32_t writeMask, bool exclusive, Interval& interval)
+        : m_readMask(readMask), m_writeMask(writeMask), m_exclusive(exclusive), m_interval(interval) {}
+
+    const char* getName() const override { return "RecordingSystem"; }
+
+    void declareAccess(SystemAccess& access) override {
+        if (m_readMask & 1) access.read<CompA>();
+        if (m_readMask & 2) access.read<CompB>();
+        if (m_readMask & 4) access.read<CompC>();
+        if (m_readMask & 8) access.read<CompD>();
+        if (m_writeMask & 1) access.write<CompA>();
+        if (m_writeMask & 2) access.write<CompB>();
+        if (m_writeMask & 4) access.write<CompC>();
+        if (m_writeMask & 8) access.write<CompD>();
+        if (m_exclusive) access.exclusive();
+    }
+
+    void update(ECS&, float) override {
+        m_interval.start = ++g_clock;
+        // 拉长执行时间，顺序错了更容易暴露出重叠
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        m_interval.end = ++g_clock;
+        m_interval.runs++;
+    }
+
+private:
+    uint32_t m_readMask;
+    uint32_t m_writeMask;
+    bool m_exclusive;
+    Interval& m_interval;
+};
+
+// 两个系统互相等对方：只有真正并行执行时才能都等到
+class RendezvousSystem : public ISystem {
+public:
+    RendezvousSystem(std::atomic<int>& arrived, bool& met) : m_arrived(arrived), m_met(met) {}
+
+    const char* getName() const override { return "RendezvousSystem"; }
+    void declareAccess(SystemAccess& access) override { access.read<CompA>(); }
+
+    void update(ECS&, float) override {
+        m_arrived++;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (m_arrived.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        m_met = m_arrived.load() >= 2;
+    }
+
+private:
+    std::atomic<int>& m_arrived;
+    bool& m_met;
+};
+
+class ThrowingSystem : public ISystem {
+public:
+    const char* getName() const override { return "ThrowingSystem"; }
+    void declareAccess(SystemAccess& access) override { access.write<CompA>(); }
+    void update(ECS&, float) override { throw std::runtime_error("system failed"); }
+};
+
+void testConflictOrdering() {
+    JobSystem jobs(3);
+    ECS ecs;
+    std::mt19937 rng(7);
+
+    bool ordered = true;
+    bool ranOnce = true;
+    for (int round = 0; round < 10; ++round) {
+        SystemScheduler scheduler(jobs);
+        std::vector<SystemAccess> accesses(12);
+        std::vector<Interval> intervals(accesses.size());
+
+        for (size_t i = 0; i < accesses.size(); ++i) {
+            uint32_t readMask = rng() % 16;
+            uint32_t writeMask = rng() % 4 == 0 ? rng() % 16 : 0;
+            bool exclusive = rng() % 16 == 0;
+            auto* system = scheduler.addSystem<RecordingSystem>(readMask, writeMask, exclusive, intervals[i]);
+            system->declareAccess(accesses[i]);
+        }
+
+        for (int frame = 0; frame < 3; ++frame) {
+            scheduler.update(ecs, 0.016f);
+
+            for (size_t i = 0; i < accesses.size(); ++i) {
+                ranOnce &= intervals[i].runs == frame + 1;
+                for (size_t j = i + 1; j < accesses.size(); ++j) {
+                    if (accesses[i].conflictsWith(accesses[j])) {
+                        ordered &= intervals[i].end < intervals[j].start;
+                    }
+                }
+            }
+        }
+    }
+    CHECK(ordered);
+    CHECK(ranOnce);
+}
+
+void testConflictRules() {
+    SystemAccess reader;
+    reader.read<CompA>();
+    SystemAccess otherReader;
+    otherReader.read<CompA>().read<CompB>();
+    SystemAccess writer;
+    writer.write<CompA>();
+    SystemAccess unrelatedWriter;
+    unrelatedWriter.write<CompC>();
+    SystemAccess exclusive;
+    exclusive.exclusive();
+
+    CHECK(!reader.conflictsWith(otherReader));
+    CHECK(reader.conflictsWith(writer));
+    CHECK(writer.conflictsWith(reader));
+    CHECK(writer.conflictsWith(writer));
+    CHECK(!writer.conflictsWith(unrelatedWriter));
+    CHECK(exclusive.conflictsWith(SystemAccess()));
+    CHECK(SystemAccess().conflictsWith(exclusive));
+}
+
+void testReadersRunInParallel() {
+    JobSystem jobs(2);
+    ECS ecs;
+    SystemScheduler scheduler(jobs);
+
+    std::atomic<int> arrived{0};
+    bool firstMet = false;
+    bool secondMet = false;
+    scheduler.addSystem<RendezvousSystem>(arrived, firstMet);
+    scheduler.addSystem<RendezvousSystem>(arrived, secondMet);
+    scheduler.update(ecs, 0.016f);
+
+    CHECK(firstMet);
+    CHECK(secondMet);
+}
+
+void testExceptionRethrown() {
+    JobSystem jobs(2);
+    ECS ecs;
+    SystemScheduler scheduler(jobs);
+
+    Interval before, after;
+    scheduler.addSystem<RecordingSystem>(0u, 1u, false, before);
+    scheduler.addSystem<ThrowingSystem>();
+    scheduler.addSystem<RecordingSystem>(1u, 0u, false, after);
+
+    bool thrown = false;
+    try {
+        scheduler.update(ecs, 0.016f);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // 整帧跑完才抛：依赖出错系统的系统也执行了
+    CHECK_EQ(before.runs, 1);
+    CHECK_EQ(after.runs, 1);
+}
+
+} // namespace
+
+int main() {
+    testConflictRules();
+    testConflictOrdering();
+    testReadersRunInParallel();
+    testExceptionRethrown();
+    return test::finish("test_system_scheduler");
+}
@@ -0,0 +1,176 @@
+#include "TestCommon.h"
+#include "Framework/TransformBatch.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// TransformBatch：SIMD版本（SSE，ENABLE_AVX2时是AVX2）和逐元素的标量公式一致，
+// 包括凑不满一组的零头、不对齐的数组、原地乘法，并且不写越界
+
+namespace {
+
+constexpr float SENTINEL = -12345.0f;
+
+// 和TransformComponent::getLocalMatrix()相同的公式，逐元素写出来
+void referenceLocal(const glm::vec3& p, const glm::quat& q, const glm::vec3& s, float* o) {
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    const float values[16] = {
+        (1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f,
+        2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f,
+        2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f,
+        p.x, p.y, p.z, 1.0f
+    };
+    for (int i = 0; i < 16; ++i) o[i] = values[i];
+}
+
+void referenceMultiply(const float* l, const float* r, float* o) {
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) sum += l[k * 4 + row] * r[column * 4 + k];
+            o[column * 4 + row] = sum;
+        }
+    }
+}
+
+bool close(const float* a, const float* b, int count) {
+    for (int i = 0; i < count; ++i) {
+        float tolerance = 1e-5f * std::max(1.0f, std::fabs(b[i]));
+        if (!(std::fabs(a[i] - b[i]) <= tolerance)) return false;
+    }
+    return true;
+}
+
+// 数组从偏移一个float的位置开始，既不16字节也不32字节对齐；末尾留哨兵检查越界
+template<typename T>
+struct Unaligned {
+    std::vector<float> storage;
+    size_t count;
+
+    explicit Unaligned(size_t n, size_t guard = 0)
+        : storage(1 + (n + guard) * (sizeof(T) / sizeof(float)), SENTINEL), count(n) {}
+
+    T* data() { return reinterpret_cast<T*>(storage.data() + 1); }
+    const float* floats(size_t i) { return storage.data() + 1 + i * (sizeof(T) / sizeof(float)); }
+};
+
+struct Inputs {
+    Unaligned<glm::vec3> positions;
+    Unaligned<glm::quat> rotations;
+    Unaligned<glm::vec3> scales;
+
+    Inputs(size_t count, std::mt19937& rng) : positions(count), rotations(count), scales(count) {
+        std::uniform_real_distribution<float> value(-5.0f, 5.0f);
+        for (size_t i = 0; i < count; ++i) {
+            positions.data()[i] = glm::vec3(value(rng), value(rng), value(rng));
+            glm::quat q(value(rng), value(rng), value(rng), value(rng));
+            float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+            rotations.data()[i] = glm::quat(q.w / length, q.x / length, q.y / length, q.z / length);
+            scales.data()[i] = glm::vec3(value(rng), value(rng), value(rng));
+        }
+    }
+};
+
+constexpr size_t GUARD = 2;
+
+bool guardIntact(Unaligned<glm::mat4>& out) {
+    for (size_t i = out.count; i < out.count + GUARD; ++i) {
+        const float* guard = out.floats(i);
+        for (int k = 0; k < 16; ++k) {
+            if (guard[k] != SENTINEL) return false;
+        }
+    }
+    return true;
+}
+
+void testLocalMatrices() {
+    std::mt19937 rng(8);
+    bool match = true;
+    bool inBounds = true;
+
+    // 0..41覆盖AVX2的8个一组、SSE的4个一组和每种零头
+    for (size_t count = 0; count <= 41; ++count) {
+        Inputs inputs(count, rng);
+        Unaligned<glm::mat4> out(count, GUARD);
+        TransformBatch::computeLocalMatrices(
+            inputs.positions.data(), inputs.rotations.data(), inputs.scales.data(), out.data(), count);
+
+        for (size_t i = 0; i < count; ++i) {
+            float expected[16];
+            referenceLocal(inputs.positions.data()[i], inputs.rotations.data()[i], inputs.scales.data()[i], expected);
+            match &= close(out.floats(i), expected, 16);
+        }
+        inBounds &= guardIntact(out);
+    }
+    CHECK(match);
+    CHECK(inBounds);
+}
+
+void testMultiply() {
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+    bool match = true;
+    bool inPlaceMatch = true;
+    bool inBounds = true;
+
+    for (size_t count = 0; count <= 19; ++count) {
+        glm::mat4 lhs;
+        for (int column = 0; column < 4; ++column) {
+            lhs[column] = glm::vec4(value(rng), value(rng), value(rng), value(rng));
+        }
+
+        Unaligned<glm::mat4> rhs(count);
+        for (size_t i = 0; i < count; ++i) {
+            for (int column = 0; column < 4; ++column) {
+                rhs.data()[i][column] = glm::vec4(value(rng), value(rng), value(rng), value(rng));
+            }
+        }
+
+        std::vector<float> expected(count * 16);
+        for (size_t i = 0; i < count; ++i) {
+            referenceMultiply(glm::value_ptr(lhs), rhs.floats(i), expected.data() + i * 16);
+        }
+
+        Unaligned<glm::mat4> out(count, GUARD);
+        TransformBatch::multiply(lhs, rhs.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i) match &= close(out.floats(i), expected.data() + i * 16, 16);
+        inBounds &= guardIntact(out);
+
+        // out和rhs是同一个数组
+        TransformBatch::multiply(lhs, rhs.data(), rhs.data(), count);
+        for (size_t i = 0; i < count; ++i) inPlaceMatch &= close(rhs.floats(i), expected.data() + i * 16, 16);
+    }
+    CHECK(match);
+    CHECK(inPlaceMatch);
+    CHECK(inBounds);
+}
+
+// lhs本身不对齐（例如在组件数组中间的父节点世界矩阵）
+void testUnalignedLhs() {
+    Unaligned<glm::mat4> lhs(1);
+    for (int i = 0; i < 16; ++i) lhs.storage[1 + i] = static_cast<float>(i + 1);
+
+    glm::mat4 rhs(1.0f);
+    rhs[3] = glm::vec4(1.0f, 2.0f, 3.0f, 1.0f);
+    glm::mat4 out;
+    TransformBatch::multiply(*lhs.data(), &rhs, &out, 1);
+
+    float expected[16];
+    referenceMultiply(lhs.floats(0), glm::value_ptr(rhs), expected);
+    CHECK(close(glm::value_ptr(out), expected, 16));
+}
+
+} // namespace
+
+int main() {
+    std::printf("TransformBatch instruction set: %s\n", TransformBatch::getInstructionSet());
+    testLocalMatrices();
+    testMultiply();
+    testUnalignedLhs();
+    return test::finish("test_transform_batch");
+}
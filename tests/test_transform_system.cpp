@@ -0,0 +1,214 @@
+#include "TestCommon.h"
+#include "ECS/ECS.h"
+#include "ECS/TransformSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// TransformSystem：随机修改/换父节点/增删实体后，世界矩阵和逐个递归算出来的结果一致；
+// 没变的子树不重算，不带变换的结构变化不触发rebuild
+
+namespace {
+
+// 不带变换的实体用到的组件
+struct Tag { int value; };
+
+// 暴力计算：沿父链递归，父节点不存在或没有变换时当作根
+glm::mat4 bruteForceWorld(ECS& ecs, Entity entity, int depth = 0) {
+    const TransformComponent* transform = ecs.getComponent<TransformComponent>(entity);
+    glm::mat4 local = transform->getLocalMatrix();
+    if (depth > 1000 || !ecs.hasComponent<TransformComponent>(transform->parent)) {
+        return local;
+    }
+    return bruteForceWorld(ecs, transform->parent, depth + 1) * local;
+}
+
+bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+    for (int column = 0; column < 4; ++column) {
+        for (int row = 0; row < 4; ++row) {
+            float scale = std::max(1.0f, std::fabs(b[column][row]));
+            if (std::fabs(a[column][row] - b[column][row]) > 1e-3f * scale) return false;
+        }
+    }
+    return true;
+}
+
+bool matchesBruteForce(ECS& ecs) {
+    bool match = true;
+    ecs.view<TransformComponent>().each([&](Entity entity, TransformComponent& transform) {
+        match &= !transform.dirty;
+        match &= nearlyEqual(transform.transform, bruteForceWorld(ecs, entity));
+    });
+    return match;
+}
+
+// ancestor是否在entity的父链上（换父节点时避免成环）
+bool isAncestor(ECS& ecs, Entity ancestor, Entity entity) {
+    for (int depth = 0; depth < 1000 && entity != INVALID_ENTITY; ++depth) {
+        if (entity == ancestor) return true;
+        const TransformComponent* transform = ecs.getComponent<TransformComponent>(entity);
+        entity = transform ? transform->parent : INVALID_ENTITY;
+    }
+    return false;
+}
+
+glm::quat randomRotation(std::mt19937& rng) {
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+    return TransformComponent::fromEuler(glm::vec3(angle(rng), angle(rng), angle(rng)));
+}
+
+void testRandomHierarchy() {
+    ECS ecs;
+    TransformSystem system;
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+    std::vector<Entity> entities;
+    auto pick = [&]() { return entities[std::uniform_int_distribution<size_t>(0, entities.size() - 1)(rng)]; };
+
+    auto spawn = [&]() {
+        TransformComponent transform;
+        transform.position = glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng));
+        transform.rotation = randomRotation(rng);
+        transform.scale = glm::vec3(scale(rng), scale(rng), scale(rng));
+        if (!entities.empty() && rng() % 4 != 0) {
+            transform.parent = pick();
+        }
+        Entity entity = ecs.createEntity();
+        ecs.addComponent(entity, transform);
+        entities.push_back(entity);
+    };
+
+    for (int i = 0; i < 500; ++i) spawn();
+
+    bool match = true;
+    for (int frame = 0; frame < 60 && match; ++frame) {
+        int changes = std::uniform_int_distribution<int>(0, 20)(rng);
+        for (int c = 0; c < changes; ++c) {
+            Entity entity = pick();
+            TransformComponent* transform = ecs.getComponent<TransformComponent>(entity);
+
+            switch (rng() % 7) {
+                case 0: transform->setPosition(glm::vec3(coordinate(rng), coordinate(rng), coordinate(rng))); break;
+                case 1: transform->setRotation(randomRotation(rng)); break;
+                case 2: transform->setScale(glm::vec3(scale(rng))); break;
+                case 3: {
+                    Entity parent = rng() % 5 == 0 ? INVALID_ENTITY : pick();
+                    if (!isAncestor(ecs, entity, parent)) transform->setParent(parent);
+                    break;
+                }
+                case 4:
+                    // 孩子失去父节点，变成根
+                    ecs.destroyEntity(entity);
+                    entities.erase(std::find(entities.begin(), entities.end(), entity));
+                    break;
+                case 5: spawn(); break;
+                default:
+                    // 换archetype：组件指针变了，但层级没变
+                    if (ecs.hasComponent<Tag>(entity)) ecs.removeComponent<Tag>(entity);
+                    else ecs.addComponent(entity, Tag{ frame });
+                    break;
+            }
+        }
+
+        system.update(ecs, 0.016f);
+        match = matchesBruteForce(ecs);
+    }
+    CHECK(match);
+    CHECK_EQ(system.getNodeCount(), entities.size());
+}
+
+// 只改一个叶子：只重算这一个；改一个中间节点：重算它的整棵子树，别的都不碰
+void testOnlyChangedSubtreesUpdate() {
+    ECS ecs;
+    TransformSystem system;
+
+    // root -> a -> a1, a2；root -> b
+    auto spawn = [&](Entity parent, glm::vec3 position) {
+        Entity entity = ecs.createEntity();
+        TransformComponent transform;
+        transform.position = position;
+        transform.parent = parent;
+        ecs.addComponent(entity, transform);
+        return entity;
+    };
+    Entity root = spawn(INVALID_ENTITY, glm::vec3(1, 0, 0));
+    Entity a = spawn(root, glm::vec3(0, 1, 0));
+    Entity a1 = spawn(a, glm::vec3(0, 0, 1));
+    Entity a2 = spawn(a, glm::vec3(0, 0, 2));
+    Entity b = spawn(root, glm::vec3(0, 3, 0));
+
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getUpdatedCount(), 5u);
+    CHECK_EQ(system.getMaxDepth(), 2u);
+    CHECK(matchesBruteForce(ecs));
+
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getUpdatedCount(), 0u);
+
+    ecs.getComponent<TransformComponent>(a2)->setPosition(glm::vec3(5, 5, 5));
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getUpdatedCount(), 1u);
+
+    uint32_t bVersion = ecs.getComponent<TransformComponent>(b)->version;
+    ecs.getComponent<TransformComponent>(a)->setScale(glm::vec3(2.0f));
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getUpdatedCount(), 3u);
+    CHECK_EQ(ecs.getComponent<TransformComponent>(b)->version, bVersion);
+    CHECK(matchesBruteForce(ecs));
+
+    // 换父节点
+    ecs.getComponent<TransformComponent>(a1)->setParent(b);
+    system.update(ecs, 0.016f);
+    CHECK(matchesBruteForce(ecs));
+
+    // 父节点被删：孩子变成根，世界矩阵等于局部矩阵
+    ecs.destroyEntity(b);
+    system.update(ecs, 0.016f);
+    const TransformComponent* orphan = ecs.getComponent<TransformComponent>(a1);
+    CHECK(nearlyEqual(orphan->transform, orphan->getLocalMatrix()));
+    CHECK(matchesBruteForce(ecs));
+}
+
+// 不带变换的实体的结构变化不触发rebuild，变换组件被搬动时才rebuild
+void testRebuildOnlyForTransformChanges() {
+    ECS ecs;
+    TransformSystem system;
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 100; ++i) {
+        Entity entity = ecs.createEntity();
+        ecs.addComponent(entity, TransformComponent());
+        entities.push_back(entity);
+    }
+    system.update(ecs, 0.016f);
+    size_t rebuilds = system.getRebuildCount();
+
+    for (int i = 0; i < 50; ++i) {
+        Entity particle = ecs.createEntity();
+        ecs.addComponent(particle, Tag{ i });
+        if (i % 2) ecs.destroyEntity(particle);
+    }
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getRebuildCount(), rebuilds);
+    CHECK_EQ(system.getUpdatedCount(), 0u);
+
+    // 给带变换的实体加组件：行被搬到别的archetype，缓存的指针失效
+    ecs.addComponent(entities[10], Tag{ 1 });
+    ecs.getComponent<TransformComponent>(entities[10])->setPosition(glm::vec3(3, 2, 1));
+    system.update(ecs, 0.016f);
+    CHECK_EQ(system.getRebuildCount(), rebuilds + 1);
+    CHECK_EQ(system.getUpdatedCount(), 1u);
+    CHECK(matchesBruteForce(ecs));
+}
+
+} // namespace
+
+int main() {
+    testRandomHierarchy();
+    testOnlyChangedSubtreesUpdate();
+    testRebuildOnlyForTransformChanges();
+    return test::finish("test_transform_system");
+}
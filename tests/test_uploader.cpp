@@ -0,0 +1,253 @@
+#include "TestCommon.h"
+#include "Core/VulkanUploader.h"
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+// VulkanUploader的CPU部分：
+// - 环形缓冲的分配和回收：还没完成的分配在物理上互不重叠、不跨过末尾、对齐，
+//   按allocateRing()的顺序（回收、从头开始、提交）总能分配成功
+// - planCopies()：同一批次里重叠的上传按上传顺序生效，段内没有重叠的目标区域
+// 提交、timeline信号量和所有权转移需要设备（VulkanBuffer::create还是学习任务），这里不测
+
+namespace {
+
+using Copy = VulkanUploader::Copy;
+using CopyCommand = VulkanUploader::CopyCommand;
+
+VkBuffer handle(uintptr_t value) {
+    return reinterpret_cast<VkBuffer>(value);
+}
+
+struct Allocation {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct Batch {
+    uint64_t ringEnd = 0;
+    std::vector<Allocation> allocations;
+};
+
+void testRingKnown() {
+    VulkanUploader::RingSpace ring;
+    ring.size = 64;
+    VkDeviceSize offset = 0;
+
+    CHECK(ring.tryAllocate(20, offset));
+    CHECK_EQ(offset, 0u);
+    CHECK(ring.tryAllocate(8, offset));
+    CHECK_EQ(offset, 32u);                  // 对齐到COPY_ALIGNMENT
+    CHECK(!ring.tryAllocate(30, offset));   // 末尾放不下，开头还被占着
+    CHECK_EQ(ring.head, 40u);
+
+    // 第一个批次完成：开头空出来，跳过末尾
+    ring.tail = 20;
+    CHECK(!ring.tryAllocate(30, offset));   // 跳过末尾后要到64 + 30，超过tail + 64
+    ring.tail = 40;
+    CHECK(ring.tryAllocate(30, offset));
+    CHECK_EQ(offset, 0u);
+    CHECK_EQ(ring.head, 94u);
+
+    // 全部完成，但跳过末尾算占用：空闲时从头开始
+    ring.tail = ring.head;
+    CHECK(!ring.tryAllocate(40, offset));
+    CHECK(ring.isIdle());
+    ring.restart();
+    CHECK_EQ(ring.head, 128u);
+    CHECK(ring.tryAllocate(40, offset));
+    CHECK_EQ(offset, 0u);
+}
+
+// 和allocateRing()相同的循环，批次随机提交、按顺序随机完成
+void testRingReclaim() {
+    std::mt19937 rng(17);
+    bool aligned = true;
+    bool inside = true;
+    bool disjoint = true;
+    bool allocated = true;
+
+    for (VkDeviceSize ringSize : { 64u, 256u, 4096u }) {
+        VulkanUploader::RingSpace ring;
+        ring.size = ringSize;
+        std::deque<Batch> batches;
+        Batch current;
+
+        for (int step = 0; step < 20000 && allocated; ++step) {
+            VkDeviceSize bytes = 1 + rng() % (ringSize / 2);
+            VkDeviceSize offset = 0;
+            int attempts = 0;
+            while (!ring.tryAllocate(bytes, offset)) {
+                if (++attempts > 1000) {
+                    allocated = false;
+                    break;
+                }
+                if (!batches.empty()) {
+                    // 等待最早的批次
+                    ring.tail = batches.front().ringEnd;
+                    batches.pop_front();
+                } else if (ring.isIdle()) {
+                    ring.restart();
+                } else {
+                    // 占着空间的只有当前批次自己：提交
+                    current.ringEnd = ring.head;
+                    batches.push_back(std::move(current));
+                    current = Batch();
+                }
+            }
+            if (!allocated) break;
+
+            aligned &= offset % VulkanUploader::COPY_ALIGNMENT == 0;
+            inside &= offset + bytes <= ringSize;
+            auto overlaps = [&](const Allocation& other) {
+                return offset < other.offset + other.size && other.offset < offset + bytes;
+            };
+            for (const Batch& batch : batches) {
+                for (const Allocation& other : batch.allocations) disjoint &= !overlaps(other);
+            }
+            for (const Allocation& other : current.allocations) disjoint &= !overlaps(other);
+            current.allocations.push_back({ offset, bytes });
+
+            if (rng() % 4 == 0 && !current.allocations.empty()) {
+                current.ringEnd = ring.head;
+                batches.push_back(std::move(current));
+                current = Batch();
+            }
+            if (rng() % 3 == 0 && !batches.empty()) {
+                ring.tail = batches.front().ringEnd;
+                batches.pop_front();
+            }
+        }
+    }
+    CHECK(allocated);
+    CHECK(aligned);
+    CHECK(inside);
+    CHECK(disjoint);
+}
+
+// 按命令执行复制：每个区域把它的srcOffset（上传的编号）写进目标的字节。
+// 检查段内（两个屏障之间）目标区域不重叠、每个上传恰好出现一次、命令的源和目标是上传的
+bool executePlan(const std::vector<Copy>& copies, const std::vector<VkBufferCopy>& regions,
+                 const std::vector<CopyCommand>& commands, std::vector<std::vector<int>>& memory) {
+    std::set<std::pair<VkBuffer, VkDeviceSize>> segmentBytes;
+    std::vector<int> seen(copies.size(), 0);
+    uint32_t nextRegion = 0;
+
+    for (const CopyCommand& command : commands) {
+        if (command.barrierBefore) segmentBytes.clear();
+        if (command.firstRegion != nextRegion || command.regionCount == 0) return false;
+        nextRegion += command.regionCount;
+
+        for (uint32_t i = command.firstRegion; i < command.firstRegion + command.regionCount; ++i) {
+            const VkBufferCopy& region = regions[i];
+            const Copy& copy = copies[region.srcOffset];
+            if (copy.src != command.src || copy.dst != command.dst || copy.region.dstOffset != region.dstOffset ||
+                copy.region.size != region.size) {
+                return false;
+            }
+            seen[region.srcOffset]++;
+
+            for (VkDeviceSize byte = region.dstOffset; byte < region.dstOffset + region.size; ++byte) {
+                if (!segmentBytes.insert({ command.dst, byte }).second) return false;
+                memory[reinterpret_cast<uintptr_t>(command.dst)][byte] = static_cast<int>(region.srcOffset);
+            }
+        }
+    }
+    for (int count : seen) {
+        if (count != 1) return false;
+    }
+    return nextRegion == regions.size();
+}
+
+void testPlanAgainstUploadOrder() {
+    std::mt19937 rng(29);
+    bool valid = true;
+    bool matches = true;
+
+    for (int round = 0; round < 500; ++round) {
+        // 源：环形缓冲或单独的staging；目标：3个缓冲的前64字节
+        std::vector<Copy> copies(1 + rng() % 40);
+        for (size_t i = 0; i < copies.size(); ++i) {
+            copies[i].src = handle(10 + rng() % 2);
+            copies[i].dst = handle(rng() % 3);
+            copies[i].region = { i, rng() % 56, 1 + rng() % 8 };   // srcOffset记下编号
+        }
+
+        std::vector<std::vector<int>> expected(3, std::vector<int>(64, -1));
+        for (size_t i = 0; i < copies.size(); ++i) {
+            const VkBufferCopy& region = copies[i].region;
+            for (VkDeviceSize byte = region.dstOffset; byte < region.dstOffset + region.size; ++byte) {
+                expected[reinterpret_cast<uintptr_t>(copies[i].dst)][byte] = static_cast<int>(i);
+            }
+        }
+
+        std::vector<VkBufferCopy> regions;
+        std::vector<CopyCommand> commands;
+        VulkanUploader::planCopies(copies, regions, commands);
+
+        std::vector<std::vector<int>> memory(3, std::vector<int>(64, -1));
+        valid &= executePlan(copies, regions, commands, memory);
+        matches &= memory == expected;
+    }
+    CHECK(valid);
+    CHECK(matches);
+}
+
+void testPlanKnown() {
+    VkBuffer ring = handle(10);
+    VkBuffer staging = handle(11);
+    VkBuffer vertices = handle(1);
+    VkBuffer indices = handle(2);
+
+    std::vector<VkBufferCopy> regions;
+    std::vector<CopyCommand> commands;
+
+    // 没有重叠：每对源和目标一条命令，没有屏障
+    std::vector<Copy> disjoint = {
+        { ring, vertices, { 0, 0, 16 } },
+        { ring, indices, { 16, 0, 16 } },
+        { ring, vertices, { 32, 16, 16 } },
+        { staging, vertices, { 0, 32, 16 } },
+    };
+    VulkanUploader::planCopies(disjoint, regions, commands);
+    CHECK_EQ(commands.size(), 3u);
+    CHECK_EQ(regions.size(), 4u);
+    bool barriers = false;
+    for (const CopyCommand& command : commands) barriers |= command.barrierBefore;
+    CHECK(!barriers);
+
+    // 同一块区域先从单独的staging、再从环形缓冲上传：按源排序会让环形缓冲的先执行，
+    // 这里必须保持上传顺序并且中间有屏障
+    std::vector<Copy> overwrite = {
+        { staging, vertices, { 0, 0, 32 } },
+        { ring, vertices, { 0, 8, 8 } },
+    };
+    VulkanUploader::planCopies(overwrite, regions, commands);
+    CHECK_EQ(commands.size(), 2u);
+    CHECK(commands[0].src == staging);
+    CHECK(!commands[0].barrierBefore);
+    CHECK(commands[1].src == ring);
+    CHECK(commands[1].barrierBefore);
+
+    // 相邻不算重叠
+    std::vector<Copy> adjacent = {
+        { ring, vertices, { 0, 0, 16 } },
+        { ring, vertices, { 16, 16, 16 } },
+    };
+    VulkanUploader::planCopies(adjacent, regions, commands);
+    CHECK_EQ(commands.size(), 1u);
+    CHECK_EQ(commands[0].regionCount, 2u);
+}
+
+} // namespace
+
+int main() {
+    testRingKnown();
+    testRingReclaim();
+    testPlanAgainstUploadOrder();
+    testPlanKnown();
+    return test::finish("test_uploader");
+}